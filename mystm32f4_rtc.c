@@ -515,11 +515,18 @@ void myRTC_ExitInitMode(void)
   * 3. 等待 RSF 标志置位或超时（SYNCHRO_TIMEOUT）。
   * 4. 根据 RSF 标志判断同步状态，返回 SUCCESS 或 ERROR。
   * 5. 重新启用 RTC 写保护。
+  * @note   旁路影子寄存器（BYPSHAD = 1）时读取不依赖 RSF，直接返回 SUCCESS，不做等待。
   */
 ErrorStatus myRTC_WaitForSynchro(void)
 {
     __IO uint32_t synchrocounter = 0;
     uint32_t synchrostatus = 0;
+
+    // 旁路模式下不需要同步
+    if ((RTC->CR & RTC_CR_BYPSHAD) != RESET)
+    {
+        return SUCCESS;
+    }
     
     // 禁用写保护
     RTC->WPR = 0xCA;
@@ -587,6 +594,37 @@ ErrorStatus myRTC_RefClockCmd(FunctionalState NewState)
     return status;
 }
 
+/**
+  * @brief  启用或禁用影子寄存器旁路（BYPSHAD）
+  * @param  NewState: 旁路的新状态
+  *          此参数可取值：
+  *            - ENABLE  : 日历读取直接访问计数器，不经过影子寄存器
+  *            - DISABLE : 日历读取经过影子寄存器（复位默认）
+  * @retval None
+  * @note   旁路模式下：
+  *          - 从 Stop 等低功耗模式唤醒后不需要 myRTC_WaitForSynchro()（直接返回 SUCCESS），
+  *            读到的是计数器当前值，没有影子寄存器最多 2 个 RTCCLK 的滞后。
+  *          - 计数器在读取过程中可能进位，myRTC_GetTime()、myRTC_GetDate()、
+  *            myRTC_GetEpochMs/Us() 会连续读两遍并比较，不一致则重读。
+  *          - APB1 时钟低于 RTCCLK 的 7 倍时影子寄存器无法正确同步，必须使用旁路模式。
+  *          小白理解：影子寄存器像“拍照”，要等照片洗好（RSF）才能看；旁路是直接看表盘，
+  *          不用等，但秒针可能正好在跳，所以看两眼一致才算数。
+  */
+void myRTC_BypassShadowCmd(FunctionalState NewState)
+{
+    // 参数检查
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    // 禁用写保护
+    RTC->WPR = 0xCA;
+    RTC->WPR = 0x53;
+
+    (NewState != DISABLE) ? (RTC->CR |= RTC_CR_BYPSHAD) : (RTC->CR &= ~RTC_CR_BYPSHAD);
+
+    // 重新启用写保护
+    RTC->WPR = 0xFF;
+}
+
 /** @defgroup RTC_Group2 时间和日期配置函数
  *  @brief   时间和日期配置相关函数
  *
@@ -599,27 +637,49 @@ ErrorStatus myRTC_RefClockCmd(FunctionalState NewState)
 
 
 /**
-  * @brief   设置 RTC 当前时间
+  * @brief  把一个字中的 4 个压缩 BCD 字节（每字节 0x00~0x99）一次转换为 4 个二进制字节。
+  * @param  Bcd: 4 个 BCD 字节，调用者须先屏蔽 PM、WDU、MSKx 等非数字位
+  * @retval 4 个二进制字节，字节位置与输入相同
+  * @note   每个字节 16*十位 + 个位 减去 6*十位 即为 10*十位 + 个位；
+  *         6*十位 不超过 54，不会跨字节进位，减法结果非负，不会跨字节借位。
+  *         一次乘法、一次减法替代逐字段的乘法和移位。
+  */
+static uint32_t RTC_Bcd4ToBin4(uint32_t Bcd)
+{
+    return Bcd - 6 * ((Bcd >> 4) & 0x0F0F0F0F);
+}
+
+/**
+  * @brief  把一个字中的 4 个二进制字节（每字节 0~99）一次转换为 4 个压缩 BCD 字节。
+  * @param  Bin: 4 个二进制字节
+  * @retval 4 个 BCD 字节，字节位置与输入相同
+  * @note   奇偶字节分别放进 16 位通道，十位 = (v * 103) >> 10（v < 179 时精确），
+  *         99 * 103 = 10197 不超过 16 位，通道之间不会进位；BCD = v + 6*十位。
+  *         两次乘法替代 4 次除法和 4 次取余。
+  */
+static uint32_t RTC_Bin4ToBcd4(uint32_t Bin)
+{
+    uint32_t even = Bin & 0x00FF00FF;
+    uint32_t odd = (Bin >> 8) & 0x00FF00FF;
+
+    even += 6 * (((even * 103) >> 10) & 0x000F000F);
+    odd += 6 * (((odd * 103) >> 10) & 0x000F000F);
+
+    return even | (odd << 8);
+}
+
+/**
+  * @brief   把时间结构体转换为 RTC_TR 寄存器映像
   * @param   RTC_Format: 指定时间数据格式
   *           - RTC_Format_BIN : 二进制格式
   *           - RTC_Format_BCD : BCD 格式
-  * @param   RTC_TimeStruct: 指向 RTC_TimeTypeDef 结构体，包含时间配置信息
-  * @retval  ErrorStatus:
-  *           - SUCCESS : RTC 时间寄存器配置成功
-  *           - ERROR   : RTC 时间寄存器配置失败
-  * @note    RTC 时间寄存器受写保护，调用前应禁用写保护：
-  *          RTC_WriteProtectionCmd(DISABLE)
-  * @details
-  * 1. 根据输入格式（BIN/BCD）检查小时、分钟、秒数是否合法。
-  * 2. 将时间数据转换为 RTC_TR 寄存器格式。
-  * 3. 进入 RTC 初始化模式，写入时间寄存器。
-  * 4. 退出初始化模式，必要时等待同步完成。
-  * 5. 重新启用写保护。
+  * @param   RTC_TimeStruct: 指向 RTC_TimeTypeDef 结构体，24 小时制时 RTC_H12 被清零
+  * @retval  RTC_TR 寄存器值（BCD，含 PM 位）
+  * @note    只做参数检查和格式转换，不访问寄存器；myRTC_SetTime() 和异步设置共用。
   */
-ErrorStatus myRTC_SetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct)
+uint32_t myRTC_PackTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct)
 {
     uint32_t tmpreg = 0;
-    ErrorStatus status = ERROR;
     uint8_t is12Hour = ((RTC->CR & RTC_CR_FMT) != RESET) ? 1 : 0;
 
     // 参数检查
@@ -634,9 +694,9 @@ ErrorStatus myRTC_SetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct)
         assert_param(IS_RTC_MINUTES(RTC_TimeStruct->RTC_Minutes));
         assert_param(IS_RTC_SECONDS(RTC_TimeStruct->RTC_Seconds));
         
-        tmpreg = ((uint32_t)RTC_ByteToBcd2(RTC_TimeStruct->RTC_Hours) << 16) |
-                 ((uint32_t)RTC_ByteToBcd2(RTC_TimeStruct->RTC_Minutes) << 8) |
-                 ((uint32_t)RTC_ByteToBcd2(RTC_TimeStruct->RTC_Seconds)) |
+        tmpreg = RTC_Bin4ToBcd4(((uint32_t)RTC_TimeStruct->RTC_Hours << 16) |
+                                ((uint32_t)RTC_TimeStruct->RTC_Minutes << 8) |
+                                ((uint32_t)RTC_TimeStruct->RTC_Seconds)) |
                  ((uint32_t)RTC_TimeStruct->RTC_H12 << 16);
     }
 	else { // BCD 格式
@@ -658,6 +718,32 @@ ErrorStatus myRTC_SetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct)
                  ((uint32_t)RTC_TimeStruct->RTC_H12 << 16);
     }
 
+    return tmpreg & RTC_TR_RESERVED_MASK;
+}
+
+/**
+  * @brief   设置 RTC 当前时间
+  * @param   RTC_Format: 指定时间数据格式
+  *           - RTC_Format_BIN : 二进制格式
+  *           - RTC_Format_BCD : BCD 格式
+  * @param   RTC_TimeStruct: 指向 RTC_TimeTypeDef 结构体，包含时间配置信息
+  * @retval  ErrorStatus:
+  *           - SUCCESS : RTC 时间寄存器配置成功
+  *           - ERROR   : RTC 时间寄存器配置失败
+  * @note    RTC 时间寄存器受写保护，调用前应禁用写保护：
+  *          RTC_WriteProtectionCmd(DISABLE)
+  * @details
+  * 1. 根据输入格式（BIN/BCD）检查小时、分钟、秒数是否合法。
+  * 2. 将时间数据转换为 RTC_TR 寄存器格式。
+  * 3. 进入 RTC 初始化模式，写入时间寄存器。
+  * 4. 退出初始化模式，必要时等待同步完成。
+  * 5. 重新启用写保护。
+  */
+ErrorStatus myRTC_SetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct)
+{
+    uint32_t tmpreg = myRTC_PackTime(RTC_Format, RTC_TimeStruct);
+    ErrorStatus status = ERROR;
+
     // 禁用写保护
     RTC->WPR = 0xCA;
     RTC->WPR = 0x53;
@@ -694,6 +780,59 @@ void myRTC_TimeStructInit(RTC_TimeTypeDef* RTC_TimeStruct)
   RTC_TimeStruct->RTC_Seconds = 0; 
 }
 
+/**
+  * @brief  旁路模式下读一个日历寄存器：连续读两遍，一致才返回。
+  * @param  Reg: RTC->TR 或 RTC->DR
+  * @retval 寄存器值
+  * @note   计数器进位只在 RTCCLK 边沿发生，两次读取间隔远小于一个 RTCCLK 周期，
+  *         最多重读一次。
+  */
+static uint32_t RTC_ReadStable(__IO uint32_t* Reg)
+{
+    uint32_t first = 0;
+    uint32_t second = *Reg;
+
+    do
+    {
+        first = second;
+        second = *Reg;
+    } while (first != second);
+
+    return second;
+}
+
+/**
+  * @brief  读取一组前后一致的 SSR、TR、DR。
+  * @param  SSR/TR/DR: 输出寄存器值
+  * @retval None
+  * @note   影子寄存器模式：按 SSR -> TR -> DR 顺序各读一次。读 SSR 会锁住 TR/DR 影子寄存器，
+  *         读 DR 才解锁，三者来自同一时刻。
+  *         旁路模式：整组读两遍并比较，任何一个不同说明中间有计数边沿，重读。
+  */
+static void RTC_ReadCalendar(uint32_t* SSR, uint32_t* TR, uint32_t* DR)
+{
+    uint32_t ssr = RTC->SSR;
+    uint32_t tr = RTC->TR;
+    uint32_t dr = RTC->DR;
+
+    if ((RTC->CR & RTC_CR_BYPSHAD) != RESET)
+    {
+        do
+        {
+            *SSR = ssr;
+            *TR = tr;
+            *DR = dr;
+            ssr = RTC->SSR;
+            tr = RTC->TR;
+            dr = RTC->DR;
+        } while (ssr != *SSR || tr != *TR || dr != *DR);
+    }
+
+    *SSR = ssr;
+    *TR = tr;
+    *DR = dr;
+}
+
 /**
   * @brief  获取 RTC 当前时间
   * @param  RTC_Format: 指定返回时间的格式，可取值：
@@ -702,6 +841,7 @@ void myRTC_TimeStructInit(RTC_TimeTypeDef* RTC_TimeStruct)
   * @param  RTC_TimeStruct: 指向 RTC_TimeTypeDef 结构体指针，用于存储获取的时间
   * @retval None
   * @note   从 RTC_TR 寄存器读取当前时间，并根据 RTC_Format 转换格式。
+  *         旁路影子寄存器时连续读两遍 TR，一致才使用。
   */
 void myRTC_GetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct)
 {
@@ -711,21 +851,18 @@ void myRTC_GetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct)
   assert_param(IS_RTC_FORMAT(RTC_Format));
 
   /* 读取 RTC_TR 寄存器 */
-  tmpreg = (uint32_t)(RTC->TR & RTC_TR_RESERVED_MASK); 
-  
-  /* 将寄存器值填充到结构体中 */
-  RTC_TimeStruct->RTC_Hours   = (uint8_t)((tmpreg & (RTC_TR_HT | RTC_TR_HU)) >> 16);
-  RTC_TimeStruct->RTC_Minutes = (uint8_t)((tmpreg & (RTC_TR_MNT | RTC_TR_MNU)) >> 8);
-  RTC_TimeStruct->RTC_Seconds = (uint8_t)(tmpreg & (RTC_TR_ST | RTC_TR_SU));
-  RTC_TimeStruct->RTC_H12     = (uint8_t)((tmpreg & (RTC_TR_PM)) >> 16);  
+  tmpreg = ((RTC->CR & RTC_CR_BYPSHAD) != RESET) ? RTC_ReadStable(&RTC->TR) : RTC->TR;
+  tmpreg &= RTC_TR_RESERVED_MASK;
+  RTC_TimeStruct->RTC_H12 = (uint8_t)((tmpreg & (RTC_TR_PM)) >> 16);
 
-  /* 如果需要二进制格式，将 BCD 转换为二进制 */
-  if (RTC_Format == RTC_Format_BIN)
-  {
-    RTC_TimeStruct->RTC_Hours   = (uint8_t)RTC_Bcd2ToByte(RTC_TimeStruct->RTC_Hours);
-    RTC_TimeStruct->RTC_Minutes = (uint8_t)RTC_Bcd2ToByte(RTC_TimeStruct->RTC_Minutes);
-    RTC_TimeStruct->RTC_Seconds = (uint8_t)RTC_Bcd2ToByte(RTC_TimeStruct->RTC_Seconds);   
-  }
+  /* 去掉 PM 位后整字转换：二进制格式时时、分、秒三个字段一次完成 */
+  tmpreg &= ~RTC_TR_PM;
+  tmpreg = (RTC_Format == RTC_Format_BIN) ? RTC_Bcd4ToBin4(tmpreg) : tmpreg;
+
+  /* 将寄存器值填充到结构体中 */
+  RTC_TimeStruct->RTC_Hours   = (uint8_t)(tmpreg >> 16);
+  RTC_TimeStruct->RTC_Minutes = (uint8_t)(tmpreg >> 8);
+  RTC_TimeStruct->RTC_Seconds = (uint8_t)tmpreg;
 }
 
 /**
@@ -748,25 +885,106 @@ uint32_t myRTC_GetSubSecond(void)
   return tmpreg;
 }
 
+/**
+  * @brief  把 TR/DR 寄存器映像直接格式化为 ISO-8601 字符串 "20YY-MM-DDTHH:MM:SS[.mmm]"。
+  * @param  Buf: 输出缓冲区，至少 24 字节（含结尾 '\0'）
+  * @param  TR: RTC_TR（或 RTC_TSTR）寄存器值
+  * @param  DR: RTC_DR（或 RTC_TSDR）寄存器值
+  * @param  Ms: 毫秒 0~999；小于 0 时不输出小数部分
+  * @retval 写入的字符数（不含 '\0'）：19 或 23
+  * @note   BCD 的每个半字节就是一个十进制数字，直接加 '0' 输出，
+  *         不经过 BCD -> 二进制 -> sprintf 的往返，也不需要除法。
+  *         RTC 为 12 小时制（CR.FMT=1）时按 PM 位换算为 24 小时制。
+  *         TSDR 不含年份，格式化时间戳时年份固定输出 "2000"。
+  *         小白理解：把日志里的“读寄存器、拆字段、转二进制、再 sprintf”合成一步。
+  */
+uint8_t myRTC_FormatIso8601(char* Buf, uint32_t TR, uint32_t DR, int32_t Ms)
+{
+  uint32_t hours = (TR >> 16) & 0x3F;
+  uint32_t tmp = 0;
+
+  /* 12 小时制换算：12AM -> 00，1PM~11PM -> 13~23，12PM -> 12 */
+  if ((RTC->CR & RTC_CR_FMT) != RESET)
+  {
+    hours = (hours == 0x12) ? 0x00 : hours;
+    hours = ((TR & RTC_TR_PM) != RESET) ? RTC_Bin4ToBcd4(RTC_Bcd4ToBin4(hours) + 12) : hours;
+  }
+
+  Buf[0]  = '2';
+  Buf[1]  = '0';
+  Buf[2]  = (char)('0' + ((DR >> 20) & 0x0F));
+  Buf[3]  = (char)('0' + ((DR >> 16) & 0x0F));
+  Buf[4]  = '-';
+  Buf[5]  = (char)('0' + ((DR >> 12) & 0x01));
+  Buf[6]  = (char)('0' + ((DR >> 8) & 0x0F));
+  Buf[7]  = '-';
+  Buf[8]  = (char)('0' + ((DR >> 4) & 0x03));
+  Buf[9]  = (char)('0' + (DR & 0x0F));
+  Buf[10] = 'T';
+  Buf[11] = (char)('0' + (hours >> 4));
+  Buf[12] = (char)('0' + (hours & 0x0F));
+  Buf[13] = ':';
+  Buf[14] = (char)('0' + ((TR >> 12) & 0x07));
+  Buf[15] = (char)('0' + ((TR >> 8) & 0x0F));
+  Buf[16] = ':';
+  Buf[17] = (char)('0' + ((TR >> 4) & 0x07));
+  Buf[18] = (char)('0' + (TR & 0x0F));
+
+  if (Ms < 0)
+  {
+    Buf[19] = '\0';
+    return 19;
+  }
+
+  /* 毫秒拆位用乘法代替除法：v*41>>12 对 0~999 等于 v/100，v*103>>10 对 0~99 等于 v/10 */
+  tmp = (uint32_t)Ms;
+  tmp = (tmp > 999) ? 999 : tmp;
+  Buf[19] = '.';
+  Buf[20] = (char)('0' + ((tmp * 41) >> 12));
+  tmp -= ((tmp * 41) >> 12) * 100;
+  Buf[21] = (char)('0' + ((tmp * 103) >> 10));
+  Buf[22] = (char)('0' + (tmp - ((tmp * 103) >> 10) * 10));
+  Buf[23] = '\0';
+
+  return 23;
+}
+
+/**
+  * @brief  读取当前日历并格式化为 ISO-8601 字符串（含毫秒）。
+  * @param  Buf: 输出缓冲区，至少 24 字节
+  * @retval 写入的字符数（不含 '\0'）
+  * @note   SSR/TR/DR 一次读出（见 RTC_ReadCalendar），毫秒由亚秒计数换算：
+  *         ms = (PREDIV_S - SS) * 1000 / (PREDIV_S + 1)。
+  *         SS 在移位操作后可能暂时大于 PREDIV_S，此时毫秒按 0 处理。
+  */
+uint8_t myRTC_GetIso8601(char* Buf)
+{
+  uint32_t ssr = 0, tr = 0, dr = 0;
+  uint32_t prediv_s = RTC->PRER & RTC_PRER_PREDIV_S;
+  int32_t ms = 0;
+
+  RTC_ReadCalendar(&ssr, &tr, &dr);
+  ssr &= RTC_SSR_SS;
+
+  ms = (ssr > prediv_s) ? 0 : (int32_t)(((prediv_s - ssr) * 1000) / (prediv_s + 1));
+
+  return myRTC_FormatIso8601(Buf, tr & RTC_TR_RESERVED_MASK, dr & RTC_DR_RESERVED_MASK, ms);
+}
+
 
 
 /**
-  * @brief  设置 RTC 当前日期
+  * @brief  把日期结构体转换为 RTC_DR 寄存器映像
   * @param  RTC_Format: 指定输入参数的格式，可取值：
   *            @arg RTC_Format_BIN: 二进制格式
   *            @arg RTC_Format_BCD: BCD 格式
-  * @param  RTC_DateStruct: 指向 RTC_DateTypeDef 结构体指针，包含日期配置信息
-  * @retval An ErrorStatus 枚举值:
-  *          - SUCCESS: RTC 日期寄存器已配置
-  *          - ERROR: RTC 日期寄存器配置失败
-  * @note   调用前应先关闭写保护（RTC_WriteProtectionCmd(DISABLE)），
-  *         设置完成后会自动恢复写保护。
-  *         如果 RTC_CR_BYPSHAD 位为 0，则会等待寄存器同步完成。
+  * @param  RTC_DateStruct: 指向 RTC_DateTypeDef 结构体指针
+  * @retval RTC_DR 寄存器值（BCD，含星期）
+  * @note   只做参数检查和格式转换，不访问寄存器；myRTC_SetDate() 和异步设置共用。
   */
-ErrorStatus myRTC_SetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
+uint32_t myRTC_PackDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
 {
   uint32_t tmpreg = 0;
-  ErrorStatus status = ERROR;
 
   /* 参数检查 */
   assert_param(IS_RTC_FORMAT(RTC_Format));
@@ -783,9 +1001,9 @@ ErrorStatus myRTC_SetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
     assert_param(IS_RTC_MONTH(RTC_DateStruct->RTC_Month));
     assert_param(IS_RTC_DATE(RTC_DateStruct->RTC_Date));
     
-    tmpreg = ((uint32_t)RTC_ByteToBcd2(RTC_DateStruct->RTC_Year) << 16) |
-             ((uint32_t)RTC_ByteToBcd2(RTC_DateStruct->RTC_Month) << 8) |
-             ((uint32_t)RTC_ByteToBcd2(RTC_DateStruct->RTC_Date)) |
+    tmpreg = RTC_Bin4ToBcd4(((uint32_t)RTC_DateStruct->RTC_Year << 16) |
+                            ((uint32_t)RTC_DateStruct->RTC_Month << 8) |
+                            ((uint32_t)RTC_DateStruct->RTC_Date)) |
              ((uint32_t)RTC_DateStruct->RTC_WeekDay << 13);
   }
   else
@@ -800,6 +1018,27 @@ ErrorStatus myRTC_SetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
              ((uint32_t)RTC_DateStruct->RTC_WeekDay << 13);
   }
 
+  return tmpreg & RTC_DR_RESERVED_MASK;
+}
+
+/**
+  * @brief  设置 RTC 当前日期
+  * @param  RTC_Format: 指定输入参数的格式，可取值：
+  *            @arg RTC_Format_BIN: 二进制格式
+  *            @arg RTC_Format_BCD: BCD 格式
+  * @param  RTC_DateStruct: 指向 RTC_DateTypeDef 结构体指针，包含日期配置信息
+  * @retval An ErrorStatus 枚举值:
+  *          - SUCCESS: RTC 日期寄存器已配置
+  *          - ERROR: RTC 日期寄存器配置失败
+  * @note   调用前应先关闭写保护（RTC_WriteProtectionCmd(DISABLE)），
+  *         设置完成后会自动恢复写保护。
+  *         如果 RTC_CR_BYPSHAD 位为 0，则会等待寄存器同步完成。
+  */
+ErrorStatus myRTC_SetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
+{
+  uint32_t tmpreg = myRTC_PackDate(RTC_Format, RTC_DateStruct);
+  ErrorStatus status = ERROR;
+
   /* 禁止写保护 */
   RTC->WPR = 0xCA;
   RTC->WPR = 0x53;
@@ -855,6 +1094,7 @@ void myRTC_DateStructInit(RTC_DateTypeDef* RTC_DateStruct)
   *           - 月份：RTC_DR_MT | RTC_DR_MU
   *           - 日期：RTC_DR_DT | RTC_DR_DU
   *           - 星期：RTC_DR_WDU
+  *         旁路影子寄存器时连续读两遍 DR，一致才使用。
   */
 void myRTC_GetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
 {
@@ -864,21 +1104,174 @@ void myRTC_GetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
   assert_param(IS_RTC_FORMAT(RTC_Format));
   
   /* 读取 RTC_DR 寄存器并屏蔽保留位 */
-  tmpreg = RTC->DR & RTC_DR_RESERVED_MASK; 
+  tmpreg = ((RTC->CR & RTC_CR_BYPSHAD) != RESET) ? RTC_ReadStable(&RTC->DR) : RTC->DR;
+  tmpreg &= RTC_DR_RESERVED_MASK;
+  RTC_DateStruct->RTC_WeekDay = (uint8_t)((tmpreg & RTC_DR_WDU) >> 13);
+
+  /* 去掉星期位后整字转换：二进制格式时年、月、日三个字段一次完成 */
+  tmpreg &= ~RTC_DR_WDU;
+  tmpreg = (RTC_Format == RTC_Format_BIN) ? RTC_Bcd4ToBin4(tmpreg) : tmpreg;
 
   /* 将寄存器值填入结构体 */
-  RTC_DateStruct->RTC_Year = (uint8_t)((tmpreg & (RTC_DR_YT | RTC_DR_YU)) >> 16);
-  RTC_DateStruct->RTC_Month = (uint8_t)((tmpreg & (RTC_DR_MT | RTC_DR_MU)) >> 8);
-  RTC_DateStruct->RTC_Date = (uint8_t)(tmpreg & (RTC_DR_DT | RTC_DR_DU));
-  RTC_DateStruct->RTC_WeekDay = (uint8_t)((tmpreg & RTC_DR_WDU) >> 13);
+  RTC_DateStruct->RTC_Year  = (uint8_t)(tmpreg >> 16);
+  RTC_DateStruct->RTC_Month = (uint8_t)(tmpreg >> 8);
+  RTC_DateStruct->RTC_Date  = (uint8_t)tmpreg;
+}
 
-  /* 若指定为二进制格式，则进行 BCD 转换 */
-  if (RTC_Format == RTC_Format_BIN)
-  {
-    RTC_DateStruct->RTC_Year  = (uint8_t)RTC_Bcd2ToByte(RTC_DateStruct->RTC_Year);
-    RTC_DateStruct->RTC_Month = (uint8_t)RTC_Bcd2ToByte(RTC_DateStruct->RTC_Month);
-    RTC_DateStruct->RTC_Date  = (uint8_t)RTC_Bcd2ToByte(RTC_DateStruct->RTC_Date);
-  }
+/**
+  * @brief  由 RTC 日历日期计算自 1970-01-01 起的天数（无分支、无循环）。
+  * @param  Year: 年份 0~99，表示 2000~2099 年
+  * @param  Month: 月份 1~12
+  * @param  Date: 日 1~31
+  * @retval 自 1970-01-01 起的天数
+  * @note   采用“把 3 月当作一年第一个月”的民用历算法：闰日落在年末，
+  *         月份的累计天数可以用 (153*mp+2)/5 一个公式算出，不需要查表。
+  *         RTC 年份只有 2000~2099，调整后的年份在 1999~2099 之间，
+  *         Y/100 - Y/400 恒为 15，世纪闰年规则化简为常数。
+  *         所有除法的除数都是常数，编译器会换成乘法和移位。
+  */
+static uint32_t RTC_DaysFromCivil(uint32_t Year, uint32_t Month, uint32_t Date)
+{
+    uint32_t jan_feb = (Month <= 2);                  /* 1、2 月算作上一年 */
+    uint32_t y = 2000 + Year - jan_feb;
+    uint32_t mp = Month + 9 - 12 * (1 - jan_feb);     /* 3 月 = 0 ... 2 月 = 11 */
+    uint32_t doy = (153 * mp + 2) / 5 + Date - 1;
+
+    /* 719468 为 0000-03-01 到 1970-01-01 的天数 */
+    return 365 * y + y / 4 - 15 + doy - 719468;
+}
+
+/**
+  * @brief  一次性读取 RTC 日历并换算为 Unix 秒和秒内子秒计数。
+  * @param  SubTicks: 输出秒内已经过的同步预分频计数，范围 0 ~ *Ticks-1
+  * @param  Ticks: 输出每秒的计数数，即 PREDIV_S + 1
+  * @retval 自 1970-01-01 00:00:00 起的秒数（RTC 日历按 UTC 设置时即为 Unix 时间）
+  *
+  * @note
+  *  - 读取顺序为 SSR -> TR -> DR：BYPSHAD = 0 时读 SSR 会锁住 TR/DR 影子寄存器，
+  *    直到读 DR 才解锁，三者来自同一时刻；顺序错了会在秒进位时得到相差 1 秒的结果。
+  *  - 影子寄存器模式下调用前须已同步（RSF = 1），例如初始化或低功耗唤醒后先调用 myRTC_WaitForSynchro()；
+  *    旁路模式（myRTC_BypassShadowCmd）不需要等待，整组读两遍比较，见 RTC_ReadCalendar()。
+  *  - 同步移位（myRTC_SynchroShiftConfig）后 SSR 可能大于 PREDIV_S，此时时刻属于上一秒，这里按借位处理。
+  *  - 12 小时制下 12 AM 为 0 点、12 PM 为 12 点。
+  */
+static uint32_t RTC_ReadEpoch(uint32_t* SubTicks, uint32_t* Ticks)
+{
+    uint32_t ssr = 0;
+    uint32_t tr = 0;
+    uint32_t dr = 0;
+    uint32_t prediv = 0;
+    uint32_t hours = 0;
+    uint32_t minutes = 0;
+    uint32_t seconds = 0;
+    uint32_t borrow = 0;
+    uint32_t days = 0;
+
+    RTC_ReadCalendar(&ssr, &tr, &dr);
+    prediv = RTC->PRER & RTC_PRER_PREDIV_S;
+    hours = ((tr >> 20) & 0x3) * 10 + ((tr >> 16) & 0xF);
+    minutes = ((tr >> 12) & 0x7) * 10 + ((tr >> 8) & 0xF);
+    seconds = ((tr >> 4) & 0x7) * 10 + (tr & 0xF);
+    borrow = (ssr > prediv);
+    days = RTC_DaysFromCivil(((dr >> 20) & 0xF) * 10 + ((dr >> 16) & 0xF),
+                             ((dr >> 12) & 0x1) * 10 + ((dr >> 8) & 0xF),
+                             ((dr >> 4) & 0x3) * 10 + (dr & 0xF));
+
+    /* 12 小时制：12 -> 0，PM 加 12；24 小时制下 PM 位恒为 0 */
+    hours = (RTC->CR & RTC_CR_FMT) ? (hours % 12) + ((tr & RTC_TR_PM) ? 12 : 0) : hours;
+
+    *Ticks = prediv + 1;
+    *SubTicks = prediv - ssr + (borrow ? prediv + 1 : 0);
+
+    return days * 86400 + hours * 3600 + minutes * 60 + seconds - borrow;
+}
+
+/**
+  * @brief  读取当前 Unix 时间戳（毫秒）。
+  * @param  None
+  * @retval 自 1970-01-01 00:00:00 起的毫秒数
+  * @note   一次读取 SSR、TR、DR，结果前后一致，可以替代
+  *         myRTC_GetSubSecond() + myRTC_GetTime() + myRTC_GetDate() 三次调用。
+  *         分辨率为 1/(PREDIV_S+1) 秒，LSE 配 PREDIV_S = 255 时约 3.9ms。
+  *         只用到 32 位除法（Cortex-M4 的 UDIV），适合给每条日志打时间戳。
+  *
+  * @example
+  *         uint64_t t = myRTC_GetEpochMs();
+  *         Log_Write(t, "boot");
+  */
+uint64_t myRTC_GetEpochMs(void)
+{
+    uint32_t sub = 0;
+    uint32_t ticks = 0;
+    uint32_t sec = RTC_ReadEpoch(&sub, &ticks);
+
+    /* sub < ticks <= 32768，sub*1000 不会溢出 32 位 */
+    return (uint64_t)sec * 1000 + (sub * 1000) / ticks;
+}
+
+/**
+  * @brief  读取当前 Unix 时间戳（微秒）。
+  * @param  None
+  * @retval 自 1970-01-01 00:00:00 起的微秒数
+  * @note   与 myRTC_GetEpochMs() 读取方式相同，只是子秒换算到微秒。
+  *         sub*1000000 可能超过 32 位，拆成两次 32 位除法：先算毫秒，再用余数算微秒，
+  *         避免调用 64 位除法库函数。
+  */
+uint64_t myRTC_GetEpochUs(void)
+{
+    uint32_t sub = 0;
+    uint32_t ticks = 0;
+    uint32_t sec = RTC_ReadEpoch(&sub, &ticks);
+    uint32_t ms = (sub * 1000) / ticks;
+    uint32_t us = (((sub * 1000) % ticks) * 1000) / ticks;
+
+    return (uint64_t)sec * 1000000 + ms * 1000 + us;
+}
+
+/**
+  * @brief  把 Unix 秒换算为 RTC 日期和时间（二进制格式、24 小时制）。
+  * @param  Epoch: 自 1970-01-01 00:00:00 起的秒数，须在 2000-01-01 ~ 2099-12-31 之间
+  * @param  RTC_DateStruct: 输出日期，RTC_Year 为 0~99，星期按 RTC_Weekday_x 编码
+  * @param  RTC_TimeStruct: 输出时间，RTC_H12 固定为 RTC_H12_AM
+  * @retval None
+  * @note   RTC_DaysFromCivil() 的逆运算，同样以 3 月为一年之始，没有循环。
+  *         结果可以直接交给 myRTC_SetDate/myRTC_SetTime(RTC_Format_BIN, ...)，
+  *         或用来填写闹钟的日期和时间字段。
+  */
+void myRTC_EpochToDateTime(uint32_t Epoch, RTC_DateTypeDef* RTC_DateStruct, RTC_TimeTypeDef* RTC_TimeStruct)
+{
+    uint32_t days = Epoch / 86400;
+    uint32_t rem = Epoch % 86400;
+    uint32_t z = days + 719468;                       /* 自 0000-03-01 起的天数 */
+    uint32_t era = z / 146097;                        /* 400 年周期序号：2000 年 1、2 月为 4，其余为 5 */
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t month = mp + 3 - 12 * (mp >= 10);
+
+    RTC_DateStruct->RTC_Year = (uint8_t)(era * 400 + yoe + (month <= 2) - 2000);
+    RTC_DateStruct->RTC_Month = (uint8_t)month;
+    RTC_DateStruct->RTC_Date = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    RTC_DateStruct->RTC_WeekDay = (uint8_t)((days + 3) % 7 + 1);   /* 1970-01-01 为星期四 */
+
+    RTC_TimeStruct->RTC_Hours = (uint8_t)(rem / 3600);
+    RTC_TimeStruct->RTC_Minutes = (uint8_t)(rem / 60 % 60);
+    RTC_TimeStruct->RTC_Seconds = (uint8_t)(rem % 60);
+    RTC_TimeStruct->RTC_H12 = RTC_H12_AM;
+}
+
+/**
+  * @brief  把 RTC 日期和时间（二进制格式、24 小时制）换算为 Unix 秒。
+  * @param  RTC_DateStruct: 日期，RTC_Year 为 0~99 表示 2000~2099，RTC_WeekDay 不参与计算
+  * @param  RTC_TimeStruct: 时间，RTC_Hours 为 0~23
+  * @retval 自 1970-01-01 00:00:00 起的秒数
+  */
+uint32_t myRTC_DateTimeToEpoch(RTC_DateTypeDef* RTC_DateStruct, RTC_TimeTypeDef* RTC_TimeStruct)
+{
+    uint32_t days = RTC_DaysFromCivil(RTC_DateStruct->RTC_Year, RTC_DateStruct->RTC_Month, RTC_DateStruct->RTC_Date);
+
+    return days * 86400 + RTC_TimeStruct->RTC_Hours * 3600 + RTC_TimeStruct->RTC_Minutes * 60 + RTC_TimeStruct->RTC_Seconds;
 }
 
 /**
@@ -901,24 +1294,20 @@ void myRTC_GetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct)
 
 
 /**
-  * @brief  设置指定的 RTC 闹钟（闹钟 A 或 B）。
-  * @note   闹钟寄存器只能在对应闹钟被禁用时写入（使用 RTC_AlarmCmd(DISABLE) 禁用）。
+  * @brief  把闹钟结构体转换为 RTC_ALRMxR 寄存器映像。
   * @param  RTC_Format: 指定传入时间参数的格式，可选值：
   *            @arg RTC_Format_BIN: 二进制格式
   *            @arg RTC_Format_BCD: BCD 格式
-  * @param  RTC_Alarm: 指定要配置的闹钟，可选值：
-  *            @arg RTC_Alarm_A: 闹钟 A
-  *            @arg RTC_Alarm_B: 闹钟 B
-  * @param  RTC_AlarmStruct: 指向 RTC_AlarmTypeDef 结构体的指针，包含闹钟的时间和日期配置参数
-  * @retval None
+  * @param  RTC_AlarmStruct: 指向 RTC_AlarmTypeDef 结构体的指针
+  * @retval RTC_ALRMxR 寄存器值（BCD，含掩码和日期/星期选择）
+  * @note   只做参数检查和格式转换，不访问闹钟寄存器；RTC_SetAlarm() 和异步设置共用。
   */
-void RTC_SetAlarm(uint32_t RTC_Format, uint32_t RTC_Alarm, RTC_AlarmTypeDef* RTC_AlarmStruct)
+uint32_t myRTC_PackAlarm(uint32_t RTC_Format, RTC_AlarmTypeDef* RTC_AlarmStruct)
 {
     uint32_t tmpreg = 0;
 
     /* 参数检查 */
     assert_param(IS_RTC_FORMAT(RTC_Format));
-    assert_param(IS_RTC_ALARM(RTC_Alarm));
     assert_param(IS_ALARM_MASK(RTC_AlarmStruct->RTC_AlarmMask));
     assert_param(IS_RTC_ALARM_DATE_WEEKDAY_SEL(RTC_AlarmStruct->RTC_AlarmDateWeekDaySel));
 
@@ -980,14 +1369,39 @@ void RTC_SetAlarm(uint32_t RTC_Format, uint32_t RTC_Alarm, RTC_AlarmTypeDef* RTC
          (uint32_t)RTC_AlarmStruct->RTC_AlarmDateWeekDaySel |
          (uint32_t)RTC_AlarmStruct->RTC_AlarmMask)
         :
-        ((uint32_t)RTC_ByteToBcd2(RTC_AlarmStruct->RTC_AlarmTime.RTC_Hours) << 16 |
-         (uint32_t)RTC_ByteToBcd2(RTC_AlarmStruct->RTC_AlarmTime.RTC_Minutes) << 8 |
-         (uint32_t)RTC_ByteToBcd2(RTC_AlarmStruct->RTC_AlarmTime.RTC_Seconds) |
+        (RTC_Bin4ToBcd4((uint32_t)RTC_AlarmStruct->RTC_AlarmDateWeekDay << 24 |
+                        (uint32_t)RTC_AlarmStruct->RTC_AlarmTime.RTC_Hours << 16 |
+                        (uint32_t)RTC_AlarmStruct->RTC_AlarmTime.RTC_Minutes << 8 |
+                        (uint32_t)RTC_AlarmStruct->RTC_AlarmTime.RTC_Seconds) |
          (uint32_t)RTC_AlarmStruct->RTC_AlarmTime.RTC_H12 << 16 |
-         (uint32_t)RTC_ByteToBcd2(RTC_AlarmStruct->RTC_AlarmDateWeekDay) << 24 |
          (uint32_t)RTC_AlarmStruct->RTC_AlarmDateWeekDaySel |
          (uint32_t)RTC_AlarmStruct->RTC_AlarmMask);
 
+    return tmpreg;
+}
+
+/**
+  * @brief  设置指定的 RTC 闹钟（闹钟 A 或 B）。
+  * @note   闹钟寄存器只能在对应闹钟被禁用时写入（使用 RTC_AlarmCmd(DISABLE) 禁用）。
+  * @param  RTC_Format: 指定传入时间参数的格式，可选值：
+  *            @arg RTC_Format_BIN: 二进制格式
+  *            @arg RTC_Format_BCD: BCD 格式
+  * @param  RTC_Alarm: 指定要配置的闹钟，可选值：
+  *            @arg RTC_Alarm_A: 闹钟 A
+  *            @arg RTC_Alarm_B: 闹钟 B
+  * @param  RTC_AlarmStruct: 指向 RTC_AlarmTypeDef 结构体的指针，包含闹钟的时间和日期配置参数
+  * @retval None
+  */
+void RTC_SetAlarm(uint32_t RTC_Format, uint32_t RTC_Alarm, RTC_AlarmTypeDef* RTC_AlarmStruct)
+{
+    uint32_t tmpreg = 0;
+
+    /* 参数检查 */
+    assert_param(IS_RTC_ALARM(RTC_Alarm));
+
+    /* 构造闹钟寄存器值 */
+    tmpreg = myRTC_PackAlarm(RTC_Format, RTC_AlarmStruct);
+
     /* 禁用 RTC 寄存器写保护 */
     RTC->WPR = 0xCA;
     RTC->WPR = 0x53;
@@ -1047,24 +1461,20 @@ void myRTC_GetAlarm(uint32_t RTC_Format, uint32_t RTC_Alarm, RTC_AlarmTypeDef* R
     /* 读取指定闹钟寄存器 */
     tmpreg = (RTC_Alarm == RTC_Alarm_A) ? RTC->ALRMAR : RTC->ALRMBR;
 
-    /* 解析寄存器值填充结构体 */
-    RTC_AlarmStruct->RTC_AlarmTime.RTC_Hours = (tmpreg & (RTC_ALRMAR_HT | RTC_ALRMAR_HU)) >> 16;
-    RTC_AlarmStruct->RTC_AlarmTime.RTC_Minutes = (tmpreg & (RTC_ALRMAR_MNT | RTC_ALRMAR_MNU)) >> 8;
-    RTC_AlarmStruct->RTC_AlarmTime.RTC_Seconds = tmpreg & (RTC_ALRMAR_ST | RTC_ALRMAR_SU);
+    /* 解析寄存器值填充结构体：非数字位（掩码、星期选择、PM）先取出 */
     RTC_AlarmStruct->RTC_AlarmTime.RTC_H12 = (tmpreg & RTC_ALRMAR_PM) >> 16;
-
-    RTC_AlarmStruct->RTC_AlarmDateWeekDay = (tmpreg & (RTC_ALRMAR_DT | RTC_ALRMAR_DU)) >> 24;
     RTC_AlarmStruct->RTC_AlarmDateWeekDaySel = tmpreg & RTC_ALRMAR_WDSEL;
     RTC_AlarmStruct->RTC_AlarmMask = tmpreg & RTC_AlarmMask_All;
 
-    /* 如果格式为二进制，则将 BCD 转为二进制 */
-    if (RTC_Format == RTC_Format_BIN)
-    {
-        RTC_AlarmStruct->RTC_AlarmTime.RTC_Hours = RTC_Bcd2ToByte(RTC_AlarmStruct->RTC_AlarmTime.RTC_Hours);
-        RTC_AlarmStruct->RTC_AlarmTime.RTC_Minutes = RTC_Bcd2ToByte(RTC_AlarmStruct->RTC_AlarmTime.RTC_Minutes);
-        RTC_AlarmStruct->RTC_AlarmTime.RTC_Seconds = RTC_Bcd2ToByte(RTC_AlarmStruct->RTC_AlarmTime.RTC_Seconds);
-        RTC_AlarmStruct->RTC_AlarmDateWeekDay = RTC_Bcd2ToByte(RTC_AlarmStruct->RTC_AlarmDateWeekDay);
-    }
+    /* 日期、时、分、秒四个字段整字转换 */
+    tmpreg &= (RTC_ALRMAR_DT | RTC_ALRMAR_DU | RTC_ALRMAR_HT | RTC_ALRMAR_HU |
+               RTC_ALRMAR_MNT | RTC_ALRMAR_MNU | RTC_ALRMAR_ST | RTC_ALRMAR_SU);
+    tmpreg = (RTC_Format == RTC_Format_BIN) ? RTC_Bcd4ToBin4(tmpreg) : tmpreg;
+
+    RTC_AlarmStruct->RTC_AlarmDateWeekDay = (uint8_t)(tmpreg >> 24);
+    RTC_AlarmStruct->RTC_AlarmTime.RTC_Hours = (uint8_t)(tmpreg >> 16);
+    RTC_AlarmStruct->RTC_AlarmTime.RTC_Minutes = (uint8_t)(tmpreg >> 8);
+    RTC_AlarmStruct->RTC_AlarmTime.RTC_Seconds = (uint8_t)tmpreg;
 }
 
 
@@ -1709,29 +2119,28 @@ void myRTC_GetTimeStamp(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_StampTimeStruc
   tmptime = RTC->TSTR & RTC_TR_RESERVED_MASK;
   tmpdate = RTC->TSDR & RTC_DR_RESERVED_MASK;
 
-  /* 填充时间结构体 */
-  RTC_StampTimeStruct->RTC_Hours   = (uint8_t)((tmptime & (RTC_TR_HT | RTC_TR_HU)) >> 16);
-  RTC_StampTimeStruct->RTC_Minutes = (uint8_t)((tmptime & (RTC_TR_MNT | RTC_TR_MNU)) >> 8);
-  RTC_StampTimeStruct->RTC_Seconds = (uint8_t)(tmptime & (RTC_TR_ST | RTC_TR_SU));
-  RTC_StampTimeStruct->RTC_H12     = (uint8_t)((tmptime & RTC_TR_PM) >> 16);  
-
-  /* 填充日期结构体 */
-  RTC_StampDateStruct->RTC_Year    = 0;
-  RTC_StampDateStruct->RTC_Month   = (uint8_t)((tmpdate & (RTC_DR_MT | RTC_DR_MU)) >> 8);
-  RTC_StampDateStruct->RTC_Date    = (uint8_t)(tmpdate & (RTC_DR_DT | RTC_DR_DU));
+  /* 非数字位（PM、星期）先取出，星期 1~7 两种格式相同 */
+  RTC_StampTimeStruct->RTC_H12     = (uint8_t)((tmptime & RTC_TR_PM) >> 16);
   RTC_StampDateStruct->RTC_WeekDay = (uint8_t)((tmpdate & RTC_DR_WDU) >> 13);
 
-  /* 根据格式将BCD转换为二进制 */
+  /* 时间、日期各一次整字转换 */
+  tmptime &= ~RTC_TR_PM;
+  tmpdate &= (RTC_DR_MT | RTC_DR_MU | RTC_DR_DT | RTC_DR_DU);
   if (RTC_Format == RTC_Format_BIN)
   {
-    RTC_StampTimeStruct->RTC_Hours   = (uint8_t)RTC_Bcd2ToByte(RTC_StampTimeStruct->RTC_Hours);
-    RTC_StampTimeStruct->RTC_Minutes = (uint8_t)RTC_Bcd2ToByte(RTC_StampTimeStruct->RTC_Minutes);
-    RTC_StampTimeStruct->RTC_Seconds = (uint8_t)RTC_Bcd2ToByte(RTC_StampTimeStruct->RTC_Seconds);
-
-    RTC_StampDateStruct->RTC_Month   = (uint8_t)RTC_Bcd2ToByte(RTC_StampDateStruct->RTC_Month);
-    RTC_StampDateStruct->RTC_Date    = (uint8_t)RTC_Bcd2ToByte(RTC_StampDateStruct->RTC_Date);
-    RTC_StampDateStruct->RTC_WeekDay = (uint8_t)RTC_Bcd2ToByte(RTC_StampDateStruct->RTC_WeekDay);
+    tmptime = RTC_Bcd4ToBin4(tmptime);
+    tmpdate = RTC_Bcd4ToBin4(tmpdate);
   }
+
+  /* 填充时间结构体 */
+  RTC_StampTimeStruct->RTC_Hours   = (uint8_t)(tmptime >> 16);
+  RTC_StampTimeStruct->RTC_Minutes = (uint8_t)(tmptime >> 8);
+  RTC_StampTimeStruct->RTC_Seconds = (uint8_t)tmptime;
+
+  /* 填充日期结构体（时间戳寄存器不含年份） */
+  RTC_StampDateStruct->RTC_Year    = 0;
+  RTC_StampDateStruct->RTC_Month   = (uint8_t)(tmpdate >> 8);
+  RTC_StampDateStruct->RTC_Date    = (uint8_t)tmpdate;
 }
 
 /**
@@ -2232,16 +2641,6 @@ void myRTC_ClearITPendingBit(uint32_t RTC_IT)
     RTC->ISR = (~((tmpmask | RTC_ISR_INIT) & 0xFFFF)) | (RTC->ISR & RTC_ISR_INIT);
 }
 
-/**
-  * @brief  将 2 位十进制数转换为 BCD 格式。
-  * @param  Value: 待转换的字节值 (0~99)
-  * @retval 转换后的 BCD 值
-  */
-static uint8_t RTC_ByteToBcd2(uint8_t Value)
-{
-    return ((Value / 10) << 4) | (Value % 10);
-}
-
 /**
   * @brief  将 2 位 BCD 值转换为二进制。
   * @param  Value: 待转换的 BCD 值
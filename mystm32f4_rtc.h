@@ -9,13 +9,23 @@ ErrorStatus myRTC_EnterInitMode(void);                         // 进入 RTC 初
 void myRTC_ExitInitMode(void);                                 // 退出 RTC 初始化模式
 ErrorStatus myRTC_WaitForSynchro(void);                        // 等待 RTC 寄存器同步
 ErrorStatus myRTC_RefClockCmd(FunctionalState NewState);       // 启用或禁用参考时钟检测
+void myRTC_BypassShadowCmd(FunctionalState NewState);          // 启用或禁用影子寄存器旁路（快速读取）
+uint32_t myRTC_PackTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct); // 时间转换为 RTC_TR 寄存器值
 ErrorStatus myRTC_SetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct); // 设置 RTC 时间
 void myRTC_TimeStructInit(RTC_TimeTypeDef* RTC_TimeStruct);   // 初始化 RTC_TimeTypeDef 结构体
 void myRTC_GetTime(uint32_t RTC_Format, RTC_TimeTypeDef* RTC_TimeStruct);       // 获取 RTC 时间
 uint32_t myRTC_GetSubSecond(void);                             // 获取 RTC 秒下分数
+uint8_t myRTC_FormatIso8601(char* Buf, uint32_t TR, uint32_t DR, int32_t Ms); // TR/DR 映像格式化为 ISO-8601 字符串
+uint8_t myRTC_GetIso8601(char* Buf);                           // 当前日历格式化为 ISO-8601（含毫秒）
+uint32_t myRTC_PackDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct); // 日期转换为 RTC_DR 寄存器值
 ErrorStatus myRTC_SetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct); // 设置 RTC 日期
 void myRTC_DateStructInit(RTC_DateTypeDef* RTC_DateStruct);   // 初始化 RTC_DateTypeDef 结构体
 void myRTC_GetDate(uint32_t RTC_Format, RTC_DateTypeDef* RTC_DateStruct);       // 获取 RTC 日期
+uint64_t myRTC_GetEpochMs(void);                               // 一次读取日历，返回 Unix 毫秒时间戳
+uint64_t myRTC_GetEpochUs(void);                               // 一次读取日历，返回 Unix 微秒时间戳
+void myRTC_EpochToDateTime(uint32_t Epoch, RTC_DateTypeDef* RTC_DateStruct, RTC_TimeTypeDef* RTC_TimeStruct); // Unix 秒换算为日期时间
+uint32_t myRTC_DateTimeToEpoch(RTC_DateTypeDef* RTC_DateStruct, RTC_TimeTypeDef* RTC_TimeStruct); // 日期时间换算为 Unix 秒
+uint32_t myRTC_PackAlarm(uint32_t RTC_Format, RTC_AlarmTypeDef* RTC_AlarmStruct); // 闹钟转换为 RTC_ALRMxR 寄存器值
 void myRTC_AlarmStructInit(RTC_AlarmTypeDef* RTC_AlarmStruct);// 初始化 RTC_AlarmTypeDef 结构体
 void myRTC_GetAlarm(uint32_t RTC_Format, uint32_t RTC_Alarm, RTC_AlarmTypeDef* RTC_AlarmStruct); // 获取闹钟设置
 ErrorStatus myRTC_AlarmCmd(uint32_t RTC_Alarm, FunctionalState NewState);       // 启用或禁用闹钟
@@ -57,4 +67,4 @@ void myRTC_ClearITPendingBit(uint32_t RTC_IT);                   // 清除 RTC 
 
 				
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,409 @@
+/**
+  ******************************************************************************
+  * @file     mystm32f4_rtc_alarm.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    基于 RTC Alarm A/B 的软件闹钟复用服务
+  *
+  * @attention
+  *
+  * 硬件只有两个闹钟，本文件在其上复用任意数量的日历闹钟和相对闹钟：
+  *
+  * - 每个闹钟是调用者分配的节点，到期时刻统一用 Unix 毫秒表示（与 myRTC_GetEpochMs() 同一时基）。
+  * - 两条按到期时间升序的链表：普通队列编程到 Alarm A，紧急队列编程到 Alarm B。
+  *   节点类别的位在 UrgentClasses 中即为紧急，紧急闹钟不会被大量普通闹钟的重新编程打扰，
+  *   也可以单独用 Alarm B 驱动 RTC_AF1 输出。
+  * - 硬件闹钟只编程队头：日期 + 时 + 分 + 秒全部比较，亚秒 MASKSS = 15 比较 SS[14:0]，
+  *   精度为一个同步预分频计数（LSE、PREDIV_S = 255 时约 3.9ms）。亚秒向上取整，保证不会提前到期。
+  * - 记录每个硬件闹钟当前编程的时刻，队头没有变化时不重新编程
+  *   （关闭闹钟要等 ALRxWF，最多约 2 个 RTCCLK 周期）。
+  * - 距离不足 RTC_ALARM_GUARD_TICKS 的时刻来不及由硬件匹配，改为 myEXTI_GenerateSWInterrupt()
+  *   软件触发 EXTI17，回调始终在 RTC_Alarm 中断中执行。
+  *
+  * 限制：
+  * - 闹钟日期字段只有“日”，超过一个月的时刻可能在较早月份的同一天提前触发一次中断，
+  *   中断中核对时间后不执行回调，硬件闹钟保持不变，直到真正到期。
+  * - 运行期间不要修改日历（myRTC_SetTime/SetDate/SynchroShiftConfig），否则应重新启动各闹钟。
+  * - 编程硬件闹钟期间关中断，最长约 2 个 RTCCLK 周期（约 60us）。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) RTC 时钟与日历已初始化（myRTC_Init、myRTC_SetTime、myRTC_SetDate），日历按 UTC 设置。
+
+(#) 初始化服务，类别 1 为紧急：
+    myRTC_AlarmServiceInit(1U << 1);
+
+(#) 在 NVIC 中使能 RTC_Alarm_IRQn，并在中断中调用：
+    void RTC_Alarm_IRQHandler(void)
+    {
+        myRTC_AlarmServiceIRQHandler();
+    }
+
+(#) 定义并启动闹钟：
+    static RTC_AlarmNodeTypeDef logger;
+    myRTC_AlarmNodeInit(&logger, LoggerSample, NULL, RTC_ALARM_CLASS_NORMAL);
+    myRTC_AlarmStartIn(&logger, 60000, 60000);     // 1 分钟后首次到期，之后每分钟一次
+
+(#) 主循环里没有事情时直接进入 Stop 模式，闹钟到期由 EXTI17 唤醒。
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_rtc_alarm.h"
+#include "mystm32f4_exti.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ALARM_NONE            ((uint64_t)0xFFFFFFFFFFFFFFFF)   /* 队列为空 / 硬件闹钟未编程 */
+#define ALARM_HW_A            0
+#define ALARM_HW_B            1
+#define ALARM_MASKSS_ALL      ((uint32_t)0x0F000000)           /* MASKSS = 15：比较 SS[14:0] */
+
+/* Private variables ---------------------------------------------------------*/
+static RTC_AlarmNodeTypeDef* s_queue[2] = { NULL, NULL };     /* 两条有序队列：A 普通，B 紧急 */
+static uint64_t s_programmed[2] = { ALARM_NONE, ALARM_NONE }; /* 硬件闹钟当前编程的时刻 */
+static uint32_t s_urgent = 0;                                 /* 紧急类别位图 */
+static uint8_t s_inHandler = 0;                               /* 中断处理中，推迟重新编程 */
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Alarm_Hw(const RTC_AlarmNodeTypeDef* Node);
+static void Alarm_Link(RTC_AlarmNodeTypeDef* Node);
+static void Alarm_Unlink(RTC_AlarmNodeTypeDef* Node);
+static void Alarm_Program(uint8_t Hw);
+
+
+/**
+  * @brief  节点所属的硬件闹钟。
+  */
+static uint8_t Alarm_Hw(const RTC_AlarmNodeTypeDef* Node)
+{
+    return ((s_urgent >> Node->Class) & 1) ? ALARM_HW_B : ALARM_HW_A;
+}
+
+/**
+  * @brief  按到期时间有序插入，相同时刻按插入先后排列。
+  */
+static void Alarm_Link(RTC_AlarmNodeTypeDef* Node)
+{
+    RTC_AlarmNodeTypeDef** pp = &s_queue[Alarm_Hw(Node)];
+
+    while (*pp != NULL && (*pp)->Deadline <= Node->Deadline)
+    {
+        pp = &(*pp)->Next;
+    }
+    Node->Next = *pp;
+    *pp = Node;
+    Node->Queued = 1;
+}
+
+/**
+  * @brief  从所在队列摘除。
+  */
+static void Alarm_Unlink(RTC_AlarmNodeTypeDef* Node)
+{
+    RTC_AlarmNodeTypeDef** pp = &s_queue[Alarm_Hw(Node)];
+
+    while (*pp != NULL && *pp != Node)
+    {
+        pp = &(*pp)->Next;
+    }
+    if (*pp == Node)
+    {
+        *pp = Node->Next;
+    }
+    Node->Next = NULL;
+    Node->Queued = 0;
+}
+
+/**
+  * @brief  把队头编程到对应的硬件闹钟，队头时刻未变时什么也不做。
+  * @param  Hw: ALARM_HW_A / ALARM_HW_B
+  * @note   调用者须已关中断。
+  *         时刻换算：秒 = 毫秒 / 1000，亚秒计数向上取整，SS = PREDIV_S - 亚秒计数。
+  *         编程完成后若已经来不及由硬件匹配，软件触发 EXTI17。
+  */
+static void Alarm_Program(uint8_t Hw)
+{
+    uint32_t alarm = (Hw == ALARM_HW_A) ? RTC_Alarm_A : RTC_Alarm_B;
+    uint64_t target = (s_queue[Hw] != NULL) ? s_queue[Hw]->Deadline : ALARM_NONE;
+    uint32_t ticks = (RTC->PRER & RTC_PRER_PREDIV_S) + 1;
+    uint32_t sec = 0;
+    uint32_t sub = 0;
+    uint64_t guard = 0;
+    RTC_AlarmTypeDef config;
+    RTC_DateTypeDef date;
+
+    if (target == s_programmed[Hw])
+    {
+        return;
+    }
+    s_programmed[Hw] = target;
+
+    myRTC_AlarmCmd(alarm, DISABLE);
+    if (target == ALARM_NONE)
+    {
+        return;
+    }
+
+    sec = (uint32_t)(target / 1000);
+    sub = ((uint32_t)(target % 1000) * ticks + 999) / 1000;
+    sec += (sub >= ticks) ? 1 : 0;
+    sub = (sub >= ticks) ? 0 : sub;
+
+    myRTC_EpochToDateTime(sec, &date, &config.RTC_AlarmTime);
+    if ((RTC->CR & RTC_CR_FMT) != RESET)
+    {
+        /* 12 小时制：0 点为 12 AM，12 点为 12 PM */
+        config.RTC_AlarmTime.RTC_H12 = (config.RTC_AlarmTime.RTC_Hours >= 12) ? RTC_H12_PM : RTC_H12_AM;
+        config.RTC_AlarmTime.RTC_Hours = (config.RTC_AlarmTime.RTC_Hours % 12 == 0) ? 12 : config.RTC_AlarmTime.RTC_Hours % 12;
+    }
+    config.RTC_AlarmDateWeekDaySel = RTC_AlarmDateWeekDaySel_Date;
+    config.RTC_AlarmDateWeekDay = date.RTC_Date;
+    config.RTC_AlarmMask = RTC_AlarmMask_None;
+
+    RTC_SetAlarm(RTC_Format_BIN, alarm, &config);
+    myRTC_AlarmSubSecondConfig(alarm, (ticks - 1) - sub, ALARM_MASKSS_ALL);
+    myRTC_ClearFlag((Hw == ALARM_HW_A) ? RTC_FLAG_ALRAF : RTC_FLAG_ALRBF);
+    myRTC_AlarmCmd(alarm, ENABLE);
+
+    /* 编程期间时间已经走过或距离太近，硬件匹配不到，改为软件触发 */
+    guard = ((uint64_t)RTC_ALARM_GUARD_TICKS * 1000 + ticks - 1) / ticks;
+    if (myRTC_GetEpochMs() + guard >= target)
+    {
+        myEXTI_GenerateSWInterrupt(EXTI_Line17);
+    }
+}
+
+/**
+  * @brief  初始化闹钟服务。
+  * @param  UrgentClasses: 紧急类别位图，位 n 置 1 表示类别 n 的闹钟走 Alarm B；0 表示全部走 Alarm A。
+  * @retval SUCCESS: 初始化完成；ERROR: 关闭硬件闹钟超时（RTC 时钟未运行）。
+  *
+  * @note
+  *  - 关闭并接管 Alarm A/B，使能其中断，把 EXTI17 配置为上升沿中断以便从 Stop 模式唤醒。
+  *  - 清空两条队列；之前挂入的节点视为未启动。
+  *  - 用户需在 NVIC 中使能 RTC_Alarm_IRQn。
+  *  - 小白理解：硬件只有两个闹钟，服务始终把“最早要响的那个”设进去，响了再设下一个。
+  */
+ErrorStatus myRTC_AlarmServiceInit(uint32_t UrgentClasses)
+{
+    EXTI_InitTypeDef exti;
+    ErrorStatus status = SUCCESS;
+
+    status = (myRTC_AlarmCmd(RTC_Alarm_A, DISABLE) == SUCCESS &&
+              myRTC_AlarmCmd(RTC_Alarm_B, DISABLE) == SUCCESS) ? SUCCESS : ERROR;
+
+    s_queue[ALARM_HW_A] = NULL;
+    s_queue[ALARM_HW_B] = NULL;
+    s_programmed[ALARM_HW_A] = ALARM_NONE;
+    s_programmed[ALARM_HW_B] = ALARM_NONE;
+    s_urgent = UrgentClasses;
+    s_inHandler = 0;
+
+    /* RTC 闹钟通过 EXTI17 进入 RTC_Alarm_IRQn */
+    myEXTI_ClearITPendingBit(EXTI_Line17);
+    exti.EXTI_Line = EXTI_Line17;
+    exti.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti.EXTI_Trigger = EXTI_Trigger_Rising;
+    exti.EXTI_LineCmd = ENABLE;
+    myEXTI_Init(&exti);
+
+    myRTC_ClearFlag(RTC_FLAG_ALRAF | RTC_FLAG_ALRBF);
+    myRTC_ITConfig(RTC_IT_ALRA | RTC_IT_ALRB, ENABLE);
+
+    return status;
+}
+
+/**
+  * @brief  初始化闹钟节点。
+  * @param  Node: 闹钟节点。
+  * @param  Callback: 到期回调，在 RTC_Alarm 中断上下文执行，应尽量短。
+  * @param  Arg: 回调参数。
+  * @param  Class: 类别 0~31，决定走 Alarm A 还是 Alarm B。
+  * @retval None
+  */
+void myRTC_AlarmNodeInit(RTC_AlarmNodeTypeDef* Node, RTC_AlarmCallback Callback, void* Arg, uint8_t Class)
+{
+    /* 参数检查 */
+    assert_param(Class < 32);
+
+    Node->Next = NULL;
+    Node->Deadline = 0;
+    Node->Period = 0;
+    Node->Callback = Callback;
+    Node->Arg = Arg;
+    Node->Class = Class & 0x1F;
+    Node->Queued = 0;
+}
+
+/**
+  * @brief  以日历时刻启动（或重启）闹钟。
+  * @param  Node: 已初始化的闹钟节点，若已在队列中则先取消再重新插入。
+  * @param  EpochMs: 到期时刻，Unix 毫秒，可用 myRTC_DateTimeToEpoch() * 1000 得到。
+  *         已经过去的时刻会立即（在中断中）到期。
+  * @param  Period: 周期（毫秒），0 表示单次。周期闹钟按 Deadline += Period 推进，不累积误差。
+  * @retval None
+  * @note   可在线程、中断及闹钟回调中调用；在回调中调用时重新编程推迟到回调全部执行完。
+  */
+void myRTC_AlarmStartAt(RTC_AlarmNodeTypeDef* Node, uint64_t EpochMs, uint32_t Period)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t hw = Alarm_Hw(Node);
+
+    __disable_irq();
+    if (Node->Queued)
+    {
+        Alarm_Unlink(Node);
+    }
+    Node->Deadline = EpochMs;
+    Node->Period = Period;
+    Alarm_Link(Node);
+    if (!s_inHandler)
+    {
+        Alarm_Program(hw);
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  以相对时间启动（或重启）闹钟。
+  * @param  Node: 已初始化的闹钟节点。
+  * @param  DelayMs: 距离现在的毫秒数。
+  * @param  Period: 周期（毫秒），0 表示单次。
+  * @retval None
+  */
+void myRTC_AlarmStartIn(RTC_AlarmNodeTypeDef* Node, uint32_t DelayMs, uint32_t Period)
+{
+    myRTC_AlarmStartAt(Node, myRTC_GetEpochMs() + DelayMs, Period);
+}
+
+/**
+  * @brief  取消闹钟。
+  * @param  Node: 闹钟节点，不在队列中时什么也不做。
+  * @retval None
+  * @note   取消的是队头时才会重新编程硬件闹钟。
+  */
+void myRTC_AlarmStop(RTC_AlarmNodeTypeDef* Node)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t hw = Alarm_Hw(Node);
+
+    __disable_irq();
+    if (Node->Queued)
+    {
+        Alarm_Unlink(Node);
+        if (!s_inHandler)
+        {
+            Alarm_Program(hw);
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  闹钟是否在队列中。
+  * @param  Node: 闹钟节点。
+  * @retval 1：在队列中；0：未启动或已到期的单次闹钟。
+  */
+uint8_t myRTC_AlarmIsActive(const RTC_AlarmNodeTypeDef* Node)
+{
+    return Node->Queued;
+}
+
+/**
+  * @brief  最近的到期时刻。
+  * @param  None
+  * @retval Unix 毫秒；两条队列都为空时返回 0xFFFFFFFFFFFFFFFF。
+  * @note   可用来决定进入哪一级低功耗模式。
+  */
+uint64_t myRTC_AlarmNextDeadline(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint64_t a = ALARM_NONE;
+    uint64_t b = ALARM_NONE;
+
+    __disable_irq();
+    a = (s_queue[ALARM_HW_A] != NULL) ? s_queue[ALARM_HW_A]->Deadline : ALARM_NONE;
+    b = (s_queue[ALARM_HW_B] != NULL) ? s_queue[ALARM_HW_B]->Deadline : ALARM_NONE;
+    __set_PRIMASK(primask);
+
+    return (a < b) ? a : b;
+}
+
+/**
+  * @brief  闹钟中断处理，在 RTC_Alarm_IRQHandler 中调用。
+  * @param  None
+  * @retval None
+  *
+  * @note
+  *  - 清除 ALRAF/ALRBF 和 EXTI17 挂起位，读一次当前时间，依次执行两条队列中所有已到期的闹钟。
+  *  - 周期闹钟重新入队；错过多个周期（例如调试暂停）时跳到当前时间之后的第一个周期，不补发。
+  *  - 回调执行完后才重新编程硬件闹钟，每个硬件闹钟最多编程一次。
+  *  - 回调中重启的闹钟若已经到期，会在本次中断中继续执行；不要在回调里以 0 延时反复重启自身。
+  */
+void myRTC_AlarmServiceIRQHandler(void)
+{
+    uint32_t primask = 0;
+    uint64_t now = 0;
+    uint8_t hw = 0;
+    RTC_AlarmNodeTypeDef* node = NULL;
+
+    myRTC_ClearFlag(RTC_FLAG_ALRAF | RTC_FLAG_ALRBF);
+    myEXTI_ClearITPendingBit(EXTI_Line17);
+
+    s_inHandler = 1;
+    now = myRTC_GetEpochMs();
+
+    for (hw = ALARM_HW_A; hw <= ALARM_HW_B; hw++)
+    {
+        while (1)
+        {
+            primask = __get_PRIMASK();
+            __disable_irq();
+            node = s_queue[hw];
+            if (node == NULL || node->Deadline > now)
+            {
+                __set_PRIMASK(primask);
+                break;
+            }
+            Alarm_Unlink(node);
+            if (node->Period != 0)
+            {
+                node->Deadline += node->Period;
+                node->Deadline += (node->Deadline <= now) ?
+                    ((now - node->Deadline) / node->Period + 1) * node->Period : 0;
+                Alarm_Link(node);
+            }
+            __set_PRIMASK(primask);
+
+            if (node->Callback != NULL)
+            {
+                node->Callback(node->Arg);
+            }
+        }
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    s_inHandler = 0;
+    Alarm_Program(ALARM_HW_A);
+    Alarm_Program(ALARM_HW_B);
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,38 @@
+#ifndef mystm32f4_rtc_alarm_h
+#define mystm32f4_rtc_alarm_h
+
+#include "mystm32f4_rtc.h"
+
+/* 编程闹钟时要求的最小提前量（RTCCLK 同步预分频计数），不足时直接软件触发中断 */
+#ifndef RTC_ALARM_GUARD_TICKS
+#define RTC_ALARM_GUARD_TICKS       2
+#endif
+
+/* 闹钟类别 0~31；类别位在 UrgentClasses 中的闹钟走硬件 Alarm B */
+#define RTC_ALARM_CLASS_NORMAL      0
+
+typedef void (*RTC_AlarmCallback)(void* Arg);
+
+/* 软件闹钟节点，由调用者分配，在队列中期间不得释放 */
+typedef struct RTC_AlarmNode
+{
+    struct RTC_AlarmNode* Next;      /* 按到期时间升序的单向链表后继 */
+    uint64_t Deadline;               /* 到期时刻，Unix 毫秒 */
+    uint32_t Period;                 /* 周期（毫秒），0 表示单次 */
+    RTC_AlarmCallback Callback;      /* 到期回调，在 RTC_Alarm 中断上下文执行 */
+    void* Arg;                       /* 回调参数 */
+    uint8_t Class;                   /* 类别 0~31 */
+    uint8_t Queued;                  /* 1：在队列中 */
+} RTC_AlarmNodeTypeDef;
+
+ErrorStatus myRTC_AlarmServiceInit(uint32_t UrgentClasses);          // 初始化闹钟服务，指定走 Alarm B 的类别位图
+void myRTC_AlarmNodeInit(RTC_AlarmNodeTypeDef* Node,                 // 初始化闹钟节点
+    RTC_AlarmCallback Callback, void* Arg, uint8_t Class);
+void myRTC_AlarmStartAt(RTC_AlarmNodeTypeDef* Node, uint64_t EpochMs, uint32_t Period); // 日历闹钟：在指定 Unix 毫秒到期
+void myRTC_AlarmStartIn(RTC_AlarmNodeTypeDef* Node, uint32_t DelayMs, uint32_t Period); // 相对闹钟：从现在起 DelayMs 后到期
+void myRTC_AlarmStop(RTC_AlarmNodeTypeDef* Node);                    // 取消闹钟
+uint8_t myRTC_AlarmIsActive(const RTC_AlarmNodeTypeDef* Node);       // 闹钟是否在队列中
+uint64_t myRTC_AlarmNextDeadline(void);                              // 最近的到期时刻（Unix 毫秒），无闹钟返回全 1
+void myRTC_AlarmServiceIRQHandler(void);                             // 闹钟中断处理，在 RTC_Alarm_IRQHandler 中调用
+
+#endif
@@ -0,0 +1,560 @@
+/**
+  ******************************************************************************
+  * @file     mystm32f4_rtc_async.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    非阻塞的 RTC 配置状态机
+  *
+  * @attention
+  *
+  * myRTC_SetTime()/SetDate()/AlarmCmd()/WakeUpCmd()/DeInit() 都要忙等 INITF、RSF、ALRxWF、WUTWF
+  * 等标志，每个标志需要 1~2 个 RTCCLK（LSE 时约 30~61us），DeInit 和设置日历要连等两三个，
+  * 控制环路在这段时间里被整段卡住。本模块把这些操作拆成步骤，提交后立即返回：
+  *
+  * - 提交时完成参数检查和寄存器映像打包（myRTC_PackTime/PackDate/PackAlarm），
+  *   把操作挂入先进先出队列。
+  * - myRTC_AsyncPoll() 每次调用只检查当前步骤等待的标志，标志到了就执行下一步写寄存器，
+  *   没到就返回；操作完成（或超时）后调用完成回调，再开始下一个操作。
+  * - 每一步在关中断的状态下解除写保护、写寄存器、恢复写保护，步骤本身不会被其他 RTC 写操作打断。
+  *
+  * 各操作的步骤：
+  *   日历：  置 INIT → 等 INITF → 写 TR/DR、清 INIT、清 RSF → 等 RSF（BYPSHAD = 1 时省略）
+  *   闹钟：  清 ALRxE → 等 ALRxWF → 写 ALRMxR/ALRMxSSR、置 ALRxE
+  *   唤醒：  清 WUTE → 等 WUTWF → 写 WUCKSEL/WUTR、置 WUTE
+  *   复位：  置 INIT → 等 INITF → 复位 TR/DR/CR → 等 WUTWF → 复位其余寄存器 → 等 RSF
+  *
+  * 推进方式：
+  * - 这些标志都不产生中断，所以没有“由 RTC 中断推进”的可能，需要周期调用 myRTC_AsyncPoll()，
+  *   一般放在主循环里，完成时间取决于循环周期。
+  * - 每个步骤最多等待 RTC_ASYNC_MAX_POLLS 次轮询，超过则以 ERROR 完成并退出初始化模式。
+  *
+  * 限制：
+  * - 从提交到写入 TR/DR 有轮询间隔的延迟，需要精确对时请在回调中再做一次 myRTC_SynchroShiftConfig()。
+  * - 同步函数（myRTC_SetTime/SetDate、myRTC_SynchroShiftConfig、myRTC_SmoothCalibConfig 等，
+  *   以及 PPS、日志、校准模块里调用它们的处理函数）在忙等期间一直保持写保护解除。
+  *   myRTC_AsyncPoll() 若抢占了这样的调用，步骤结束时写 WPR = 0xFF 会把它重新上锁，
+  *   被抢占函数的后续写入被硬件静默丢弃。因此有操作排队期间（任一句柄 myRTC_AsyncBusy() 为 1），
+  *   不要在可能被 myRTC_AsyncPoll() 抢占的上下文中调用同步函数：
+  *   把 myRTC_AsyncPoll() 放在主循环或优先级不高于任何同步调用者的上下文中。
+  *   反方向（同步函数所在的中断抢占 myRTC_AsyncPoll()）由步骤内的关中断保证安全。
+  * - 操作执行期间不要用同步函数修改同一组寄存器（同一个闹钟、唤醒定时器或日历）。
+  * - myRTC_AsyncPoll() 不可重入：只在一个上下文中调用。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 在主循环中推进（不要放进会抢占同步 RTC 调用的中断，见“限制”）：
+    while (1)
+    {
+        myRTC_AsyncPoll();
+        ...
+    }
+
+(#) 网络对时，提交后立即返回：
+    static RTC_AsyncOpTypeDef setClock;
+    static void OnClockSet(ErrorStatus Status, void* Arg)
+    {
+        Log("RTC set %s", (Status == SUCCESS) ? "ok" : "failed");
+    }
+    myRTC_EpochToDateTime(ntpSeconds, &date, &time);
+    myRTC_AsyncSetCalendar(&setClock, RTC_Format_BIN, &time, &date, OnClockSet, NULL);
+
+(#) 修改唤醒周期（上一个操作未完成时返回 ERROR，可以先查询）：
+    if (!myRTC_AsyncBusy(&setWakeUp))
+    {
+        myRTC_AsyncSetWakeUp(&setWakeUp, RTC_WakeUpClock_CK_SPRE_16bits, 9, NULL, NULL);
+    }
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_rtc_async.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ASYNC_CALENDAR        0
+#define ASYNC_ALARM           1
+#define ASYNC_ALARM_ON        2
+#define ASYNC_ALARM_OFF       3
+#define ASYNC_WAKEUP          4
+#define ASYNC_WAKEUP_ON       5
+#define ASYNC_WAKEUP_OFF      6
+#define ASYNC_DEINIT          7
+
+/* 步骤执行结果 */
+#define ASYNC_WAIT            0             /* 等待的标志未到 */
+#define ASYNC_NEXT            1             /* 进入下一步，可以马上继续 */
+#define ASYNC_DONE            2             /* 操作完成 */
+
+#define ASYNC_TR              0x01          /* 日历操作 Value[2]：写 TR */
+#define ASYNC_DR              0x02          /* 日历操作 Value[2]：写 DR */
+
+#define ASYNC_INIT_MASK       ((uint32_t)0xFFFFFFFF)                    /* 置 INIT，其余标志写 1 不受影响 */
+#define ASYNC_RSF_MASK        ((uint32_t)~(RTC_ISR_INIT | RTC_ISR_RSF))  /* 清 RSF，保持 INIT */
+
+#define ASYNC_UNLOCK()        do { RTC->WPR = 0xCA; RTC->WPR = 0x53; } while (0)
+#define ASYNC_LOCK()          (RTC->WPR = 0xFF)
+
+/* Private variables ---------------------------------------------------------*/
+static RTC_AsyncOpTypeDef* s_head = NULL;
+static RTC_AsyncOpTypeDef* s_tail = NULL;
+
+/* Private function prototypes -----------------------------------------------*/
+static ErrorStatus Async_Submit(RTC_AsyncOpTypeDef* Op, uint8_t Type, RTC_AsyncCallback Done, void* Arg);
+static uint8_t Async_Calendar(RTC_AsyncOpTypeDef* Op);
+static uint8_t Async_Alarm(RTC_AsyncOpTypeDef* Op);
+static uint8_t Async_WakeUp(RTC_AsyncOpTypeDef* Op);
+static uint8_t Async_DeInit(RTC_AsyncOpTypeDef* Op);
+static void Async_Abort(void);
+
+
+/**
+  * @brief  挂入队列尾部；Op 尚未完成时返回 ERROR。Value[] 须在调用前填好。
+  */
+static ErrorStatus Async_Submit(RTC_AsyncOpTypeDef* Op, uint8_t Type, RTC_AsyncCallback Done, void* Arg)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (Op->Busy)
+    {
+        __set_PRIMASK(primask);
+        return ERROR;
+    }
+
+    Op->Next = NULL;
+    Op->Done = Done;
+    Op->Arg = Arg;
+    Op->Polls = 0;
+    Op->Type = Type;
+    Op->Step = 0;
+    Op->Busy = 1;
+
+    (s_tail != NULL) ? (s_tail->Next = Op) : (s_head = Op);
+    s_tail = Op;
+    __set_PRIMASK(primask);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  日历：置 INIT → 等 INITF → 写 TR/DR、退出初始化 → 等 RSF。
+  */
+static uint8_t Async_Calendar(RTC_AsyncOpTypeDef* Op)
+{
+    switch (Op->Step)
+    {
+    case 0:
+        ASYNC_UNLOCK();
+        RTC->ISR = ASYNC_INIT_MASK;
+        ASYNC_LOCK();
+        return ASYNC_NEXT;
+
+    case 1:
+        if ((RTC->ISR & RTC_ISR_INITF) == 0)
+        {
+            return ASYNC_WAIT;
+        }
+        ASYNC_UNLOCK();
+        if (Op->Value[2] & ASYNC_TR)
+        {
+            RTC->TR = Op->Value[0];
+        }
+        if (Op->Value[2] & ASYNC_DR)
+        {
+            RTC->DR = Op->Value[1];
+        }
+        RTC->ISR &= ~RTC_ISR_INIT;
+        RTC->ISR &= ASYNC_RSF_MASK;
+        ASYNC_LOCK();
+        return (RTC->CR & RTC_CR_BYPSHAD) ? ASYNC_DONE : ASYNC_NEXT;
+
+    default:
+        return (RTC->ISR & RTC_ISR_RSF) ? ASYNC_DONE : ASYNC_WAIT;
+    }
+}
+
+/**
+  * @brief  闹钟：清 ALRxE → 等 ALRxWF → 写寄存器、置 ALRxE。Value[2] 为 RTC_Alarm_A / RTC_Alarm_B。
+  */
+static uint8_t Async_Alarm(RTC_AsyncOpTypeDef* Op)
+{
+    uint32_t alarm = Op->Value[2];
+
+    if (Op->Type == ASYNC_ALARM_ON)
+    {
+        ASYNC_UNLOCK();
+        RTC->CR |= alarm;
+        ASYNC_LOCK();
+        return ASYNC_DONE;
+    }
+
+    switch (Op->Step)
+    {
+    case 0:
+        ASYNC_UNLOCK();
+        RTC->CR &= ~alarm;
+        ASYNC_LOCK();
+        return ASYNC_NEXT;
+
+    default:
+        if ((RTC->ISR & (alarm >> 8)) == 0)
+        {
+            return ASYNC_WAIT;
+        }
+        if (Op->Type == ASYNC_ALARM)
+        {
+            ASYNC_UNLOCK();
+            (alarm == RTC_Alarm_A) ? (RTC->ALRMAR = Op->Value[0], RTC->ALRMASSR = Op->Value[1])
+                                   : (RTC->ALRMBR = Op->Value[0], RTC->ALRMBSSR = Op->Value[1]);
+            RTC->CR |= alarm;
+            ASYNC_LOCK();
+        }
+        return ASYNC_DONE;
+    }
+}
+
+/**
+  * @brief  唤醒定时器：清 WUTE → 等 WUTWF → 写 WUCKSEL/WUTR、置 WUTE。
+  */
+static uint8_t Async_WakeUp(RTC_AsyncOpTypeDef* Op)
+{
+    if (Op->Type == ASYNC_WAKEUP_ON)
+    {
+        ASYNC_UNLOCK();
+        RTC->CR |= RTC_CR_WUTE;
+        ASYNC_LOCK();
+        return ASYNC_DONE;
+    }
+
+    switch (Op->Step)
+    {
+    case 0:
+        ASYNC_UNLOCK();
+        RTC->CR &= ~RTC_CR_WUTE;
+        ASYNC_LOCK();
+        return ASYNC_NEXT;
+
+    default:
+        if ((RTC->ISR & RTC_ISR_WUTWF) == 0)
+        {
+            return ASYNC_WAIT;
+        }
+        if (Op->Type == ASYNC_WAKEUP)
+        {
+            ASYNC_UNLOCK();
+            RTC->CR = (RTC->CR & ~RTC_CR_WUCKSEL) | Op->Value[0];
+            RTC->WUTR = Op->Value[1];
+            RTC->CR |= RTC_CR_WUTE;
+            ASYNC_LOCK();
+        }
+        return ASYNC_DONE;
+    }
+}
+
+/**
+  * @brief  复位：与 myRTC_DeInit() 相同的寄存器序列，每个等待点拆成一步。
+  */
+static uint8_t Async_DeInit(RTC_AsyncOpTypeDef* Op)
+{
+    switch (Op->Step)
+    {
+    case 0:
+        ASYNC_UNLOCK();
+        RTC->ISR = ASYNC_INIT_MASK;
+        ASYNC_LOCK();
+        return ASYNC_NEXT;
+
+    case 1:
+        if ((RTC->ISR & RTC_ISR_INITF) == 0)
+        {
+            return ASYNC_WAIT;
+        }
+        ASYNC_UNLOCK();
+        RTC->TR = 0x00000000;
+        RTC->DR = 0x00002101;
+        RTC->CR &= 0x00000007;
+        ASYNC_LOCK();
+        return ASYNC_NEXT;
+
+    case 2:
+        if ((RTC->ISR & RTC_ISR_WUTWF) == 0)
+        {
+            return ASYNC_WAIT;
+        }
+        ASYNC_UNLOCK();
+        RTC->CR &= 0x00000000;
+        RTC->WUTR = 0x0000FFFF;
+        RTC->PRER = 0x007F00FF;
+        RTC->CALIBR = 0x00000000;
+        RTC->ALRMAR = 0x00000000;
+        RTC->ALRMBR = 0x00000000;
+        RTC->SHIFTR = 0x00000000;
+        RTC->CALR = 0x00000000;
+        RTC->ALRMASSR = 0x00000000;
+        RTC->ALRMBSSR = 0x00000000;
+        RTC->ISR = 0x00000000;                 /* 同时退出初始化模式、清 RSF */
+        RTC->TAFCR = 0x00000000;
+        ASYNC_LOCK();
+        return ASYNC_NEXT;
+
+    default:
+        return (RTC->ISR & RTC_ISR_RSF) ? ASYNC_DONE : ASYNC_WAIT;
+    }
+}
+
+/**
+  * @brief  超时放弃当前操作：不能停留在初始化模式，否则日历一直停走。
+  */
+static void Async_Abort(void)
+{
+    ASYNC_UNLOCK();
+    RTC->ISR &= ~RTC_ISR_INIT;
+    ASYNC_LOCK();
+}
+
+/**
+  * @brief  异步设置时间和/或日期。
+  * @param  Op: 操作句柄。
+  * @param  RTC_Format: RTC_Format_BIN 或 RTC_Format_BCD。
+  * @param  RTC_TimeStruct: 时间，NULL 表示不改。
+  * @param  RTC_DateStruct: 日期，NULL 表示不改。
+  * @param  Done: 完成回调，可为 NULL。
+  * @param  Arg: 回调参数。
+  * @retval SUCCESS: 已提交；ERROR: Op 的上一次操作尚未完成。
+  *
+  * @note
+  *  - 时间和日期在同一次初始化模式中写入，不会出现“新时间、旧日期”的中间状态。
+  *  - 结构体在提交时即打包，返回后可以释放。
+  *  - 小白理解：把要做的事写在单子上交给前台就走，办好了前台打电话（回调）通知你。
+  */
+ErrorStatus myRTC_AsyncSetCalendar(RTC_AsyncOpTypeDef* Op, uint32_t RTC_Format,
+    RTC_TimeTypeDef* RTC_TimeStruct, RTC_DateTypeDef* RTC_DateStruct, RTC_AsyncCallback Done, void* Arg)
+{
+    if (Op->Busy)
+    {
+        return ERROR;
+    }
+
+    Op->Value[0] = (RTC_TimeStruct != NULL) ? myRTC_PackTime(RTC_Format, RTC_TimeStruct) : 0;
+    Op->Value[1] = (RTC_DateStruct != NULL) ? myRTC_PackDate(RTC_Format, RTC_DateStruct) : 0;
+    Op->Value[2] = ((RTC_TimeStruct != NULL) ? ASYNC_TR : 0) | ((RTC_DateStruct != NULL) ? ASYNC_DR : 0);
+
+    return Async_Submit(Op, ASYNC_CALENDAR, Done, Arg);
+}
+
+/**
+  * @brief  异步设置闹钟（含亚秒）并使能。
+  * @param  Op: 操作句柄。
+  * @param  RTC_Alarm: RTC_Alarm_A 或 RTC_Alarm_B。
+  * @param  RTC_Format: RTC_Format_BIN 或 RTC_Format_BCD。
+  * @param  RTC_AlarmStruct: 闹钟时间和掩码。
+  * @param  RTC_AlarmSubSecondValue: 亚秒值 0~0x7FFF。
+  * @param  RTC_AlarmSubSecondMask: 亚秒掩码 RTC_AlarmSubSecondMask_x。
+  * @param  Done: 完成回调，可为 NULL。
+  * @param  Arg: 回调参数。
+  * @retval SUCCESS: 已提交；ERROR: Op 的上一次操作尚未完成。
+  * @note   闹钟中断使能（ALRxIE）不变，仍由 myRTC_ITConfig() 控制。
+  */
+ErrorStatus myRTC_AsyncSetAlarm(RTC_AsyncOpTypeDef* Op, uint32_t RTC_Alarm, uint32_t RTC_Format,
+    RTC_AlarmTypeDef* RTC_AlarmStruct, uint32_t RTC_AlarmSubSecondValue, uint32_t RTC_AlarmSubSecondMask,
+    RTC_AsyncCallback Done, void* Arg)
+{
+    /* 参数检查 */
+    assert_param(IS_RTC_ALARM(RTC_Alarm));
+    assert_param(IS_RTC_ALARM_SUB_SECOND_VALUE(RTC_AlarmSubSecondValue));
+    assert_param(IS_RTC_ALARM_SUB_SECOND_MASK(RTC_AlarmSubSecondMask));
+
+    if (Op->Busy)
+    {
+        return ERROR;
+    }
+
+    Op->Value[0] = myRTC_PackAlarm(RTC_Format, RTC_AlarmStruct);
+    Op->Value[1] = RTC_AlarmSubSecondValue | RTC_AlarmSubSecondMask;
+    Op->Value[2] = RTC_Alarm;
+
+    return Async_Submit(Op, ASYNC_ALARM, Done, Arg);
+}
+
+/**
+  * @brief  异步启用或禁用闹钟。
+  * @param  Op: 操作句柄。
+  * @param  RTC_Alarm: RTC_Alarm_A 或 RTC_Alarm_B。
+  * @param  NewState: ENABLE 或 DISABLE。
+  * @param  Done: 完成回调，可为 NULL。
+  * @param  Arg: 回调参数。
+  * @retval SUCCESS: 已提交；ERROR: Op 的上一次操作尚未完成。
+  * @note   禁用在 ALRxWF 置位（闹钟寄存器可写）后才完成。
+  */
+ErrorStatus myRTC_AsyncAlarmCmd(RTC_AsyncOpTypeDef* Op, uint32_t RTC_Alarm, FunctionalState NewState,
+    RTC_AsyncCallback Done, void* Arg)
+{
+    /* 参数检查 */
+    assert_param(IS_RTC_ALARM(RTC_Alarm));
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    if (Op->Busy)
+    {
+        return ERROR;
+    }
+
+    Op->Value[2] = RTC_Alarm;
+
+    return Async_Submit(Op, (NewState != DISABLE) ? ASYNC_ALARM_ON : ASYNC_ALARM_OFF, Done, Arg);
+}
+
+/**
+  * @brief  异步设置唤醒定时器的时钟和计数值并使能。
+  * @param  Op: 操作句柄。
+  * @param  RTC_WakeUpClock: RTC_WakeUpClock_x。
+  * @param  RTC_WakeUpCounter: 计数值 0~0xFFFF。
+  * @param  Done: 完成回调，可为 NULL。
+  * @param  Arg: 回调参数。
+  * @retval SUCCESS: 已提交；ERROR: Op 的上一次操作尚未完成。
+  */
+ErrorStatus myRTC_AsyncSetWakeUp(RTC_AsyncOpTypeDef* Op, uint32_t RTC_WakeUpClock, uint32_t RTC_WakeUpCounter,
+    RTC_AsyncCallback Done, void* Arg)
+{
+    /* 参数检查 */
+    assert_param(IS_RTC_WAKEUP_CLOCK(RTC_WakeUpClock));
+    assert_param(IS_RTC_WAKEUP_COUNTER(RTC_WakeUpCounter));
+
+    if (Op->Busy)
+    {
+        return ERROR;
+    }
+
+    Op->Value[0] = RTC_WakeUpClock;
+    Op->Value[1] = RTC_WakeUpCounter;
+
+    return Async_Submit(Op, ASYNC_WAKEUP, Done, Arg);
+}
+
+/**
+  * @brief  异步启用或禁用唤醒定时器。
+  * @param  Op: 操作句柄。
+  * @param  NewState: ENABLE 或 DISABLE。
+  * @param  Done: 完成回调，可为 NULL。
+  * @param  Arg: 回调参数。
+  * @retval SUCCESS: 已提交；ERROR: Op 的上一次操作尚未完成。
+  * @note   禁用在 WUTWF 置位（WUTR 可写）后才完成。
+  */
+ErrorStatus myRTC_AsyncWakeUpCmd(RTC_AsyncOpTypeDef* Op, FunctionalState NewState, RTC_AsyncCallback Done, void* Arg)
+{
+    /* 参数检查 */
+    assert_param(IS_FUNCTIONAL_STATE(NewState));
+
+    return Async_Submit(Op, (NewState != DISABLE) ? ASYNC_WAKEUP_ON : ASYNC_WAKEUP_OFF, Done, Arg);
+}
+
+/**
+  * @brief  异步把 RTC 寄存器复位到默认值（不复位时钟源和备份寄存器）。
+  * @param  Op: 操作句柄。
+  * @param  Done: 完成回调，可为 NULL。
+  * @param  Arg: 回调参数。
+  * @retval SUCCESS: 已提交；ERROR: Op 的上一次操作尚未完成。
+  */
+ErrorStatus myRTC_AsyncDeInit(RTC_AsyncOpTypeDef* Op, RTC_AsyncCallback Done, void* Arg)
+{
+    return Async_Submit(Op, ASYNC_DEINIT, Done, Arg);
+}
+
+/**
+  * @brief  操作是否尚未完成。
+  * @param  Op: 操作句柄。
+  * @retval 1：在队列中或正在执行；0：空闲，可以提交新操作。
+  * @note   完成回调执行时已返回 0，可以在回调中用同一个句柄提交下一个操作。
+  */
+uint8_t myRTC_AsyncBusy(const RTC_AsyncOpTypeDef* Op)
+{
+    return Op->Busy;
+}
+
+/**
+  * @brief  推进状态机。
+  * @param  None
+  * @retval None
+  *
+  * @note
+  *  - 在主循环中周期调用，每次调用不忙等：
+  *    当前步骤的标志没到就返回，到了就连续执行到下一个等待点；一个操作完成后本次调用即返回。
+  *  - 每一步的“解锁、写寄存器、上锁”在关中断下完成，中断里的同步 RTC 函数不会插进来；
+  *    反过来本函数不能抢占正在执行的同步函数，调用上下文的要求见文件头“限制”。
+  *  - 完成回调在本函数中调用，参数为 SUCCESS，或超时时为 ERROR。
+  */
+void myRTC_AsyncPoll(void)
+{
+    RTC_AsyncOpTypeDef* op = s_head;
+    RTC_AsyncCallback done = NULL;
+    void* arg = NULL;
+    uint32_t primask = 0;
+    uint8_t result = ASYNC_NEXT;
+    ErrorStatus status = SUCCESS;
+
+    if (op == NULL)
+    {
+        return;
+    }
+
+    while (result == ASYNC_NEXT)
+    {
+        /* 步骤只写寄存器、不忙等，关中断的时间很短 */
+        primask = __get_PRIMASK();
+        __disable_irq();
+        result = (op->Type == ASYNC_CALENDAR) ? Async_Calendar(op)
+               : (op->Type == ASYNC_DEINIT) ? Async_DeInit(op)
+               : (op->Type <= ASYNC_ALARM_OFF) ? Async_Alarm(op)
+               : Async_WakeUp(op);
+        __set_PRIMASK(primask);
+        if (result == ASYNC_NEXT)
+        {
+            op->Step++;
+            op->Polls = 0;
+        }
+    }
+
+    if (result == ASYNC_WAIT)
+    {
+        if (++op->Polls < RTC_ASYNC_MAX_POLLS)
+        {
+            return;
+        }
+        primask = __get_PRIMASK();
+        __disable_irq();
+        Async_Abort();
+        __set_PRIMASK(primask);
+        status = ERROR;
+    }
+
+    /* 出队后再回调，回调中可以立即提交新操作 */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    s_head = op->Next;
+    s_tail = (s_head == NULL) ? NULL : s_tail;
+    done = op->Done;
+    arg = op->Arg;
+    op->Busy = 0;
+    __set_PRIMASK(primask);
+
+    if (done != NULL)
+    {
+        done(status, arg);
+    }
+}
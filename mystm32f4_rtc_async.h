@@ -0,0 +1,41 @@
+#ifndef mystm32f4_rtc_async_h
+#define mystm32f4_rtc_async_h
+
+#include "mystm32f4_rtc.h"
+
+/* 单个操作最多等待的轮询次数，超过则以 ERROR 完成 */
+#ifndef RTC_ASYNC_MAX_POLLS
+#define RTC_ASYNC_MAX_POLLS         1000
+#endif
+
+typedef void (*RTC_AsyncCallback)(ErrorStatus Status, void* Arg);
+
+/* 异步操作，由调用者分配，完成回调之前不得释放或复用 */
+typedef struct RTC_AsyncOp
+{
+    struct RTC_AsyncOp* Next;        /* 队列后继 */
+    RTC_AsyncCallback Done;          /* 完成回调，在 myRTC_AsyncPoll() 的调用上下文执行，可为 NULL */
+    void* Arg;                       /* 回调参数 */
+    uint32_t Value[3];               /* 提交时打包好的寄存器映像 */
+    uint16_t Polls;                  /* 当前步骤已等待的轮询次数 */
+    uint8_t Type;                    /* 操作类型 */
+    uint8_t Step;                    /* 当前步骤 */
+    volatile uint8_t Busy;           /* 1：在队列中或正在执行 */
+} RTC_AsyncOpTypeDef;
+
+ErrorStatus myRTC_AsyncSetCalendar(RTC_AsyncOpTypeDef* Op, uint32_t RTC_Format, // 异步设置时间和/或日期（NULL 表示不改）
+    RTC_TimeTypeDef* RTC_TimeStruct, RTC_DateTypeDef* RTC_DateStruct, RTC_AsyncCallback Done, void* Arg);
+ErrorStatus myRTC_AsyncSetAlarm(RTC_AsyncOpTypeDef* Op, uint32_t RTC_Alarm, uint32_t RTC_Format, // 异步设置并使能闹钟
+    RTC_AlarmTypeDef* RTC_AlarmStruct, uint32_t RTC_AlarmSubSecondValue, uint32_t RTC_AlarmSubSecondMask,
+    RTC_AsyncCallback Done, void* Arg);
+ErrorStatus myRTC_AsyncAlarmCmd(RTC_AsyncOpTypeDef* Op, uint32_t RTC_Alarm, FunctionalState NewState, // 异步启用或禁用闹钟
+    RTC_AsyncCallback Done, void* Arg);
+ErrorStatus myRTC_AsyncSetWakeUp(RTC_AsyncOpTypeDef* Op, uint32_t RTC_WakeUpClock, uint32_t RTC_WakeUpCounter, // 异步设置并使能唤醒定时器
+    RTC_AsyncCallback Done, void* Arg);
+ErrorStatus myRTC_AsyncWakeUpCmd(RTC_AsyncOpTypeDef* Op, FunctionalState NewState, // 异步启用或禁用唤醒定时器
+    RTC_AsyncCallback Done, void* Arg);
+ErrorStatus myRTC_AsyncDeInit(RTC_AsyncOpTypeDef* Op, RTC_AsyncCallback Done, void* Arg); // 异步复位 RTC 寄存器
+uint8_t myRTC_AsyncBusy(const RTC_AsyncOpTypeDef* Op);               // 操作是否尚未完成
+void myRTC_AsyncPoll(void);                                           // 推进状态机，在主循环中调用，不得抢占同步 RTC 调用
+
+#endif
@@ -0,0 +1,331 @@
+/**
+  ******************************************************************************
+  * @file     mystm32f4_rtc_idle.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    基于 RTC 唤醒定时器的无节拍低功耗空闲
+  *
+  * @attention
+  *
+  * 系统空闲时不再每 1ms 被节拍中断叫醒，而是按“下一次有事的时刻”设置一次 RTC 唤醒定时器，
+  * 进入 Stop 模式一直睡到那时。
+  *
+  * 唤醒时钟自动选档（LSE 32768Hz 时）：
+  *   RTCCLK/2   每计数 61.04us   最长 4s
+  *   RTCCLK/4   每计数 122.1us   最长 8s
+  *   RTCCLK/8   每计数 244.1us   最长 16s
+  *   RTCCLK/16  每计数 488.3us   最长 32s
+  *   ck_spre    每计数 1s        最长 65536s（16 位）/ 131072s（17 位）
+  * - 装得下的最细一档误差最小（不超过半个计数），优先选用。
+  * - 超出 RTCCLK/16 量程时用 ck_spre：第一个计数在下一个秒边沿，按读到的 SSR 计算相位，
+  *   向下取整到整秒，剩余不足 1 秒的部分醒来后再用 RTCCLK 档睡第二段。
+  *
+  * 开销补偿与实际睡眠时间：
+  * - 睡前、睡后各用 myRTC_GetEpochUs() 读一次日历（含 SSR），差值即实际睡眠时间，
+  *   包含进入 Stop、唤醒、恢复时钟的全部开销。
+  * - 由定时器唤醒时，“实际 - 计划”作为一次开销样本，按 1/8 权重滑动平均，
+  *   下一次计划时长先减去该开销，使实际睡眠时间对准请求值。
+  * - 实际时间的分辨率为 1/(PREDIV_S+1) 秒：PREDIV_A = 127、PREDIV_S = 255 时为 3.9ms，
+  *   需要更细的结果可把 PREDIV_A 调小、PREDIV_S 调大（功耗略增）。
+  *   样本带有正负一个分辨率的量化误差，负样本照样计入（截掉负值会让估计偏大约半个分辨率）；
+  *   计划时长短于一个分辨率时样本只剩量化噪声，不更新估计。
+  *   Stop 模式下只有 RTC/IWDG 的时钟在走，DWT、SysTick 无法跨过睡眠计时，
+  *   WUT 计数器也不可读，所以只能用日历测量。
+  *
+  * 限制：
+  * - 任何中断都会提前唤醒，此时立即返回已经睡过的时间，由调用者决定是否再睡。
+  * - 睡眠期间关中断（PRIMASK），唤醒源的中断服务在本函数返回前的开中断处执行。
+  * - 唤醒后如果 BYPSHAD = 0 需要等待 RSF 同步（最多约 2 个 RTCCLK），
+  *   配合 myRTC_BypassShadowCmd(ENABLE) 可以省掉这段等待。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) RTC 已用 LSE 初始化并设置好日历，使能 PWR 时钟。
+
+(#) 初始化：
+    RTC_IdleInitTypeDef idle;
+    idle.RtcClk = 32768;
+    idle.Regulator = PWR_Regulator_LowPower;
+    idle.Resume = SystemClock_Restore;      // 唤醒后系统时钟为 HSI，需要重新切到 PLL
+    myRTC_IdleInit(&idle);
+
+(#) 在 NVIC 中使能 RTC_WKUP_IRQn（WFI 靠它唤醒），中断服务中调用 myRTC_IdleIRQHandler()。
+
+(#) 空闲任务 / 主循环：
+    uint64_t slept = myRTC_IdleSleep(NextEventUs());
+    Os_AdvanceTime(slept);
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_rtc_idle.h"
+#include "mystm32f4_exti.h"
+
+/* Private define ------------------------------------------------------------*/
+#define IDLE_MAX_COUNT        65536U        /* 16 位唤醒计数器的最大计数个数 */
+#define IDLE_EMA_SHIFT        3             /* 开销滑动平均权重 1/8 */
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t s_rtcClk = 32768;
+static uint32_t s_regulator = PWR_Regulator_LowPower;
+static void (*s_resume)(void) = NULL;
+static int32_t s_overhead = RTC_IDLE_OVERHEAD_US << IDLE_EMA_SHIFT;   /* 开销估计 ×8，可能为负 */
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Idle_SprePeriodUs(void);
+static uint32_t Idle_PhaseUs(void);
+static uint64_t Idle_Stage(uint64_t Us, uint8_t* ByTimer);
+static uint32_t Idle_OverheadUs(void);
+
+
+/**
+  * @brief  ck_spre 周期（微秒）：(PREDIV_A+1)(PREDIV_S+1)/RTCCLK，正常配置为 1000000。
+  */
+static uint32_t Idle_SprePeriodUs(void)
+{
+    uint32_t prer = RTC->PRER;
+    uint64_t div = (uint64_t)(((prer >> 16) & 0x7F) + 1) * ((prer & RTC_PRER_PREDIV_S) + 1);
+
+    return (uint32_t)(div * 1000000 / s_rtcClk);
+}
+
+/**
+  * @brief  开销估计（微秒），滑动平均为负时按 0 使用。
+  */
+static uint32_t Idle_OverheadUs(void)
+{
+    return (s_overhead > 0) ? (uint32_t)(s_overhead >> IDLE_EMA_SHIFT) : 0;
+}
+
+/**
+  * @brief  距下一个 ck_spre 边沿的时间（微秒），由 SSR 计算：SSR 递减到 0 后的下一个计数产生边沿。
+  */
+static uint32_t Idle_PhaseUs(void)
+{
+    uint32_t prediv = RTC->PRER & RTC_PRER_PREDIV_S;
+    uint32_t ssr = RTC->SSR;
+
+    (void)RTC->DR;   /* 解锁影子寄存器 */
+    ssr = (ssr > prediv) ? prediv : ssr;
+
+    return (uint32_t)((uint64_t)(ssr + 1) * Idle_SprePeriodUs() / (prediv + 1));
+}
+
+/**
+  * @brief  初始化低功耗空闲。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成；ERROR: 参数非法或唤醒定时器无法关闭。
+  *
+  * @note
+  *  - 关闭唤醒定时器，把 EXTI22 配置为上升沿中断（RTC 唤醒经 EXTI22 进入 RTC_WKUP_IRQn）。
+  *  - 开销估计复位为 RTC_IDLE_OVERHEAD_US。
+  *  - 小白理解：以前每毫秒醒一次看看有没有事；现在算好下次有事的时间，定个闹钟一觉睡到那时。
+  */
+ErrorStatus myRTC_IdleInit(RTC_IdleInitTypeDef* Init)
+{
+    EXTI_InitTypeDef exti;
+
+    /* 参数检查 */
+    assert_param(Init->RtcClk != 0);
+    assert_param(IS_PWR_REGULATOR(Init->Regulator));
+
+    if (Init->RtcClk == 0 || myRTC_WakeUpCmd(DISABLE) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    s_rtcClk = Init->RtcClk;
+    s_regulator = Init->Regulator;
+    s_resume = Init->Resume;
+    s_overhead = RTC_IDLE_OVERHEAD_US << IDLE_EMA_SHIFT;
+
+    myEXTI_ClearITPendingBit(EXTI_Line22);
+    exti.EXTI_Line = EXTI_Line22;
+    exti.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti.EXTI_Trigger = EXTI_Trigger_Rising;
+    exti.EXTI_LineCmd = ENABLE;
+    myEXTI_Init(&exti);
+
+    myRTC_ClearFlag(RTC_FLAG_WUTF);
+    myRTC_ITConfig(RTC_IT_WUT, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  为给定时长选择唤醒时钟和计数值。
+  * @param  Us: 希望的唤醒时长（微秒）。
+  * @param  PhaseUs: 距下一个 ck_spre 边沿的时间（微秒），只在选用 ck_spre 时使用。
+  * @param  Plan: 输出方案；Plan->Us = 0 表示时长不足半个最细计数，不值得睡。
+  * @retval None
+  *
+  * @note
+  *  - RTCCLK/2、/4、/8、/16 依次尝试，计数值四舍五入，第一个装得下的就是误差最小的。
+  *  - 都装不下时用 ck_spre：计划 = PhaseUs + (N-1) 个周期，N 向下取整，不会睡过头；
+  *    N > 65536 用 17 位模式（WUTR = N - 1 - 65536），超过 131072 个周期则截断。
+  */
+void myRTC_IdlePlan(uint64_t Us, uint32_t PhaseUs, RTC_IdlePlanTypeDef* Plan)
+{
+    static const uint32_t clocks[4] = { RTC_WakeUpClock_RTCCLK_Div2, RTC_WakeUpClock_RTCCLK_Div4,
+                                        RTC_WakeUpClock_RTCCLK_Div8, RTC_WakeUpClock_RTCCLK_Div16 };
+    uint64_t count = 0;
+    uint64_t spre = Idle_SprePeriodUs();
+    uint32_t div = 2;
+    uint8_t i = 0;
+
+    for (i = 0; i < 4; i++, div <<= 1)
+    {
+        count = (Us * s_rtcClk + (uint64_t)div * 500000) / ((uint64_t)div * 1000000);
+        if (count <= IDLE_MAX_COUNT)
+        {
+            Plan->Clock = clocks[i];
+            Plan->Counter = (count != 0) ? (uint32_t)(count - 1) : 0;
+            Plan->Us = count * div * 1000000 / s_rtcClk;
+            return;
+        }
+    }
+
+    /* ck_spre：第一个计数在 PhaseUs 后，之后每 spre 一个 */
+    count = (Us > PhaseUs) ? (Us - PhaseUs) / spre + 1 : 1;
+    count = (count > 2 * IDLE_MAX_COUNT) ? 2 * IDLE_MAX_COUNT : count;
+    Plan->Clock = (count > IDLE_MAX_COUNT) ? RTC_WakeUpClock_CK_SPRE_17bits : RTC_WakeUpClock_CK_SPRE_16bits;
+    Plan->Counter = (uint32_t)((count - 1) & 0xFFFF);
+    Plan->Us = PhaseUs + (count - 1) * spre;
+}
+
+/**
+  * @brief  睡一段：设置唤醒定时器，进入 Stop，唤醒后恢复时钟并测量实际时间。
+  * @param  Us: 希望的实际睡眠时长，函数内先扣除开销估计再选方案。
+  * @param  ByTimer: 输出 1 表示由唤醒定时器唤醒。
+  * @retval 实际睡眠时间（微秒），定时器唤醒时不小于计划时长；不值得睡时返回 0。
+  * @note   调用者须已关中断。
+  */
+static uint64_t Idle_Stage(uint64_t Us, uint8_t* ByTimer)
+{
+    RTC_IdlePlanTypeDef plan;
+    uint64_t overhead = Idle_OverheadUs();
+    uint64_t t0 = 0;
+    uint64_t t1 = 0;
+    int32_t sample = 0;
+
+    *ByTimer = 0;
+    if (Us <= overhead)
+    {
+        return 0;
+    }
+    myRTC_IdlePlan(Us - overhead, Idle_PhaseUs(), &plan);
+    if (plan.Us == 0)
+    {
+        return 0;
+    }
+
+    myRTC_WakeUpCmd(DISABLE);
+    myRTC_WakeUpClockConfig(plan.Clock);
+    myRTC_SetWakeUpCounter(plan.Counter);
+    myRTC_ClearFlag(RTC_FLAG_WUTF);
+    myEXTI_ClearITPendingBit(EXTI_Line22);
+    NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+
+    t0 = myRTC_GetEpochUs();
+    myRTC_WakeUpCmd(ENABLE);
+    PWR_EnterSTOPMode(s_regulator, PWR_STOPEntry_WFI);
+
+    if (s_resume != NULL)
+    {
+        s_resume();
+    }
+    myRTC_WaitForSynchro();
+    t1 = myRTC_GetEpochUs();
+
+    *ByTimer = (myRTC_GetFlagStatus(RTC_FLAG_WUTF) != RESET) ? 1 : 0;
+    myRTC_WakeUpCmd(DISABLE);
+    myRTC_ClearFlag(RTC_FLAG_WUTF);
+    myEXTI_ClearITPendingBit(EXTI_Line22);
+    NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+
+    /* 定时器唤醒才是完整的一次睡眠，用来修正开销估计；
+       日历分辨率比计划时长还粗时样本只是量化噪声，不用。负样本不截断，量化误差正负抵消 */
+    if (*ByTimer && t1 >= t0 && Idle_SprePeriodUs() / ((RTC->PRER & RTC_PRER_PREDIV_S) + 1) <= plan.Us)
+    {
+        sample = (int32_t)((int64_t)(t1 - t0) - (int64_t)plan.Us);
+        s_overhead += sample - s_overhead / (1 << IDLE_EMA_SHIFT);
+    }
+
+    /* 比一个日历分辨率还短的睡眠测出来可能是 0；定时器唤醒时至少已经睡满计划时长，
+       按计划时长计入，否则调用者会一直重睡到 SSR 变化，多睡最多一个分辨率 */
+    t1 = (t1 > t0) ? t1 - t0 : 0;
+    return (*ByTimer && t1 < plan.Us) ? plan.Us : t1;
+}
+
+/**
+  * @brief  进入 Stop 模式睡眠。
+  * @param  Us: 希望睡眠的时间（微秒），61us（LSE 下一个 RTCCLK/2 计数）到数十小时。
+  * @retval 实际睡眠时间（微秒），由日历（含 SSR）测得，包含进出 Stop 的开销；
+  *         由定时器唤醒的一段按不小于其计划时长计入。
+  *
+  * @note
+  *  - 超过 RTCCLK/16 量程时先用 ck_spre 睡整秒部分，再用 RTCCLK 档睡剩余部分。
+  *  - 被其他中断提前唤醒时立即返回，返回值小于 Us。
+  *  - 返回前恢复调用前的中断屏蔽状态，提前唤醒的中断在此之后得到服务。
+  */
+uint64_t myRTC_IdleSleep(uint64_t Us)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint64_t total = 0;
+    uint64_t slept = 0;
+    uint8_t byTimer = 1;
+
+    __disable_irq();
+    while (byTimer && total < Us)
+    {
+        slept = Idle_Stage(Us - total, &byTimer);
+        if (slept == 0 && byTimer == 0)
+        {
+            break;
+        }
+        total += slept;
+    }
+    __set_PRIMASK(primask);
+
+    return total;
+}
+
+/**
+  * @brief  当前的进出 Stop 开销估计。
+  * @param  None
+  * @retval 开销（微秒）
+  */
+uint32_t myRTC_IdleGetOverhead(void)
+{
+    return Idle_OverheadUs();
+}
+
+/**
+  * @brief  唤醒中断处理，在 RTC_WKUP_IRQHandler 中调用。
+  * @param  None
+  * @retval None
+  * @note   myRTC_IdleSleep() 自己会清除标志，这里只处理其余情况下残留的唤醒标志。
+  */
+void myRTC_IdleIRQHandler(void)
+{
+    myRTC_ClearFlag(RTC_FLAG_WUTF);
+    myEXTI_ClearITPendingBit(EXTI_Line22);
+}
@@ -0,0 +1,34 @@
+#ifndef mystm32f4_rtc_idle_h
+#define mystm32f4_rtc_idle_h
+
+#include "mystm32f4_rtc.h"
+#include "stm32f4xx_pwr.h"
+
+/* 进出 Stop 模式开销的初始估计（微秒），运行中按实测自动修正 */
+#ifndef RTC_IDLE_OVERHEAD_US
+#define RTC_IDLE_OVERHEAD_US        100
+#endif
+
+/* 低功耗空闲初始化参数 */
+typedef struct
+{
+    uint32_t RtcClk;             /* RTCCLK 频率（Hz），LSE 为 32768 */
+    uint32_t Regulator;          /* Stop 模式调压器：PWR_Regulator_ON / PWR_Regulator_LowPower */
+    void (*Resume)(void);        /* 唤醒后恢复系统时钟（重新打开 HSE/PLL），可为 NULL */
+} RTC_IdleInitTypeDef;
+
+/* 一次唤醒定时的方案 */
+typedef struct
+{
+    uint32_t Clock;              /* RTC_WakeUpClock_x */
+    uint32_t Counter;            /* 写入 WUTR 的值 */
+    uint64_t Us;                 /* 该方案的计划时长（微秒） */
+} RTC_IdlePlanTypeDef;
+
+ErrorStatus myRTC_IdleInit(RTC_IdleInitTypeDef* Init);               // 初始化低功耗空闲
+void myRTC_IdlePlan(uint64_t Us, uint32_t PhaseUs, RTC_IdlePlanTypeDef* Plan); // 为给定时长选择唤醒时钟和计数值
+uint64_t myRTC_IdleSleep(uint64_t Us);                                // 进入 Stop 模式睡眠，返回实际睡眠时间（微秒）
+uint32_t myRTC_IdleGetOverhead(void);                                 // 当前的进出 Stop 开销估计（微秒）
+void myRTC_IdleIRQHandler(void);                                      // 唤醒中断处理，在 RTC_WKUP_IRQHandler 中调用
+
+#endif
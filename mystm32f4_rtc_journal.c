@@ -0,0 +1,402 @@
+/**
+  ******************************************************************************
+  * @file     mystm32f4_rtc_journal.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    RTC 时间戳 / 侵入检测事件日志
+  *
+  * @attention
+  *
+  * 把时间戳引脚和侵入检测（tamper）事件逐条记录下来，时间精确到亚秒（PREDIV_S = 255 时 3.9ms，
+  * 需要 1ms 以内请把 PREDIV_S 调到 1023 以上）。
+  *
+  * 捕获：
+  * - 硬件在事件发生的瞬间把日历和 SSR 锁存到 TSTR/TSDR/TSSSR 并置位 TSF，与中断响应延迟无关。
+  *   侵入检测同时打开 TAMPTS，使侵入事件也得到硬件时间戳。
+  * - 中断驱动（TAMP_STAMP_IRQn，经 EXTI21）：轮询标志在突发事件时必然漏掉中间的事件。
+  * - TSF 未清时再来事件，硬件只置 TSOVF，第二个事件的时间无法恢复。按参考手册的顺序
+  *   “读时间戳 → 清 TSF → 再检查 TSOVF”，溢出记为一条 RTC_JOURNAL_SRC_OVERFLOW 事件，
+  *   时间取中断中的当前时间并标记 INEXACT，保证事件个数不丢。
+  * - RTC 事件中断在 EXTI 上是电平“或”的上升沿：处理过程中又有标志置位时不会产生新的边沿，
+  *   所以中断处理循环到所有标志都清零为止。
+  *
+  * 缓冲与持久化：
+  * - 内存中为单生产者（中断）/ 单消费者（主循环）环形缓冲，满时丢弃新事件并计数。
+  * - 每条事件同时写入备份寄存器（默认 DR12~DR19，4 条）：字 0 为 Unix 秒，
+  *   字 1 为 [31:16] 序号 [15:12] 来源 [11:10] 标志 [9:0] 毫秒。
+  *   先把字 1 写 0 使该条失效，再写字 0，最后写字 1，写到一半掉电只会丢这一条。
+  * - 复位后序号从备份寄存器中最新的一条继续。
+  *
+  * 限制：
+  * - 侵入检测事件会由硬件清空全部备份寄存器，之前保存的事件（以及 myRTC_KV 存储）随之清除；
+  *   本模块在清除之后写入侵入事件本身，所以侵入事件总能保存下来。
+  * - 时间戳寄存器不含年份，按当前日期推算：时间戳月份大于当前月份视为上一年。
+  * - 只支持侵入检测 1（与 myRTC_TamperCmd() 一致）。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) RTC 已初始化并设置好日历，打开备份域写访问：PWR_BackupAccessCmd(ENABLE)。
+    时间戳引脚 PC13（RTC_AF1）、侵入检测引脚 PC13 或 PI8 按 myRTC_TimeStampPinSelection()、
+    myRTC_TamperPinSelection() 选择。
+
+(#) 初始化：
+    RTC_JournalInitTypeDef init;
+    myRTC_JournalStructInit(&init);
+    init.Tamper = ENABLE;
+    myRTC_JournalInit(&init);
+
+(#) 在 NVIC 中使能 TAMP_STAMP_IRQn，并在中断中调用：
+    void TAMP_STAMP_IRQHandler(void)
+    {
+        myRTC_JournalIRQHandler();
+    }
+
+(#) 上电时查看上次运行保存的事件：
+    RTC_JournalEntryTypeDef last[RTC_JOURNAL_SLOTS];
+    uint8_t n = myRTC_JournalLoad(last, RTC_JOURNAL_SLOTS);
+
+(#) 主循环中取出新事件：
+    RTC_JournalEntryTypeDef e;
+    while (myRTC_JournalRead(&e) == SUCCESS)
+    {
+        Audit_Log(e.EpochMs, e.Source, e.Flags);
+    }
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_rtc_journal.h"
+#include "mystm32f4_exti.h"
+
+/* Private define ------------------------------------------------------------*/
+#define JOURNAL_MASK          (RTC_JOURNAL_DEPTH - 1)
+#define JOURNAL_FLAGS         (RTC_FLAG_TSF | RTC_FLAG_TSOVF | RTC_FLAG_TAMP1F)
+
+/* Private variables ---------------------------------------------------------*/
+static RTC_JournalEntryTypeDef s_ring[RTC_JOURNAL_DEPTH];
+static volatile uint8_t s_head = 0;                  /* 中断写 */
+static volatile uint8_t s_tail = 0;                  /* 主循环读 */
+static volatile uint32_t s_dropped = 0;
+static uint16_t s_seq = 0;
+static uint8_t s_slot = 0;                           /* 下一条持久化写入的位置 */
+static uint8_t s_persist = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint64_t Journal_StampMs(void);
+static void Journal_Push(uint64_t EpochMs, uint8_t Source, uint8_t Flags);
+static void Journal_Persist(const RTC_JournalEntryTypeDef* Entry);
+static ErrorStatus Journal_LoadSlot(uint8_t Slot, RTC_JournalEntryTypeDef* Entry);
+static uint8_t Journal_Newest(void);
+
+
+/**
+  * @brief  读出硬件时间戳并换算为 Unix 毫秒，年份由当前日期推算。
+  */
+static uint64_t Journal_StampMs(void)
+{
+    RTC_TimeTypeDef time;
+    RTC_DateTypeDef date;
+    RTC_DateTypeDef now;
+    uint32_t ss = myRTC_GetTimeStampSubSecond();
+    uint32_t prediv = RTC->PRER & RTC_PRER_PREDIV_S;
+
+    myRTC_GetTimeStamp(RTC_Format_BIN, &time, &date);
+    myRTC_GetDate(RTC_Format_BIN, &now);
+
+    date.RTC_Year = (date.RTC_Month > now.RTC_Month) ? (uint8_t)((now.RTC_Year + 99) % 100) : now.RTC_Year;
+    time.RTC_Hours = (RTC->CR & RTC_CR_FMT) ? (uint8_t)(time.RTC_Hours % 12 + (time.RTC_H12 ? 12 : 0)) : time.RTC_Hours;
+
+    /* 平移操作后 SSR 可能大于 PREDIV_S，按 0 毫秒处理 */
+    ss = (ss > prediv) ? prediv : ss;
+
+    return (uint64_t)myRTC_DateTimeToEpoch(&date, &time) * 1000 + (prediv - ss) * 1000 / (prediv + 1);
+}
+
+/**
+  * @brief  追加一条事件到环形缓冲并持久化，只在中断中调用。
+  */
+static void Journal_Push(uint64_t EpochMs, uint8_t Source, uint8_t Flags)
+{
+    RTC_JournalEntryTypeDef* e = &s_ring[s_head & JOURNAL_MASK];
+    RTC_JournalEntryTypeDef tmp;
+
+    s_seq = (uint16_t)((s_seq == 0xFFFF) ? 1 : s_seq + 1);
+
+    /* 缓冲满：丢弃新事件（已读出的旧事件不能被覆盖），但仍然持久化 */
+    e = ((uint8_t)(s_head - s_tail) >= RTC_JOURNAL_DEPTH) ? &tmp : e;
+    e->EpochMs = EpochMs;
+    e->Seq = s_seq;
+    e->Source = Source;
+    e->Flags = Flags;
+
+    if (e == &tmp)
+    {
+        s_dropped++;
+    }
+    else
+    {
+        s_head++;
+    }
+
+    if (s_persist)
+    {
+        Journal_Persist(e);
+    }
+}
+
+/**
+  * @brief  写入一条持久化记录：先使该条失效，再写秒，最后写序号和毫秒。
+  */
+static void Journal_Persist(const RTC_JournalEntryTypeDef* Entry)
+{
+    uint32_t base = RTC_JOURNAL_FIRST_DR + (uint32_t)s_slot * 2;
+    uint32_t sec = (uint32_t)(Entry->EpochMs / 1000);
+    uint32_t ms = (uint32_t)(Entry->EpochMs - (uint64_t)sec * 1000);
+
+    myRTC_WriteBackupRegister(base + 1, 0);
+    myRTC_WriteBackupRegister(base, sec);
+    myRTC_WriteBackupRegister(base + 1, ((uint32_t)Entry->Seq << 16) | ((uint32_t)(Entry->Source & 0x0F) << 12)
+                                         | ((uint32_t)(Entry->Flags & 0x03) << 10) | ms);
+
+    s_slot = (uint8_t)((s_slot + 1) % RTC_JOURNAL_SLOTS);
+}
+
+/**
+  * @brief  读出一条持久化记录，序号为 0（空或写到一半）或字段非法时返回 ERROR。
+  */
+static ErrorStatus Journal_LoadSlot(uint8_t Slot, RTC_JournalEntryTypeDef* Entry)
+{
+    uint32_t base = RTC_JOURNAL_FIRST_DR + (uint32_t)Slot * 2;
+    uint32_t w1 = myRTC_ReadBackupRegister(base + 1);
+
+    if ((w1 >> 16) == 0 || (w1 & 0x3FF) > 999 || ((w1 >> 12) & 0x0F) == 0 || ((w1 >> 12) & 0x0F) > RTC_JOURNAL_SRC_OVERFLOW)
+    {
+        return ERROR;
+    }
+
+    Entry->EpochMs = (uint64_t)myRTC_ReadBackupRegister(base) * 1000 + (w1 & 0x3FF);
+    Entry->Seq = (uint16_t)(w1 >> 16);
+    Entry->Source = (uint8_t)((w1 >> 12) & 0x0F);
+    Entry->Flags = (uint8_t)((w1 >> 10) & 0x03);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  最新一条持久化记录的位置（序号按 16 位回绕比较），没有记录返回 RTC_JOURNAL_SLOTS。
+  */
+static uint8_t Journal_Newest(void)
+{
+    RTC_JournalEntryTypeDef e;
+    uint16_t best = 0;
+    uint8_t newest = RTC_JOURNAL_SLOTS;
+    uint8_t i = 0;
+
+    for (i = 0; i < RTC_JOURNAL_SLOTS; i++)
+    {
+        if (Journal_LoadSlot(i, &e) == SUCCESS && (newest == RTC_JOURNAL_SLOTS || (int16_t)(e.Seq - best) > 0))
+        {
+            best = e.Seq;
+            newest = i;
+        }
+    }
+
+    return newest;
+}
+
+/**
+  * @brief  用默认值填充初始化参数。
+  * @param  Init: 初始化参数。
+  * @retval None
+  * @note   默认：记录上升沿时间戳事件，不用侵入检测，持久化打开。
+  */
+void myRTC_JournalStructInit(RTC_JournalInitTypeDef* Init)
+{
+    Init->TimeStamp = ENABLE;
+    Init->TimeStampEdge = RTC_TimeStampEdge_Rising;
+    Init->Tamper = DISABLE;
+    Init->TamperTrigger = RTC_TamperTrigger_RisingEdge;
+    Init->Persist = ENABLE;
+}
+
+/**
+  * @brief  初始化事件日志。
+  * @param  Init: 初始化参数。
+  * @retval None
+  *
+  * @note
+  *  - 事件序号从备份寄存器中最新的一条继续，持久化写入紧接其后的位置。
+  *  - 清除残留的 TSF/TSOVF/TAMP1F，按参数打开时间戳、侵入检测（同时打开 TAMPTS）及其中断，
+  *    把 EXTI21 配置为上升沿中断（可从 Stop 模式唤醒）。
+  *  - 用户需在 NVIC 中使能 TAMP_STAMP_IRQn。
+  *  - 小白理解：事件发生的一瞬间硬件先“拍照”记下时间，中断晚一点来也不影响时间的准确性。
+  */
+void myRTC_JournalInit(RTC_JournalInitTypeDef* Init)
+{
+    RTC_JournalEntryTypeDef e;
+    EXTI_InitTypeDef exti;
+    uint8_t newest = Journal_Newest();
+
+    /* 参数检查 */
+    assert_param(IS_FUNCTIONAL_STATE(Init->TimeStamp));
+    assert_param(IS_FUNCTIONAL_STATE(Init->Tamper));
+    assert_param(IS_FUNCTIONAL_STATE(Init->Persist));
+
+    s_head = 0;
+    s_tail = 0;
+    s_dropped = 0;
+    s_persist = (Init->Persist == ENABLE) ? 1 : 0;
+    s_slot = (newest == RTC_JOURNAL_SLOTS) ? 0 : (uint8_t)((newest + 1) % RTC_JOURNAL_SLOTS);
+    s_seq = (newest != RTC_JOURNAL_SLOTS && Journal_LoadSlot(newest, &e) == SUCCESS) ? e.Seq : 0;
+
+    /* 先关闭事件源和中断，清除残留标志 */
+    myRTC_ITConfig(RTC_IT_TS | RTC_IT_TAMP, DISABLE);
+    myRTC_TimeStampCmd(Init->TimeStampEdge, DISABLE);
+    myRTC_TamperCmd(RTC_Tamper_1, DISABLE);
+    myRTC_ClearFlag(JOURNAL_FLAGS);
+
+    if (Init->Tamper == ENABLE)
+    {
+        myRTC_TamperTriggerConfig(RTC_Tamper_1, Init->TamperTrigger);
+        myRTC_TimeStampOnTamperDetectionCmd(ENABLE);
+        myRTC_TamperCmd(RTC_Tamper_1, ENABLE);
+    }
+    if (Init->TimeStamp == ENABLE)
+    {
+        myRTC_TimeStampCmd(Init->TimeStampEdge, ENABLE);
+    }
+
+    /* RTC 时间戳 / 侵入检测通过 EXTI21 进入 TAMP_STAMP_IRQn */
+    myEXTI_ClearITPendingBit(EXTI_Line21);
+    exti.EXTI_Line = EXTI_Line21;
+    exti.EXTI_Mode = EXTI_Mode_Interrupt;
+    exti.EXTI_Trigger = EXTI_Trigger_Rising;
+    exti.EXTI_LineCmd = ENABLE;
+    myEXTI_Init(&exti);
+
+    myRTC_ITConfig(RTC_IT_TS, (Init->TimeStamp == ENABLE || Init->Tamper == ENABLE) ? ENABLE : DISABLE);
+    myRTC_ITConfig(RTC_IT_TAMP, Init->Tamper);
+}
+
+/**
+  * @brief  取出最早的一条事件。
+  * @param  Entry: 事件。
+  * @retval SUCCESS: 取出一条；ERROR: 没有未读事件。
+  */
+ErrorStatus myRTC_JournalRead(RTC_JournalEntryTypeDef* Entry)
+{
+    if (s_tail == s_head)
+    {
+        return ERROR;
+    }
+
+    *Entry = s_ring[s_tail & JOURNAL_MASK];
+    s_tail++;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  缓冲中未读的事件数。
+  * @retval 事件数。
+  */
+uint8_t myRTC_JournalCount(void)
+{
+    return (uint8_t)(s_head - s_tail);
+}
+
+/**
+  * @brief  因缓冲满而丢弃的事件数（这些事件仍写入了备份寄存器）。
+  * @retval 事件数。
+  */
+uint32_t myRTC_JournalDropped(void)
+{
+    return s_dropped;
+}
+
+/**
+  * @brief  读出备份寄存器中保存的事件。
+  * @param  Entries: 输出数组。
+  * @param  Max: 数组长度。
+  * @retval 读出的条数，按从旧到新排列，最多 RTC_JOURNAL_SLOTS 条。
+  * @note   在 myRTC_JournalInit() 之前或之后调用均可；侵入事件之后只剩侵入事件及其后的记录。
+  */
+uint8_t myRTC_JournalLoad(RTC_JournalEntryTypeDef* Entries, uint8_t Max)
+{
+    uint8_t newest = Journal_Newest();
+    uint8_t n = 0;
+    uint8_t i = 0;
+
+    if (newest == RTC_JOURNAL_SLOTS)
+    {
+        return 0;
+    }
+
+    /* 从最新一条的下一个位置开始，绕一圈即为从旧到新 */
+    for (i = 1; i <= RTC_JOURNAL_SLOTS && n < Max; i++)
+    {
+        if (Journal_LoadSlot((uint8_t)((newest + i) % RTC_JOURNAL_SLOTS), &Entries[n]) == SUCCESS)
+        {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/**
+  * @brief  时间戳 / 侵入检测中断处理。
+  * @param  None
+  * @retval None
+  *
+  * @note
+  *  - 在 TAMP_STAMP_IRQHandler 中调用。
+  *  - 有硬件时间戳时（TSF）按时间戳记录，同时置位的 TAMP1F 说明这是侵入事件；
+  *    只有 TAMP1F 没有 TSF（时间戳已被前一个事件占用）时取当前时间并标记 INEXACT。
+  *  - 先清 TSF 再检查 TSOVF，避免清 TSF 之前的一瞬间发生的事件被漏记。
+  */
+void myRTC_JournalIRQHandler(void)
+{
+    uint32_t isr = 0;
+
+    myEXTI_ClearITPendingBit(EXTI_Line21);
+
+    /* 处理过程中有新标志置位不会产生新的 EXTI 边沿，循环到全部清零 */
+    while (((isr = RTC->ISR) & JOURNAL_FLAGS) != 0)
+    {
+        if (isr & RTC_FLAG_TSF)
+        {
+            Journal_Push(Journal_StampMs(), (isr & RTC_FLAG_TAMP1F) ? RTC_JOURNAL_SRC_TAMP1 : RTC_JOURNAL_SRC_TS, 0);
+            myRTC_ClearFlag(RTC_FLAG_TSF | (isr & RTC_FLAG_TAMP1F));
+        }
+        else if (isr & RTC_FLAG_TAMP1F)
+        {
+            Journal_Push(myRTC_GetEpochMs(), RTC_JOURNAL_SRC_TAMP1, RTC_JOURNAL_FLAG_INEXACT);
+            myRTC_ClearFlag(RTC_FLAG_TAMP1F);
+        }
+
+        if (RTC->ISR & RTC_FLAG_TSOVF)
+        {
+            Journal_Push(myRTC_GetEpochMs(), RTC_JOURNAL_SRC_OVERFLOW, RTC_JOURNAL_FLAG_INEXACT);
+            myRTC_ClearFlag(RTC_FLAG_TSOVF);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef mystm32f4_rtc_journal_h
+#define mystm32f4_rtc_journal_h
+
+#include "mystm32f4_rtc.h"
+
+/* 内存环形缓冲深度，须为 2 的幂 */
+#ifndef RTC_JOURNAL_DEPTH
+#define RTC_JOURNAL_DEPTH           16
+#endif
+
+/* 备份寄存器持久化区：从 RTC_JOURNAL_FIRST_DR 开始，每条 2 个寄存器 */
+#ifndef RTC_JOURNAL_FIRST_DR
+#define RTC_JOURNAL_FIRST_DR        RTC_BKP_DR12
+#endif
+#ifndef RTC_JOURNAL_SLOTS
+#define RTC_JOURNAL_SLOTS           4    /* DR12~DR19 */
+#endif
+
+/* 事件来源 */
+#define RTC_JOURNAL_SRC_TS          1    /* 时间戳引脚 */
+#define RTC_JOURNAL_SRC_TAMP1       2    /* 侵入检测 1 */
+#define RTC_JOURNAL_SRC_OVERFLOW    3    /* TSOVF：时间戳寄存器未读时又发生事件，该事件时间丢失 */
+
+/* 事件标志 */
+#define RTC_JOURNAL_FLAG_INEXACT    0x01 /* 时间取自中断中读到的当前时间，而不是硬件时间戳 */
+
+/* 事件日志初始化参数 */
+typedef struct
+{
+    FunctionalState TimeStamp;   /* 是否记录时间戳引脚事件 */
+    uint32_t TimeStampEdge;      /* RTC_TimeStampEdge_Rising / RTC_TimeStampEdge_Falling */
+    FunctionalState Tamper;      /* 是否记录侵入检测 1 事件 */
+    uint32_t TamperTrigger;      /* RTC_TamperTrigger_RisingEdge / RTC_TamperTrigger_FallingEdge */
+    FunctionalState Persist;     /* 是否把每条事件写入备份寄存器（需打开备份域写访问） */
+} RTC_JournalInitTypeDef;
+
+/* 一条事件 */
+typedef struct
+{
+    uint64_t EpochMs;            /* 事件时刻，Unix 毫秒 */
+    uint16_t Seq;                /* 事件序号，1~65535 循环 */
+    uint8_t  Source;             /* RTC_JOURNAL_SRC_x */
+    uint8_t  Flags;              /* RTC_JOURNAL_FLAG_x */
+} RTC_JournalEntryTypeDef;
+
+void myRTC_JournalStructInit(RTC_JournalInitTypeDef* Init);          // 初始化参数结构体默认值
+void myRTC_JournalInit(RTC_JournalInitTypeDef* Init);                // 初始化事件日志，使能时间戳/侵入检测中断
+ErrorStatus myRTC_JournalRead(RTC_JournalEntryTypeDef* Entry);        // 取出最早的一条事件，没有事件返回 ERROR
+uint8_t myRTC_JournalCount(void);                                     // 缓冲中未读的事件数
+uint32_t myRTC_JournalDropped(void);                                  // 因缓冲满而丢弃的事件数
+uint8_t myRTC_JournalLoad(RTC_JournalEntryTypeDef* Entries, uint8_t Max); // 读出备份寄存器中保存的事件（从旧到新）
+void myRTC_JournalIRQHandler(void);                                   // 事件中断处理，在 TAMP_STAMP_IRQHandler 中调用
+
+#endif
@@ -0,0 +1,419 @@
+/**
+  ******************************************************************************
+  * @file     mystm32f4_rtc_kv.c
+  * @author   QiangGu
+  * @version  V1.0.1
+  * @date     2026-10-18
+  * @brief    RTC 备份寄存器上的带校验键值存储
+  *
+  * @attention
+  *
+  * 20 个备份寄存器在 VBAT 供电下掉电保持，适合存放启动计数、上次故障码、校准偏移等少量数据。
+  * 逐个寄存器读写没有完整性保护，写到一半掉电或欠压复位后会带着半新半旧的数据启动。
+  * 本模块在备份寄存器上实现一个小型键值存储：
+  *
+  * 存储布局（两个存储体交替使用，默认 DR0~DR5、DR6~DR11，DR12~DR19 由事件日志使用）：
+  *   字 0（头）：[31:16] CRC16  [15:8] 序号  [7:0] 已用字节数
+  *   字 1~N：  记录区，按字节小端打包；每条记录 = 1 字节标签（键 << 2 | 类型）+ 1/2/4 字节值
+  * - CRC16-CCITT 覆盖序号、已用字节数和记录区，全 0（备份域复位后）的头一定校验失败。
+  *
+  * 原子提交（双缓冲）：
+  * - 修改只作用于内存镜像；提交时写入“非当前”存储体：先写数据字，最后写头。
+  *   头是一次 32 位写，要么是旧头（与新数据 CRC 不符，整体无效），要么是新头。
+  * - 上电加载两个存储体，取校验通过且序号较新的一个；任何时刻至少有一个完整的存储体。
+  * - 只写与寄存器当前内容不同的字，写完读回比对，备份域写保护（DBP = 0）时返回 ERROR。
+  *
+  * 查找：
+  * - 加载和修改时建立 键 → 记录偏移 的索引（32 字节），读写均为 O(1)，不需要扫描记录区。
+  *
+  * 限制：
+  * - 单个存储体默认 20 字节记录区：可存 4 个 32 位值，或 10 个 8 位值；不使用事件日志时可把
+  *   RTC_KV_BANK_WORDS 改为 10，占满 20 个寄存器。
+  * - 备份寄存器没有擦写寿命问题，存储体交替是为了掉电原子性，而不是磨损均衡。
+  * - 侵入检测（tamper）或备份域复位会清空全部寄存器，此时 myRTC_KVInit() 返回 ERROR，应使用默认值。
+  * - 非线程安全，只在主循环或同一个任务中使用。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  * V1.0.1 默认存储体缩小为 6 个寄存器，DR12~DR19 留给事件日志
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 PWR 时钟并打开备份域写访问：PWR_BackupAccessCmd(ENABLE)。
+
+(#) 启动时加载：
+    #define KEY_BOOT_COUNT   0
+    #define KEY_LAST_FAULT   1
+    uint32_t boots = 0;
+    myRTC_KVInit();                                   // 返回 ERROR 时存储为空，使用默认值
+    myRTC_KVGet(KEY_BOOT_COUNT, RTC_KV_U32, &boots);
+    myRTC_KVSet(KEY_BOOT_COUNT, RTC_KV_U32, boots + 1);
+    myRTC_KVCommit();
+
+(#) 故障处理中记录故障码：
+    myRTC_KVSet(KEY_LAST_FAULT, RTC_KV_U8, code);
+    myRTC_KVCommit();
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_rtc_kv.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define KV_DATA_BYTES         ((RTC_KV_BANK_WORDS - 1) * 4)
+#define KV_NO_BANK            0xFF
+#define KV_SIZE(type)         (1U << ((type) - 1))  /* U8/U16/U32 → 1/2/4 字节 */
+#define KV_TAG(key, type)     ((uint8_t)(((key) << 2) | (type)))
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_data[KV_DATA_BYTES];                /* 记录区内存镜像 */
+static uint8_t s_index[RTC_KV_KEYS];                 /* 键 → 记录偏移 + 1，0 表示不存在 */
+static uint8_t s_used = 0;
+static uint8_t s_seq = 0;
+static uint8_t s_active = KV_NO_BANK;
+static uint8_t s_dirty = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t Kv_Crc16(uint8_t Seq, uint8_t Used, const uint8_t* Data);
+static uint32_t Kv_Word(const uint8_t* Data, uint8_t Index);
+static ErrorStatus Kv_Reindex(const uint8_t* Data, uint8_t Used, uint8_t* Index);
+static ErrorStatus Kv_LoadBank(uint8_t Bank, uint8_t* Data, uint8_t* Seq, uint8_t* Used);
+static void Kv_Remove(uint8_t Key);
+
+
+/**
+  * @brief  CRC16-CCITT（多项式 0x1021，初值 0xFFFF），依次覆盖序号、已用字节数、记录区。
+  */
+static uint16_t Kv_Crc16(uint8_t Seq, uint8_t Used, const uint8_t* Data)
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t i = 0;
+    uint8_t j = 0;
+    uint8_t b = 0;
+
+    for (i = 0; i < (uint16_t)Used + 2; i++)
+    {
+        b = (i == 0) ? Seq : (i == 1) ? Used : Data[i - 2];
+        crc ^= (uint16_t)b << 8;
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+  * @brief  记录区第 Index 个字（小端）。
+  */
+static uint32_t Kv_Word(const uint8_t* Data, uint8_t Index)
+{
+    const uint8_t* p = &Data[Index * 4];
+
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+  * @brief  遍历记录区建立索引；标签非法或记录越界时返回 ERROR。
+  */
+static ErrorStatus Kv_Reindex(const uint8_t* Data, uint8_t Used, uint8_t* Index)
+{
+    uint8_t off = 0;
+    uint8_t type = 0;
+
+    memset(Index, 0, RTC_KV_KEYS);
+    while (off < Used)
+    {
+        type = Data[off] & 0x03;
+        if (type == 0 || off + 1 + KV_SIZE(type) > Used || Index[Data[off] >> 2] != 0)
+        {
+            return ERROR;
+        }
+        Index[Data[off] >> 2] = (uint8_t)(off + 1);
+        off = (uint8_t)(off + 1 + KV_SIZE(type));
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  读出一个存储体并校验 CRC 和记录结构。
+  */
+static ErrorStatus Kv_LoadBank(uint8_t Bank, uint8_t* Data, uint8_t* Seq, uint8_t* Used)
+{
+    uint8_t index[RTC_KV_KEYS];
+    uint32_t base = RTC_KV_FIRST_DR + (uint32_t)Bank * RTC_KV_BANK_WORDS;
+    uint32_t head = myRTC_ReadBackupRegister(base);
+    uint32_t word = 0;
+    uint8_t i = 0;
+
+    *Seq = (uint8_t)(head >> 8);
+    *Used = (uint8_t)head;
+    if (*Used > KV_DATA_BYTES)
+    {
+        return ERROR;
+    }
+
+    memset(Data, 0, KV_DATA_BYTES);
+    for (i = 0; i < (*Used + 3) / 4; i++)
+    {
+        word = myRTC_ReadBackupRegister(base + 1 + i);
+        Data[i * 4] = (uint8_t)word;
+        Data[i * 4 + 1] = (uint8_t)(word >> 8);
+        Data[i * 4 + 2] = (uint8_t)(word >> 16);
+        Data[i * 4 + 3] = (uint8_t)(word >> 24);
+    }
+    /* 最后一个字中超出已用字节的部分不参与校验，清零保持镜像确定 */
+    memset(&Data[*Used], 0, KV_DATA_BYTES - *Used);
+
+    if ((uint16_t)(head >> 16) != Kv_Crc16(*Seq, *Used, Data))
+    {
+        return ERROR;
+    }
+
+    return Kv_Reindex(Data, *Used, index);
+}
+
+/**
+  * @brief  从镜像中删除一条记录，后面的记录前移。
+  */
+static void Kv_Remove(uint8_t Key)
+{
+    uint8_t off = (uint8_t)(s_index[Key] - 1);
+    uint8_t size = (uint8_t)(1 + KV_SIZE(s_data[off] & 0x03));
+
+    memmove(&s_data[off], &s_data[off + size], s_used - off - size);
+    s_used = (uint8_t)(s_used - size);
+    memset(&s_data[s_used], 0, size);
+    (void)Kv_Reindex(s_data, s_used, s_index);
+    s_dirty = 1;
+}
+
+/**
+  * @brief  从备份寄存器加载键值存储。
+  * @retval SUCCESS: 加载了有效数据；ERROR: 两个存储体都无效（首次上电、备份域复位），存储已清空。
+  *
+  * @note
+  *  - 两个存储体都有效时取序号较新的一个（序号按 8 位回绕比较）。
+  *  - 提交中途掉电时，被写的存储体校验失败，自动回到上一次提交的内容。
+  *  - 小白理解：抄一份新的写在另一页，最后才签名；没签名的那页不算数，翻回旧页继续用。
+  */
+ErrorStatus myRTC_KVInit(void)
+{
+    uint8_t data[2][KV_DATA_BYTES];
+    uint8_t seq[2] = {0, 0};
+    uint8_t used[2] = {0, 0};
+    uint8_t ok0 = (Kv_LoadBank(0, data[0], &seq[0], &used[0]) == SUCCESS);
+    uint8_t ok1 = (Kv_LoadBank(1, data[1], &seq[1], &used[1]) == SUCCESS);
+
+    s_active = (ok0 && ok1) ? (((int8_t)(seq[1] - seq[0]) > 0) ? 1 : 0) : ok0 ? 0 : ok1 ? 1 : KV_NO_BANK;
+    s_dirty = 0;
+
+    if (s_active == KV_NO_BANK)
+    {
+        memset(s_data, 0, sizeof(s_data));
+        memset(s_index, 0, sizeof(s_index));
+        s_used = 0;
+        s_seq = 0;
+        return ERROR;
+    }
+
+    memcpy(s_data, data[s_active], KV_DATA_BYTES);
+    s_used = used[s_active];
+    s_seq = seq[s_active];
+
+    return Kv_Reindex(s_data, s_used, s_index);
+}
+
+/**
+  * @brief  写入键值。
+  * @param  Key: 键 0 ~ RTC_KV_KEYS-1。
+  * @param  Type: RTC_KV_U8 / RTC_KV_U16 / RTC_KV_U32，值按类型截断。
+  * @param  Value: 值。
+  * @retval SUCCESS: 已写入镜像；ERROR: 键或类型非法、空间不足（原有记录不变）。
+  * @note   同键同类型原地覆盖；类型改变时删除旧记录再追加。值未变时不标记修改，提交不会写寄存器。
+  */
+ErrorStatus myRTC_KVSet(uint8_t Key, uint8_t Type, uint32_t Value)
+{
+    uint8_t off = 0;
+    uint8_t i = 0;
+    uint8_t b = 0;
+
+    /* 参数检查 */
+    assert_param(Key < RTC_KV_KEYS);
+    assert_param(Type >= RTC_KV_U8 && Type <= RTC_KV_U32);
+
+    /* 发布版本 assert_param 为空：键越界会写出 s_index，类型越界会破坏标签的键位 */
+    if (Key >= RTC_KV_KEYS || Type < RTC_KV_U8 || Type > RTC_KV_U32)
+    {
+        return ERROR;
+    }
+
+    if (s_index[Key] != 0 && (s_data[s_index[Key] - 1] & 0x03) != Type)
+    {
+        /* 空间不够换类型时保留旧记录 */
+        if (s_used - KV_SIZE(s_data[s_index[Key] - 1] & 0x03) + KV_SIZE(Type) > KV_DATA_BYTES)
+        {
+            return ERROR;
+        }
+        Kv_Remove(Key);
+    }
+
+    if (s_index[Key] == 0)
+    {
+        if (s_used + 1 + KV_SIZE(Type) > KV_DATA_BYTES)
+        {
+            return ERROR;
+        }
+        s_data[s_used] = KV_TAG(Key, Type);
+        s_index[Key] = (uint8_t)(s_used + 1);
+        s_used = (uint8_t)(s_used + 1 + KV_SIZE(Type));
+        s_dirty = 1;
+    }
+
+    off = s_index[Key];
+    for (i = 0; i < KV_SIZE(Type); i++)
+    {
+        b = (uint8_t)(Value >> (i * 8));
+        s_dirty |= (s_data[off + i] != b);
+        s_data[off + i] = b;
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  读取键值。
+  * @param  Key: 键 0 ~ RTC_KV_KEYS-1。
+  * @param  Type: 期望的类型。
+  * @param  Value: 读出的值（零扩展到 32 位），失败时不修改。
+  * @retval SUCCESS: 读取成功；ERROR: 键不存在或类型不符。
+  */
+ErrorStatus myRTC_KVGet(uint8_t Key, uint8_t Type, uint32_t* Value)
+{
+    uint8_t off = 0;
+    uint32_t v = 0;
+    uint8_t i = 0;
+
+    /* 参数检查 */
+    assert_param(Key < RTC_KV_KEYS);
+
+    if (Key >= RTC_KV_KEYS || s_index[Key] == 0 || (s_data[s_index[Key] - 1] & 0x03) != Type)
+    {
+        return ERROR;
+    }
+
+    off = s_index[Key];
+    for (i = 0; i < KV_SIZE(Type); i++)
+    {
+        v |= (uint32_t)s_data[off + i] << (i * 8);
+    }
+    *Value = v;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  删除键，键不存在时无操作。
+  * @param  Key: 键 0 ~ RTC_KV_KEYS-1。
+  * @retval None
+  */
+void myRTC_KVDelete(uint8_t Key)
+{
+    /* 参数检查 */
+    assert_param(Key < RTC_KV_KEYS);
+
+    if (Key < RTC_KV_KEYS && s_index[Key] != 0)
+    {
+        Kv_Remove(Key);
+    }
+}
+
+/**
+  * @brief  把内存镜像原子地提交到备份寄存器。
+  * @retval SUCCESS: 提交完成或没有修改；ERROR: 读回比对失败（备份域未打开写访问）。
+  *
+  * @note
+  *  - 写入另一个存储体：先写与寄存器内容不同的数据字，最后写头；成功后切换当前存储体。
+  *  - 失败时当前存储体不变，镜像保留修改，可以打开写访问后重新提交。
+  */
+ErrorStatus myRTC_KVCommit(void)
+{
+    uint8_t bank = (s_active == 0) ? 1 : 0;
+    uint8_t seq = (uint8_t)(s_seq + 1);
+    uint32_t base = RTC_KV_FIRST_DR + (uint32_t)bank * RTC_KV_BANK_WORDS;
+    uint32_t head = ((uint32_t)Kv_Crc16(seq, s_used, s_data) << 16) | ((uint32_t)seq << 8) | s_used;
+    uint8_t i = 0;
+
+    if (!s_dirty && s_active != KV_NO_BANK)
+    {
+        return SUCCESS;
+    }
+
+    for (i = 0; i < (s_used + 3) / 4; i++)
+    {
+        if (myRTC_ReadBackupRegister(base + 1 + i) != Kv_Word(s_data, i))
+        {
+            myRTC_WriteBackupRegister(base + 1 + i, Kv_Word(s_data, i));
+        }
+    }
+
+    /* 头最后写：这一次 32 位写完成前，该存储体整体无效 */
+    myRTC_WriteBackupRegister(base, head);
+
+    for (i = 0; i < (s_used + 3) / 4; i++)
+    {
+        if (myRTC_ReadBackupRegister(base + 1 + i) != Kv_Word(s_data, i))
+        {
+            return ERROR;
+        }
+    }
+    if (myRTC_ReadBackupRegister(base) != head)
+    {
+        return ERROR;
+    }
+
+    s_active = bank;
+    s_seq = seq;
+    s_dirty = 0;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  清空全部键值。
+  * @retval None
+  * @note   只清内存镜像，调用 myRTC_KVCommit() 后生效；旧数据所在的存储体序号较旧，不会再被加载。
+  */
+void myRTC_KVFormat(void)
+{
+    memset(s_data, 0, sizeof(s_data));
+    memset(s_index, 0, sizeof(s_index));
+    s_used = 0;
+    s_dirty = 1;
+}
+
+/**
+  * @brief  剩余可用字节数。
+  * @retval 字节数；一条记录占 1 字节标签加 1/2/4 字节值。
+  */
+uint8_t myRTC_KVFree(void)
+{
+    return (uint8_t)(KV_DATA_BYTES - s_used);
+}
@@ -0,0 +1,30 @@
+#ifndef mystm32f4_rtc_kv_h
+#define mystm32f4_rtc_kv_h
+
+#include "mystm32f4_rtc.h"
+
+/* 存储区位置：两个存储体连续排列，从 RTC_KV_FIRST_DR 开始，每个存储体 RTC_KV_BANK_WORDS 个寄存器 */
+#ifndef RTC_KV_FIRST_DR
+#define RTC_KV_FIRST_DR             RTC_BKP_DR0
+#endif
+#ifndef RTC_KV_BANK_WORDS
+#define RTC_KV_BANK_WORDS           6    /* 1 个头 + 5 个数据字，可存 20 字节记录；DR12~DR19 留给事件日志 */
+#endif
+
+/* 键 0~31 */
+#define RTC_KV_KEYS                 32
+
+/* 值类型 */
+#define RTC_KV_U8                   1
+#define RTC_KV_U16                  2
+#define RTC_KV_U32                  3
+
+ErrorStatus myRTC_KVInit(void);                                      // 从备份寄存器加载，返回 ERROR 表示没有有效数据（已清空）
+ErrorStatus myRTC_KVSet(uint8_t Key, uint8_t Type, uint32_t Value);   // 写入键值（只改内存镜像，myRTC_KVCommit() 后生效）
+ErrorStatus myRTC_KVGet(uint8_t Key, uint8_t Type, uint32_t* Value);  // 读取键值，键不存在或类型不符返回 ERROR
+void myRTC_KVDelete(uint8_t Key);                                     // 删除键
+ErrorStatus myRTC_KVCommit(void);                                     // 原子提交到备份寄存器
+void myRTC_KVFormat(void);                                            // 清空全部键值（需再提交）
+uint8_t myRTC_KVFree(void);                                           // 剩余可用字节数
+
+#endif
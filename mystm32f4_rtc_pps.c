@@ -0,0 +1,329 @@
+/**
+  ******************************************************************************
+  * @file     mystm32f4_rtc_pps.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    秒脉冲（1PPS）驯服 RTC
+  *
+  * @attention
+  *
+  * 用 GPS 等外部秒脉冲持续校正 RTC，不再用 myRTC_SetTime() 粗暴地跳变时间。
+  *
+  * 测量：
+  * - 时间戳来源：PPS 接 RTC 时间戳引脚，边沿到来时硬件锁存 SSR。秒边界处 SS = PREDIV_S，
+  *   相位误差 = PREDIV_S - TSSSR 个 SSR 计数，折算到 ±半秒。分辨率为一个 SSR 计数。
+  * - 外部来源：用户用更细的手段测量（如 84MHz 定时器同时捕获 PPS 和 RTC 的 1Hz 校准输出），
+  *   直接调用 myRTC_PpsInput() 输入纳秒误差。
+  *
+  * 控制（PI）：
+  * - 比例支路 → 相位：相位累加器 += 误差 / 2^KpShift，满一个 SSR 计数就用 myRTC_SynchroShiftConfig() 修正：
+  *   RTC 超前时 SUBFS = k 推迟 k 个计数；落后时 ADD1S + SUBFS = N - k 提前 k 个计数。时间连续，不跳秒。
+  * - 积分支路 → 频率：频率估计 += 误差 / 2^KiShift（每秒的纳秒误差就是 ppb），
+  *   换算成平滑校准量 X = -频率 × 2^20 / 10^9 写入 CALR，变化时才写。
+  *   频率估计限制在平滑校准的范围内（约 -488 ~ +487ppm），防止积分饱和。
+  * - 默认 Kp = 1/2、Ki = 1/16，阻尼比约为 1，几十秒内收敛。
+  * - 误差超过 StepNs（默认 1ms）时直接一次性移相对齐，不更新频率，连续 RTC_PPS_LOCK_COUNT
+  *   次在门限内后进入锁定。StepNs 至少取 2 个 SSR 计数，否则量化误差本身就超过门限，
+  *   永远走步进、频率支路不起作用（PREDIV_S = 255 时一个计数 3.9ms，门限按 7.8ms 计）。
+  *
+  * 精度：
+  * - 修正的最小单位是一个 SSR 计数 = 1/(PREDIV_S+1) 秒：标准配置（PREDIV_S = 255）为 3.9ms，
+  *   PREDIV_A = 0、PREDIV_S = 32767 时为 30.5us，这是 32768Hz LSE 能做到的极限，
+  *   达不到几微秒；节点间对齐误差约为一个计数。
+  * - 平滑校准步长 0.954ppm，剩余的频率误差由比例支路的移相补偿。
+  *
+  * 限制：
+  * - 时间戳来源独占 RTC 时间戳功能，不能与 myRTC_Journal 的时间戳记录同时使用。
+  * - 只校正秒以下的相位；整秒时间由 NMEA 等给出，首次对时用 myRTC_AsyncSetCalendar()。
+  * - 使用参考时钟检测（REFCKON = 1）时不能移相，myRTC_PpsInit() 返回 ERROR。
+  * - 移相和写 CALR 在中断中执行，最多等待约 2 个 RTCCLK。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) RTC 已初始化；需要更细的分辨率时用 PREDIV_A = 0、PREDIV_S = 32767（LSE）。
+    GPS 的 PPS 接时间戳引脚（PC13），并用 NMEA 时间设置好整秒。
+
+(#) 初始化：
+    RTC_PpsInitTypeDef pps;
+    myRTC_PpsStructInit(&pps);
+    myRTC_PpsInit(&pps);
+
+(#) 在 NVIC 中使能 TAMP_STAMP_IRQn，并在中断中调用：
+    void TAMP_STAMP_IRQHandler(void)
+    {
+        myRTC_PpsIRQHandler();
+    }
+
+(#) 外部测量时（pps.Source = RTC_PPS_SRC_EXTERNAL），每秒输入一次：
+    myRTC_PpsInput(measuredNs);
+
+(#) 查看状态：
+    RTC_PpsStatusTypeDef st;
+    myRTC_PpsGetStatus(&st);       // st.State == RTC_PPS_LOCKED 时误差在一个 SSR 计数左右
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_rtc_pps.h"
+#include "mystm32f4_exti.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PPS_NS                1000000000LL
+#define PPS_STEP_MAX          512           /* CALP = 1, CALM = 0 */
+#define PPS_STEP_MIN          (-511)        /* CALP = 0, CALM = 511 */
+#define PPS_FREQ_MAX          487328        /* X = -511 对应的 ppb */
+#define PPS_FREQ_MIN          (-488281)     /* X = +512 对应的 ppb */
+#define PPS_HOLDOVER_MS       2000
+
+/* Private variables ---------------------------------------------------------*/
+static RTC_PpsStatusTypeDef s_status;
+static uint8_t s_kp = 1;
+static uint8_t s_ki = 4;
+static uint32_t s_stepNs = 1000000;
+static uint8_t s_good = 0;
+static int64_t s_phase = 0;                          /* 相位累加器（纳秒），不足一个计数的部分 */
+static uint64_t s_lastMs = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Pps_Ticks(void);
+static ErrorStatus Pps_Shift(int32_t Ticks);
+static void Pps_Calibrate(void);
+
+
+/**
+  * @brief  每秒 SSR 计数个数 N = PREDIV_S + 1。
+  */
+static uint32_t Pps_Ticks(void)
+{
+    return (RTC->PRER & RTC_PRER_PREDIV_S) + 1;
+}
+
+/**
+  * @brief  移相 Ticks 个 SSR 计数：正数推迟（RTC 超前），负数提前（RTC 落后）。
+  * @retval myRTC_SynchroShiftConfig() 的结果，上一次移相未完成等情况下为 ERROR
+  */
+static ErrorStatus Pps_Shift(int32_t Ticks)
+{
+    uint32_t n = Pps_Ticks();
+
+    return (Ticks > 0) ? myRTC_SynchroShiftConfig(RTC_ShiftAdd1S_Reset, (uint32_t)Ticks)
+                       : myRTC_SynchroShiftConfig(RTC_ShiftAdd1S_Set, n - (uint32_t)(-Ticks));
+}
+
+/**
+  * @brief  把频率估计换算为平滑校准量，变化时写入 CALR。
+  */
+static void Pps_Calibrate(void)
+{
+    int64_t x = -(int64_t)s_status.FreqPpb * 1048576;
+
+    x = (x >= 0) ? (x + PPS_NS / 2) / PPS_NS : (x - PPS_NS / 2) / PPS_NS;
+    x = (x > PPS_STEP_MAX) ? PPS_STEP_MAX : (x < PPS_STEP_MIN) ? PPS_STEP_MIN : x;
+
+    if (x != s_status.Steps
+        && myRTC_SmoothCalibConfig(RTC_SmoothCalibPeriod_32sec,
+               (x > 0) ? RTC_SmoothCalibPlusPulses_Set : RTC_SmoothCalibPlusPulses_Reset,
+               (uint32_t)((x > 0) ? PPS_STEP_MAX - x : -x)) == SUCCESS)
+    {
+        s_status.Steps = (int16_t)x;
+    }
+}
+
+/**
+  * @brief  用默认值填充初始化参数。
+  * @param  Init: 初始化参数。
+  * @retval None
+  * @note   默认：时间戳引脚上升沿，Kp = 1/2，Ki = 1/16，步进门限 1ms（不足 2 个 SSR 计数时由 myRTC_PpsInit() 放大）。
+  */
+void myRTC_PpsStructInit(RTC_PpsInitTypeDef* Init)
+{
+    Init->Source = RTC_PPS_SRC_TIMESTAMP;
+    Init->TimeStampEdge = RTC_TimeStampEdge_Rising;
+    Init->KpShift = 1;
+    Init->KiShift = 4;
+    Init->StepNs = 1000000;
+}
+
+/**
+  * @brief  初始化秒脉冲驯服。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成；ERROR: 参考时钟检测已打开，不能移相。
+  *
+  * @note
+  *  - 频率估计从当前 CALR 开始，已有的校准（如 myRTC_Trim 的结果）作为初值保留。
+  *  - StepNs 按当前 PREDIV_S 至少取 2 个 SSR 计数；之后修改 PREDIV_S 需重新调用本函数。
+  *  - 时间戳来源时打开时间戳、时间戳中断和 EXTI21 上升沿中断；用户需在 NVIC 中使能 TAMP_STAMP_IRQn。
+  *  - 小白理解：GPS 每秒拍一下手，RTC 看自己差了多少——差一点就悄悄拨一下（移相），
+  *    总是往一个方向差就调快慢（校准），而不是把表针一下子拧过去。
+  */
+ErrorStatus myRTC_PpsInit(RTC_PpsInitTypeDef* Init)
+{
+    EXTI_InitTypeDef exti;
+    uint32_t calr = RTC->CALR;
+    uint32_t minStep = 2 * (uint32_t)((PPS_NS + Pps_Ticks() - 1) / Pps_Ticks());
+
+    /* 参数检查 */
+    assert_param(Init->Source <= RTC_PPS_SRC_EXTERNAL);
+    assert_param(Init->KpShift < 16 && Init->KiShift < 16);
+
+    s_kp = Init->KpShift;
+    s_ki = Init->KiShift;
+    s_stepNs = (Init->StepNs < minStep) ? minStep : Init->StepNs;
+    s_good = 0;
+    s_phase = 0;
+    s_lastMs = 0;
+
+    s_status.State = RTC_PPS_IDLE;
+    s_status.ErrorNs = 0;
+    s_status.Steps = (int16_t)(((calr & RTC_CALR_CALP) ? PPS_STEP_MAX : 0) - (int32_t)(calr & RTC_CALR_CALM));
+    s_status.FreqPpb = (int32_t)(-(int64_t)s_status.Steps * PPS_NS / 1048576);
+    s_status.Count = 0;
+    s_status.Jumps = 0;
+
+    if (RTC->CR & RTC_CR_REFCKON)
+    {
+        return ERROR;
+    }
+
+    if (Init->Source == RTC_PPS_SRC_TIMESTAMP)
+    {
+        myRTC_ITConfig(RTC_IT_TS, DISABLE);
+        myRTC_ClearFlag(RTC_FLAG_TSF | RTC_FLAG_TSOVF);
+        myRTC_TimeStampCmd(Init->TimeStampEdge, ENABLE);
+
+        /* RTC 时间戳通过 EXTI21 进入 TAMP_STAMP_IRQn */
+        myEXTI_ClearITPendingBit(EXTI_Line21);
+        exti.EXTI_Line = EXTI_Line21;
+        exti.EXTI_Mode = EXTI_Mode_Interrupt;
+        exti.EXTI_Trigger = EXTI_Trigger_Rising;
+        exti.EXTI_LineCmd = ENABLE;
+        myEXTI_Init(&exti);
+
+        myRTC_ITConfig(RTC_IT_TS, ENABLE);
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  输入一次相位误差并更新控制环。
+  * @param  ErrorNs: 秒脉冲时刻 RTC 的秒内相位（纳秒），RTC 超前为正，范围 ±5 亿。
+  * @retval None
+  * @note   每个秒脉冲调用一次；时间戳来源由 myRTC_PpsIRQHandler() 自动调用。
+  *         与 myRTC_PpsIRQHandler() 在同一优先级的上下文中调用。
+  */
+void myRTC_PpsInput(int32_t ErrorNs)
+{
+    uint32_t n = Pps_Ticks();
+    int64_t ticks = 0;
+    int32_t freq = 0;
+
+    s_status.Count++;
+    s_status.ErrorNs = ErrorNs;
+
+    /* 误差过大：一次性移相对齐，不更新频率 */
+    if (ErrorNs > (int32_t)s_stepNs || ErrorNs < -(int32_t)s_stepNs)
+    {
+        ticks = ((int64_t)ErrorNs * n + ((ErrorNs >= 0) ? PPS_NS / 2 : -PPS_NS / 2)) / PPS_NS;
+        if (ticks != 0)
+        {
+            Pps_Shift((int32_t)ticks);
+        }
+        s_phase = 0;
+        s_good = 0;
+        s_status.Jumps++;
+        s_status.State = RTC_PPS_ACQUIRING;
+        s_lastMs = myRTC_GetEpochMs();
+        return;
+    }
+
+    s_good = (s_good < RTC_PPS_LOCK_COUNT) ? (uint8_t)(s_good + 1) : s_good;
+    s_status.State = (s_good >= RTC_PPS_LOCK_COUNT) ? RTC_PPS_LOCKED : RTC_PPS_ACQUIRING;
+
+    /* 积分支路：频率 */
+    freq = s_status.FreqPpb + ErrorNs / (1 << s_ki);
+    s_status.FreqPpb = (freq > PPS_FREQ_MAX) ? PPS_FREQ_MAX : (freq < PPS_FREQ_MIN) ? PPS_FREQ_MIN : freq;
+    Pps_Calibrate();
+
+    /* 比例支路：相位，满一个计数才移相 */
+    s_phase += ErrorNs / (1 << s_kp);
+    ticks = s_phase * n / PPS_NS;
+    if (ticks != 0 && Pps_Shift((int32_t)ticks) == SUCCESS)
+    {
+        /* 移相失败时保留累加器，下一秒连同新误差一起重试 */
+        s_phase -= ticks * PPS_NS / n;
+    }
+
+    s_lastMs = myRTC_GetEpochMs();
+}
+
+/**
+  * @brief  读取同步状态。
+  * @param  Status: 状态。
+  * @retval None
+  * @note   超过 2 秒没有秒脉冲时返回 RTC_PPS_HOLDOVER，此时频率校正保持不变。
+  */
+void myRTC_PpsGetStatus(RTC_PpsStatusTypeDef* Status)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint64_t last = 0;
+
+    __disable_irq();
+    *Status = s_status;
+    last = s_lastMs;
+    __set_PRIMASK(primask);
+
+    if (Status->State != RTC_PPS_IDLE && myRTC_GetEpochMs() - last > PPS_HOLDOVER_MS)
+    {
+        Status->State = RTC_PPS_HOLDOVER;
+    }
+}
+
+/**
+  * @brief  时间戳中断处理。
+  * @param  None
+  * @retval None
+  *
+  * @note
+  *  - 在 TAMP_STAMP_IRQHandler 中调用。
+  *  - 读 TSSSR 得到相位：秒边界处 SS = PREDIV_S，误差 = PREDIV_S - SS 个计数，折算到 ±半秒；
+  *    移相后 SS 可能暂时大于 PREDIV_S，此时误差为负，同样正确。
+  */
+void myRTC_PpsIRQHandler(void)
+{
+    uint32_t n = Pps_Ticks();
+    int32_t ticks = 0;
+
+    myEXTI_ClearITPendingBit(EXTI_Line21);
+
+    if ((RTC->ISR & RTC_FLAG_TSF) == 0)
+    {
+        return;
+    }
+
+    ticks = (int32_t)(n - 1) - (int32_t)myRTC_GetTimeStampSubSecond();
+    myRTC_ClearFlag(RTC_FLAG_TSF);
+    myRTC_ClearFlag(RTC_FLAG_TSOVF);
+
+    ticks = (ticks >= (int32_t)(n / 2)) ? ticks - (int32_t)n : (ticks < -(int32_t)(n / 2)) ? ticks + (int32_t)n : ticks;
+
+    myRTC_PpsInput((int32_t)((int64_t)ticks * PPS_NS / n));
+}
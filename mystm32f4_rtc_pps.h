@@ -0,0 +1,47 @@
+#ifndef mystm32f4_rtc_pps_h
+#define mystm32f4_rtc_pps_h
+
+#include "mystm32f4_rtc.h"
+
+/* 秒脉冲测量来源 */
+#define RTC_PPS_SRC_TIMESTAMP       0    /* PPS 接 RTC 时间戳引脚，由 TSSSR 得到相位 */
+#define RTC_PPS_SRC_EXTERNAL        1    /* 用户自行测量（如定时器捕获），通过 myRTC_PpsInput() 输入 */
+
+/* 同步状态 */
+#define RTC_PPS_IDLE                0    /* 尚未收到秒脉冲 */
+#define RTC_PPS_ACQUIRING           1    /* 相位误差大，按步进对齐 */
+#define RTC_PPS_LOCKED              2    /* 连续 RTC_PPS_LOCK_COUNT 次误差在步进门限内 */
+#define RTC_PPS_HOLDOVER            3    /* 超过 2 秒没有秒脉冲，保持最后的频率校正 */
+
+#ifndef RTC_PPS_LOCK_COUNT
+#define RTC_PPS_LOCK_COUNT          8
+#endif
+
+/* 秒脉冲驯服初始化参数 */
+typedef struct
+{
+    uint8_t  Source;             /* RTC_PPS_SRC_x */
+    uint32_t TimeStampEdge;      /* 时间戳来源的有效边沿 RTC_TimeStampEdge_x */
+    uint8_t  KpShift;            /* 比例增益 1/2^KpShift，作用于相位（SynchroShift） */
+    uint8_t  KiShift;            /* 积分增益 1/2^KiShift，作用于频率（平滑校准） */
+    uint32_t StepNs;             /* 相位误差超过此值（纳秒）时直接步进对齐，不进入控制环；至少按 2 个 SSR 计数生效 */
+} RTC_PpsInitTypeDef;
+
+/* 秒脉冲驯服状态 */
+typedef struct
+{
+    uint8_t  State;              /* RTC_PPS_x */
+    int32_t  ErrorNs;            /* 最近一次相位误差（纳秒），正为 RTC 超前 */
+    int32_t  FreqPpb;            /* 估计的 RTC 频率误差（ppb），正为偏快 */
+    int16_t  Steps;              /* 当前平滑校准量 CALP*512 - CALM */
+    uint32_t Count;              /* 收到的秒脉冲数 */
+    uint32_t Jumps;              /* 步进对齐次数 */
+} RTC_PpsStatusTypeDef;
+
+void myRTC_PpsStructInit(RTC_PpsInitTypeDef* Init);                  // 初始化参数结构体默认值
+ErrorStatus myRTC_PpsInit(RTC_PpsInitTypeDef* Init);                 // 初始化秒脉冲驯服
+void myRTC_PpsInput(int32_t ErrorNs);                                 // 输入一次相位误差（纳秒，RTC 超前为正）并更新控制环
+void myRTC_PpsGetStatus(RTC_PpsStatusTypeDef* Status);                // 读取同步状态
+void myRTC_PpsIRQHandler(void);                                       // 时间戳中断处理，在 TAMP_STAMP_IRQHandler 中调用
+
+#endif
@@ -0,0 +1,380 @@
+/**
+  ******************************************************************************
+  * @file     mystm32f4_rtc_trim.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    以定时器为基准的 RTC 平滑校准自动修正
+  *
+  * @attention
+  *
+  * 用 32 位定时器（TIM2/TIM5，时钟来自 HSE 派生的 APB1）输入捕获 RTC 的频率，
+  * 算出 ppm 误差并用 myRTC_SmoothCalibConfig() 写入 CALP/CALM。
+  *
+  * 测量源：
+  * - LSE：TIM5_CH4 内部重映射到 LSE（myTIM_RemapConfig(TIM5, TIM5_LSE)），不需要接线，
+  *   IC 预分频 8，每秒 4096 个捕获。测的是校准前的原始频率。
+  * - 512Hz：RTC_AF1(PC13) 输出 512Hz 校准信号，飞线接到定时器通道。512Hz 不受平滑校准影响，
+  *   同样测原始频率。
+  * - 1Hz：RTC_AF1 输出 1Hz，受平滑校准影响，测得的是当前校准下的残差，在现有 CALR 上累加修正。
+  *   门限取 32 秒的整数倍，才能覆盖一个完整的平滑校准周期。
+  *
+  * 测量方法（非阻塞）：
+  * - 自举：先连续采 RTC_TRIM_BOOT_CAPTURES 个捕获得到粗略周期（LSE 约 16ms，512Hz 约 125ms）。
+  * - 门限：之后不再处理每个边沿，只在门限到达后读一次最新捕获值 C，
+  *   用粗略周期把 C - Start 换算成整数个周期 n（粗略周期误差约 1ppm，换算不会错一个周期），
+  *   误差 = (n × 预分频 × TimerClk - 标称 × (C - Start)) / (标称 × (C - Start))。
+  *   门限越长越准：84MHz 定时器、10 秒门限时分辨率约 0.002ppm，远小于校准步长 0.954ppm。
+  *   1Hz 源每个门限只有几十个周期，直接用标称周期换算，跳过自举。
+  *
+  * 校正量：
+  *   平滑校准后频率 = f × (1 + X / (2^20 - X))，X = CALP × 512 - CALM，范围 -511 ~ +512。
+  *   要抵消误差 e，X = -e × 2^20 / (1 - e)，四舍五入到整数步。
+  *
+  * 限制：
+  * - 测量期间独占参考定时器；门限须小于 32 位计数器回绕时间（84MHz 时约 51 秒）。
+  * - 512Hz/1Hz 要求 RTCCLK = 32768Hz、PREDIV_A = 127、PREDIV_S = 255 的标准配置。
+  * - 校准精度取决于 HSE 精度（普通晶振 ±10~30ppm，需要更高精度请用 TCXO 或外部 GPS 秒脉冲）。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 系统时钟由 HSE 经 PLL 产生，RTC 已用 LSE 初始化；使能 TIM5 时钟。
+
+(#) 初始化，每小时重校一次：
+    static RTC_TrimTypeDef trim;
+    RTC_TrimInitTypeDef init;
+    myRTC_TrimStructInit(&init);         // TIM5 CH4，LSE 源，10 秒门限
+    init.Interval = 3600;
+    myRTC_TrimInit(&trim, &init);
+    myRTC_TrimStart(&trim);              // 上电先校一次
+
+(#) 主循环里调用：
+    myRTC_TrimTask(&trim);               // 到时间自动开始测量，门限到达后写入校准
+
+(#) 查看结果：myRTC_TrimGetErrorPpb(&trim)、trim.Steps
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_rtc_trim.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TRIM_LSE_HZ           32768
+#define TRIM_STEP_MAX         512           /* CALP = 1, CALM = 0 */
+#define TRIM_STEP_MIN         (-511)        /* CALP = 0, CALM = 511 */
+#define TRIM_NO_BOOT          500           /* 门限内捕获数少于此值时用标称周期换算 */
+#define TRIM_CALR_CALM        0x01FF
+#define TRIM_CALR_CALP        0x8000
+
+/* Private function prototypes -----------------------------------------------*/
+static ErrorStatus Trim_Capture(RTC_TrimTypeDef* Trim, uint32_t* Value);
+static void Trim_Stop(RTC_TrimTypeDef* Trim);
+static void Trim_Apply(RTC_TrimTypeDef* Trim, int32_t Steps);
+
+
+/**
+  * @brief  等待下一个捕获并读取，超过 2 个标称捕获周期没有边沿则返回 ERROR。
+  * @note   读 CCRx 同时清除 CCxIF。
+  */
+static ErrorStatus Trim_Capture(RTC_TrimTypeDef* Trim, uint32_t* Value)
+{
+    uint16_t flag = (uint16_t)(TIM_FLAG_CC1 << (Trim->Channel - 1));
+    uint32_t limit = (uint32_t)((uint64_t)Trim->TimerClk * Trim->Psc * 2 / Trim->Nominal);
+    uint32_t t0 = Trim->TIMx->CNT;
+
+    while (myTIM_GetFlagStatus(Trim->TIMx, flag) == RESET)
+    {
+        if (Trim->TIMx->CNT - t0 > limit)
+        {
+            return ERROR;
+        }
+    }
+    *Value = myTIM_GetCapture(Trim->TIMx, (uint8_t)((Trim->Channel - 1) << 2));
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  停止测量：关定时器和捕获通道，恢复重映射，关闭校准输出。
+  */
+static void Trim_Stop(RTC_TrimTypeDef* Trim)
+{
+    myTIM_Cmd(Trim->TIMx, DISABLE);
+    Trim->TIMx->CCER &= (uint16_t)~(TIM_CCER_CC1E << ((Trim->Channel - 1) * 4));
+
+    (Trim->Source == RTC_TRIM_SRC_LSE) ? myTIM_RemapConfig(Trim->TIMx, TIM5_GPIO) : myRTC_CalibOutputCmd(DISABLE);
+
+    Trim->State = RTC_TRIM_IDLE;
+}
+
+/**
+  * @brief  把校正量写入 CALR：X > 0 用 CALP = 1、CALM = 512 - X，否则 CALP = 0、CALM = -X。
+  */
+static void Trim_Apply(RTC_TrimTypeDef* Trim, int32_t Steps)
+{
+    Steps = (Steps > TRIM_STEP_MAX) ? TRIM_STEP_MAX : (Steps < TRIM_STEP_MIN) ? TRIM_STEP_MIN : Steps;
+
+    if (myRTC_SmoothCalibConfig(RTC_SmoothCalibPeriod_32sec,
+            (Steps > 0) ? RTC_SmoothCalibPlusPulses_Set : RTC_SmoothCalibPlusPulses_Reset,
+            (uint32_t)((Steps > 0) ? TRIM_STEP_MAX - Steps : -Steps)) == SUCCESS)
+    {
+        Trim->Steps = (int16_t)Steps;
+    }
+}
+
+/**
+  * @brief  用默认值填充初始化参数。
+  * @param  Init: 初始化参数。
+  * @retval None
+  * @note   默认：TIM5 CH4，LSE 内部源，10 秒门限，不自动重校。
+  */
+void myRTC_TrimStructInit(RTC_TrimInitTypeDef* Init)
+{
+    Init->TIMx = TIM5;
+    Init->Channel = 4;
+    Init->Source = RTC_TRIM_SRC_LSE;
+    Init->GateSeconds = 10;
+    Init->Interval = 0;
+}
+
+/**
+  * @brief  初始化自动校准。
+  * @param  Trim: 句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成；ERROR: 参数非法（非 32 位定时器、LSE 源不是 TIM5 CH4、门限超过计数器回绕时间）。
+  *
+  * @note
+  *  - 只检查参数并记录当前 CALR，不占用定时器；测量在 myRTC_TrimStart() 时才开始。
+  *  - 512Hz/1Hz 源需要用户事先把 PC13 接到所选通道的引脚并配置好复用功能。
+  *  - 小白理解：拿精度高的 HSE 当尺子，量一量 LSE 走快了还是走慢了，再让 RTC 每 32 秒少数或多数几个脉冲。
+  */
+ErrorStatus myRTC_TrimInit(RTC_TrimTypeDef* Trim, RTC_TrimInitTypeDef* Init)
+{
+    uint32_t calr = RTC->CALR;
+
+    /* 参数检查 */
+    assert_param(Init->TIMx == TIM2 || Init->TIMx == TIM5);
+    assert_param(Init->Source <= RTC_TRIM_SRC_1HZ);
+    assert_param(Init->GateSeconds != 0);
+
+    Trim->TIMx = Init->TIMx;
+    Trim->Channel = Init->Channel;
+    Trim->Source = Init->Source;
+    Trim->TimerClk = myTIM_GetClockFreq(Init->TIMx);
+    Trim->Psc = (Init->Source == RTC_TRIM_SRC_LSE) ? 8 : 1;
+    Trim->Nominal = (Init->Source == RTC_TRIM_SRC_LSE) ? TRIM_LSE_HZ : (Init->Source == RTC_TRIM_SRC_512HZ) ? 512 : 1;
+    Trim->Gate = (uint32_t)((uint64_t)Trim->TimerClk * Init->GateSeconds);
+    Trim->Interval = Init->Interval;
+    Trim->State = RTC_TRIM_IDLE;
+    Trim->NextMs = 0;
+    Trim->ErrorPpb = 0;
+    Trim->Count = 0;
+    Trim->Steps = (int16_t)(((calr & TRIM_CALR_CALP) ? TRIM_STEP_MAX : 0) - (int32_t)(calr & TRIM_CALR_CALM));
+
+    if ((Init->TIMx != TIM2 && Init->TIMx != TIM5) || Init->Channel < 1 || Init->Channel > 4
+        || Init->Source > RTC_TRIM_SRC_1HZ || Init->GateSeconds == 0
+        || (Init->Source == RTC_TRIM_SRC_LSE && (Init->TIMx != TIM5 || Init->Channel != 4))
+        || (uint64_t)Trim->TimerClk * (Init->GateSeconds + 2) > 0xFFFFFFFF)
+    {
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  开始一次测量。
+  * @param  Trim: 句柄。
+  * @retval SUCCESS: 测量已开始；ERROR: 正在测量，或没有捕获到源信号。
+  *
+  * @note
+  *  - 配置参考定时器（不分频、满量程、上升沿捕获），打开测量源，完成自举后立即返回；
+  *    自举期间轮询捕获标志，LSE 约 16ms，512Hz 约 125ms，1Hz 只等一个边沿（最多 1 秒）。
+  *  - 之后反复调用 myRTC_TrimPoll() 或 myRTC_TrimTask()。
+  */
+ErrorStatus myRTC_TrimStart(RTC_TrimTypeDef* Trim)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_ICInitTypeDef ic;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint16_t i = 0;
+
+    if (Trim->State == RTC_TRIM_RUNNING)
+    {
+        return ERROR;
+    }
+
+    /* 测量源 */
+    if (Trim->Source == RTC_TRIM_SRC_LSE)
+    {
+        myTIM_RemapConfig(Trim->TIMx, TIM5_LSE);
+    }
+    else
+    {
+        myRTC_CalibOutputConfig((Trim->Source == RTC_TRIM_SRC_512HZ) ? RTC_CalibOutput_512Hz : RTC_CalibOutput_1Hz);
+        myRTC_CalibOutputCmd(ENABLE);
+    }
+
+    /* 参考定时器：不分频、满量程，上升沿捕获 */
+    myTIM_Cmd(Trim->TIMx, DISABLE);
+    Trim->TIMx->SMCR = 0;
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Period = 0xFFFFFFFF;
+    myTIM_TimeBaseInit(Trim->TIMx, &timeBase);
+    myTIM_ICStructInit(&ic);
+    ic.TIM_Channel = (uint16_t)((Trim->Channel - 1) << 2);
+    ic.TIM_ICPolarity = TIM_ICPolarity_Rising;
+    ic.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    ic.TIM_ICPrescaler = (Trim->Psc == 8) ? TIM_ICPSC_DIV8 : TIM_ICPSC_DIV1;
+    myTIM_ICInit(Trim->TIMx, &ic);
+    myTIM_Cmd(Trim->TIMx, ENABLE);
+
+    /* 丢弃使能前残留的捕获，取第一个新边沿 */
+    myTIM_ClearFlag(Trim->TIMx, (uint16_t)(TIM_FLAG_CC1 << (Trim->Channel - 1)));
+    if (Trim_Capture(Trim, &first) != SUCCESS)
+    {
+        Trim_Stop(Trim);
+        return ERROR;
+    }
+    last = first;
+
+    /* 自举：门限内周期数较多时先测粗略周期，否则直接用标称周期 */
+    if ((uint64_t)Trim->Gate / Trim->TimerClk * Trim->Nominal / Trim->Psc >= TRIM_NO_BOOT)
+    {
+        for (i = 0; i < RTC_TRIM_BOOT_CAPTURES; i++)
+        {
+            if (Trim_Capture(Trim, &last) != SUCCESS)
+            {
+                Trim_Stop(Trim);
+                return ERROR;
+            }
+        }
+        Trim->BootTicks = last - first;
+    }
+    else
+    {
+        /* 84MHz、1Hz 源时为 5.4e9，必须保持 64 位 */
+        Trim->BootTicks = (uint64_t)Trim->TimerClk * Trim->Psc * RTC_TRIM_BOOT_CAPTURES / Trim->Nominal;
+    }
+
+    Trim->Start = last;
+    Trim->StartMs = myRTC_GetEpochMs();
+    Trim->State = RTC_TRIM_RUNNING;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  推进测量。
+  * @param  Trim: 句柄。
+  * @retval 1：本次调用完成了测量并写入了校准；0：未在测量、门限未到，或测量作废。
+  *
+  * @note
+  *  - 门限未到时只读一次 CCRx，几乎没有开销，可以在主循环里频繁调用。
+  *  - 两次调用间隔超过计数器回绕时间（按 RTC 时间判断）时测量作废，等下次重校。
+  *  - 1Hz 源测的是残差，在当前校正量上累加；其余源测原始误差，直接换算校正量。
+  */
+uint8_t myRTC_TrimPoll(RTC_TrimTypeDef* Trim)
+{
+    uint32_t elapsed = 0;
+    uint64_t n = 0;
+    int64_t num = 0;
+    int64_t den = 0;
+    int64_t steps = 0;
+
+    if (Trim->State != RTC_TRIM_RUNNING)
+    {
+        return 0;
+    }
+
+    /* 计数器回绕后差值不再可信 */
+    if (myRTC_GetEpochMs() - Trim->StartMs > (0xFFFFFFFF / Trim->TimerClk) * 1000 - 1000)
+    {
+        Trim_Stop(Trim);
+        Trim->NextMs = myRTC_GetEpochMs() + (uint64_t)Trim->Interval * 1000;
+        return 0;
+    }
+
+    elapsed = myTIM_GetCapture(Trim->TIMx, (uint8_t)((Trim->Channel - 1) << 2)) - Trim->Start;
+    if (elapsed < Trim->Gate)
+    {
+        return 0;
+    }
+    Trim_Stop(Trim);
+
+    /* 捕获个数 n，四舍五入 */
+    n = ((uint64_t)elapsed * RTC_TRIM_BOOT_CAPTURES * 2 + Trim->BootTicks) / (Trim->BootTicks * 2);
+
+    num = (int64_t)(n * Trim->Psc * Trim->TimerClk) - (int64_t)Trim->Nominal * elapsed;
+    den = (int64_t)Trim->Nominal * elapsed;
+
+    /* 超过 ±1% 说明源不对（接线、配置），不写入 */
+    if (num > den / 100 || num < -den / 100)
+    {
+        Trim->NextMs = myRTC_GetEpochMs() + (uint64_t)Trim->Interval * 1000;
+        return 0;
+    }
+
+    Trim->ErrorPpb = (int32_t)(num * 1000000 / (den / 1000));
+
+    /* X = -e × 2^20 / (1 - e)，e = num / den，四舍五入 */
+    steps = -num * 1048576;
+    steps = (steps >= 0) ? (steps + (den - num) / 2) / (den - num) : (steps - (den - num) / 2) / (den - num);
+    steps += (Trim->Source == RTC_TRIM_SRC_1HZ) ? Trim->Steps : 0;
+
+    Trim_Apply(Trim, (int32_t)steps);
+    Trim->Count++;
+    Trim->NextMs = myRTC_GetEpochMs() + (uint64_t)Trim->Interval * 1000;
+
+    return 1;
+}
+
+/**
+  * @brief  周期重校任务。
+  * @param  Trim: 句柄。
+  * @retval None
+  * @note   在主循环中调用：测量中则推进测量；空闲且 Interval 非零、到了重校时间则开始新的测量。
+  *         重校间隔按 RTC 时间计，温度变化快的场合可以缩短间隔。
+  */
+void myRTC_TrimTask(RTC_TrimTypeDef* Trim)
+{
+    if (Trim->State == RTC_TRIM_RUNNING)
+    {
+        (void)myRTC_TrimPoll(Trim);
+    }
+    else if (Trim->Interval != 0 && myRTC_GetEpochMs() >= Trim->NextMs)
+    {
+        if (myRTC_TrimStart(Trim) != SUCCESS)
+        {
+            Trim->NextMs = myRTC_GetEpochMs() + (uint64_t)Trim->Interval * 1000;
+        }
+    }
+}
+
+/**
+  * @brief  最近一次测得的频率误差。
+  * @param  Trim: 句柄。
+  * @retval 误差（ppb，1ppm = 1000ppb），正值表示偏快；1Hz 源为校准后的残差。
+  */
+int32_t myRTC_TrimGetErrorPpb(RTC_TrimTypeDef* Trim)
+{
+    return Trim->ErrorPpb;
+}
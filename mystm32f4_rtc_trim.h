@@ -0,0 +1,59 @@
+#ifndef mystm32f4_rtc_trim_h
+#define mystm32f4_rtc_trim_h
+
+#include "mystm32f4_rtc.h"
+#include "mystm32f4_tim.h"
+
+/* 测量源 */
+#define RTC_TRIM_SRC_LSE            0    /* LSE 经 TIM5_CH4 内部重映射，不需要接线，测原始频率 */
+#define RTC_TRIM_SRC_512HZ          1    /* RTC_AF1(PC13) 512Hz 校准输出接到定时器输入，测原始频率 */
+#define RTC_TRIM_SRC_1HZ            2    /* RTC_AF1(PC13) 1Hz 校准输出接到定时器输入，测校准后的残差 */
+
+/* 状态 */
+#define RTC_TRIM_IDLE               0
+#define RTC_TRIM_RUNNING            1
+
+/* 自举阶段采集的捕获个数，用来解算长门限内的周期数 */
+#ifndef RTC_TRIM_BOOT_CAPTURES
+#define RTC_TRIM_BOOT_CAPTURES      64
+#endif
+
+/* 自动校准初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;           /* 32 位参考定时器 TIM2 / TIM5；LSE 源固定为 TIM5 */
+    uint8_t  Channel;            /* 捕获通道 1~4；LSE 源固定为 4 */
+    uint8_t  Source;             /* RTC_TRIM_SRC_x */
+    uint8_t  GateSeconds;        /* 测量门限（秒），1Hz 源取 32 的倍数以覆盖完整校准周期 */
+    uint32_t Interval;           /* 周期重校间隔（秒），0 表示只在调用 myRTC_TrimStart() 时校准 */
+} RTC_TrimInitTypeDef;
+
+/* 自动校准句柄，由调用者分配 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;
+    uint8_t  Channel;
+    uint8_t  Source;
+    uint8_t  Psc;                /* 输入捕获预分频：每个捕获对应的源周期数 */
+    uint8_t  State;              /* RTC_TRIM_IDLE / RTC_TRIM_RUNNING */
+    uint32_t TimerClk;           /* 参考定时器计数频率（Hz），来自 HSE 派生的 APB 时钟 */
+    uint32_t Nominal;            /* 源的标称频率（Hz） */
+    uint32_t Gate;               /* 测量门限（定时器节拍） */
+    uint32_t Interval;           /* 周期重校间隔（秒） */
+    uint32_t Start;              /* 门限起点的捕获值 */
+    uint64_t BootTicks;          /* 自举阶段 RTC_TRIM_BOOT_CAPTURES 个捕获的总节拍（1Hz 源按标称值算会超过 32 位） */
+    uint64_t StartMs;            /* 门限起点的 RTC 时间（Unix 毫秒），用于超时判断 */
+    uint64_t NextMs;             /* 下一次重校的 RTC 时间（Unix 毫秒） */
+    int32_t  ErrorPpb;           /* 最近一次测得的频率误差（ppb，正为偏快） */
+    int16_t  Steps;              /* 当前写入的校正量 CALP*512 - CALM（每步约 0.954ppm） */
+    uint32_t Count;              /* 完成的校准次数 */
+} RTC_TrimTypeDef;
+
+void myRTC_TrimStructInit(RTC_TrimInitTypeDef* Init);                 // 初始化参数结构体默认值
+ErrorStatus myRTC_TrimInit(RTC_TrimTypeDef* Trim, RTC_TrimInitTypeDef* Init); // 初始化自动校准
+ErrorStatus myRTC_TrimStart(RTC_TrimTypeDef* Trim);                  // 开始一次测量（非阻塞，自举约 16~130ms）
+uint8_t myRTC_TrimPoll(RTC_TrimTypeDef* Trim);                        // 推进测量，完成并写入校准时返回 1
+void myRTC_TrimTask(RTC_TrimTypeDef* Trim);                           // 周期重校任务，在主循环中调用
+int32_t myRTC_TrimGetErrorPpb(RTC_TrimTypeDef* Trim);                 // 最近一次测得的频率误差（ppb）
+
+#endif
@@ -745,6 +745,50 @@ void myTIM_Cmd(TIM_TypeDef* TIMx, FunctionalState NewState)
         : (TIMx->CR1 &= (uint16_t)~TIM_CR1_CEN); // DISABLE: 停止计数器
 }
 
+/**
+  * @brief  获取指定 TIMx 的内核时钟频率 TIMxCLK（预分频器之前的时钟）。
+  * @param  TIMx: 指定的定时器外设，范围 TIM1~TIM14。
+  * @retval TIMxCLK 频率，单位 Hz
+  *
+  * @note
+  *  - TIM1/TIM8/TIM9/TIM10/TIM11 挂在 APB2，其余定时器挂在 APB1。
+  *  - APB 预分频 = 1 时 TIMxCLK = PCLKx，否则 TIMxCLK = 2 × PCLKx。
+  *  - 带 TIMPRE 位的型号（F42x/F43x/F446 等）在 TIMPRE = 1 时，
+  *    TIMxCLK = min(HCLK, 4 × PCLKx)。
+  *  - 小白理解：PSC/ARR 的换算都以这个频率为基准，
+  *    不要直接拿 PCLK1/PCLK2 去算，否则分频后会差一倍。
+  *
+  * @example
+  *  uint32_t f = myTIM_GetClockFreq(TIM2);     // 168MHz 主频、APB1 四分频时为 84MHz
+  *  TIM2->PSC = f / 1000000 - 1;               // 计数器 1MHz
+  */
+uint32_t myTIM_GetClockFreq(TIM_TypeDef* TIMx)
+{
+    RCC_ClocksTypeDef clocks;
+    uint32_t pclk = 0;
+    uint32_t divided = 0;
+    uint8_t isAPB2 = 0;
+
+    /* 检查参数有效性 */
+    assert_param(IS_TIM_ALL_PERIPH(TIMx));
+
+    RCC_GetClocksFreq(&clocks);
+
+    /* 判断所在总线，取对应的 PCLK 和 APB 预分频最高位（最高位为 1 表示分频 ≥ 2） */
+    isAPB2 = (TIMx == TIM1 || TIMx == TIM8 || TIMx == TIM9 || TIMx == TIM10 || TIMx == TIM11);
+    pclk = isAPB2 ? clocks.PCLK2_Frequency : clocks.PCLK1_Frequency;
+    divided = isAPB2 ? (RCC->CFGR & RCC_CFGR_PPRE2_2) : (RCC->CFGR & RCC_CFGR_PPRE1_2);
+
+#if defined(RCC_DCKCFGR_TIMPRE)
+    if (RCC->DCKCFGR & RCC_DCKCFGR_TIMPRE)
+    {
+        return (pclk * 4 > clocks.HCLK_Frequency) ? clocks.HCLK_Frequency : pclk * 4;
+    }
+#endif
+
+    return divided ? pclk * 2 : pclk;
+}
+
 /** @defgroup TIM_Group2 输出比较（Output Compare）管理函数
   * @brief    定时器输出比较管理函数
   *
@@ -1493,8 +1537,8 @@ void myTIM_OCClearConfig(TIM_TypeDef* TIMx, uint8_t Channel, uint16_t TIM_OCClea
 
     tmp = *CCMR;
 
-    // 清除对应通道的 OCxCE 位
-    tmp &= (uint16_t)~(0x1 << shift);
+    // 清除对应通道的 OCxCE 位（bit7 / bit15）
+    tmp &= (uint16_t)~(TIM_CCMR1_OC1CE << shift);
 
     // 设置新的清零状态
     tmp |= (TIM_OCClear << shift);
@@ -1673,7 +1717,7 @@ void myTIM_ICInit(TIM_TypeDef* TIMx, TIM_ICInitTypeDef* TIM_ICInitStruct)
 {
 
     /* 定义指向通道配置函数的指针 */
-    void (*TI_Config[4])(TIM_TypeDef*, uint16_t, uint16_t, uint8_t) = {
+    void (*TI_Config[4])(TIM_TypeDef*, uint16_t, uint16_t, uint16_t) = {
         TI1_Config,  /* 通道1 */
         TI2_Config,  /* 通道2 */
         TI3_Config,  /* 通道3 */
@@ -1983,6 +2027,41 @@ void myTIM_BDTRStructInit(TIM_BDTRInitTypeDef* TIM_BDTRInitStruct)
     TIM_BDTRInitStruct->TIM_AutomaticOutput = TIM_AutomaticOutput_Disable;
 }
 
+/**
+  * @brief  把以纳秒表示的死区时间换算为 BDTR.DTG 编码。
+  * @param  TIMx: 高级定时器，取值 TIM1 或 TIM8（时钟分频 CKD 需已配置）。
+  * @param  DeadTimeNs: 期望的死区时间，单位 ns。
+  * @retval DTG 编码，可直接赋给 TIM_BDTRInitTypeDef.TIM_DeadTime
+  *
+  * @note
+  *  - tDTS = CKD / TIMxCLK，DTG 分四段，步长越来越粗：
+  *      0xx xxxxx : DT = DTG[7:0]            * tDTS   （0 ~ 127）
+  *      10x xxxxx : DT = (64 + DTG[5:0]) * 2 * tDTS   （128 ~ 254）
+  *      110 xxxxx : DT = (32 + DTG[4:0]) * 8 * tDTS   （256 ~ 504）
+  *      111 xxxxx : DT = (32 + DTG[4:0]) * 16 * tDTS  （512 ~ 1008）
+  *  - 每一步都向上取整，得到的死区不小于要求值；超出范围时返回 0xFF（最大死区）。
+  *  - 小白理解：死区是上下管切换时“两个都关”的安全时间，宁长勿短。
+  *
+  * @example
+  *  bdtr.TIM_DeadTime = myTIM_DeadTimeFromNs(TIM1, 500);   // 500ns 死区
+  */
+uint8_t myTIM_DeadTimeFromNs(TIM_TypeDef* TIMx, uint32_t DeadTimeNs)
+{
+    uint32_t fdts = 0;
+    uint32_t ticks = 0;
+
+    assert_param(IS_TIM_LIST4_PERIPH(TIMx));
+
+    /* CKD: 00 -> 1 分频, 01 -> 2 分频, 10 -> 4 分频 */
+    fdts = myTIM_GetClockFreq(TIMx) >> ((TIMx->CR1 & TIM_CR1_CKD) >> 8);
+    ticks = (uint32_t)(((uint64_t)DeadTimeNs * fdts + 999999999) / 1000000000);
+
+    return ticks <= 127  ? (uint8_t)ticks :
+           ticks <= 254  ? (uint8_t)(0x80 | ((ticks + 1) / 2 - 64)) :
+           ticks <= 504  ? (uint8_t)(0xC0 | ((ticks + 7) / 8 - 32)) :
+           ticks <= 1008 ? (uint8_t)(0xE0 | ((ticks + 15) / 16 - 32)) : 0xFF;
+}
+
 
 /**
   * @brief  控制高级定时器（TIM1 或 TIM8）主输出开关（MOE）。
@@ -2314,6 +2393,115 @@ void myTIM_SelectCCDMA(TIM_TypeDef* TIMx, FunctionalState NewState)
     NewState != DISABLE ? (TIMx->CR2 |= TIM_CR2_CCDS) : (TIMx->CR2 &= (uint16_t)(~TIM_CR2_CCDS));
 }
 
+/**
+  * @brief  查询 TIMx 的 DMA 请求映射到哪个 DMA 数据流和通道。
+  * @param  TIMx: 指向 TIM 外设的指针，x 可以为 1~8。
+  * @param  TIM_DMASource: 单个 DMA 请求源 TIM_DMA_Update / CC1~CC4 / COM / Trigger。
+  * @param  Alt: 同一请求有多个可选数据流时的序号，0 为第一个。
+  * @param  Stream: 输出数据流，例如 DMA1_Stream6。
+  * @param  Channel: 输出通道选择，DMA_Channel_x，可直接写入 DMA_SxCR.CHSEL。
+  * @retval SUCCESS: 找到；ERROR: 该请求没有第 Alt 个映射
+  *
+  * @note
+  *  - 映射为芯片固定布线（参考手册 DMA1/DMA2 请求映射表），本函数只查表。
+  *  - 一个数据流同一时刻只能服务一个请求，多个模块共用 DMA 时用 Alt 错开。
+  *  - 小白理解：每个定时器事件只连到固定的几条 DMA“管道”上，这里告诉你是哪一条。
+  *
+  * @example
+  *  DMA_Stream_TypeDef* stream;
+  *  uint32_t channel;
+  *  myTIM_GetDMARequest(TIM4, TIM_DMA_Update, 0, &stream, &channel);  // DMA1_Stream6, DMA_Channel_2
+  */
+ErrorStatus myTIM_GetDMARequest(TIM_TypeDef* TIMx, uint16_t TIM_DMASource, uint8_t Alt,
+    DMA_Stream_TypeDef** Stream, uint32_t* Channel)
+{
+    /* 每行：定时器、该数据流服务的请求（可组合）、数据流、通道号 */
+    const struct {
+        TIM_TypeDef* TIMx;
+        uint16_t Sources;
+        DMA_Stream_TypeDef* Stream;
+        uint8_t Channel;
+    } dmaMap[] = {
+        { TIM1, TIM_DMA_Update,                               DMA2_Stream5, 6 },
+        { TIM1, TIM_DMA_CC1,                                  DMA2_Stream1, 6 },
+        { TIM1, TIM_DMA_CC1,                                  DMA2_Stream3, 6 },
+        { TIM1, TIM_DMA_CC2,                                  DMA2_Stream2, 6 },
+        { TIM1, TIM_DMA_CC3,                                  DMA2_Stream6, 6 },
+        { TIM1, TIM_DMA_CC4 | TIM_DMA_Trigger | TIM_DMA_COM,  DMA2_Stream4, 6 },
+        { TIM1, TIM_DMA_Trigger,                              DMA2_Stream0, 6 },
+        { TIM8, TIM_DMA_Update,                               DMA2_Stream1, 7 },
+        { TIM8, TIM_DMA_CC1,                                  DMA2_Stream2, 7 },
+        { TIM8, TIM_DMA_CC2,                                  DMA2_Stream3, 7 },
+        { TIM8, TIM_DMA_CC3,                                  DMA2_Stream4, 7 },
+        { TIM8, TIM_DMA_CC4 | TIM_DMA_Trigger | TIM_DMA_COM,  DMA2_Stream7, 7 },
+        { TIM2, TIM_DMA_Update | TIM_DMA_CC3,                 DMA1_Stream1, 3 },
+        { TIM2, TIM_DMA_CC1,                                  DMA1_Stream5, 3 },
+        { TIM2, TIM_DMA_CC2 | TIM_DMA_CC4,                    DMA1_Stream6, 3 },
+        { TIM2, TIM_DMA_Update | TIM_DMA_CC4,                 DMA1_Stream7, 3 },
+        { TIM3, TIM_DMA_Update | TIM_DMA_CC4,                 DMA1_Stream2, 5 },
+        { TIM3, TIM_DMA_CC1 | TIM_DMA_Trigger,                DMA1_Stream4, 5 },
+        { TIM3, TIM_DMA_CC2,                                  DMA1_Stream5, 5 },
+        { TIM3, TIM_DMA_CC3,                                  DMA1_Stream7, 5 },
+        { TIM4, TIM_DMA_CC1,                                  DMA1_Stream0, 2 },
+        { TIM4, TIM_DMA_CC2,                                  DMA1_Stream3, 2 },
+        { TIM4, TIM_DMA_Update,                               DMA1_Stream6, 2 },
+        { TIM4, TIM_DMA_CC3,                                  DMA1_Stream7, 2 },
+        { TIM5, TIM_DMA_Update | TIM_DMA_CC3,                 DMA1_Stream0, 6 },
+        { TIM5, TIM_DMA_CC4 | TIM_DMA_Trigger,                DMA1_Stream1, 6 },
+        { TIM5, TIM_DMA_CC1,                                  DMA1_Stream2, 6 },
+        { TIM5, TIM_DMA_CC4 | TIM_DMA_Trigger,                DMA1_Stream3, 6 },
+        { TIM5, TIM_DMA_CC2,                                  DMA1_Stream4, 6 },
+        { TIM5, TIM_DMA_Update,                               DMA1_Stream6, 6 },
+        { TIM6, TIM_DMA_Update,                               DMA1_Stream1, 7 },
+        { TIM7, TIM_DMA_Update,                               DMA1_Stream2, 1 },
+        { TIM7, TIM_DMA_Update,                               DMA1_Stream4, 1 },
+    };
+    uint8_t i = 0;
+
+    for (i = 0; i < sizeof(dmaMap) / sizeof(dmaMap[0]); i++)
+    {
+        if (dmaMap[i].TIMx == TIMx && (dmaMap[i].Sources & TIM_DMASource) && Alt-- == 0)
+        {
+            *Stream = dmaMap[i].Stream;
+            *Channel = (uint32_t)dmaMap[i].Channel << 25;   // DMA_SxCR.CHSEL 位于 bit25~27
+            return SUCCESS;
+        }
+    }
+
+    return ERROR;
+}
+
+/**
+  * @brief  清除指定 DMA 数据流的全部中断标志（TC/HT/TE/DME/FE）。
+  * @param  Stream: DMA1_Stream0~7 或 DMA2_Stream0~7。
+  * @retval 无
+  * @note   数据流 0~3 的标志在 LIFCR，4~7 在 HIFCR，组内偏移依次为 0/6/16/22。
+  *         配合 myTIM_GetDMARequest() 使用，重新启动数据流前必须清除上一次的标志。
+  */
+void myTIM_DMAClearFlags(DMA_Stream_TypeDef* Stream)
+{
+    const uint8_t shift[4] = { 0, 6, 16, 22 };
+    DMA_TypeDef* DMAx = (Stream < DMA2_Stream0) ? DMA1 : DMA2;
+    uint8_t index = (uint8_t)(Stream - ((Stream < DMA2_Stream0) ? DMA1_Stream0 : DMA2_Stream0));
+
+    index < 4 ? (DMAx->LIFCR = (uint32_t)0x3D << shift[index])
+        : (DMAx->HIFCR = (uint32_t)0x3D << shift[index - 4]);
+}
+
+/**
+  * @brief  读取指定 DMA 数据流的中断标志。
+  * @param  Stream: DMA1_Stream0~7 或 DMA2_Stream0~7。
+  * @retval 标志位，已移到最低位：bit5 TCIF、bit4 HTIF、bit3 TEIF、bit2 DMEIF、bit0 FEIF
+  */
+uint8_t myTIM_DMAGetFlags(DMA_Stream_TypeDef* Stream)
+{
+    const uint8_t shift[4] = { 0, 6, 16, 22 };
+    DMA_TypeDef* DMAx = (Stream < DMA2_Stream0) ? DMA1 : DMA2;
+    uint8_t index = (uint8_t)(Stream - ((Stream < DMA2_Stream0) ? DMA1_Stream0 : DMA2_Stream0));
+
+    return (uint8_t)(((index < 4 ? DMAx->LISR : DMAx->HISR) >> shift[index & 3]) & 0x3D);
+}
+
 /**
   * @defgroup TIM_Group6 定时器时钟管理函数
   * @brief    定时器时钟管理相关函数
@@ -2584,6 +2772,57 @@ void myTIM_SelectInputTrigger(TIM_TypeDef* TIMx, uint16_t TIM_InputTriggerSource
     TIMx->SMCR = tmpsmcr;                        // 写回寄存器
 }
 
+/**
+  * @brief  查询从定时器上连接到指定主定时器 TRGO 的内部触发输入 ITRx
+  * @param  Slave: 从定时器，x 可以为 1,2,3,4,5,8,9,12
+  * @param  Master: 主定时器
+  * @retval TIM_TS_ITR0~TIM_TS_ITR3；两者之间没有内部连接时返回 0xFFFF
+  *
+  * @note
+  *  - 连接关系为芯片固定布线（参考手册“TIMx 内部触发连接”表），本函数只查表。
+  *  - TIM2 的 ITR1 默认接 TIM8 TRGO，重映射到以太网/USB SOF 后不再适用。
+  *  - 小白理解：定时器之间有几根固定的“内部导线”，这里告诉你该接哪一根。
+  *
+  * @example
+  *  myTIM_SelectInputTrigger(TIM1, myTIM_GetInternalTrigger(TIM1, TIM3)); // TIM1 由 TIM3 触发
+  */
+uint16_t myTIM_GetInternalTrigger(TIM_TypeDef* Slave, TIM_TypeDef* Master)
+{
+    /* 每行：从定时器及其 ITR0~ITR3 对应的主定时器 */
+    const struct {
+        TIM_TypeDef* Slave;
+        TIM_TypeDef* Master[4];
+    } itrMap[] = {
+        { TIM1,  { TIM5, TIM2,  TIM3,  TIM4  } },
+        { TIM8,  { TIM1, TIM2,  TIM4,  TIM5  } },
+        { TIM2,  { TIM1, TIM8,  TIM3,  TIM4  } },
+        { TIM3,  { TIM1, TIM2,  TIM5,  TIM4  } },
+        { TIM4,  { TIM1, TIM2,  TIM3,  TIM8  } },
+        { TIM5,  { TIM2, TIM3,  TIM4,  TIM8  } },
+        { TIM9,  { TIM2, TIM3,  TIM10, TIM11 } },
+        { TIM12, { TIM4, TIM5,  TIM13, TIM14 } },
+    };
+    uint8_t i = 0;
+    uint8_t itr = 0;
+
+    for (i = 0; i < sizeof(itrMap) / sizeof(itrMap[0]); i++)
+    {
+        if (itrMap[i].Slave != Slave)
+        {
+            continue;
+        }
+        for (itr = 0; itr < 4; itr++)
+        {
+            if (itrMap[i].Master[itr] == Master)
+            {
+                return (uint16_t)(TIM_TS_ITR0 + (itr << 4));   // ITR0~ITR3 = 0x00/0x10/0x20/0x30
+            }
+        }
+    }
+
+    return 0xFFFF;
+}
+
 /**
   * @brief  选择定时器的触发输出模式（Trigger Output，TRGO）
   * @param  TIMx: 指向 TIM 外设的指针，x 可以为 1~8
@@ -2923,3 +3162,31 @@ static void myTIx_Config(TIM_TypeDef* TIMx, uint8_t channel,
         TIMx->CCER = tmpccer;
     }
 }
+
+/**
+  * @brief  配置通道 1~4 输入捕获的极性、输入选择和滤波器。
+  * @note   私有函数原型在文件开头声明，统一转交 myTIx_Config() 处理。
+  */
+static void TI1_Config(TIM_TypeDef* TIMx, uint16_t TIM_ICPolarity, uint16_t TIM_ICSelection,
+    uint16_t TIM_ICFilter)
+{
+    myTIx_Config(TIMx, 1, TIM_ICPolarity, TIM_ICSelection, TIM_ICFilter);
+}
+
+static void TI2_Config(TIM_TypeDef* TIMx, uint16_t TIM_ICPolarity, uint16_t TIM_ICSelection,
+    uint16_t TIM_ICFilter)
+{
+    myTIx_Config(TIMx, 2, TIM_ICPolarity, TIM_ICSelection, TIM_ICFilter);
+}
+
+static void TI3_Config(TIM_TypeDef* TIMx, uint16_t TIM_ICPolarity, uint16_t TIM_ICSelection,
+    uint16_t TIM_ICFilter)
+{
+    myTIx_Config(TIMx, 3, TIM_ICPolarity, TIM_ICSelection, TIM_ICFilter);
+}
+
+static void TI4_Config(TIM_TypeDef* TIMx, uint16_t TIM_ICPolarity, uint16_t TIM_ICSelection,
+    uint16_t TIM_ICFilter)
+{
+    myTIx_Config(TIMx, 4, TIM_ICPolarity, TIM_ICSelection, TIM_ICFilter);
+}
@@ -18,6 +18,7 @@ void myTIM_ARRPreloadConfig(TIM_TypeDef* TIMx, FunctionalState NewState);    //
 void myTIM_SelectOnePulseMode(TIM_TypeDef* TIMx, uint16_t TIM_OPMode);       // 配置单脉冲模式
 void myTIM_SetClockDivision(TIM_TypeDef* TIMx, uint16_t TIM_CKD);            // 配置时钟分频
 void myTIM_Cmd(TIM_TypeDef* TIMx, FunctionalState NewState);                 // 启动或停止定时器
+uint32_t myTIM_GetClockFreq(TIM_TypeDef* TIMx);                              // 获取定时器内核时钟 TIMxCLK
 
 void myTIM_OCxInit(TIM_TypeDef* TIMx, uint8_t channel, TIM_OCInitTypeDef* TIM_OCInitStruct); // 配置指定通道输出比较
 void myTIM_OC2Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct); // 配置通道 2
@@ -41,6 +42,7 @@ void myTIM_SetICPrescaler(TIM_TypeDef* TIMx, uint8_t Channel, uint16_t Prescaler
 
 void myTIM_BDTRConfig(TIM_TypeDef* TIMx, TIM_BDTRInitTypeDef* TIM_BDTRInitStruct);   // 配置死区和刹车功能
 void myTIM_BDTRStructInit(TIM_BDTRInitTypeDef* TIM_BDTRInitStruct);                  // 初始化 BDTR 结构体默认值
+uint8_t myTIM_DeadTimeFromNs(TIM_TypeDef* TIMx, uint32_t DeadTimeNs);               // 死区纳秒换算为 DTG 编码
 void myTIM_CtrlPWMOutputs(TIM_TypeDef* TIMx, FunctionalState NewState);             // 控制 PWM 输出使能
 void myTIM_SelectCOM(TIM_TypeDef* TIMx, FunctionalState NewState);                  // 配置通用输出使能
 void myTIM_CCPreloadControl(TIM_TypeDef* TIMx, FunctionalState NewState);           // 配置捕获/比较预装载
@@ -54,6 +56,10 @@ void myTIM_ClearITPendingBit(TIM_TypeDef* TIMx, uint16_t TIM_IT);
 ITStatus myTIM_GetITStatus(TIM_TypeDef* TIMx, uint16_t TIM_IT);                      // 获取中断状态
 void myTIM_ClearFlag(TIM_TypeDef* TIMx, uint16_t TIM_FLAG);                          // 清标志位
 void myTIM_SelectCCDMA(TIM_TypeDef* TIMx, FunctionalState NewState);                 // 配置捕获/比较 DMA 请求
+ErrorStatus myTIM_GetDMARequest(TIM_TypeDef* TIMx, uint16_t TIM_DMASource, uint8_t Alt, // 查询 DMA 请求对应的数据流和通道
+    DMA_Stream_TypeDef** Stream, uint32_t* Channel);
+void myTIM_DMAClearFlags(DMA_Stream_TypeDef* Stream);                                // 清除 DMA 数据流全部中断标志
+uint8_t myTIM_DMAGetFlags(DMA_Stream_TypeDef* Stream);                               // 读取 DMA 数据流中断标志
 
 void myTIM_TIxExternalClockConfig(TIM_TypeDef* TIMx, uint16_t TIM_TIxExternalCLKSource, // 外部时钟模式配置
     uint16_t TIM_ICPolarity, uint16_t ICFilter);
@@ -70,6 +76,7 @@ void myTIM_SelectMasterSlaveMode(TIM_TypeDef* TIMx, uint16_t TIM_MasterSlaveMode
 void myTIM_SelectSlaveMode(TIM_TypeDef* TIMx, uint16_t TIM_SlaveMode);                 // 配置从模式
 void myTIM_SelectOutputTrigger(TIM_TypeDef* TIMx, uint16_t TIM_TRGOSource);            // 配置触发输出源
 void myTIM_SelectInputTrigger(TIM_TypeDef* TIMx, uint16_t TIM_InputTriggerSource);     // 配置输入触发源
+uint16_t myTIM_GetInternalTrigger(TIM_TypeDef* Slave, TIM_TypeDef* Master);       // 查询主从定时器间的内部触发 ITRx
 void myTIM_SelectHallSensor(TIM_TypeDef* TIMx, FunctionalState NewState);             // 使能/禁止霍尔传感器接口
 void TIM_EncoderInterfaceConfig(TIM_TypeDef* TIMx, uint16_t TIM_EncoderMode,          // 配置编码器接口
     uint16_t TIM_IC1Polarity, uint16_t TIM_IC2Polarity);
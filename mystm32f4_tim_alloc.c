@@ -0,0 +1,475 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_alloc.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    按能力分配定时器和通道的运行时资源管理
+  *
+  * @attention
+  *
+  * 多个独立模块各自写死 TIMx 时，不同产品组合下容易撞车。本文件让模块按需要的
+  * 能力申请定时器，由分配器选择：
+  *
+  * - 每个定时器有一组能力位（32 位、互补输出、DMA 突发、编码器、霍尔……）和通道数。
+  * - 整定时器分配（myTIM_Alloc）采用最佳匹配：在满足要求的空闲定时器中选多余能力
+  *   最少、其次多余通道最少的一个，把 TIM1/TIM8、TIM2/TIM5 这类稀缺资源留给真正需要的模块。
+  * - 通道分配（myTIM_AllocChannel）：同一定时器的通道共用计数器，只有时基（TimeBase，
+  *   由调用者约定，例如计数频率与周期的组合）相同的申请才会放到同一个定时器上。
+  * - 每个资源记录所有者编号，可按定时器、通道或所有者释放。定时器上最后一个资源
+  *   释放时调用 myTIM_DeInit() 复位全部寄存器并关闭时钟；分配时自动打开时钟。
+  *
+  * 能力表按 STM32F405/407/415/417/427/429 填写。芯片上没有的定时器（如 F401 的
+  * TIM6/7/8/12/13/14）请在启动时用 myTIM_Reserve(TIMx, TIM_OWNER_SYSTEM) 屏蔽。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 启动时屏蔽固定占用的定时器（例如 HAL 时基）：
+    myTIM_Reserve(TIM6, TIM_OWNER_SYSTEM);
+
+(#) 模块按能力申请整个定时器：
+    #define OWNER_MOTOR  1
+    TIM_TypeDef* pwm = myTIM_Alloc(TIM_CAP_COMPLEMENTARY | TIM_CAP_BREAK, 3, OWNER_MOTOR);
+    TIM_TypeDef* enc = myTIM_Alloc(TIM_CAP_ENCODER, 2, OWNER_MOTOR);
+
+(#) 或者申请单个通道（同一时基的通道共享定时器）：
+    TIM_TypeDef* tim;
+    uint8_t ch;
+    myTIM_AllocChannel(0, 1000, OWNER_LED, &tim, &ch);    // 例如约定 1000 = 1kHz PWM
+
+(#) 模块停止时释放：
+    myTIM_FreeOwner(OWNER_MOTOR);
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_alloc.h"
+#include "stm32f4xx_rcc.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ALLOC_NONE            0xFF
+#define ALLOC_RELEASING       TIM_OWNER_RESERVED /* 释放中：不等于任何合法所有者，分配、占用和释放都会跳过 */
+
+#define ALLOC_CAPS_GP         (TIM_CAP_DMA | TIM_CAP_DMA_BURST | TIM_CAP_ENCODER | TIM_CAP_HALL | \
+                               TIM_CAP_UPDOWN | TIM_CAP_MASTER | TIM_CAP_SLAVE)
+#define ALLOC_CAPS_ADV        (ALLOC_CAPS_GP | TIM_CAP_COMPLEMENTARY | TIM_CAP_BREAK | \
+                               TIM_CAP_REPETITION | TIM_CAP_APB2)
+
+/* Private variables ---------------------------------------------------------*/
+static const TIM_AllocInfoTypeDef s_info[TIM_ALLOC_TIMERS] = {
+    { TIM1,  RCC_APB2Periph_TIM1,  ALLOC_CAPS_ADV,                                 4, 2 },
+    { TIM2,  RCC_APB1Periph_TIM2,  ALLOC_CAPS_GP | TIM_CAP_32BIT,                  4, 1 },
+    { TIM3,  RCC_APB1Periph_TIM3,  ALLOC_CAPS_GP,                                  4, 1 },
+    { TIM4,  RCC_APB1Periph_TIM4,  ALLOC_CAPS_GP,                                  4, 1 },
+    { TIM5,  RCC_APB1Periph_TIM5,  ALLOC_CAPS_GP | TIM_CAP_32BIT,                  4, 1 },
+    { TIM6,  RCC_APB1Periph_TIM6,  TIM_CAP_DMA | TIM_CAP_MASTER,                   0, 1 },
+    { TIM7,  RCC_APB1Periph_TIM7,  TIM_CAP_DMA | TIM_CAP_MASTER,                   0, 1 },
+    { TIM8,  RCC_APB2Periph_TIM8,  ALLOC_CAPS_ADV,                                 4, 2 },
+    { TIM9,  RCC_APB2Periph_TIM9,  TIM_CAP_MASTER | TIM_CAP_SLAVE | TIM_CAP_APB2,  2, 2 },
+    { TIM10, RCC_APB2Periph_TIM10, TIM_CAP_APB2,                                   1, 2 },
+    { TIM11, RCC_APB2Periph_TIM11, TIM_CAP_APB2,                                   1, 2 },
+    { TIM12, RCC_APB1Periph_TIM12, TIM_CAP_MASTER | TIM_CAP_SLAVE,                 2, 1 },
+    { TIM13, RCC_APB1Periph_TIM13, 0,                                              1, 1 },
+    { TIM14, RCC_APB1Periph_TIM14, 0,                                              1, 1 },
+};
+
+static uint8_t s_owner[TIM_ALLOC_TIMERS];         /* 整个定时器的所有者，或 TIM_OWNER_SHARED */
+static uint8_t s_chOwner[TIM_ALLOC_TIMERS][4];    /* 共享定时器各通道的所有者 */
+static uint32_t s_timeBase[TIM_ALLOC_TIMERS];     /* 共享定时器的时基约定 */
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Alloc_Index(TIM_TypeDef* TIMx);
+static uint8_t Alloc_FreeChannel(uint8_t Index);
+static uint8_t Alloc_BestFit(uint16_t Caps, uint8_t Channels, uint8_t Shared, uint32_t TimeBase);
+static void Alloc_Claim(uint8_t Index, uint8_t Owner);
+static void Alloc_Release(uint8_t Index);
+
+
+/**
+  * @brief  按能力分配整个定时器。
+  * @param  Caps: 需要的能力 TIM_CAP_x 组合，0 表示无要求。
+  * @param  Channels: 需要的通道个数 0~4。
+  * @param  Owner: 所有者编号 1 ~ 0xFC，或 TIM_OWNER_SYSTEM。
+  * @retval 分配到的定时器（时钟已打开）；没有满足要求的空闲定时器时返回 NULL
+  *
+  * @note
+  *  - 最佳匹配：多余能力最少者优先，其次多余通道最少者优先。
+  *    例如只要一个通道的定时器会先拿 TIM13/TIM14，而不是 TIM1。
+  *  - 能力位不区分 APB1/APB2 时钟时，如需 168MHz 计数时钟请加 TIM_CAP_APB2。
+  *  - 小白理解：说清楚要什么功能，分配器挑一个“刚好够用”的定时器给你。
+  */
+TIM_TypeDef* myTIM_Alloc(uint16_t Caps, uint8_t Channels, uint8_t Owner)
+{
+    TIM_TypeDef* TIMx = NULL;
+    uint8_t index = ALLOC_NONE;
+    uint32_t primask = __get_PRIMASK();
+
+    /* 参数检查 */
+    assert_param(Owner != TIM_OWNER_NONE && Owner != TIM_OWNER_RESERVED && Owner != TIM_OWNER_SHARED);
+    assert_param(Channels <= 4);
+
+    if (Owner == TIM_OWNER_NONE || Owner == TIM_OWNER_RESERVED || Owner == TIM_OWNER_SHARED)
+    {
+        return NULL;
+    }
+
+    __disable_irq();
+    index = Alloc_BestFit(Caps, Channels, 0, 0);
+    if (index != ALLOC_NONE)
+    {
+        Alloc_Claim(index, Owner);
+        TIMx = s_info[index].TIMx;
+    }
+    __set_PRIMASK(primask);
+
+    return TIMx;
+}
+
+/**
+  * @brief  按能力分配单个通道。
+  * @param  Caps: 需要的能力 TIM_CAP_x 组合。
+  * @param  TimeBase: 时基约定，相同值的申请可共用一个定时器（共用 PSC / ARR / 计数器）。
+  * @param  Owner: 所有者编号 1 ~ 0xFC。
+  * @param  TIMx: 输出分配到的定时器。
+  * @param  Channel: 输出分配到的通道 1~4。
+  * @retval SUCCESS: 分配成功；ERROR: 没有可用通道
+  *
+  * @note
+  *  - 优先放到已有相同时基的共享定时器上，没有时再按最佳匹配拿一个空闲定时器。
+  *  - 共享定时器的时基由第一个所有者配置，后来者只能配置自己的通道，
+  *    不能修改 PSC、ARR、计数模式，也不能调用 myTIM_DeInit()。
+  */
+ErrorStatus myTIM_AllocChannel(uint16_t Caps, uint32_t TimeBase, uint8_t Owner,
+    TIM_TypeDef** TIMx, uint8_t* Channel)
+{
+    uint8_t index = ALLOC_NONE;
+    uint8_t ch = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    /* 参数检查 */
+    assert_param(Owner != TIM_OWNER_NONE && Owner < TIM_OWNER_RESERVED);
+
+    if (Owner == TIM_OWNER_NONE || Owner >= TIM_OWNER_RESERVED)
+    {
+        return ERROR;
+    }
+
+    __disable_irq();
+    index = Alloc_BestFit(Caps, 1, 1, TimeBase);
+    if (index == ALLOC_NONE)
+    {
+        index = Alloc_BestFit(Caps, 1, 0, 0);
+        if (index != ALLOC_NONE)
+        {
+            Alloc_Claim(index, TIM_OWNER_SHARED);
+            s_timeBase[index] = TimeBase;
+        }
+    }
+    if (index != ALLOC_NONE)
+    {
+        ch = Alloc_FreeChannel(index);
+        s_chOwner[index][ch] = Owner;
+        *TIMx = s_info[index].TIMx;
+        *Channel = (uint8_t)(ch + 1);
+    }
+    __set_PRIMASK(primask);
+
+    return (index != ALLOC_NONE) ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  占用指定的定时器。
+  * @param  TIMx: 要占用的定时器。
+  * @param  Owner: 所有者编号，TIM_OWNER_SYSTEM 用于屏蔽。
+  * @retval SUCCESS: 占用成功（时钟已打开）；ERROR: 已被占用
+  * @note   用于仍然固定使用某个定时器的旧模块，避免分配器把它分给别人。
+  */
+ErrorStatus myTIM_Reserve(TIM_TypeDef* TIMx, uint8_t Owner)
+{
+    uint8_t index = Alloc_Index(TIMx);
+    ErrorStatus status = ERROR;
+    uint32_t primask = __get_PRIMASK();
+
+    /* 参数检查 */
+    assert_param(IS_TIM_ALL_PERIPH(TIMx));
+    assert_param(Owner != TIM_OWNER_NONE && Owner != TIM_OWNER_RESERVED && Owner != TIM_OWNER_SHARED);
+
+    if (index == ALLOC_NONE || Owner == TIM_OWNER_NONE || Owner == TIM_OWNER_RESERVED || Owner == TIM_OWNER_SHARED)
+    {
+        return ERROR;
+    }
+
+    __disable_irq();
+    if (s_owner[index] == TIM_OWNER_NONE)
+    {
+        Alloc_Claim(index, Owner);
+        status = SUCCESS;
+    }
+    __set_PRIMASK(primask);
+
+    return status;
+}
+
+/**
+  * @brief  释放所有者在该定时器上的全部资源。
+  * @param  TIMx: 定时器。
+  * @param  Owner: 所有者编号。
+  * @retval SUCCESS: 已释放；ERROR: Owner 在该定时器上没有资源
+  * @note   定时器上没有任何所有者后调用 myTIM_DeInit() 并关闭时钟。
+  *         共享定时器上其他所有者的通道不受影响。
+  */
+ErrorStatus myTIM_Free(TIM_TypeDef* TIMx, uint8_t Owner)
+{
+    uint8_t index = Alloc_Index(TIMx);
+    uint8_t ch = 0;
+    uint8_t release = 0;
+    ErrorStatus status = ERROR;
+    uint32_t primask = __get_PRIMASK();
+
+    /* 参数检查 */
+    assert_param(Owner != TIM_OWNER_NONE && Owner != TIM_OWNER_RESERVED);
+
+    if (index == ALLOC_NONE || Owner == TIM_OWNER_NONE || Owner == TIM_OWNER_RESERVED)
+    {
+        return ERROR;
+    }
+
+    /* 关中断内判定并标记为释放中，外设复位放到关中断区之外 */
+    __disable_irq();
+    release = (s_owner[index] == Owner);
+    if (release)
+    {
+        s_owner[index] = ALLOC_RELEASING;
+    }
+    __set_PRIMASK(primask);
+
+    if (release)
+    {
+        Alloc_Release(index);
+        return SUCCESS;
+    }
+
+    for (ch = 1; ch <= 4; ch++)
+    {
+        status = (myTIM_FreeChannel(TIMx, ch, Owner) == SUCCESS) ? SUCCESS : status;
+    }
+
+    return status;
+}
+
+/**
+  * @brief  释放共享定时器上的单个通道。
+  * @param  TIMx: 定时器。
+  * @param  Channel: 通道 1~4。
+  * @param  Owner: 所有者编号。
+  * @retval SUCCESS: 已释放；ERROR: 该通道不属于 Owner
+  * @note   关闭该通道的输出使能、中断和 DMA 请求；是最后一个通道时释放整个定时器。
+  */
+ErrorStatus myTIM_FreeChannel(TIM_TypeDef* TIMx, uint8_t Channel, uint8_t Owner)
+{
+    uint8_t index = Alloc_Index(TIMx);
+    uint8_t last = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    if (index == ALLOC_NONE || Channel < 1 || Channel > 4 || Owner == TIM_OWNER_NONE || Owner == TIM_OWNER_RESERVED)
+    {
+        return ERROR;
+    }
+
+    /* 最后一个通道时在关中断内把定时器标记为释放中，
+       否则抢占的 myTIM_AllocChannel() 会在复位之前拿到这个仍是共享状态的定时器 */
+    __disable_irq();
+    if (s_owner[index] != TIM_OWNER_SHARED || s_chOwner[index][Channel - 1] != Owner)
+    {
+        __set_PRIMASK(primask);
+        return ERROR;
+    }
+    s_chOwner[index][Channel - 1] = TIM_OWNER_NONE;
+    last = (s_chOwner[index][0] | s_chOwner[index][1] | s_chOwner[index][2] | s_chOwner[index][3]) == 0;
+    if (last)
+    {
+        s_owner[index] = ALLOC_RELEASING;
+    }
+    __set_PRIMASK(primask);
+
+    if (last)
+    {
+        Alloc_Release(index);
+    }
+    else
+    {
+        /* CCxE/CCxNE 在 CCER 中每通道占 4 位；CCxIE、CCxDE 在 DIER 中逐通道排列 */
+        TIMx->CCER &= (uint16_t)~(0x5U << ((Channel - 1) << 2));
+        TIMx->DIER &= (uint16_t)~((TIM_DIER_CC1IE | TIM_DIER_CC1DE) << (Channel - 1));
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  释放所有者的全部资源。
+  * @param  Owner: 所有者编号。
+  * @retval None
+  */
+void myTIM_FreeOwner(uint8_t Owner)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < TIM_ALLOC_TIMERS; i++)
+    {
+        myTIM_Free(s_info[i].TIMx, Owner);
+    }
+}
+
+/**
+  * @brief  查询所有者。
+  * @param  TIMx: 定时器。
+  * @param  Channel: 0 查询整个定时器，1~4 查询共享定时器的通道。
+  * @retval 所有者编号；整个定时器按通道共享时返回 TIM_OWNER_SHARED，正在释放时返回 TIM_OWNER_RESERVED；
+  *         非共享定时器查询通道时返回整个定时器的所有者
+  */
+uint8_t myTIM_GetOwner(TIM_TypeDef* TIMx, uint8_t Channel)
+{
+    uint8_t index = Alloc_Index(TIMx);
+
+    if (index == ALLOC_NONE || Channel > 4)
+    {
+        return TIM_OWNER_NONE;
+    }
+
+    return (Channel == 0 || s_owner[index] != TIM_OWNER_SHARED) ? s_owner[index] : s_chOwner[index][Channel - 1];
+}
+
+/**
+  * @brief  查询定时器能力描述。
+  * @param  TIMx: 定时器。
+  * @retval 描述表项；不是本模块管理的定时器时返回 NULL
+  */
+const TIM_AllocInfoTypeDef* myTIM_GetInfo(TIM_TypeDef* TIMx)
+{
+    uint8_t index = Alloc_Index(TIMx);
+
+    return (index == ALLOC_NONE) ? NULL : &s_info[index];
+}
+
+
+/**
+  * @brief  定时器在描述表中的序号，找不到返回 ALLOC_NONE。
+  */
+static uint8_t Alloc_Index(TIM_TypeDef* TIMx)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < TIM_ALLOC_TIMERS; i++)
+    {
+        if (s_info[i].TIMx == TIMx)
+        {
+            return i;
+        }
+    }
+
+    return ALLOC_NONE;
+}
+
+/**
+  * @brief  共享定时器的第一个空闲通道（0 起），没有返回 ALLOC_NONE。
+  */
+static uint8_t Alloc_FreeChannel(uint8_t Index)
+{
+    uint8_t ch = 0;
+
+    for (ch = 0; ch < s_info[Index].Channels; ch++)
+    {
+        if (s_chOwner[Index][ch] == TIM_OWNER_NONE)
+        {
+            return ch;
+        }
+    }
+
+    return ALLOC_NONE;
+}
+
+/**
+  * @brief  最佳匹配查找，调用者负责关中断。
+  * @param  Shared: 0 在空闲定时器中找；1 在时基相同且有空闲通道的共享定时器中找。
+  * @retval 描述表序号，找不到返回 ALLOC_NONE
+  */
+static uint8_t Alloc_BestFit(uint16_t Caps, uint8_t Channels, uint8_t Shared, uint32_t TimeBase)
+{
+    uint8_t best = ALLOC_NONE;
+    uint16_t bestScore = 0xFFFF;
+    uint16_t score = 0;
+    uint16_t extra = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < TIM_ALLOC_TIMERS; i++)
+    {
+        if ((s_info[i].Caps & Caps) != Caps || s_info[i].Channels < Channels)
+        {
+            continue;
+        }
+        if (Shared ? (s_owner[i] != TIM_OWNER_SHARED || s_timeBase[i] != TimeBase ||
+            Alloc_FreeChannel(i) == ALLOC_NONE)
+            : (s_owner[i] != TIM_OWNER_NONE))
+        {
+            continue;
+        }
+
+        /* 分数 = 多余能力个数 * 8 + 多余通道数，越小越合适 */
+        score = 0;
+        for (extra = (uint16_t)(s_info[i].Caps & ~Caps); extra != 0; extra &= (uint16_t)(extra - 1))
+        {
+            score += 8;
+        }
+        score += (uint16_t)(s_info[i].Channels - Channels);
+
+        if (score < bestScore)
+        {
+            bestScore = score;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+/**
+  * @brief  记录所有者并打开时钟，调用者负责关中断。
+  */
+static void Alloc_Claim(uint8_t Index, uint8_t Owner)
+{
+    s_owner[Index] = Owner;
+    s_chOwner[Index][0] = s_chOwner[Index][1] = s_chOwner[Index][2] = s_chOwner[Index][3] = TIM_OWNER_NONE;
+    s_info[Index].APB == 1 ? RCC_APB1PeriphClockCmd(s_info[Index].RCC_APBPeriph, ENABLE)
+        : RCC_APB2PeriphClockCmd(s_info[Index].RCC_APBPeriph, ENABLE);
+}
+
+/**
+  * @brief  复位定时器寄存器、关闭时钟并标记为空闲。
+  * @note   调用者已在关中断区内把所有者改为 ALLOC_RELEASING，这期间没有人能分配到它；
+  *         复位完成后最后一步才标记为空闲。
+  */
+static void Alloc_Release(uint8_t Index)
+{
+    myTIM_DeInit(s_info[Index].TIMx);
+    s_info[Index].APB == 1 ? RCC_APB1PeriphClockCmd(s_info[Index].RCC_APBPeriph, DISABLE)
+        : RCC_APB2PeriphClockCmd(s_info[Index].RCC_APBPeriph, DISABLE);
+    s_owner[Index] = TIM_OWNER_NONE;
+}
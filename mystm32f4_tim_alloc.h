@@ -0,0 +1,49 @@
+﻿#ifndef mystm32f4_tim_alloc_h
+#define mystm32f4_tim_alloc_h
+
+#include "mystm32f4_tim.h"
+
+/* 定时器能力位 */
+#define TIM_CAP_32BIT               0x0001U   /* 32 位计数器（TIM2 / TIM5） */
+#define TIM_CAP_COMPLEMENTARY       0x0002U   /* 互补输出 + 死区（TIM1 / TIM8） */
+#define TIM_CAP_BREAK               0x0004U   /* 刹车输入（TIM1 / TIM8） */
+#define TIM_CAP_REPETITION          0x0008U   /* 重复计数器 RCR（TIM1 / TIM8） */
+#define TIM_CAP_DMA                 0x0010U   /* 有 DMA 请求 */
+#define TIM_CAP_DMA_BURST           0x0020U   /* DMA 突发（DCR / DMAR） */
+#define TIM_CAP_ENCODER             0x0040U   /* 编码器接口 */
+#define TIM_CAP_HALL                0x0080U   /* 霍尔接口（TI1S 异或输入） */
+#define TIM_CAP_UPDOWN              0x0100U   /* 向下/中心对齐计数 */
+#define TIM_CAP_MASTER              0x0200U   /* TRGO 主模式输出 */
+#define TIM_CAP_SLAVE               0x0400U   /* 从模式控制器 */
+#define TIM_CAP_APB2                0x0800U   /* 挂在 APB2（时钟可达 168MHz） */
+
+/* 所有者编号：模块自行分配 1 ~ 0xFC */
+#define TIM_OWNER_NONE              0      /* 空闲 */
+#define TIM_OWNER_RESERVED          0xFD   /* 分配器内部使用（释放中），不能作为所有者传入 */
+#define TIM_OWNER_SHARED            0xFE   /* 定时器按通道分给多个所有者（myTIM_GetOwner 返回） */
+#define TIM_OWNER_SYSTEM            0xFF   /* 屏蔽芯片上不存在或被固定占用的定时器 */
+
+/* 定时器个数 */
+#define TIM_ALLOC_TIMERS            14
+
+/* 本模块管理的定时器描述 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;
+    uint32_t RCC_APBPeriph;      /* RCC 时钟使能位 */
+    uint16_t Caps;               /* TIM_CAP_x 组合 */
+    uint8_t  Channels;           /* 捕获/比较通道个数 */
+    uint8_t  APB;                /* 1 = APB1，2 = APB2 */
+} TIM_AllocInfoTypeDef;
+
+TIM_TypeDef* myTIM_Alloc(uint16_t Caps, uint8_t Channels, uint8_t Owner);  // 按能力分配整个定时器
+ErrorStatus myTIM_AllocChannel(uint16_t Caps, uint32_t TimeBase, uint8_t Owner, // 按能力分配单个通道（同一时基共享定时器）
+    TIM_TypeDef** TIMx, uint8_t* Channel);
+ErrorStatus myTIM_Reserve(TIM_TypeDef* TIMx, uint8_t Owner);               // 占用指定的定时器（兼容固定使用某个定时器的模块）
+ErrorStatus myTIM_Free(TIM_TypeDef* TIMx, uint8_t Owner);                  // 释放所有者在该定时器上的全部资源
+ErrorStatus myTIM_FreeChannel(TIM_TypeDef* TIMx, uint8_t Channel, uint8_t Owner); // 释放单个通道
+void myTIM_FreeOwner(uint8_t Owner);                                      // 释放所有者的全部资源
+uint8_t myTIM_GetOwner(TIM_TypeDef* TIMx, uint8_t Channel);                // 查询所有者，Channel 为 0 表示整个定时器
+const TIM_AllocInfoTypeDef* myTIM_GetInfo(TIM_TypeDef* TIMx);              // 查询定时器能力描述
+
+#endif
@@ -0,0 +1,536 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_bldc.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    基于霍尔接口和 COM 事件的六步方波换相引擎
+  *
+  * @attention
+  *
+  * 本文件把换相时刻完全交给硬件：
+  *
+  *   霍尔 A/B/C ──XOR(TI1S)──> 霍尔定时器 TI1F_ED
+  *        ├─ CH1 捕获（TRC）：记录两次霍尔边沿的间隔，同时复位计数器（复位从模式）
+  *        └─ CH2 PWM2，CCR2 = 换相延时：OC2REF 上升沿作为 TRGO
+  *                       │ ITRx
+  *                       v
+  *   功率定时器（TIM1/TIM8）CCPC = 1，CCUS = 1：TRGI 上升沿产生 COM 事件，
+  *   预装载的 CCxE/CCxNE/OCxM 在这一刻同时生效。
+  *
+  * COM 中断只在换相“之后”运行：读霍尔码，把“下一步”的输出状态写进预装载寄存器。
+  * 换相时刻与中断延迟无关，没有软件抖动；中断只要在下一次霍尔边沿之前完成即可。
+  *
+  * 换相表在编译期由宏展开成 CCER/CCMR1/CCMR2 的值，六个步骤各三相为：
+  *   PWM：PWM1 模式，CCxE + CCxNE（上管斩波、下管互补续流）
+  *   LOW：强制无效电平，CCxE + CCxNE（下管常通）
+  *   OFF：CCxE = CCxNE = 0（两管都关，该相悬空）
+  * 反转时驱动序列位置 +3（上下管对调）。
+  *
+  * 停转保护：霍尔定时器溢出回绕后 CNT 会再次数到 CCR2，OC2REF 再次上升，
+  * 没有霍尔边沿也会产生一次 COM，把换相往前推一步。因此用 CH4 比较在 3/4 满量程处
+  * 提前判定停转（离回绕还有 1/4 满量程，中断有足够时间响应）：清除功率定时器 CCUS，
+  * 之后的 TRGI 不再产生 COM，同时关闭主输出并计数，由 myTIM_BldcStart() 重新启动。
+  * 霍尔定时器溢出（URS = 1 时只有溢出置 UIF）仍用于判定测周无效。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 TIM1、TIM3 和 GPIO 时钟，把 PWM 引脚和霍尔引脚复用到定时器。
+    霍尔 A/B/C 必须接霍尔定时器的 CH1/CH2/CH3（XOR 只作用于这三个输入）。
+
+(#) 按电机手册修改 TIM_BLDC_HALL_SEQUENCE：正转时霍尔码出现的顺序，
+    序列第一个霍尔码对应“U 上管 PWM、V 下管导通”这一步。
+
+(#) 初始化：
+    TIM_BldcInitTypeDef init;
+    myTIM_BldcStructInit(&init);
+    init.PwmTIM = TIM1;
+    init.HallTIM = TIM3;           // TIM1 的 ITR2
+    init.HallPort = GPIOC;
+    init.HallPins[0] = GPIO_Pin_6; init.HallPins[1] = GPIO_Pin_7; init.HallPins[2] = GPIO_Pin_8;
+    myTIM_BldcInit(&bldc, &init);
+
+(#) 使能 TIM1_TRG_COM_TIM11_IRQn，在 TIM1_TRG_COM_TIM11_IRQHandler 中调用
+    myTIM_BldcCOMIRQHandler(&bldc)
+
+(#) 使能霍尔定时器中断（TIM3_IRQn），在 TIM3_IRQHandler 中调用
+    myTIM_BldcHallIRQHandler(&bldc)；停转超时为 3/4 满量程（1MHz、16 位约 49ms），
+    低速启动需要更长时间时降低 HallFreq。
+
+(#) myTIM_BldcSetDuty(&bldc, duty); myTIM_BldcStart(&bldc);
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_bldc.h"
+#include "mystm32f4_gpio.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BLDC_OFF              0   /* 两管关断 */
+#define BLDC_PWM              1   /* 上管 PWM */
+#define BLDC_LOW              2   /* 下管常通 */
+
+/* 单相在 CCER 中的使能位（n = 0/1/2 对应 CH1/CH2/CH3） */
+#define BLDC_CCER_PHASE(s, n) ((s) != BLDC_OFF ? (uint16_t)((TIM_CCER_CC1E | TIM_CCER_CC1NE) << (4 * (n))) : 0)
+/* 单相输出模式，OFF 时也用强制无效，重新使能时不会先冒出一个脉冲 */
+#define BLDC_OCM(s)           ((s) == BLDC_PWM ? TIM_OCMode_PWM1 : TIM_ForcedAction_InActive)
+
+#define BLDC_STEP(u, v, w)    { (uint16_t)(BLDC_CCER_PHASE(u, 0) | BLDC_CCER_PHASE(v, 1) | BLDC_CCER_PHASE(w, 2)), \
+                                (uint16_t)(BLDC_OCM(u) | (BLDC_OCM(v) << 8)), \
+                                (uint16_t)BLDC_OCM(w) }
+
+#define BLDC_CCER_MASK        (uint16_t)(TIM_CCER_CC1E | TIM_CCER_CC1NE | TIM_CCER_CC2E | \
+                                         TIM_CCER_CC2NE | TIM_CCER_CC3E | TIM_CCER_CC3NE)
+#define BLDC_INVALID          0xFF
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint16_t CCER;
+    uint16_t CCMR1;
+    uint16_t CCMR2;
+} BLDC_StepTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+/* 编译期换相表：序号即正转霍尔序列位置 */
+static const BLDC_StepTypeDef s_steps[6] = {
+    BLDC_STEP(BLDC_PWM, BLDC_LOW, BLDC_OFF),   /* U+ V- */
+    BLDC_STEP(BLDC_PWM, BLDC_OFF, BLDC_LOW),   /* U+ W- */
+    BLDC_STEP(BLDC_OFF, BLDC_PWM, BLDC_LOW),   /* V+ W- */
+    BLDC_STEP(BLDC_LOW, BLDC_PWM, BLDC_OFF),   /* V+ U- */
+    BLDC_STEP(BLDC_LOW, BLDC_OFF, BLDC_PWM),   /* W+ U- */
+    BLDC_STEP(BLDC_OFF, BLDC_LOW, BLDC_PWM),   /* W+ V- */
+};
+
+static const uint8_t s_hallSequence[6] = TIM_BLDC_HALL_SEQUENCE;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Bldc_ReadHall(TIM_BldcTypeDef* Bldc);
+static void Bldc_Preload(TIM_BldcTypeDef* Bldc, uint8_t Index);
+
+
+/**
+  * @brief  初始化换相引擎参数结构体为默认值。
+  * @param  Init: 参数结构体。
+  * @retval None
+  * @note   默认：20kHz PWM、无死区、霍尔定时器 1MHz、换相延时 1 个节拍（立即换相）、正转。
+  */
+void myTIM_BldcStructInit(TIM_BldcInitTypeDef* Init)
+{
+    Init->PwmTIM = TIM1;
+    Init->HallTIM = NULL;
+    Init->HallPort = NULL;
+    Init->HallPins[0] = 0;
+    Init->HallPins[1] = 0;
+    Init->HallPins[2] = 0;
+    Init->PwmFreq = 20000;
+    Init->DeadTime = 0;
+    Init->HallFreq = 1000000;
+    Init->CommDelay = 1;
+    Init->Direction = TIM_BLDC_DIR_FORWARD;
+}
+
+/**
+  * @brief  初始化六步换相引擎。
+  * @param  Bldc: 换相引擎句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成，霍尔定时器已运行，主输出保持关闭；
+  *         ERROR: 两个定时器之间没有内部触发连接、频率无法实现或霍尔序列非法。
+  *
+  * @note
+  *  - 功率定时器：向上计数 PWM，CCR 预装载，CCPC = 1，CCUS = 1，TRGI 选霍尔定时器，
+  *    使能 COM 中断，MOE 保持关闭直到 myTIM_BldcStart()。
+  *  - 霍尔定时器：TI1S = 1，CH1 捕获 TRC，复位从模式（TI1F_ED），
+  *    CH2 PWM2 输出延时，TRGO = OC2REF，URS = 1，CH4 比较中断判定停转。
+  *  - 小白理解：霍尔一跳，硬件数完延时就自动换相，CPU 只负责提前把下一步写好。
+  */
+ErrorStatus myTIM_BldcInit(TIM_BldcTypeDef* Bldc, TIM_BldcInitTypeDef* Init)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_OCInitTypeDef oc;
+    TIM_ICInitTypeDef ic;
+    TIM_BDTRInitTypeDef bdtr;
+    TIM_TypeDef* pwm = Init->PwmTIM;
+    TIM_TypeDef* hall = Init->HallTIM;
+    uint16_t itr = myTIM_GetInternalTrigger(pwm, hall);
+    uint32_t arr = 0;
+    uint32_t psc = 0;
+    uint8_t i = 0;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST4_PERIPH(pwm));
+    assert_param(IS_TIM_LIST2_PERIPH(hall));
+    assert_param(Init->PwmFreq != 0 && Init->HallFreq != 0);
+    assert_param(Init->CommDelay != 0);
+
+    if (itr == 0xFFFF || Init->PwmFreq == 0 || Init->HallFreq == 0 || Init->CommDelay == 0)
+    {
+        return ERROR;
+    }
+
+    /* 霍尔码 -> 序列位置，序列中的码必须是 1~6 且互不相同 */
+    for (i = 0; i < 8; i++)
+    {
+        Bldc->HallToIndex[i] = BLDC_INVALID;
+    }
+    for (i = 0; i < 6; i++)
+    {
+        if (s_hallSequence[i] == 0 || s_hallSequence[i] > 6 || Bldc->HallToIndex[s_hallSequence[i]] != BLDC_INVALID)
+        {
+            return ERROR;
+        }
+        Bldc->HallToIndex[s_hallSequence[i]] = i;
+    }
+
+    arr = myTIM_GetClockFreq(pwm) / Init->PwmFreq;
+    psc = (myTIM_GetClockFreq(hall) + Init->HallFreq / 2) / Init->HallFreq;
+    if (arr < 2 || arr > 0x10000 || psc == 0 || psc > 0x10000)
+    {
+        return ERROR;
+    }
+
+    Bldc->PwmTIM = pwm;
+    Bldc->HallTIM = hall;
+    Bldc->HallPort = Init->HallPort;
+    Bldc->HallPins[0] = Init->HallPins[0];
+    Bldc->HallPins[1] = Init->HallPins[1];
+    Bldc->HallPins[2] = Init->HallPins[2];
+    Bldc->HallFreq = myTIM_GetClockFreq(hall) / psc;
+    Bldc->HallPeriod = 0;
+    Bldc->CommCount = 0;
+    Bldc->FaultCount = 0;
+    Bldc->StallCount = 0;
+    Bldc->Stalled = 0;
+    Bldc->Direction = Init->Direction;
+
+    /* ---------------- 功率定时器 ---------------- */
+    myTIM_Cmd(pwm, DISABLE);
+    myTIM_CtrlPWMOutputs(pwm, DISABLE);
+    myTIM_CCPreloadControl(pwm, DISABLE);
+
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Period = arr - 1;
+    myTIM_TimeBaseInit(pwm, &timeBase);
+    myTIM_ARRPreloadConfig(pwm, ENABLE);
+
+    /* 三相先以关断状态初始化，极性、空闲状态在此确定，之后只改使能位和模式 */
+    myTIM_OCStructInit(&oc);
+    oc.TIM_OCMode = TIM_ForcedAction_InActive;
+    oc.TIM_OutputState = TIM_OutputState_Disable;
+    oc.TIM_OutputNState = TIM_OutputNState_Disable;
+    oc.TIM_Pulse = 0;
+    oc.TIM_OCPolarity = TIM_OCPolarity_High;
+    oc.TIM_OCNPolarity = TIM_OCNPolarity_High;
+    oc.TIM_OCIdleState = TIM_OCIdleState_Reset;
+    oc.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+    myTIM_OCxInit(pwm, 1, &oc);
+    myTIM_OC2Init(pwm, &oc);
+    myTIM_OC3Init(pwm, &oc);
+    pwm->CCMR1 |= TIM_CCMR1_OC1PE | TIM_CCMR1_OC2PE;   // CCR 预装载，占空比在更新事件生效
+    pwm->CCMR2 |= TIM_CCMR2_OC3PE;
+
+    /* OSSR = 1：关断相在 MOE = 1 时保持无效电平而不是高阻 */
+    myTIM_BDTRStructInit(&bdtr);
+    bdtr.TIM_OSSRState = TIM_OSSRState_Enable;
+    bdtr.TIM_OSSIState = TIM_OSSIState_Enable;
+    bdtr.TIM_DeadTime = Init->DeadTime;
+    myTIM_BDTRConfig(pwm, &bdtr);
+
+    /* 换相状态预装载，COM 由 COMG 或 TRGI 上升沿产生 */
+    myTIM_CCPreloadControl(pwm, ENABLE);
+    myTIM_SelectCOM(pwm, ENABLE);
+    myTIM_SelectInputTrigger(pwm, itr);
+
+    pwm->SR = (uint16_t)~TIM_SR_COMIF;
+    myTIM_ITConfig(pwm, TIM_IT_COM, ENABLE);
+    myTIM_Cmd(pwm, ENABLE);
+
+    /* ---------------- 霍尔定时器 ---------------- */
+    myTIM_Cmd(hall, DISABLE);
+    myTIM_UpdateRequestConfig(hall, TIM_UpdateSource_Regular);
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Prescaler = (uint16_t)(psc - 1);
+    timeBase.TIM_Period = (hall == TIM2 || hall == TIM5) ? 0xFFFFFFFF : 0xFFFF;
+    myTIM_TimeBaseInit(hall, &timeBase);
+
+    /* CH1~CH3 异或后送 TI1，CH1 在每个霍尔边沿捕获 */
+    myTIM_SelectHallSensor(hall, ENABLE);
+    myTIM_ICStructInit(&ic);
+    ic.TIM_Channel = TIM_Channel_1;
+    ic.TIM_ICPolarity = TIM_ICPolarity_Rising;
+    ic.TIM_ICSelection = TIM_ICSelection_TRC;
+    ic.TIM_ICFilter = 0x0F;
+    myTIM_ICInit(hall, &ic);
+    myTIM_SelectInputTrigger(hall, TIM_TS_TI1F_ED);
+    myTIM_SelectSlaveMode(hall, TIM_SlaveMode_Reset);
+
+    /* CH2 PWM2：复位后 CNT < CCR2 为无效，数到 CCR2 时 OC2REF 上升产生 TRGO */
+    myTIM_OCStructInit(&oc);
+    oc.TIM_OCMode = TIM_OCMode_PWM2;
+    oc.TIM_OutputState = TIM_OutputState_Disable;
+    oc.TIM_Pulse = Init->CommDelay;
+    myTIM_OC2Init(hall, &oc);
+    myTIM_SelectOutputTrigger(hall, TIM_TRGOSource_OC2Ref);
+
+    /* CH4 冻结模式只产生比较中断：3/4 满量程没有霍尔边沿即停转，赶在回绕之前处理 */
+    myTIM_OCStructInit(&oc);
+    oc.TIM_OCMode = TIM_OCMode_Timing;
+    oc.TIM_OutputState = TIM_OutputState_Disable;
+    oc.TIM_Pulse = timeBase.TIM_Period - (timeBase.TIM_Period >> 2);
+    myTIM_OC4Init(hall, &oc);
+
+    myTIM_SetCounter(hall, 0);
+    hall->SR = 0;
+    myTIM_ITConfig(hall, TIM_IT_CC4, ENABLE);
+    myTIM_Cmd(hall, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  按当前霍尔位置立即输出，预装载下一步并打开主输出。
+  * @param  Bldc: 换相引擎句柄。
+  * @retval SUCCESS: 已启动；ERROR: 霍尔码非法（000/111 或传感器未接），保持关闭。
+  * @note   启动前先用 myTIM_BldcSetDuty() 设置占空比。
+  *         同时清除停转状态：霍尔计数从 0 重新开始计时，恢复 TRGI 触发 COM。
+  */
+ErrorStatus myTIM_BldcStart(TIM_BldcTypeDef* Bldc)
+{
+    uint8_t index = Bldc->HallToIndex[Bldc_ReadHall(Bldc)];
+    uint32_t primask = 0;
+
+    if (index == BLDC_INVALID)
+    {
+        return ERROR;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* 停转计时从现在开始，先清 CC4IF 再恢复硬件换相 */
+    myTIM_SetCounter(Bldc->HallTIM, 0);
+    Bldc->HallTIM->SR = (uint16_t)~(TIM_SR_CC4IF | TIM_SR_UIF);
+    Bldc->HallPeriod = 0;
+    Bldc->Stalled = 0;
+    myTIM_SelectCOM(Bldc->PwmTIM, ENABLE);
+
+    /* 当前步：写预装载后用 COMG 立即生效 */
+    Bldc_Preload(Bldc, index);
+    myTIM_GenerateEvent(Bldc->PwmTIM, TIM_EventSource_COM);
+    Bldc->PwmTIM->SR = (uint16_t)~TIM_SR_COMIF;
+
+    /* 下一步：等霍尔边沿触发的 COM */
+    index = (Bldc->Direction == TIM_BLDC_DIR_FORWARD) ? (uint8_t)((index + 1) % 6) : (uint8_t)((index + 5) % 6);
+    Bldc_Preload(Bldc, index);
+
+    __set_PRIMASK(primask);
+
+    myTIM_CtrlPWMOutputs(Bldc->PwmTIM, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  关闭主输出，所有相进入 OSSI 定义的安全状态。
+  * @param  Bldc: 换相引擎句柄。
+  * @retval None
+  */
+void myTIM_BldcStop(TIM_BldcTypeDef* Bldc)
+{
+    myTIM_CtrlPWMOutputs(Bldc->PwmTIM, DISABLE);
+}
+
+/**
+  * @brief  设置 PWM 占空比。
+  * @param  Bldc: 换相引擎句柄。
+  * @param  Duty: 比较值，0 ~ ARR + 1，三相同时写入，下一个更新事件生效。
+  * @retval None
+  */
+void myTIM_BldcSetDuty(TIM_BldcTypeDef* Bldc, uint32_t Duty)
+{
+    Bldc->PwmTIM->CCR1 = Duty;
+    Bldc->PwmTIM->CCR2 = Duty;
+    Bldc->PwmTIM->CCR3 = Duty;
+}
+
+/**
+  * @brief  设置转向。
+  * @param  Bldc: 换相引擎句柄。
+  * @param  Direction: TIM_BLDC_DIR_FORWARD 或 TIM_BLDC_DIR_REVERSE。
+  * @retval None
+  * @note   立即按新方向重写预装载的下一步，从下一次换相起生效。
+  *         高速时直接反向会产生很大的反电动势电流，应先减速。
+  */
+void myTIM_BldcSetDirection(TIM_BldcTypeDef* Bldc, uint8_t Direction)
+{
+    uint8_t index = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    Bldc->Direction = Direction;
+    index = Bldc->HallToIndex[Bldc_ReadHall(Bldc)];
+    if (index != BLDC_INVALID)
+    {
+        index = (Direction == TIM_BLDC_DIR_FORWARD) ? (uint8_t)((index + 1) % 6) : (uint8_t)((index + 5) % 6);
+        Bldc_Preload(Bldc, index);
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  设置霍尔边沿到换相的延时。
+  * @param  Bldc: 换相引擎句柄。
+  * @param  Delay: 延时，霍尔定时器节拍，至少为 1。
+  * @retval None
+  * @note   可用于超前/滞后角补偿，例如 Delay = HallPeriod * 角度 / 60。
+  */
+void myTIM_BldcSetCommDelay(TIM_BldcTypeDef* Bldc, uint32_t Delay)
+{
+    myTIM_SetCompare(Bldc->HallTIM, 2, (Delay != 0) ? Delay : 1);
+}
+
+/**
+  * @brief  获取霍尔边沿间隔（60° 电角度）。
+  * @param  Bldc: 换相引擎句柄。
+  * @retval 间隔，霍尔定时器节拍；停转或尚未测到完整间隔返回 0
+  * @note   距上一次边沿的时间已经超过上一个间隔时返回该时间，减速过程连续。
+  */
+uint32_t myTIM_BldcGetHallPeriod(TIM_BldcTypeDef* Bldc)
+{
+    uint32_t period = Bldc->HallPeriod;
+    uint32_t elapsed = Bldc->HallTIM->CNT;
+
+    if (period == 0 || Bldc->Stalled || (Bldc->HallTIM->SR & TIM_SR_UIF))
+    {
+        return 0;
+    }
+
+    return (elapsed > period) ? elapsed : period;
+}
+
+/**
+  * @brief  获取电角速度。
+  * @param  Bldc: 换相引擎句柄。
+  * @retval 电转/分（机械转速 = 电转速 / 极对数）；停转返回 0
+  * @note   一个电周期 6 个霍尔边沿：eRPM = 60 * f / (6 * period) = 10 * f / period。
+  */
+uint32_t myTIM_BldcGetERPM(TIM_BldcTypeDef* Bldc)
+{
+    uint32_t period = myTIM_BldcGetHallPeriod(Bldc);
+
+    return (period != 0) ? (uint32_t)(((uint64_t)Bldc->HallFreq * 10) / period) : 0;
+}
+
+/**
+  * @brief  换相中断处理函数。
+  * @param  Bldc: 换相引擎句柄。
+  * @retval None
+  *
+  * @note
+  *  - 硬件已经完成本次换相，这里读取新的霍尔码，预装载下一步。
+  *  - 同时读取霍尔定时器 CCR1 作为本次霍尔边沿间隔；期间发生过溢出则本次间隔无效。
+  *  - 非法霍尔码时关闭主输出并计数，由上层决定是否重新启动。
+  */
+void myTIM_BldcCOMIRQHandler(TIM_BldcTypeDef* Bldc)
+{
+    TIM_TypeDef* hall = Bldc->HallTIM;
+    uint8_t index = 0;
+    uint32_t period = 0;
+
+    if ((Bldc->PwmTIM->SR & TIM_SR_COMIF) == 0)
+    {
+        return;
+    }
+    Bldc->PwmTIM->SR = (uint16_t)~TIM_SR_COMIF;
+
+    /* 测周：读 CCR1 同时清除 CC1IF */
+    period = hall->CCR1;
+    if (hall->SR & TIM_SR_UIF)
+    {
+        hall->SR = (uint16_t)~TIM_SR_UIF;
+        period = 0;
+    }
+    Bldc->HallPeriod = period;
+    Bldc->CommCount++;
+
+    /* 预装载下一步 */
+    index = Bldc->HallToIndex[Bldc_ReadHall(Bldc)];
+    if (index == BLDC_INVALID)
+    {
+        myTIM_CtrlPWMOutputs(Bldc->PwmTIM, DISABLE);
+        Bldc->FaultCount++;
+        return;
+    }
+
+    index = (Bldc->Direction == TIM_BLDC_DIR_FORWARD) ? (uint8_t)((index + 1) % 6) : (uint8_t)((index + 5) % 6);
+    Bldc_Preload(Bldc, index);
+}
+
+/**
+  * @brief  霍尔定时器中断处理函数：停转检测。
+  * @param  Bldc: 换相引擎句柄。
+  * @retval None
+  * @note   CH4 比较表示距上一次霍尔边沿已经 3/4 满量程。此时清除 CCUS，
+  *         计数器回绕后 OC2REF 的上升沿不再产生 COM；关闭主输出并计数，
+  *         由上层决定是否调用 myTIM_BldcStart() 重新启动。
+  */
+void myTIM_BldcHallIRQHandler(TIM_BldcTypeDef* Bldc)
+{
+    TIM_TypeDef* hall = Bldc->HallTIM;
+
+    if ((hall->SR & TIM_SR_CC4IF) == 0)
+    {
+        return;
+    }
+    hall->SR = (uint16_t)~TIM_SR_CC4IF;
+
+    myTIM_SelectCOM(Bldc->PwmTIM, DISABLE);
+    myTIM_CtrlPWMOutputs(Bldc->PwmTIM, DISABLE);
+    Bldc->HallPeriod = 0;
+    Bldc->Stalled = 1;
+    Bldc->StallCount++;
+}
+
+/**
+  * @brief  读取霍尔码：A 为 bit0，B 为 bit1，C 为 bit2。
+  */
+static uint8_t Bldc_ReadHall(TIM_BldcTypeDef* Bldc)
+{
+    uint16_t idr = myGPIO_ReadInputData(Bldc->HallPort);
+
+    return (uint8_t)(((idr & Bldc->HallPins[0]) ? 1 : 0) |
+                     ((idr & Bldc->HallPins[1]) ? 2 : 0) |
+                     ((idr & Bldc->HallPins[2]) ? 4 : 0));
+}
+
+/**
+  * @brief  把序列位置 Index 对应的输出状态写入预装载寄存器。
+  * @note   CCPC = 1 时 CCxE/CCxNE/OCxM 写入的是预装载值，下一次 COM 才生效。
+  *         反转时同一霍尔位置驱动相反的一步（+3）。
+  */
+static void Bldc_Preload(TIM_BldcTypeDef* Bldc, uint8_t Index)
+{
+    TIM_TypeDef* TIMx = Bldc->PwmTIM;
+    const BLDC_StepTypeDef* step = &s_steps[(Bldc->Direction == TIM_BLDC_DIR_FORWARD) ? Index : (uint8_t)((Index + 3) % 6)];
+
+    TIMx->CCMR1 = (uint16_t)((TIMx->CCMR1 & (uint16_t)~(TIM_CCMR1_OC1M | TIM_CCMR1_OC2M)) | step->CCMR1);
+    TIMx->CCMR2 = (uint16_t)((TIMx->CCMR2 & (uint16_t)~TIM_CCMR2_OC3M) | step->CCMR2);
+    TIMx->CCER = (uint16_t)((TIMx->CCER & (uint16_t)~BLDC_CCER_MASK) | step->CCER);
+}
@@ -0,0 +1,57 @@
+﻿#ifndef mystm32f4_tim_bldc_h
+#define mystm32f4_tim_bldc_h
+
+#include "mystm32f4_tim.h"
+
+/* 正转时霍尔码（A 为 bit0，B 为 bit1，C 为 bit2）出现的顺序，按电机手册修改 */
+#ifndef TIM_BLDC_HALL_SEQUENCE
+#define TIM_BLDC_HALL_SEQUENCE      { 1, 3, 2, 6, 4, 5 }
+#endif
+
+#define TIM_BLDC_DIR_FORWARD        0
+#define TIM_BLDC_DIR_REVERSE        1
+
+/* 换相引擎初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* PwmTIM;         /* 功率定时器 TIM1 或 TIM8，CH1~CH3/CH1N~CH3N 接 U/V/W 三相半桥 */
+    TIM_TypeDef* HallTIM;        /* 霍尔定时器，CH1~CH3 接霍尔 A/B/C，须有到 PwmTIM 的内部触发连接 */
+    GPIO_TypeDef* HallPort;      /* 霍尔引脚所在端口（用于读取霍尔码） */
+    uint16_t HallPins[3];        /* 霍尔 A/B/C 引脚，GPIO_Pin_x */
+    uint32_t PwmFreq;            /* PWM 频率（Hz） */
+    uint8_t  DeadTime;           /* BDTR.DTG 原始值 */
+    uint32_t HallFreq;           /* 霍尔定时器计数频率（Hz），决定测周分辨率和最低可测转速 */
+    uint32_t CommDelay;          /* 霍尔边沿到换相的延时（霍尔定时器节拍），至少为 1 */
+    uint8_t  Direction;          /* TIM_BLDC_DIR_FORWARD / TIM_BLDC_DIR_REVERSE */
+} TIM_BldcInitTypeDef;
+
+/* 换相引擎句柄，由调用者分配 */
+typedef struct
+{
+    TIM_TypeDef* PwmTIM;
+    TIM_TypeDef* HallTIM;
+    GPIO_TypeDef* HallPort;
+    uint16_t HallPins[3];
+    uint32_t HallFreq;
+    volatile uint32_t HallPeriod;    /* 最近一次霍尔边沿间隔（60° 电角度，霍尔定时器节拍），0 表示无效 */
+    volatile uint32_t CommCount;     /* 换相次数 */
+    volatile uint32_t FaultCount;    /* 非法霍尔码次数 */
+    volatile uint32_t StallCount;    /* 停转次数 */
+    volatile uint8_t  Stalled;       /* 1：已判定停转，换相已断开，等待 myTIM_BldcStart() */
+    uint8_t  Direction;
+    uint8_t  HallToIndex[8];         /* 霍尔码 -> 正转序列位置，0xFF 为非法码 */
+} TIM_BldcTypeDef;
+
+void myTIM_BldcStructInit(TIM_BldcInitTypeDef* Init);                 // 初始化参数结构体默认值
+ErrorStatus myTIM_BldcInit(TIM_BldcTypeDef* Bldc, TIM_BldcInitTypeDef* Init); // 初始化六步换相引擎
+ErrorStatus myTIM_BldcStart(TIM_BldcTypeDef* Bldc);                   // 按当前霍尔位置输出并打开主输出
+void myTIM_BldcStop(TIM_BldcTypeDef* Bldc);                           // 关闭主输出
+void myTIM_BldcSetDuty(TIM_BldcTypeDef* Bldc, uint32_t Duty);         // 设置 PWM 占空比（CCR 值）
+void myTIM_BldcSetDirection(TIM_BldcTypeDef* Bldc, uint8_t Direction); // 设置转向
+void myTIM_BldcSetCommDelay(TIM_BldcTypeDef* Bldc, uint32_t Delay);   // 设置霍尔边沿到换相的延时
+uint32_t myTIM_BldcGetHallPeriod(TIM_BldcTypeDef* Bldc);              // 获取霍尔边沿间隔（节拍），停转返回 0
+uint32_t myTIM_BldcGetERPM(TIM_BldcTypeDef* Bldc);                    // 获取电角速度（电转/分）
+void myTIM_BldcCOMIRQHandler(TIM_BldcTypeDef* Bldc);                  // 换相中断处理，在 TIMx_TRG_COM_IRQHandler 中调用
+void myTIM_BldcHallIRQHandler(TIM_BldcTypeDef* Bldc);                 // 停转检测，在霍尔定时器 TIMx_IRQHandler 中调用
+
+#endif
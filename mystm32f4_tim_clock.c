@@ -0,0 +1,326 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_clock.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    基于 32 位定时器（TIM2/TIM5）的 64 位单调时间戳服务
+  *
+  * @attention
+  *
+  * 本文件在 mystm32f4_tim 驱动之上实现一个全局 64 位单调时间戳，用于
+  * 调度、协议超时和事件打点。读取过程不关中断、不加锁，可在任意优先级的
+  * 中断或线程中调用。
+  *
+  * 实现思路（半周期跟踪）：
+  * 1. 定时器以 ARR = 满量程向上计数，用更新中断（溢出，最高位 1 -> 0）和
+  *    一个比较通道（CCR = 半量程，最高位 0 -> 1）各产生一次中断，
+  *    中断里只维护一个 32 位计数 Half = 已观测到的最高位翻转次数。
+  * 2. Half 的奇偶性必然等于当时计数器的最高位。读取时先读 Half 再读 CNT，
+  *    若 CNT 最高位与 Half 奇偶不一致，说明翻转已经发生而中断尚未执行
+  *    （例如读者优先级更高，或者正好被挡在关中断区里），此时补 1 即可。
+  * 3. 中断处理是幂等的：只在奇偶不一致时把 Half 加 1，即使读者抢占了
+  *    中断、或者两个标志同时挂起，也不会重复计数。
+  * 4. 读者在 Half 读两次之间被中断更新时重试一次，从而排除读者被长时间
+  *    抢占、跨越多次翻转的情况。
+  *
+  * 约束：
+  * - 中断延迟必须小于半个计数周期（32 位、84MHz 时约 25 秒），实际不可能超出。
+  * - 时间戳定时器独占更新中断和一个比较通道，其余通道仍可用于其它功能。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *   - 通用 64 位计数扩展 myTIM_ExtendXxx
+  *   - 全局时间戳 myTIM_ClockXxx，支持节拍和纳秒读取
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能定时器时钟：RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM5, ENABLE)
+
+(#) 调用 myTIM_ClockInit(TIM5, 1000000, 4) 初始化 1MHz 时间戳，
+    使用通道 4 作为半周期比较通道
+
+(#) 在 NVIC 中使能 TIM5_IRQn，优先级按系统规划设置即可（不要求最高）
+
+(#) 在中断服务函数中调用处理函数：
+    void TIM5_IRQHandler(void) { myTIM_ClockIRQHandler(); }
+
+(#) 任意位置调用 myTIM_ClockGetTicks() / myTIM_ClockGetNanos() 读取时间戳
+
+(#) 其它需要 64 位计数的定时器（例如外部事件计数）可以直接使用
+    myTIM_ExtendInit / myTIM_ExtendRead / myTIM_ExtendIRQHandler
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_clock.h"
+
+/* Private define ------------------------------------------------------------*/
+/* 比较通道 x 的中断标志：CC1IF << (x - 1) */
+#define EXT_CC_FLAG(ch)      ((uint16_t)(TIM_SR_CC1IF << ((ch) - 1)))
+
+/* Private variables ---------------------------------------------------------*/
+static TIM_ExtendTypeDef s_clock;           /* 全局时间戳使用的扩展描述符 */
+static uint32_t s_clockFreq = 0;            /* 实际计数频率 Hz */
+static uint32_t s_nsMult = 0;               /* 节拍 -> 纳秒 定点乘数 */
+static uint8_t  s_nsShift = 0;              /* 节拍 -> 纳秒 定点移位 */
+
+
+/**
+  * @brief  初始化定时器计数值的 64 位扩展。
+  * @param  Ext: 扩展描述符，由调用者分配（通常为静态变量）。
+  * @param  TIMx: 被扩展的定时器，必须已配置为向上计数且 ARR 为满量程
+  *         （TIM2/TIM5 为 0xFFFFFFFF，其余为 0xFFFF）。
+  * @param  Channel: 用于半量程比较中断的通道，取值 1~4。
+  * @retval SUCCESS: 配置完成；ERROR: ARR 不是满量程或通道非法。
+  *
+  * @note
+  *  - 本函数把通道配置为冻结（Timing）比较模式，CCR = 半量程，
+  *    并打开更新中断和该通道比较中断，不改变计数器运行状态。
+  *  - 用户需在 NVIC 中使能 TIMx 中断，并在 TIMx_IRQHandler 中调用
+  *    myTIM_ExtendIRQHandler(Ext)。
+  *  - 小白理解：把 16/32 位计数器“接长”成 64 位，溢出由中断记账，
+  *    读的时候再顺手把还没来得及记账的那一次补上。
+  */
+ErrorStatus myTIM_ExtendInit(TIM_ExtendTypeDef* Ext, TIM_TypeDef* TIMx, uint8_t Channel)
+{
+    uint8_t is32 = (TIMx == TIM2 || TIMx == TIM5);
+    uint32_t fullScale = is32 ? 0xFFFFFFFF : 0xFFFF;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST3_PERIPH(TIMx));
+    assert_param(Channel >= 1 && Channel <= 4);
+
+    if (Channel < 1 || Channel > 4 || TIMx->ARR != fullScale)
+    {
+        return ERROR;
+    }
+
+    Ext->TIMx = TIMx;
+    Ext->Width = is32 ? 32 : 16;
+    Ext->HalfMask = is32 ? 0x80000000 : 0x8000;
+    Ext->Channel = Channel;
+
+    /* 关闭相关中断后再配置，避免初始化过程中中断读到半成品 */
+    TIMx->DIER &= (uint16_t)~(TIM_DIER_UIE | (TIM_DIER_CC1IE << (Channel - 1)));
+
+    /* 比较通道：冻结模式，只产生标志不影响引脚，CCR = 半量程 */
+    myTIM_SelectOCxM(TIMx, (uint16_t)((Channel - 1) << 2), TIM_OCMode_Timing);
+    myTIM_SetCompare(TIMx, Channel, Ext->HalfMask);
+
+    /* Half 的奇偶与当前计数器最高位保持一致 */
+    Ext->Half = (TIMx->CNT & Ext->HalfMask) ? 1 : 0;
+
+    /* 清除残留标志后打开中断 */
+    TIMx->SR = (uint16_t)~(TIM_SR_UIF | EXT_CC_FLAG(Channel));
+    TIMx->DIER |= (uint16_t)(TIM_DIER_UIE | (TIM_DIER_CC1IE << (Channel - 1)));
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  无锁读取 64 位扩展计数值。
+  * @param  Ext: 已初始化的扩展描述符。
+  * @retval 64 位计数值
+  *
+  * @note
+  *  - 可在任意上下文调用，包括优先级高于 TIMx 中断的中断，不关中断。
+  *  - 先读 Half 后读 CNT 的顺序不能颠倒：颠倒后翻转若发生在两次读取之间，
+  *    会把同一次翻转补两次。
+  */
+uint64_t myTIM_ExtendRead(TIM_ExtendTypeDef* Ext)
+{
+    uint32_t half = 0;
+    uint32_t cnt = 0;
+
+    /* Half 在两次读取之间被中断修改则重读，保证 half 与 cnt 属于同一时刻 */
+    do
+    {
+        half = Ext->Half;
+        cnt = Ext->TIMx->CNT;
+    } while (half != Ext->Half);
+
+    /* 最高位与 half 奇偶不一致：翻转已发生、中断还没执行，补上这一次 */
+    half += (uint32_t)((cnt & Ext->HalfMask) != 0) ^ (half & 1);
+
+    return ((uint64_t)(half >> 1) << Ext->Width) | cnt;
+}
+
+/**
+  * @brief  64 位扩展计数的中断处理。
+  * @param  Ext: 已初始化的扩展描述符。
+  * @retval None
+  *
+  * @note
+  *  - 在 TIMx_IRQHandler 中调用；同一定时器上的其它中断源不受影响。
+  *  - 只在计数器最高位与 Half 奇偶不一致时加 1，重复进入不会重复计数。
+  */
+void myTIM_ExtendIRQHandler(TIM_ExtendTypeDef* Ext)
+{
+    TIM_TypeDef* TIMx = Ext->TIMx;
+    uint16_t sr = TIMx->SR & (uint16_t)(TIM_SR_UIF | EXT_CC_FLAG(Ext->Channel));
+    uint32_t half = 0;
+
+    if (sr == 0)
+    {
+        return;
+    }
+
+    /* SR 为写 0 清除，写 1 无影响：只清自己的标志 */
+    TIMx->SR = (uint16_t)~sr;
+
+    half = Ext->Half;
+    if ((uint32_t)((TIMx->CNT & Ext->HalfMask) != 0) != (half & 1))
+    {
+        Ext->Half = half + 1;
+    }
+}
+
+/**
+  * @brief  初始化全局 64 位单调时间戳。
+  * @param  TIMx: 32 位定时器，TIM2 或 TIM5（时钟需提前使能）。
+  * @param  TickFreq: 期望的计数频率 Hz，例如 1000000 表示 1us 一个节拍。
+  * @param  Channel: 半周期比较通道，取值 1~4，其余通道仍可自由使用。
+  * @retval SUCCESS: 初始化完成并已启动；ERROR: 定时器不是 32 位或频率无法实现。
+  *
+  * @note
+  *  - 预分频 = round(TIMxCLK / TickFreq)，实际频率可用 myTIM_ClockGetFreq() 读取。
+  *  - 本函数会重新配置并启动 TIMx，计数从 0 开始。
+  *  - 用户需使能 TIMx 的 NVIC 中断并在 TIMx_IRQHandler 中调用 myTIM_ClockIRQHandler()。
+  *
+  * @example
+  *  RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM5, ENABLE);
+  *  myTIM_ClockInit(TIM5, 1000000, 4);          // 1MHz 时间戳，通道 4 做半周期比较
+  */
+ErrorStatus myTIM_ClockInit(TIM_TypeDef* TIMx, uint32_t TickFreq, uint8_t Channel)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    uint32_t timclk = 0;
+    uint32_t psc = 0;
+    uint8_t shift = 32;
+
+    /* 参数检查 */
+    assert_param(TIMx == TIM2 || TIMx == TIM5);
+    assert_param(TickFreq != 0);
+
+    if ((TIMx != TIM2 && TIMx != TIM5) || TickFreq == 0)
+    {
+        return ERROR;
+    }
+
+    /* 计算预分频，四舍五入到最近的整数 */
+    timclk = myTIM_GetClockFreq(TIMx);
+    psc = (timclk + TickFreq / 2) / TickFreq;
+    if (psc == 0 || psc > 0x10000)
+    {
+        return ERROR;
+    }
+
+    /* 停止计数器，配置为满量程向上计数；URS = 1 使 UG 不置 UIF */
+    myTIM_Cmd(TIMx, DISABLE);
+    myTIM_UpdateRequestConfig(TIMx, TIM_UpdateSource_Regular);
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Prescaler = (uint16_t)(psc - 1);
+    timeBase.TIM_Period = 0xFFFFFFFF;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+    myTIM_SetCounter(TIMx, 0);
+
+    if (myTIM_ExtendInit(&s_clock, TIMx, Channel) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    /* 预先算好 节拍 -> 纳秒 的定点系数：ns = ticks * mult >> shift，mult 取能放进 32 位的最大精度 */
+    s_clockFreq = timclk / psc;
+    while (shift > 0 && (((uint64_t)1000000000 << shift) / s_clockFreq) > 0xFFFFFFFF)
+    {
+        shift--;
+    }
+    s_nsShift = shift;
+    s_nsMult = (uint32_t)((((uint64_t)1000000000 << shift) + s_clockFreq / 2) / s_clockFreq);
+
+    myTIM_Cmd(TIMx, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  读取 64 位时间戳（计数节拍）。
+  * @retval 自 myTIM_ClockInit() 以来的节拍数
+  * @note   无锁、不关中断，可在任意上下文调用。
+  */
+uint64_t myTIM_ClockGetTicks(void)
+{
+    return myTIM_ExtendRead(&s_clock);
+}
+
+/**
+  * @brief  将节拍数换算为纳秒。
+  * @param  Ticks: 节拍数。
+  * @retval 纳秒数
+  *
+  * @note
+  *  - 使用初始化时算好的定点系数，只有两次 32x32 乘法和移位，没有 64 位除法。
+  *  - 高 32 位和低 32 位分开相乘，避免 ticks * mult 溢出 64 位。
+  *  - 系数相对误差小于 2^-32 / (1e9 / f)，1MHz 计数时约 0.25ppb。
+  */
+uint64_t myTIM_ClockTicksToNanos(uint64_t Ticks)
+{
+    uint32_t hi = (uint32_t)(Ticks >> 32);
+    uint32_t lo = (uint32_t)Ticks;
+
+    return (((uint64_t)hi * s_nsMult) << (32 - s_nsShift)) +
+        (((uint64_t)lo * s_nsMult) >> s_nsShift);
+}
+
+/**
+  * @brief  读取 64 位时间戳（纳秒）。
+  * @retval 自 myTIM_ClockInit() 以来的纳秒数
+  */
+uint64_t myTIM_ClockGetNanos(void)
+{
+    return myTIM_ClockTicksToNanos(myTIM_ExtendRead(&s_clock));
+}
+
+/**
+  * @brief  获取时间戳实际计数频率。
+  * @retval 频率 Hz，未初始化时为 0
+  */
+uint32_t myTIM_ClockGetFreq(void)
+{
+    return s_clockFreq;
+}
+
+/**
+  * @brief  获取时间戳所用的定时器。
+  * @retval TIM2 / TIM5，未初始化时为 NULL
+  * @note   其它模块（如定时轮）可借此在同一时基的空闲通道上工作。
+  */
+TIM_TypeDef* myTIM_ClockGetTIM(void)
+{
+    return s_clock.TIMx;
+}
+
+/**
+  * @brief  时间戳中断处理函数。
+  * @retval None
+  * @note   在 TIM2_IRQHandler / TIM5_IRQHandler 中调用。
+  */
+void myTIM_ClockIRQHandler(void)
+{
+    myTIM_ExtendIRQHandler(&s_clock);
+}
@@ -0,0 +1,28 @@
+﻿#ifndef mystm32f4_tim_clock_h
+#define mystm32f4_tim_clock_h
+
+#include "mystm32f4_tim.h"
+
+/* 定时器计数值 64 位扩展描述符 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;           /* 被扩展的定时器，计数器须向上计数且 ARR 为满量程 */
+    volatile uint32_t Half;      /* 已记录的计数器最高位翻转次数（仅由中断写入） */
+    uint32_t HalfMask;           /* 计数器最高位掩码：32 位为 0x80000000，16 位为 0x8000 */
+    uint8_t  Width;              /* 计数器位宽：32 或 16 */
+    uint8_t  Channel;            /* 用于半周期比较中断的通道，1~4 */
+} TIM_ExtendTypeDef;
+
+ErrorStatus myTIM_ExtendInit(TIM_ExtendTypeDef* Ext, TIM_TypeDef* TIMx, uint8_t Channel); // 初始化计数值 64 位扩展
+uint64_t myTIM_ExtendRead(TIM_ExtendTypeDef* Ext);                    // 无锁读取 64 位扩展计数值
+void myTIM_ExtendIRQHandler(TIM_ExtendTypeDef* Ext);                  // 扩展计数中断处理，在 TIMx_IRQHandler 中调用
+
+ErrorStatus myTIM_ClockInit(TIM_TypeDef* TIMx, uint32_t TickFreq, uint8_t Channel); // 初始化 64 位单调时间戳（TIM2/TIM5）
+uint64_t myTIM_ClockGetTicks(void);                                   // 读取 64 位时间戳（计数节拍）
+uint64_t myTIM_ClockGetNanos(void);                                   // 读取 64 位时间戳（纳秒）
+uint64_t myTIM_ClockTicksToNanos(uint64_t Ticks);                     // 节拍数换算为纳秒
+uint32_t myTIM_ClockGetFreq(void);                                    // 获取时间戳实际计数频率
+TIM_TypeDef* myTIM_ClockGetTIM(void);                                 // 获取时间戳所用定时器
+void myTIM_ClockIRQHandler(void);                                     // 时间戳中断处理，在 TIMx_IRQHandler 中调用
+
+#endif
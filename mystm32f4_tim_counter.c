@@ -0,0 +1,439 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_counter.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    ETR / TIx 外部时钟脉冲计数与直接法、倒数法自动切换测频
+  *
+  * @attention
+  *
+  * 本文件在 TIM_ETRClockMode1Config()、TIM_ETRClockMode2Config()、
+  * myTIM_TIxExternalClockConfig() 之上提供 MHz 级外部脉冲计数服务：
+  *
+  * - 外部脉冲直接作为计数器时钟，每个边沿由硬件加 1，CPU 不参与；
+  *   计数值用 myTIM_ExtendInit() 扩展到 64 位，每半个量程只进一次中断。
+  * - ETR 预分频（/2 /4 /8）让输入频率可以超过定时器时钟的 1/4：
+  *   ETR 同步后的信号最高 TIMxCLK/4，预分频 /8 后输入最高约 2 × TIMxCLK（受引脚限制）。
+  *   TIx 输入最高约 TIMxCLK/2。
+  * - ETR2 模式不占用从模式控制器，可以再配置门控从模式：只在 TRGI（例如另一个
+  *   定时器的单脉冲输出）为高时计数，窗口宽度由硬件决定，得到严格的门控计数。
+  *
+  * 测频（myTIM_CounterSample，无需每边沿中断）：
+  * - 直接法：相邻两次采样的计数差 / 参考时基时间差，误差 ±1 个计数，适合高频。
+  * - 倒数法：在计数定时器的比较通道上挂“下一个边沿”（CCR = CNT + 1，翻转模式），
+  *   比较匹配产生的 OCxREF 经 TRGO -> ITRx 送到参考时基（TIM2/TIM5）的 TRC 捕获通道，
+  *   由硬件记下该边沿的时刻。两个被捕获的边沿之间是整数个输入周期，
+  *   误差只有 ±1 个参考时基节拍，与输入频率无关，适合低频。
+  * - 窗口内计数 >= TIM_COUNTER_DIRECT_ENTER 用直接法，< TIM_COUNTER_DIRECT_EXIT 用倒数法。
+  *   高频时 CNT 变化太快，CPU 无法可靠地把比较挂到“下一个”边沿，因此不用倒数法。
+  * - 输入停止时，倒数法结果按“距上一个边沿的时间”单调衰减到 0，不会停在旧值。
+  *
+  * 限制：
+  * - 计数定时器须为 TIM1~TIM5/TIM8；参考时基须为 TIM2/TIM5 且与计数定时器之间有
+  *   内部触发连接（myTIM_GetInternalTrigger），参考时基的 TS 位被本模块占用。
+  * - 16 位计数定时器每 32768 个计数进一次扩展中断，10MHz 输入时约 300 次/秒。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 TIM3 与 TIM5 时钟，PD2 复用为 TIM3_ETR；TIM5 已作为满量程自由运行时基
+    （例如 myTIM_ClockInit(TIM5, 84000000, 1)）。
+
+(#) 初始化：
+    TIM_CounterInitTypeDef init;
+    myTIM_CounterStructInit(&init);
+    init.CntTIM = TIM3;
+    init.Source = TIM_COUNTER_SRC_ETR2;
+    init.ExtTRGPrescaler = TIM_ExtTRGPSC_DIV2;
+    init.RefTIM = TIM5;
+    myTIM_CounterInit(&cnt, &init);
+
+(#) TIM3_IRQHandler 中调用 myTIM_CounterIRQHandler(&cnt)
+
+(#) 周期调用（例如每 100ms）：myTIM_CounterSample(&cnt)
+
+(#) 任意上下文读取：myTIM_CounterGetSnapshot(&cnt, &snap)
+    snap.FreqMilliHz / 1000 为整数 Hz，snap.Count 为累计脉冲数
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_counter.h"
+
+/* Private function prototypes -----------------------------------------------*/
+static uint64_t Counter_Freq(const TIM_CounterTypeDef* Cnt, uint64_t Counts, uint32_t Ticks);
+static void Counter_Arm(TIM_CounterTypeDef* Cnt);
+static void Counter_UpdateEdge(TIM_CounterTypeDef* Cnt, uint32_t Now);
+
+
+/**
+  * @brief  初始化脉冲计数器参数结构体为默认值。
+  * @param  Init: 参数结构体。
+  * @retval None
+  * @note   默认：ETR 模式 2、不分频、上升沿、无滤波、不门控，
+  *         CH4 做 64 位扩展，CH3 标记边沿，参考时基 CH3 捕获，10Hz 采样。
+  */
+void myTIM_CounterStructInit(TIM_CounterInitTypeDef* Init)
+{
+    Init->CntTIM = NULL;
+    Init->Source = TIM_COUNTER_SRC_ETR2;
+    Init->ExtTRGPrescaler = TIM_ExtTRGPSC_OFF;
+    Init->ExtTRGPolarity = TIM_ExtTRGPolarity_NonInverted;
+    Init->ICPolarity = TIM_ICPolarity_Rising;
+    Init->Filter = 0;
+    Init->GateTrigger = TIM_COUNTER_NO_GATE;
+    Init->ExtChannel = 4;
+    Init->RefTIM = NULL;
+    Init->RefChannel = 3;
+    Init->EdgeChannel = 3;
+    Init->SampleFreq = 10;
+}
+
+/**
+  * @brief  初始化外部脉冲计数器。
+  * @param  Cnt: 计数器句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成并已开始计数；
+  *         ERROR: 定时器/来源/通道组合非法，或参考时基不满足要求。
+  *
+  * @note
+  *  - CntTIM 被配置为满量程、PSC = 0 向上计数，计数从 0 开始。
+  *  - TIx 来源占用对应输入通道（TI1/TI1ED 占 CH1，TI2 占 CH2），ExtChannel、
+  *    EdgeChannel 不能与之重复。
+  *  - 门控只支持 ETR2：ETR1 和 TIx 已经占用了从模式控制器。
+  *  - 两个定时器的时钟需提前使能，NVIC 只需要 CntTIM 的中断。
+  *  - 小白理解：脉冲当“时钟”喂给计数器，硬件自己数，CPU 只管隔一段时间来看一眼。
+  */
+ErrorStatus myTIM_CounterInit(TIM_CounterTypeDef* Cnt, TIM_CounterInitTypeDef* Init)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_ICInitTypeDef ic;
+    TIM_TypeDef* TIMx = Init->CntTIM;
+    TIM_TypeDef* ref = Init->RefTIM;
+    uint16_t trig = 0;
+    uint8_t inCh = 0;
+    uint8_t edge = Init->EdgeChannel;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST3_PERIPH(TIMx));
+    assert_param(Init->Source <= TIM_COUNTER_SRC_TI1ED);
+    assert_param(IS_TIM_IC_FILTER(Init->Filter));
+    assert_param(ref != NULL || Init->SampleFreq != 0);
+
+    /* TIx 来源占用的输入通道 */
+    inCh = (Init->Source == TIM_COUNTER_SRC_TI2) ? 2 : (Init->Source >= TIM_COUNTER_SRC_TI1) ? 1 : 0;
+
+    if (TIMx == NULL || Init->Source > TIM_COUNTER_SRC_TI1ED
+        || Init->ExtChannel < 1 || Init->ExtChannel > 4 || Init->ExtChannel == inCh
+        || (Init->GateTrigger != TIM_COUNTER_NO_GATE && Init->Source != TIM_COUNTER_SRC_ETR2)
+        || (ref == NULL && Init->SampleFreq == 0))
+    {
+        return ERROR;
+    }
+
+    if (ref != NULL)
+    {
+        trig = myTIM_GetInternalTrigger(ref, TIMx);
+        if ((ref != TIM2 && ref != TIM5) || ref == TIMx || trig == 0xFFFF || ref->ARR != 0xFFFFFFFF
+            || edge < 1 || edge > 4 || edge == inCh || edge == Init->ExtChannel
+            || Init->RefChannel < 1 || Init->RefChannel > 4)
+        {
+            return ERROR;
+        }
+    }
+
+    Cnt->RefTIM = ref;
+    Cnt->SampleFreq = Init->SampleFreq;
+    Cnt->CntMask = (TIMx == TIM2 || TIMx == TIM5) ? 0xFFFFFFFF : 0xFFFF;
+    Cnt->Mul = (Init->Source <= TIM_COUNTER_SRC_ETR2) ? (uint8_t)(1U << (Init->ExtTRGPrescaler >> 12)) : 1;
+    Cnt->Div = (Init->Source == TIM_COUNTER_SRC_TI1ED) ? 2 : 1;
+    Cnt->RefChannel = Init->RefChannel;
+    Cnt->EdgeChannel = edge;
+    Cnt->Method = TIM_COUNTER_METHOD_DIRECT;
+    Cnt->Armed = 0;
+    Cnt->EdgeValid = 0;
+    Cnt->RecipValid = 0;
+    Cnt->LastCount = 0;
+    Cnt->RecipFreq = 0;
+    Cnt->Seq = 0;
+
+    /* 计数定时器：满量程，不分频 */
+    myTIM_Cmd(TIMx, DISABLE);
+    TIMx->SMCR = 0;
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Period = Cnt->CntMask;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+
+    /* 时钟来源 */
+    switch (Init->Source)
+    {
+    case TIM_COUNTER_SRC_ETR1:
+        TIM_ETRClockMode1Config(TIMx, Init->ExtTRGPrescaler, Init->ExtTRGPolarity, Init->Filter);
+        break;
+    case TIM_COUNTER_SRC_ETR2:
+        TIM_ETRClockMode2Config(TIMx, Init->ExtTRGPrescaler, Init->ExtTRGPolarity, Init->Filter);
+        if (Init->GateTrigger != TIM_COUNTER_NO_GATE)
+        {
+            myTIM_SelectInputTrigger(TIMx, Init->GateTrigger);
+            myTIM_SelectSlaveMode(TIMx, TIM_SlaveMode_Gated);
+        }
+        break;
+    default:
+        myTIM_TIxExternalClockConfig(TIMx,
+            (Init->Source == TIM_COUNTER_SRC_TI1) ? TIM_TIxExternalCLK1Source_TI1 :
+            (Init->Source == TIM_COUNTER_SRC_TI2) ? TIM_TIxExternalCLK1Source_TI2 : TIM_TIxExternalCLK1Source_TI1ED,
+            Init->ICPolarity, Init->Filter);
+        break;
+    }
+
+    if (ref != NULL)
+    {
+        /* 边沿标记通道：翻转模式、无预装载、不输出到引脚，OCxREF 经 TRGO 送参考时基 */
+        myTIM_SelectOCxM(TIMx, (uint16_t)((edge - 1) << 2), TIM_OCMode_Toggle);
+        (edge <= 2) ? (TIMx->CCMR1 &= (uint16_t)~(TIM_CCMR1_OC1PE << ((edge - 1) * 8)))
+            : (TIMx->CCMR2 &= (uint16_t)~(TIM_CCMR2_OC3PE << ((edge - 3) * 8)));
+        myTIM_SelectOutputTrigger(TIMx, (uint16_t)(TIM_TRGOSource_OC1Ref + ((edge - 1) << 4)));
+
+        /* 参考时基：TRC 双边沿捕获，TS 指向计数定时器，从模式保持关闭 */
+        myTIM_SelectInputTrigger(ref, trig);
+        myTIM_ICStructInit(&ic);
+        ic.TIM_Channel = (uint16_t)((Init->RefChannel - 1) << 2);
+        ic.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+        ic.TIM_ICSelection = TIM_ICSelection_TRC;
+        myTIM_ICInit(ref, &ic);
+
+        Cnt->RefFreq = myTIM_GetClockFreq(ref) / (ref->PSC + 1);
+        Cnt->LastTime = ref->CNT;
+    }
+
+    if (myTIM_ExtendInit(&Cnt->Ext, TIMx, Init->ExtChannel) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    myTIM_Cmd(TIMx, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  读取 64 位累计计数。
+  * @param  Cnt: 计数器句柄。
+  * @retval 计数器累计计数；输入脉冲数约为 计数 × ETR 预分频（TI1ED 为 计数 / 2）
+  * @note   不关中断，可在任意上下文调用。
+  */
+uint64_t myTIM_CounterRead(TIM_CounterTypeDef* Cnt)
+{
+    return myTIM_ExtendRead(&Cnt->Ext);
+}
+
+/**
+  * @brief  采样：测量频率并发布快照。
+  * @param  Cnt: 计数器句柄。
+  * @retval None
+  *
+  * @note
+  *  - 有参考时基时调用间隔不必精确，时长以参考时基为准；没有时必须以 SampleFreq 调用。
+  *  - 调用间隔就是测频窗口：间隔越长，直接法分辨率越高、倒数法结果越平滑。
+  *  - 只能有一个调用者（单写者），读取方使用 myTIM_CounterGetSnapshot()。
+  */
+void myTIM_CounterSample(TIM_CounterTypeDef* Cnt)
+{
+    TIM_CounterSnapshotTypeDef* snap = NULL;
+    uint64_t count = 0;
+    uint64_t delta = 0;
+    uint64_t freq = 0;
+    uint32_t now = 0;
+    uint32_t seq = Cnt->Seq;
+    uint32_t primask = __get_PRIMASK();
+
+    /* 计数与时刻在同一时间点读取 */
+    __disable_irq();
+    count = myTIM_ExtendRead(&Cnt->Ext);
+    now = (Cnt->RefTIM != NULL) ? Cnt->RefTIM->CNT : 0;
+    __set_PRIMASK(primask);
+
+    delta = count - Cnt->LastCount;
+
+    if (Cnt->RefTIM == NULL)
+    {
+        freq = delta * Cnt->Mul * Cnt->SampleFreq * 1000 / Cnt->Div;
+    }
+    else
+    {
+        Cnt->Method = (delta >= TIM_COUNTER_DIRECT_ENTER) ? TIM_COUNTER_METHOD_DIRECT :
+                      (delta < TIM_COUNTER_DIRECT_EXIT) ? TIM_COUNTER_METHOD_RECIP : Cnt->Method;
+
+        if (Cnt->Method == TIM_COUNTER_METHOD_RECIP)
+        {
+            Counter_UpdateEdge(Cnt, now);
+        }
+        else
+        {
+            /* 高频：放弃边沿标记，重新进入倒数法时从头开始 */
+            Cnt->Armed = 0;
+            Cnt->EdgeValid = 0;
+            Cnt->RecipValid = 0;
+        }
+
+        freq = (Cnt->Method == TIM_COUNTER_METHOD_RECIP && Cnt->RecipValid) ? Cnt->RecipFreq
+            : Counter_Freq(Cnt, delta, now - Cnt->LastTime);
+    }
+
+    Cnt->LastCount = count;
+    Cnt->LastTime = now;
+
+    /* 写入空闲的一份快照后再发布序号 */
+    snap = &Cnt->Snap[(seq + 1) & 1];
+    snap->Count = count;
+    snap->FreqMilliHz = freq;
+    snap->Sequence = seq + 1;
+    snap->Method = (Cnt->RefTIM != NULL) ? Cnt->Method : TIM_COUNTER_METHOD_DIRECT;
+
+    __DMB();
+    Cnt->Seq = seq + 1;
+}
+
+/**
+  * @brief  无锁读取最新快照。
+  * @param  Cnt: 计数器句柄。
+  * @param  Snap: 输出快照。
+  * @retval None
+  * @note   不关中断，可在任意优先级调用；读取期间写方完整执行两次时重读。
+  */
+void myTIM_CounterGetSnapshot(const TIM_CounterTypeDef* Cnt, TIM_CounterSnapshotTypeDef* Snap)
+{
+    uint32_t seq = 0;
+
+    do
+    {
+        seq = Cnt->Seq;
+        __DMB();
+        *Snap = Cnt->Snap[seq & 1];
+        __DMB();
+    } while ((uint32_t)(Cnt->Seq - seq) >= 2);
+}
+
+/**
+  * @brief  计数定时器中断处理函数。
+  * @param  Cnt: 计数器句柄。
+  * @retval None
+  * @note   在 CntTIM 的 TIMx_IRQHandler 中调用，只处理 64 位扩展的更新和半量程标志；
+  *         边沿标记通道不开中断。
+  */
+void myTIM_CounterIRQHandler(TIM_CounterTypeDef* Cnt)
+{
+    myTIM_ExtendIRQHandler(&Cnt->Ext);
+}
+
+/**
+  * @brief  计数差 / 参考节拍差 换算为频率。
+  * @param  Cnt: 计数器句柄。
+  * @param  Counts: 计数器计数差。
+  * @param  Ticks: 参考时基节拍差。
+  * @retval 频率（mHz）
+  * @note   先求整数 Hz 再求余数部分，计数差 1e8、RefFreq 168MHz 时中间值也不溢出 64 位。
+  */
+static uint64_t Counter_Freq(const TIM_CounterTypeDef* Cnt, uint64_t Counts, uint32_t Ticks)
+{
+    uint64_t num = Counts * Cnt->Mul * Cnt->RefFreq;
+    uint64_t hz = 0;
+    uint64_t rem = 0;
+
+    if (Ticks == 0)
+    {
+        return 0;
+    }
+
+    hz = num / Ticks;
+    rem = num % Ticks;
+
+    return (hz * 1000 + rem * 1000 / Ticks) / Cnt->Div;
+}
+
+/**
+  * @brief  在下一个输入边沿上挂比较，并清除上一次的匹配标志。
+  * @param  Cnt: 计数器句柄。
+  * @retval None
+  * @note   写 CCR 后 CNT 变了说明边沿可能正好落在读写之间，
+  *         此时清标志重挂，保证标志和捕获只对应 ArmIndex 这一个边沿。
+  */
+static void Counter_Arm(TIM_CounterTypeDef* Cnt)
+{
+    TIM_TypeDef* TIMx = Cnt->Ext.TIMx;
+    uint16_t flag = (uint16_t)(TIM_SR_CC1IF << (Cnt->EdgeChannel - 1));
+    volatile uint32_t* ccr = &TIMx->CCR1 + (Cnt->EdgeChannel - 1);
+    uint64_t c = 0;
+
+    do
+    {
+        TIMx->SR = (uint16_t)~flag;
+        c = myTIM_ExtendRead(&Cnt->Ext);
+        *ccr = (uint32_t)(c + 1) & Cnt->CntMask;
+    } while (((TIMx->CNT ^ (uint32_t)c) & Cnt->CntMask) != 0);
+
+    Cnt->ArmIndex = c + 1;
+    Cnt->Armed = 1;
+}
+
+/**
+  * @brief  倒数法：取回被捕获的边沿，计算频率并重新挂下一个边沿。
+  * @param  Cnt: 计数器句柄。
+  * @param  Now: 本次采样的参考时刻。
+  * @retval None
+  * @note
+  *  - 两个捕获边沿之间的计数差是整数个输入周期，时刻由硬件捕获，没有软件延迟。
+  *  - 本窗口没有新边沿时，用“1 个边沿 / 距上一个边沿的时间”作为上限，
+  *    输入停止后频率连续下降；距上一个边沿超过参考时基半量程时归 0。
+  */
+static void Counter_UpdateEdge(TIM_CounterTypeDef* Cnt, uint32_t Now)
+{
+    TIM_TypeDef* TIMx = Cnt->Ext.TIMx;
+    uint16_t flag = (uint16_t)(TIM_SR_CC1IF << (Cnt->EdgeChannel - 1));
+    uint32_t t = 0;
+    uint32_t elapsed = 0;
+    uint64_t bound = 0;
+
+    if (Cnt->Armed && (TIMx->SR & flag))
+    {
+        t = myTIM_GetCapture(Cnt->RefTIM, (uint8_t)((Cnt->RefChannel - 1) << 2));
+        if (Cnt->EdgeValid && Cnt->ArmIndex != Cnt->EdgeIndex)
+        {
+            Cnt->RecipFreq = Counter_Freq(Cnt, Cnt->ArmIndex - Cnt->EdgeIndex, t - Cnt->EdgeTime);
+            Cnt->RecipValid = 1;
+        }
+        Cnt->EdgeIndex = Cnt->ArmIndex;
+        Cnt->EdgeTime = t;
+        Cnt->EdgeValid = 1;
+        Cnt->Armed = 0;
+    }
+    else if (Cnt->EdgeValid)
+    {
+        elapsed = Now - Cnt->EdgeTime;
+        bound = Counter_Freq(Cnt, 1, elapsed);
+        Cnt->RecipFreq = (elapsed >= 0x80000000) ? 0 : (bound < Cnt->RecipFreq) ? bound : Cnt->RecipFreq;
+        Cnt->EdgeValid = (elapsed >= 0x80000000) ? 0 : 1;
+    }
+
+    if (!Cnt->Armed)
+    {
+        Counter_Arm(Cnt);
+    }
+}
@@ -0,0 +1,86 @@
+﻿#ifndef mystm32f4_tim_counter_h
+#define mystm32f4_tim_counter_h
+
+#include "mystm32f4_tim.h"
+#include "mystm32f4_tim_clock.h"
+
+/* 直接法/倒数法切换滞回：一次采样窗口内计数 >= ENTER 用直接法，< EXIT 用倒数法 */
+#ifndef TIM_COUNTER_DIRECT_ENTER
+#define TIM_COUNTER_DIRECT_ENTER    2000
+#endif
+#ifndef TIM_COUNTER_DIRECT_EXIT
+#define TIM_COUNTER_DIRECT_EXIT     1000
+#endif
+
+/* 计数时钟来源 */
+#define TIM_COUNTER_SRC_ETR1        0   /* ETR 外部时钟模式 1（SMS = 111，TS = ETRF） */
+#define TIM_COUNTER_SRC_ETR2        1   /* ETR 外部时钟模式 2（ECE = 1，从模式控制器空闲，可做门控） */
+#define TIM_COUNTER_SRC_TI1         2   /* TI1FP1 单边沿 */
+#define TIM_COUNTER_SRC_TI2         3   /* TI2FP2 单边沿 */
+#define TIM_COUNTER_SRC_TI1ED       4   /* TI1 双边沿，每个周期计 2 */
+
+#define TIM_COUNTER_METHOD_DIRECT   0   /* 直接法：窗口内计数 / 窗口时长（高频） */
+#define TIM_COUNTER_METHOD_RECIP    1   /* 倒数法：整数个边沿 / 边沿对齐的时长（低频） */
+
+#define TIM_COUNTER_NO_GATE         ((uint16_t)0xFFFF)
+
+/* 脉冲计数器初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* CntTIM;         /* 计数定时器 TIM1~TIM5/TIM8，满量程向上计数 */
+    uint8_t  Source;             /* TIM_COUNTER_SRC_x */
+    uint16_t ExtTRGPrescaler;    /* ETR 预分频 TIM_ExtTRGPSC_OFF / DIV2 / DIV4 / DIV8（仅 ETR） */
+    uint16_t ExtTRGPolarity;     /* TIM_ExtTRGPolarity_NonInverted / Inverted（仅 ETR） */
+    uint16_t ICPolarity;         /* TIM_ICPolarity_Rising / Falling（仅 TIx） */
+    uint8_t  Filter;             /* 输入滤波 0x0~0xF */
+    uint16_t GateTrigger;        /* 门控触发源 TIM_TS_x，只在 TRGI 为高时计数；TIM_COUNTER_NO_GATE 为不门控（仅 ETR2） */
+    uint8_t  ExtChannel;         /* 64 位扩展占用的比较通道 1~4 */
+    TIM_TypeDef* RefTIM;         /* 参考时基 TIM2/TIM5，满量程运行；NULL 表示只用直接法 */
+    uint8_t  RefChannel;         /* 参考时基上捕获边沿时刻的通道 1~4 */
+    uint8_t  EdgeChannel;        /* 计数定时器上标记边沿的比较通道 1~4 */
+    uint32_t SampleFreq;         /* 没有 RefTIM 时 myTIM_CounterSample() 的调用频率（Hz） */
+} TIM_CounterInitTypeDef;
+
+/* 计数/频率快照 */
+typedef struct
+{
+    uint64_t Count;              /* 64 位累计计数（计数器计数，未乘 ETR 预分频） */
+    uint64_t FreqMilliHz;        /* 输入信号频率，单位 mHz */
+    uint32_t Sequence;           /* 采样序号 */
+    uint8_t  Method;             /* 本次频率所用方法 TIM_COUNTER_METHOD_x */
+} TIM_CounterSnapshotTypeDef;
+
+/* 脉冲计数器句柄，由调用者分配 */
+typedef struct
+{
+    TIM_ExtendTypeDef Ext;       /* 计数值 64 位扩展 */
+    TIM_TypeDef* RefTIM;
+    uint32_t RefFreq;            /* 参考时基计数频率（Hz） */
+    uint32_t SampleFreq;
+    uint32_t CntMask;            /* 计数器量程掩码 */
+    uint8_t  Mul;                /* 每个计数对应的输入边沿数（ETR 预分频） */
+    uint8_t  Div;                /* 每个输入周期的计数数（TI1ED 为 2） */
+    uint8_t  RefChannel;
+    uint8_t  EdgeChannel;
+    uint8_t  Method;             /* 当前方法 */
+    uint8_t  Armed;              /* 已在 EdgeIndex 之后的下一个边沿上挂好比较 */
+    uint8_t  EdgeValid;          /* EdgeIndex/EdgeTime 有效 */
+    uint8_t  RecipValid;         /* RecipFreq 有效 */
+    uint64_t LastCount;          /* 上一次采样的计数 */
+    uint32_t LastTime;           /* 上一次采样的参考时刻 */
+    uint64_t ArmIndex;           /* 挂好的边沿序号（计数值） */
+    uint64_t EdgeIndex;          /* 最近一个已捕获边沿的序号 */
+    uint32_t EdgeTime;           /* 最近一个已捕获边沿的参考时刻 */
+    uint64_t RecipFreq;          /* 倒数法最近结果（mHz） */
+    volatile uint32_t Seq;       /* 快照序号，Snap[Seq & 1] 为最新 */
+    TIM_CounterSnapshotTypeDef Snap[2];
+} TIM_CounterTypeDef;
+
+void myTIM_CounterStructInit(TIM_CounterInitTypeDef* Init);           // 初始化参数结构体默认值
+ErrorStatus myTIM_CounterInit(TIM_CounterTypeDef* Cnt, TIM_CounterInitTypeDef* Init); // 初始化外部脉冲计数器
+uint64_t myTIM_CounterRead(TIM_CounterTypeDef* Cnt);                  // 读取 64 位累计计数
+void myTIM_CounterSample(TIM_CounterTypeDef* Cnt);                    // 采样：测量频率并发布快照
+void myTIM_CounterGetSnapshot(const TIM_CounterTypeDef* Cnt, TIM_CounterSnapshotTypeDef* Snap); // 无锁读取最新快照
+void myTIM_CounterIRQHandler(TIM_CounterTypeDef* Cnt);                // 计数定时器中断处理，在 TIMx_IRQHandler 中调用
+
+#endif
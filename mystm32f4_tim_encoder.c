@@ -0,0 +1,434 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_encoder.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    正交编码器 64 位位置与 M/T 法速度估计
+  *
+  * @attention
+  *
+  * 本文件在 TIM_EncoderInterfaceConfig() 之上提供编码器服务：
+  *
+  * 位置：
+  * - 计数器差值按计数器位宽做有符号扩展后累加到 64 位位置。
+  * - 只要两次累加之间计数器移动不超过半个量程，结果就是正确的。为此在
+  *   计数器过 0（更新中断）和过半量程（CH3 比较中断）时各累加一次，
+  *   即使控制环停止调用，位置也不会丢圈。
+  *
+  * 速度（M/T 法）：
+  * - M 法：固定采样频率下，用最近 2^TIM_ENCODER_WINDOW_BITS 次采样的位置差求速度，
+  *   高速时相对分辨率高，低速时量化严重（窗口内只有零星几个计数）。
+  * - T 法：另一个定时器在 A 相上升沿复位并捕获（复位从模式 + TI1FP1），
+  *   CCR1 即为一个完整 A 相周期的节拍数，低速时精度高。
+  *   距离上一个边沿的时间（CNT）超过上一个周期时，用 CNT 作为周期上限，
+  *   速度随停转平滑衰减；计数器溢出（URS=1 时只有溢出置 UIF）视为停转。
+  * - 窗口内计数绝对值带滞回地在两种方法之间切换。
+  *
+  * 快照：
+  * - 采样结果写入双缓冲中的空闲一份后递增序号，读取方按序号取最新一份，
+  *   读取期间若序号前进 2 次以上（被写方抢占并覆盖）则重读。
+  * - 写方和读方谁的优先级高都不会死等，读方不关中断。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能定时器时钟并把引脚复用到定时器：
+    TIM3 CH1/CH2 接 A/B 相；TIM4 CH1 也接 A 相（同一信号接两个引脚）。
+
+(#) 初始化：
+    TIM_EncoderInitTypeDef init;
+    myTIM_EncoderStructInit(&init);
+    init.EncTIM = TIM3;
+    init.PerTIM = TIM4;             // 不需要低速精度时保持 NULL
+    init.PerFreq = 1000000;         // 周期测量 1MHz
+    init.SampleFreq = 20000;        // 控制环 20kHz
+    myTIM_EncoderInit(&enc, &init);
+
+(#) 使能 EncTIM 的 NVIC 中断，在 TIM3_IRQHandler 中调用 myTIM_EncoderIRQHandler(&enc)
+
+(#) 在固定频率的上下文（例如控制环定时器中断）中调用 myTIM_EncoderSample(&enc)
+
+(#) 在任意上下文读取：myTIM_EncoderGetSnapshot(&enc, &snap)
+    snap.Velocity >> 8 为整数计数/秒
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_encoder.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ENC_WINDOW_MASK       (TIM_ENCODER_WINDOW - 1)
+
+/* Private function prototypes -----------------------------------------------*/
+static void Encoder_Accumulate(TIM_EncoderTypeDef* Enc);
+static void Encoder_UpdatePeriod(TIM_EncoderTypeDef* Enc);
+static int32_t Encoder_VelocityM(TIM_EncoderTypeDef* Enc, int32_t Window);
+static int32_t Encoder_VelocityT(TIM_EncoderTypeDef* Enc);
+
+
+/**
+  * @brief  初始化编码器参数结构体为默认值。
+  * @param  Init: 参数结构体。
+  * @retval None
+  * @note   默认：四倍频、上升沿、无滤波、无周期定时器、1MHz 周期计数、20kHz 采样。
+  */
+void myTIM_EncoderStructInit(TIM_EncoderInitTypeDef* Init)
+{
+    Init->EncTIM = NULL;
+    Init->EncoderMode = TIM_EncoderMode_TI12;
+    Init->IC1Polarity = TIM_ICPolarity_Rising;
+    Init->IC2Polarity = TIM_ICPolarity_Rising;
+    Init->ICFilter = 0;
+    Init->PerTIM = NULL;
+    Init->PerFreq = 1000000;
+    Init->SampleFreq = 20000;
+}
+
+/**
+  * @brief  初始化编码器服务。
+  * @param  Enc: 编码器句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成并已启动；ERROR: 参数非法或周期定时器频率无法实现。
+  *
+  * @note
+  *  - EncTIM 配置为满量程编码器计数，CH3 被占用做半量程比较，位置从 0 开始。
+  *  - PerTIM 配置为满量程向上计数、CH1 直接输入、复位从模式（TI1FP1），
+  *    URS = 1 使复位不置 UIF，UIF 只表示计数器溢出（转速过低）。
+  *  - 两个定时器的时钟需提前使能，NVIC 只需要 EncTIM 的中断。
+  *  - 小白理解：EncTIM 数脉冲（走了多远），PerTIM 量脉冲间隔（走一格花多久）。
+  */
+ErrorStatus myTIM_EncoderInit(TIM_EncoderTypeDef* Enc, TIM_EncoderInitTypeDef* Init)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_ICInitTypeDef ic;
+    TIM_TypeDef* enc = Init->EncTIM;
+    TIM_TypeDef* per = Init->PerTIM;
+    uint32_t psc = 0;
+    uint8_t i = 0;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST3_PERIPH(enc));
+    assert_param(IS_TIM_ENCODER_MODE(Init->EncoderMode));
+    assert_param(IS_TIM_IC_FILTER(Init->ICFilter));
+    assert_param(Init->SampleFreq != 0);
+    assert_param(per == NULL || (per != enc && Init->PerFreq != 0));
+
+    if (enc == NULL || Init->SampleFreq == 0 || per == enc || (per != NULL && Init->PerFreq == 0))
+    {
+        return ERROR;
+    }
+
+    Enc->EncTIM = enc;
+    Enc->PerTIM = per;
+    Enc->PerFreq = Init->PerFreq;
+    Enc->SampleFreq = Init->SampleFreq;
+    Enc->CntMask = (enc == TIM2 || enc == TIM5) ? 0xFFFFFFFF : 0xFFFF;
+    Enc->CountsPerCycle = (Init->EncoderMode == TIM_EncoderMode_TI12) ? 4 : 2;
+
+    /* 编码器定时器：满量程，编码器模式 */
+    myTIM_Cmd(enc, DISABLE);
+    enc->DIER &= (uint16_t)~(TIM_DIER_UIE | TIM_DIER_CC3IE);
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Period = Enc->CntMask;
+    myTIM_TimeBaseInit(enc, &timeBase);
+    TIM_EncoderInterfaceConfig(enc, Init->EncoderMode, Init->IC1Polarity, Init->IC2Polarity);
+    enc->CCMR1 = (uint16_t)((enc->CCMR1 & (uint16_t)~(TIM_CCMR1_IC1F | TIM_CCMR1_IC2F)) |
+        (uint16_t)(Init->ICFilter << 4) | (uint16_t)(Init->ICFilter << 12));
+
+    /* CH3 冻结比较，CCR3 = 半量程：计数器过半量程时累加一次 */
+    myTIM_SelectOCxM(enc, TIM_Channel_3, TIM_OCMode_Timing);
+    myTIM_SetCompare(enc, 3, (Enc->CntMask >> 1) + 1);
+    myTIM_SetCounter(enc, 0);
+
+    Enc->Base = 0;
+    Enc->LastCnt = 0;
+    Enc->RingIndex = 0;
+    for (i = 0; i < TIM_ENCODER_WINDOW; i++)
+    {
+        Enc->Ring[i] = 0;
+    }
+    Enc->Seq = 0;
+    Enc->Snap[0].Position = 0;
+    Enc->Snap[0].Velocity = 0;
+    Enc->Snap[0].Sequence = 0;
+    Enc->Snap[0].Method = TIM_ENCODER_METHOD_M;
+    Enc->Snap[1] = Enc->Snap[0];
+    Enc->Period = 0;
+    Enc->PeriodValid = 0;
+    Enc->DiscardNext = 1;   /* 第一个捕获是从启动开始数的，不是完整周期 */
+    Enc->Method = (per != NULL) ? TIM_ENCODER_METHOD_T : TIM_ENCODER_METHOD_M;
+
+    /* 周期测量定时器：A 相上升沿捕获并复位计数器 */
+    if (per != NULL)
+    {
+        psc = (myTIM_GetClockFreq(per) + Init->PerFreq / 2) / Init->PerFreq;
+        if (psc == 0 || psc > 0x10000)
+        {
+            return ERROR;
+        }
+
+        myTIM_Cmd(per, DISABLE);
+        myTIM_UpdateRequestConfig(per, TIM_UpdateSource_Regular);
+        myTIM_TimeBaseStructInit(&timeBase);
+        timeBase.TIM_Prescaler = (uint16_t)(psc - 1);
+        timeBase.TIM_Period = (per == TIM2 || per == TIM5) ? 0xFFFFFFFF : 0xFFFF;
+        myTIM_TimeBaseInit(per, &timeBase);
+
+        myTIM_ICStructInit(&ic);
+        ic.TIM_Channel = TIM_Channel_1;
+        ic.TIM_ICPolarity = Init->IC1Polarity;
+        ic.TIM_ICSelection = TIM_ICSelection_DirectTI;
+        ic.TIM_ICFilter = Init->ICFilter;
+        myTIM_ICInit(per, &ic);
+
+        myTIM_SelectInputTrigger(per, TIM_TS_TI1FP1);
+        myTIM_SelectSlaveMode(per, TIM_SlaveMode_Reset);
+        myTIM_SetCounter(per, 0);
+        per->SR = 0;
+        myTIM_Cmd(per, ENABLE);
+    }
+
+    enc->SR = (uint16_t)~(TIM_SR_UIF | TIM_SR_CC3IF);
+    enc->DIER |= (uint16_t)(TIM_DIER_UIE | TIM_DIER_CC3IE);
+    myTIM_Cmd(enc, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  读取当前 64 位位置。
+  * @param  Enc: 编码器句柄。
+  * @retval 位置（计数），正方向为编码器向上计数方向
+  * @note   读取时会顺带把计数器差值累加进位置，内部有极短的关中断区。
+  */
+int64_t myTIM_EncoderGetPosition(TIM_EncoderTypeDef* Enc)
+{
+    int64_t pos = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    Encoder_Accumulate(Enc);
+    pos = Enc->Base;
+    __set_PRIMASK(primask);
+
+    return pos;
+}
+
+/**
+  * @brief  设置当前位置（例如回零）。
+  * @param  Enc: 编码器句柄。
+  * @param  Position: 新的当前位置。
+  * @retval None
+  * @note   速度窗口同步平移，设置位置不会产生速度尖峰。
+  *         应与 myTIM_EncoderSample() 在同一上下文调用。
+  */
+void myTIM_EncoderSetPosition(TIM_EncoderTypeDef* Enc, int64_t Position)
+{
+    uint32_t offset = 0;
+    uint8_t i = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    Encoder_Accumulate(Enc);
+    offset = (uint32_t)(Position - Enc->Base);
+    Enc->Base = Position;
+    __set_PRIMASK(primask);
+
+    for (i = 0; i < TIM_ENCODER_WINDOW; i++)
+    {
+        Enc->Ring[i] += offset;
+    }
+}
+
+/**
+  * @brief  固定频率采样：更新位置、估计速度并发布快照。
+  * @param  Enc: 编码器句柄。
+  * @retval None
+  *
+  * @note
+  *  - 必须以 Init->SampleFreq 的频率周期调用，M 法速度以此为时基。
+  *  - 只能有一个调用者（单写者），读取方使用 myTIM_EncoderGetSnapshot()。
+  *  - 配置了 PerTIM 时，窗口内计数 >= TIM_ENCODER_M_ENTER 用 M 法，
+  *    < TIM_ENCODER_M_EXIT 用 T 法，中间保持上一次的方法。
+  */
+void myTIM_EncoderSample(TIM_EncoderTypeDef* Enc)
+{
+    TIM_EncoderSnapshotTypeDef* snap = NULL;
+    int64_t pos = myTIM_EncoderGetPosition(Enc);
+    uint32_t oldest = Enc->Ring[Enc->RingIndex];
+    int32_t window = (int32_t)((uint32_t)pos - oldest);
+    uint32_t absWindow = (window < 0) ? (uint32_t)-window : (uint32_t)window;
+    uint32_t seq = Enc->Seq;
+
+    Enc->Ring[Enc->RingIndex] = (uint32_t)pos;
+    Enc->RingIndex = (uint8_t)((Enc->RingIndex + 1) & ENC_WINDOW_MASK);
+
+    /* 选择方法 */
+    if (Enc->PerTIM != NULL)
+    {
+        Encoder_UpdatePeriod(Enc);
+
+        Enc->Method = (absWindow >= TIM_ENCODER_M_ENTER) ? TIM_ENCODER_METHOD_M :
+                      (absWindow < TIM_ENCODER_M_EXIT) ? TIM_ENCODER_METHOD_T : Enc->Method;
+    }
+
+    /* 写入空闲的一份快照后再发布序号 */
+    snap = &Enc->Snap[(seq + 1) & 1];
+    snap->Position = pos;
+    snap->Velocity = (Enc->Method == TIM_ENCODER_METHOD_M) ? Encoder_VelocityM(Enc, window) : Encoder_VelocityT(Enc);
+    snap->Sequence = seq + 1;
+    snap->Method = Enc->Method;
+
+    __DMB();
+    Enc->Seq = seq + 1;
+}
+
+/**
+  * @brief  无锁读取最新快照。
+  * @param  Enc: 编码器句柄。
+  * @param  Snap: 输出快照。
+  * @retval None
+  *
+  * @note
+  *  - 不关中断，可在任意优先级调用。
+  *  - 写方总是写另一份，只有读取期间写方完整执行两次才会覆盖正在读的一份，
+  *    此时重读。
+  */
+void myTIM_EncoderGetSnapshot(const TIM_EncoderTypeDef* Enc, TIM_EncoderSnapshotTypeDef* Snap)
+{
+    uint32_t seq = 0;
+
+    do
+    {
+        seq = Enc->Seq;
+        __DMB();
+        *Snap = Enc->Snap[seq & 1];
+        __DMB();
+    } while ((uint32_t)(Enc->Seq - seq) >= 2);
+}
+
+/**
+  * @brief  编码器定时器中断处理函数。
+  * @param  Enc: 编码器句柄。
+  * @retval None
+  * @note   在 EncTIM 的 TIMx_IRQHandler 中调用，只处理更新和 CC3 标志。
+  */
+void myTIM_EncoderIRQHandler(TIM_EncoderTypeDef* Enc)
+{
+    TIM_TypeDef* TIMx = Enc->EncTIM;
+    uint16_t sr = TIMx->SR & (uint16_t)(TIM_SR_UIF | TIM_SR_CC3IF);
+    uint32_t primask = 0;
+
+    if (sr == 0)
+    {
+        return;
+    }
+
+    /* SR 为写 0 清除：只清自己的标志 */
+    TIMx->SR = (uint16_t)~sr;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    Encoder_Accumulate(Enc);
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  把计数器差值累加到 64 位位置（调用者已关中断）。
+  * @note   差值按计数器位宽截断后做有符号扩展，16 位计数器下溢 0 -> 0xFFFF 得到 -1。
+  */
+static void Encoder_Accumulate(TIM_EncoderTypeDef* Enc)
+{
+    uint32_t cnt = Enc->EncTIM->CNT & Enc->CntMask;
+    uint32_t delta = cnt - Enc->LastCnt;
+
+    Enc->Base += (Enc->CntMask == 0xFFFF) ? (int64_t)(int16_t)delta : (int64_t)(int32_t)delta;
+    Enc->LastCnt = cnt;
+}
+
+/**
+  * @brief  读取周期定时器的捕获结果。
+  * @note
+  *  - UIF：距上一个边沿已超过满量程，停转，丢弃周期，并锁存“丢弃下一个捕获”：
+  *    溢出之后的第一个捕获值是回绕后的计数，不是完整周期。
+  *    UIF 可能在较早的一次采样中就被清除，所以不能只看同一次采样里的两个标志。
+  *  - CC1IF：新的周期已捕获，读 CCR1 同时清除 CC1IF；锁存了丢弃时丢掉这一个并清除锁存。
+  *    与 UIF 同时出现时无法判断溢出在捕获之前还是之后，本周期丢弃，锁存保持，下一个也丢弃。
+  */
+static void Encoder_UpdatePeriod(TIM_EncoderTypeDef* Enc)
+{
+    TIM_TypeDef* TIMx = Enc->PerTIM;
+    uint16_t sr = TIMx->SR;
+    uint32_t period = 0;
+
+    if (sr & TIM_SR_UIF)
+    {
+        TIMx->SR = (uint16_t)~TIM_SR_UIF;
+        Enc->PeriodValid = 0;
+    }
+
+    if (sr & TIM_SR_CC1IF)
+    {
+        period = TIMx->CCR1;
+        if ((sr & TIM_SR_UIF) == 0 && !Enc->DiscardNext && period != 0)
+        {
+            Enc->Period = period;
+            Enc->PeriodValid = 1;
+        }
+        Enc->DiscardNext = 0;
+    }
+
+    Enc->DiscardNext = (sr & TIM_SR_UIF) ? 1 : Enc->DiscardNext;
+}
+
+/**
+  * @brief  M 法速度：窗口位置差 * 采样频率 / 窗口长度。
+  * @retval 速度，计数/秒，Q24.8
+  */
+static int32_t Encoder_VelocityM(TIM_EncoderTypeDef* Enc, int32_t Window)
+{
+    int64_t v = ((int64_t)Window * Enc->SampleFreq * 256) / TIM_ENCODER_WINDOW;
+
+    return (v > 0x7FFFFFFF) ? 0x7FFFFFFF : (v < -0x7FFFFFFF) ? -0x7FFFFFFF : (int32_t)v;
+}
+
+/**
+  * @brief  T 法速度：每个 A 相周期的计数 * 周期计数频率 / 周期节拍数。
+  * @retval 速度，计数/秒，Q24.8；停转返回 0
+  * @note   距上一个边沿的时间超过上一个周期时以它为周期，减速到停转的过程连续。
+  *         方向取编码器计数器的 DIR 位。
+  */
+static int32_t Encoder_VelocityT(TIM_EncoderTypeDef* Enc)
+{
+    uint32_t elapsed = Enc->PerTIM->CNT;
+    uint32_t period = Enc->Period;
+    uint64_t v = 0;
+
+    if (!Enc->PeriodValid)
+    {
+        return 0;
+    }
+
+    period = (elapsed > period) ? elapsed : period;
+    v = ((uint64_t)Enc->CountsPerCycle * Enc->PerFreq * 256) / period;
+    v = (v > 0x7FFFFFFF) ? 0x7FFFFFFF : v;
+
+    return (Enc->EncTIM->CR1 & TIM_CR1_DIR) ? -(int32_t)v : (int32_t)v;
+}
@@ -0,0 +1,74 @@
+﻿#ifndef mystm32f4_tim_encoder_h
+#define mystm32f4_tim_encoder_h
+
+#include "mystm32f4_tim.h"
+
+/* 速度窗口长度（采样次数）= 2^TIM_ENCODER_WINDOW_BITS，M 法用窗口两端位置差求速度 */
+#ifndef TIM_ENCODER_WINDOW_BITS
+#define TIM_ENCODER_WINDOW_BITS     4
+#endif
+#define TIM_ENCODER_WINDOW          (1U << TIM_ENCODER_WINDOW_BITS)
+
+/* M/T 切换滞回：窗口内计数绝对值 >= ENTER 切到 M 法，< EXIT 切回 T 法 */
+#ifndef TIM_ENCODER_M_ENTER
+#define TIM_ENCODER_M_ENTER         32
+#endif
+#ifndef TIM_ENCODER_M_EXIT
+#define TIM_ENCODER_M_EXIT          16
+#endif
+
+#define TIM_ENCODER_METHOD_M        0   /* 计数法（高速） */
+#define TIM_ENCODER_METHOD_T        1   /* 周期法（低速） */
+
+/* 编码器初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* EncTIM;         /* 编码器定时器，CH1/CH2 接 A/B 相，CH3 被占用做半量程比较 */
+    uint16_t EncoderMode;        /* TIM_EncoderMode_TI1 / TI2 / TI12 */
+    uint16_t IC1Polarity;        /* TIM_ICPolarity_Rising / Falling */
+    uint16_t IC2Polarity;        /* TIM_ICPolarity_Rising / Falling */
+    uint8_t  ICFilter;           /* 输入滤波 0x0~0xF，编码器与周期定时器共用 */
+    TIM_TypeDef* PerTIM;         /* 周期测量定时器，CH1 接 A 相；NULL 表示只用 M 法 */
+    uint32_t PerFreq;            /* 周期测量定时器计数频率（Hz） */
+    uint32_t SampleFreq;         /* myTIM_EncoderSample() 的调用频率（Hz） */
+} TIM_EncoderInitTypeDef;
+
+/* 位置/速度快照 */
+typedef struct
+{
+    int64_t  Position;           /* 64 位位置（计数） */
+    int32_t  Velocity;           /* 速度，单位：计数/秒，Q24.8 定点 */
+    uint32_t Sequence;           /* 采样序号 */
+    uint8_t  Method;             /* 本次速度所用方法 TIM_ENCODER_METHOD_x */
+} TIM_EncoderSnapshotTypeDef;
+
+/* 编码器服务句柄，由调用者分配 */
+typedef struct
+{
+    TIM_TypeDef* EncTIM;
+    TIM_TypeDef* PerTIM;
+    uint32_t PerFreq;
+    uint32_t SampleFreq;
+    uint32_t CntMask;            /* 计数器量程掩码：0xFFFF 或 0xFFFFFFFF */
+    uint8_t  CountsPerCycle;     /* A 相一个完整周期对应的计数：TI12 为 4，否则为 2 */
+    uint8_t  Method;             /* 当前速度方法 */
+    uint8_t  PeriodValid;        /* Period 为有效的完整周期 */
+    uint8_t  DiscardNext;        /* 溢出后锁存：下一个捕获是回绕后的计数，丢弃 */
+    uint8_t  RingIndex;
+    uint32_t Period;             /* 最近一次 A 相周期（周期定时器节拍） */
+    uint32_t Ring[TIM_ENCODER_WINDOW];   /* 最近 WINDOW 次采样的位置低 32 位 */
+    int64_t  Base;               /* LastCnt 对应的 64 位位置 */
+    uint32_t LastCnt;            /* 上一次累加时的计数器值 */
+    volatile uint32_t Seq;       /* 快照序号，Snap[Seq & 1] 为最新 */
+    TIM_EncoderSnapshotTypeDef Snap[2];
+} TIM_EncoderTypeDef;
+
+void myTIM_EncoderStructInit(TIM_EncoderInitTypeDef* Init);           // 初始化参数结构体默认值
+ErrorStatus myTIM_EncoderInit(TIM_EncoderTypeDef* Enc, TIM_EncoderInitTypeDef* Init); // 初始化编码器服务
+int64_t myTIM_EncoderGetPosition(TIM_EncoderTypeDef* Enc);            // 读取当前 64 位位置
+void myTIM_EncoderSetPosition(TIM_EncoderTypeDef* Enc, int64_t Position); // 设置当前位置（回零）
+void myTIM_EncoderSample(TIM_EncoderTypeDef* Enc);                    // 固定频率采样：估计速度并发布快照
+void myTIM_EncoderGetSnapshot(const TIM_EncoderTypeDef* Enc, TIM_EncoderSnapshotTypeDef* Snap); // 无锁读取最新快照
+void myTIM_EncoderIRQHandler(TIM_EncoderTypeDef* Enc);                // 编码器定时器中断处理，在 TIMx_IRQHandler 中调用
+
+#endif
@@ -0,0 +1,328 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_ilimit.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    基于 ETR 与 OCREF 清零的逐周期限流 PWM
+  *
+  * @attention
+  *
+  * 峰值电流模式/逐周期限流需要在“电流到达门限”的那一刻立即结束本周期的导通，
+  * 在 ADC 中断里判断已经晚了好几个周期。本文件把这件事完全交给定时器硬件：
+  *
+  *   比较器输出 ──> ETR ──滤波(ETF)──> ETRF ──> OCREF_CLR
+  *                                              │
+  *   PWM1：CNT < CCR 时 OCxREF 有效  ───────────┴──> OCxCE = 1：ETRF 为高时 OCxREF 被清零，
+  *                                                   并保持到下一个更新事件
+  *
+  * - CCR 设为最大占空比；电流没到门限时输出正常宽度，到门限后本周期提前关断，
+  *   下一个周期自动恢复，无需任何软件参与。
+  * - ETR 数字滤波要求 ETRF 连续 N 个采样为高才生效，兼作开通瞬间尖峰的消隐。
+  * - TIM1/TIM8 可再接一路更高门限的比较器到 BKIN 作硬过流保护：刹车异步清除 MOE，
+  *   AOE = 0，故障锁存到软件调用 myTIM_IlimitClearFault()。
+  * - 限流次数统计：从模式设为触发模式、TS = ETRF，计数器已在运行，触发只置 TIF；
+  *   TDE 让每次 ETRF 上升沿产生一次 DMA 请求，DMA 循环搬运一个无意义的字，
+  *   NDTR 的减少量就是限流次数，每 65535 次才进一次 DMA 中断。
+  *   正常的峰值电流波形每个受限周期只有一个 ETRF 上升沿，因此它也是“受限周期数”。
+  *
+  * 限制：
+  * - F4 的 OCREF_CLR 只能来自 ETRF，定时器须为 TIM1~TIM5/TIM8，ETR 被本模块独占。
+  * - 限流计数需要 Trigger DMA 请求，只有 TIM1/TIM3/TIM5/TIM8 有；启用后从模式控制器被占用。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 TIM1、DMA2 和 GPIO 时钟；PA8 复用为 TIM1_CH1，PE7 复用为 TIM1_ETR
+    （接限流比较器），PA6 复用为 TIM1_BKIN（接硬过流比较器，可选）。
+
+(#) 初始化：
+    TIM_IlimitInitTypeDef init;
+    myTIM_IlimitStructInit(&init);
+    init.TIMx = TIM1;
+    init.Channel = 1;
+    init.PwmFreq = 200000;
+    init.MaxDuty = 900;
+    init.ETRFilter = 0x3;                  // fDTS/2，N = 8 的消隐
+    init.Break = TIM_Break_Enable;
+    myTIM_IlimitInit(&il, &init);
+    myTIM_IlimitEnable(&il);
+
+(#) 使能 DMA2_Stream0_IRQn（或 myTIM_GetDMARequest() 查到的数据流），在中断中调用
+    myTIM_IlimitDMAIRQHandler(&il)
+
+(#) 诊断：myTIM_IlimitGetClearCount(&il)、myTIM_IlimitIsFault(&il)
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_ilimit.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ILIMIT_DMA_TCIF       0x20     /* myTIM_DMAGetFlags() 中的 TCIF */
+
+
+/**
+  * @brief  初始化逐周期限流参数结构体为默认值。
+  * @param  Init: 参数结构体。
+  * @retval None
+  * @note   默认：TIM1 CH1、100kHz、最大占空比 90%、比较器高有效、
+  *         ETR 滤波 0x3、不刹车、统计限流次数。
+  */
+void myTIM_IlimitStructInit(TIM_IlimitInitTypeDef* Init)
+{
+    Init->TIMx = TIM1;
+    Init->Channel = 1;
+    Init->PwmFreq = 100000;
+    Init->MaxDuty = 900;
+    Init->OCPolarity = TIM_OCPolarity_High;
+    Init->ETRPolarity = TIM_ExtTRGPolarity_NonInverted;
+    Init->ETRFilter = 0x3;
+    Init->Break = TIM_Break_Disable;
+    Init->BreakPolarity = TIM_BreakPolarity_Low;
+    Init->CountClears = 1;
+    Init->DMAAlt = 0;
+}
+
+/**
+  * @brief  初始化逐周期限流 PWM。
+  * @param  Il: 限流 PWM 句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成，计数器已运行，输出保持关闭；
+  *         ERROR: 定时器/通道非法、频率无法实现、非 TIM1/TIM8 却要刹车，
+  *         或要求计数但没有 Trigger DMA 请求。
+  *
+  * @note
+  *  - 输出通道 PWM1，CCR 与 ARR 均开预装载，占空比修改在下一周期生效。
+  *  - 小白理解：PWM 每个周期都“想”开到最大宽度，比较器一喊过流，
+  *    这个周期立刻关掉，下个周期重新开始，全程不用 CPU。
+  */
+ErrorStatus myTIM_IlimitInit(TIM_IlimitTypeDef* Il, TIM_IlimitInitTypeDef* Init)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_OCInitTypeDef oc;
+    TIM_BDTRInitTypeDef bdtr;
+    TIM_TypeDef* TIMx = Init->TIMx;
+    uint32_t channel = 0;
+    uint32_t arr = 0;
+    uint32_t mask = 0;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST3_PERIPH(TIMx));
+    assert_param(Init->Channel >= 1 && Init->Channel <= 4);
+    assert_param(Init->PwmFreq != 0 && Init->MaxDuty <= 1000);
+    assert_param(IS_TIM_EXT_POLARITY(Init->ETRPolarity));
+    assert_param(IS_TIM_EXT_FILTER(Init->ETRFilter));
+
+    Il->TIMx = TIMx;
+    Il->Channel = Init->Channel;
+    Il->Advanced = (TIMx == TIM1 || TIMx == TIM8);
+    Il->Stream = NULL;
+    Il->Wraps = 0;
+
+    mask = (TIMx == TIM2 || TIMx == TIM5) ? 0xFFFFFFFF : 0xFFFF;
+    arr = (Init->PwmFreq != 0) ? myTIM_GetClockFreq(TIMx) / Init->PwmFreq : 0;
+    if (Init->Channel < 1 || Init->Channel > 4 || Init->MaxDuty > 1000 || arr < 2 || arr - 1 > mask
+        || (Init->Break == TIM_Break_Enable && !Il->Advanced)
+        || (Init->CountClears && myTIM_GetDMARequest(TIMx, TIM_DMA_Trigger, Init->DMAAlt, &Il->Stream, &channel) != SUCCESS))
+    {
+        Il->Stream = NULL;
+        return ERROR;
+    }
+    Il->Period = arr - 1;
+
+    myTIM_Cmd(TIMx, DISABLE);
+    myTIM_DMACmd(TIMx, TIM_DMA_Trigger, DISABLE);
+    TIMx->SMCR = 0;
+
+    /* 边沿对齐向上计数，ARR 预装载 */
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Period = Il->Period;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+    myTIM_ARRPreloadConfig(TIMx, ENABLE);
+
+    /* PWM1，输出先关闭，空闲电平为无效 */
+    myTIM_OCStructInit(&oc);
+    oc.TIM_OCMode = TIM_OCMode_PWM1;
+    oc.TIM_OutputState = TIM_OutputState_Disable;
+    oc.TIM_Pulse = 0;
+    oc.TIM_OCPolarity = Init->OCPolarity;
+    oc.TIM_OCIdleState = TIM_OCIdleState_Reset;
+    (Init->Channel == 1) ? myTIM_OCxInit(TIMx, 1, &oc) :
+    (Init->Channel == 2) ? myTIM_OC2Init(TIMx, &oc) :
+    (Init->Channel == 3) ? myTIM_OC3Init(TIMx, &oc) : myTIM_OC4Init(TIMx, &oc);
+    (Init->Channel <= 2) ? (TIMx->CCMR1 |= (uint16_t)(TIM_CCMR1_OC1PE << ((Init->Channel - 1) * 8)))
+        : (TIMx->CCMR2 |= (uint16_t)(TIM_CCMR2_OC3PE << ((Init->Channel - 3) * 8)));
+    myTIM_IlimitSetMaxDuty(Il, Init->MaxDuty);
+
+    /* ETR -> ETRF -> OCREF_CLR */
+    myTIM_ETRConfig(TIMx, TIM_ExtTRGPSC_OFF, Init->ETRPolarity, Init->ETRFilter);
+    myTIM_OCClearConfig(TIMx, Init->Channel, TIM_OCClear_Enable);
+
+    /* 高级定时器：关闭时输出空闲电平，可选硬过流刹车，AOE = 0 使故障锁存 */
+    if (Il->Advanced)
+    {
+        myTIM_BDTRStructInit(&bdtr);
+        bdtr.TIM_OSSRState = TIM_OSSRState_Enable;
+        bdtr.TIM_OSSIState = TIM_OSSIState_Enable;
+        bdtr.TIM_Break = Init->Break;
+        bdtr.TIM_BreakPolarity = Init->BreakPolarity;
+        myTIM_BDTRConfig(TIMx, &bdtr);
+    }
+
+    /* 限流计数：触发模式只置 TIF，TDE 把每次 ETRF 上升沿变成一次 DMA 请求 */
+    if (Il->Stream != NULL)
+    {
+        Il->Stream->CR &= ~DMA_SxCR_EN;
+        while (Il->Stream->CR & DMA_SxCR_EN)
+        {
+        }
+        myTIM_DMAClearFlags(Il->Stream);
+        Il->Stream->PAR = (uint32_t)&TIMx->CNT;
+        Il->Stream->M0AR = (uint32_t)&Il->Sink;
+        Il->Stream->NDTR = TIM_ILIMIT_DMA_WRAP;
+        Il->Stream->FCR = 0;
+        Il->Stream->CR = channel | DMA_SxCR_PL_0 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 |
+            DMA_SxCR_CIRC | DMA_SxCR_TCIE;
+        Il->Stream->CR |= DMA_SxCR_EN;
+
+        myTIM_SelectInputTrigger(TIMx, TIM_TS_ETRF);
+        myTIM_SelectSlaveMode(TIMx, TIM_SlaveMode_Trigger);
+        TIMx->SR = (uint16_t)~TIM_SR_TIF;
+        myTIM_DMACmd(TIMx, TIM_DMA_Trigger, ENABLE);
+    }
+
+    myTIM_Cmd(TIMx, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  打开 PWM 输出（高级定时器同时打开 MOE）。
+  * @param  Il: 限流 PWM 句柄。
+  * @retval None
+  */
+void myTIM_IlimitEnable(TIM_IlimitTypeDef* Il)
+{
+    Il->TIMx->CCER |= (uint16_t)(TIM_CCER_CC1E << ((Il->Channel - 1) * 4));
+    Il->Advanced ? myTIM_CtrlPWMOutputs(Il->TIMx, ENABLE) : (void)0;
+}
+
+/**
+  * @brief  关闭 PWM 输出。
+  * @param  Il: 限流 PWM 句柄。
+  * @retval None
+  * @note   高级定时器关闭 MOE，输出进入空闲电平；通用定时器关闭 CCxE。
+  */
+void myTIM_IlimitDisable(TIM_IlimitTypeDef* Il)
+{
+    Il->Advanced ? myTIM_CtrlPWMOutputs(Il->TIMx, DISABLE)
+        : (void)(Il->TIMx->CCER &= (uint16_t)~(TIM_CCER_CC1E << ((Il->Channel - 1) * 4)));
+}
+
+/**
+  * @brief  设置最大占空比。
+  * @param  Il: 限流 PWM 句柄。
+  * @param  Permille: 千分比 0~1000；峰值电流模式下一般固定在 85%~95%，由比较器门限调节电流。
+  * @retval None
+  * @note   CCR 预装载，下一周期生效，不会产生半个周期的异常脉宽。
+  */
+void myTIM_IlimitSetMaxDuty(TIM_IlimitTypeDef* Il, uint16_t Permille)
+{
+    assert_param(Permille <= 1000);
+
+    Permille = (Permille > 1000) ? 1000 : Permille;
+    myTIM_SetCompare(Il->TIMx, Il->Channel, (uint32_t)(((uint64_t)(Il->Period + 1) * Permille) / 1000));
+}
+
+/**
+  * @brief  读取限流触发次数（ETRF 上升沿次数）。
+  * @param  Il: 限流 PWM 句柄。
+  * @retval 自初始化以来的次数，32 位回绕；未启用计数时返回 0
+  * @note   不关中断，可在任意上下文调用。DMA 已计满一圈但中断还没执行时，
+  *         由 TCIF 补上这一圈；TCIF 在两次读取之间变化则重读。
+  */
+uint32_t myTIM_IlimitGetClearCount(TIM_IlimitTypeDef* Il)
+{
+    uint32_t wraps = 0;
+    uint32_t ndtr = 0;
+    uint8_t tc = 0;
+
+    if (Il->Stream == NULL)
+    {
+        return 0;
+    }
+
+    do
+    {
+        wraps = Il->Wraps;
+        tc = myTIM_DMAGetFlags(Il->Stream) & ILIMIT_DMA_TCIF;
+        ndtr = Il->Stream->NDTR;
+    } while (wraps != Il->Wraps || tc != (myTIM_DMAGetFlags(Il->Stream) & ILIMIT_DMA_TCIF));
+
+    return (wraps + (tc ? 1 : 0)) * TIM_ILIMIT_DMA_WRAP + (TIM_ILIMIT_DMA_WRAP - ndtr);
+}
+
+/**
+  * @brief  是否因硬过流刹车而关断。
+  * @param  Il: 限流 PWM 句柄。
+  * @retval 1: 刹车标志 BIF 已置位；0: 无故障（通用定时器恒为 0）。
+  */
+uint8_t myTIM_IlimitIsFault(TIM_IlimitTypeDef* Il)
+{
+    return (Il->Advanced && (Il->TIMx->SR & TIM_SR_BIF)) ? 1 : 0;
+}
+
+/**
+  * @brief  清除刹车故障并恢复输出。
+  * @param  Il: 限流 PWM 句柄。
+  * @retval SUCCESS: 已恢复；ERROR: 刹车输入仍有效，MOE 无法置位。
+  * @note   刹车输入有效期间硬件持续清除 MOE，必须等过流比较器释放后再调用。
+  */
+ErrorStatus myTIM_IlimitClearFault(TIM_IlimitTypeDef* Il)
+{
+    TIM_TypeDef* TIMx = Il->TIMx;
+
+    if (!Il->Advanced)
+    {
+        return SUCCESS;
+    }
+
+    TIMx->SR = (uint16_t)~TIM_SR_BIF;
+    myTIM_CtrlPWMOutputs(TIMx, ENABLE);
+
+    return (TIMx->BDTR & TIM_BDTR_MOE) ? SUCCESS : ERROR;
+}
+
+/**
+  * @brief  限流计数 DMA 中断处理。
+  * @param  Il: 限流 PWM 句柄。
+  * @retval None
+  * @note   在对应的 DMAx_Streamy_IRQHandler 中调用，每 65535 次限流进入一次。
+  */
+void myTIM_IlimitDMAIRQHandler(TIM_IlimitTypeDef* Il)
+{
+    uint8_t flags = myTIM_DMAGetFlags(Il->Stream);
+
+    myTIM_DMAClearFlags(Il->Stream);
+    if (flags & ILIMIT_DMA_TCIF)
+    {
+        Il->Wraps++;
+    }
+}
@@ -0,0 +1,47 @@
+﻿#ifndef mystm32f4_tim_ilimit_h
+#define mystm32f4_tim_ilimit_h
+
+#include "mystm32f4_tim.h"
+
+/* 限流计数 DMA 每圈的请求数（NDTR 重装值） */
+#define TIM_ILIMIT_DMA_WRAP         0xFFFF
+
+/* 逐周期限流 PWM 初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;           /* 定时器 TIM1~TIM5/TIM8（需要 ETR） */
+    uint8_t  Channel;            /* 驱动开关管的 PWM 通道 1~4 */
+    uint32_t PwmFreq;            /* PWM 频率（Hz），边沿对齐 */
+    uint16_t MaxDuty;            /* 最大占空比（千分比 0~1000），限流未触发时的脉宽 */
+    uint16_t OCPolarity;         /* TIM_OCPolarity_High / Low */
+    uint16_t ETRPolarity;        /* 比较器过流电平：TIM_ExtTRGPolarity_NonInverted 高有效 / Inverted 低有效 */
+    uint16_t ETRFilter;          /* ETR 数字滤波 0x0~0xF，兼作开通尖峰消隐 */
+    uint16_t Break;              /* 硬过流刹车 TIM_Break_Enable / Disable（仅 TIM1/TIM8） */
+    uint16_t BreakPolarity;      /* TIM_BreakPolarity_Low / High */
+    uint8_t  CountClears;        /* 1：用 Trigger DMA 统计限流次数（TIM1/TIM3/TIM5/TIM8） */
+    uint8_t  DMAAlt;             /* Trigger DMA 请求的备选数据流序号，见 myTIM_GetDMARequest() */
+} TIM_IlimitInitTypeDef;
+
+/* 逐周期限流 PWM 句柄，由调用者分配 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;
+    uint8_t  Channel;
+    uint8_t  Advanced;           /* TIM1/TIM8：有 BDTR，需要 MOE */
+    uint32_t Period;             /* ARR */
+    DMA_Stream_TypeDef* Stream;  /* 限流计数 DMA 数据流，NULL 表示不计数 */
+    volatile uint32_t Wraps;     /* DMA 计满一圈的次数（仅由 DMA 中断写入） */
+    uint32_t Sink;               /* DMA 搬运目的地，内容无意义 */
+} TIM_IlimitTypeDef;
+
+void myTIM_IlimitStructInit(TIM_IlimitInitTypeDef* Init);             // 初始化参数结构体默认值
+ErrorStatus myTIM_IlimitInit(TIM_IlimitTypeDef* Il, TIM_IlimitInitTypeDef* Init); // 初始化逐周期限流 PWM
+void myTIM_IlimitEnable(TIM_IlimitTypeDef* Il);                       // 打开 PWM 输出
+void myTIM_IlimitDisable(TIM_IlimitTypeDef* Il);                      // 关闭 PWM 输出
+void myTIM_IlimitSetMaxDuty(TIM_IlimitTypeDef* Il, uint16_t Permille); // 设置最大占空比（下一周期生效）
+uint32_t myTIM_IlimitGetClearCount(TIM_IlimitTypeDef* Il);            // 读取限流触发次数
+uint8_t myTIM_IlimitIsFault(TIM_IlimitTypeDef* Il);                   // 是否因硬过流刹车而关断
+ErrorStatus myTIM_IlimitClearFault(TIM_IlimitTypeDef* Il);            // 清除刹车并恢复输出
+void myTIM_IlimitDMAIRQHandler(TIM_IlimitTypeDef* Il);                // 计数 DMA 中断处理，在 DMAx_Streamy_IRQHandler 中调用
+
+#endif
@@ -0,0 +1,264 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_inverter.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    中心对齐互补三相 PWM 与定点空间矢量调制
+  *
+  * @attention
+  *
+  * 本文件在高级定时器互补输出和 myTIM_BDTRConfig() 之上提供三相逆变器驱动：
+  *
+  * - 中心对齐模式 1，PWM1，CH1~CH3 与 CH1N~CH3N 互补输出，死区由 ns 换算。
+  * - CCR 和 ARR 均开预装载，RCR = 1 使每个 PWM 周期只有一次更新事件，
+  *   TRGO = 更新事件，可直接触发 ADC 在周期中点（下管导通中心）采样电流。
+  *
+  * 空间矢量调制（SVPWM）采用“最小-最大零序注入”，与七段式 SVPWM 等效但不需要扇区判断：
+  *   va = α
+  *   vb = -α/2 + (√3/2)β
+  *   vc = -α/2 - (√3/2)β
+  *   off = (max(va, vb, vc) + min(va, vb, vc)) / 2
+  *   CCRx = ARR/2 + (vx - off) * ARR / √3
+  * α、β 为 Q15，单位 Vdc/√3：幅值 1.0（32767）正好是线性调制区的内切圆。
+  * 全程整数运算，一次 32x32 乘 + 少量比较，Cortex-M4 上几十个周期。
+  *
+  * 三路 CCR 在 UDIS 保护下写入：写入期间即使遇到更新事件也不会把半新半旧的
+  * 三个值装入影子寄存器，三相总是同一拍生效。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 TIM1 时钟，把 CH1~CH3、CH1N~CH3N（及 BKIN）复用到 TIM1。
+
+(#) 初始化：
+    TIM_InverterInitTypeDef init;
+    myTIM_InverterStructInit(&init);
+    init.TIMx = TIM1;
+    init.PwmFreq = 20000;
+    init.DeadTimeNs = 500;
+    myTIM_InverterInit(&inv, &init);
+    myTIM_InverterEnable(&inv);
+
+(#) FOC 控制环（例如 ADC 注入转换完成中断）中：
+    myTIM_InverterSetVoltage(&inv, valpha, vbeta);     // Q15，单位 Vdc/√3
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_inverter.h"
+
+/* Private define ------------------------------------------------------------*/
+#define INV_SQRT3_2_Q15       28378        /* √3/2，Q15 */
+#define INV_INV_SQRT3_Q16     37837        /* 1/√3，Q16 */
+
+
+/**
+  * @brief  初始化逆变器参数结构体为默认值。
+  * @param  Init: 参数结构体。
+  * @retval None
+  * @note   默认：TIM1、20kHz、500ns 死区、上下管高有效、不使能刹车。
+  */
+void myTIM_InverterStructInit(TIM_InverterInitTypeDef* Init)
+{
+    Init->TIMx = TIM1;
+    Init->PwmFreq = 20000;
+    Init->DeadTimeNs = 500;
+    Init->OCPolarity = TIM_OCPolarity_High;
+    Init->OCNPolarity = TIM_OCNPolarity_High;
+    Init->Break = TIM_Break_Disable;
+    Init->BreakPolarity = TIM_BreakPolarity_Low;
+}
+
+/**
+  * @brief  初始化中心对齐互补三相 PWM。
+  * @param  Inv: 逆变器句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成，计数器已运行，三相 50% 占空比，主输出保持关闭；
+  *         ERROR: 定时器不是 TIM1/TIM8 或 PWM 频率无法实现。
+  *
+  * @note
+  *  - OSSR = OSSI = 1：MOE 关闭时输出为空闲电平（OISx = 0，上下管都关）。
+  *  - 小白理解：中心对齐的 PWM 三相脉冲都以周期中点对称，谐波更小，也方便在中点采样电流。
+  */
+ErrorStatus myTIM_InverterInit(TIM_InverterTypeDef* Inv, TIM_InverterInitTypeDef* Init)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_OCInitTypeDef oc;
+    TIM_BDTRInitTypeDef bdtr;
+    TIM_TypeDef* TIMx = Init->TIMx;
+    uint32_t arr = 0;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST4_PERIPH(TIMx));
+    assert_param(Init->PwmFreq != 0);
+
+    if ((TIMx != TIM1 && TIMx != TIM8) || Init->PwmFreq == 0)
+    {
+        return ERROR;
+    }
+
+    arr = myTIM_GetClockFreq(TIMx) / (2 * Init->PwmFreq);
+    if (arr < 2 || arr > 0xFFFF)
+    {
+        return ERROR;
+    }
+
+    Inv->TIMx = TIMx;
+    Inv->Period = arr;
+    Inv->Gain = arr * INV_INV_SQRT3_Q16;
+    Inv->Center = ((int64_t)arr << 30) + ((int64_t)1 << 30);
+
+    myTIM_Cmd(TIMx, DISABLE);
+    myTIM_CtrlPWMOutputs(TIMx, DISABLE);
+
+    /* 中心对齐，RCR = 1：每个 PWM 周期一次更新事件 */
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_CounterMode = TIM_CounterMode_CenterAligned1;
+    timeBase.TIM_Period = arr;
+    timeBase.TIM_RepetitionCounter = 1;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+    myTIM_ARRPreloadConfig(TIMx, ENABLE);
+
+    /* 三相 PWM1 互补输出，初始 50% 占空比即零电压矢量 */
+    myTIM_OCStructInit(&oc);
+    oc.TIM_OCMode = TIM_OCMode_PWM1;
+    oc.TIM_OutputState = TIM_OutputState_Enable;
+    oc.TIM_OutputNState = TIM_OutputNState_Enable;
+    oc.TIM_Pulse = arr / 2;
+    oc.TIM_OCPolarity = Init->OCPolarity;
+    oc.TIM_OCNPolarity = Init->OCNPolarity;
+    oc.TIM_OCIdleState = TIM_OCIdleState_Reset;
+    oc.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+    myTIM_OCxInit(TIMx, 1, &oc);
+    myTIM_OC2Init(TIMx, &oc);
+    myTIM_OC3Init(TIMx, &oc);
+    TIMx->CCMR1 |= TIM_CCMR1_OC1PE | TIM_CCMR1_OC2PE;
+    TIMx->CCMR2 |= TIM_CCMR2_OC3PE;
+
+    myTIM_BDTRStructInit(&bdtr);
+    bdtr.TIM_OSSRState = TIM_OSSRState_Enable;
+    bdtr.TIM_OSSIState = TIM_OSSIState_Enable;
+    bdtr.TIM_DeadTime = myTIM_DeadTimeFromNs(TIMx, Init->DeadTimeNs);
+    bdtr.TIM_Break = Init->Break;
+    bdtr.TIM_BreakPolarity = Init->BreakPolarity;
+    myTIM_BDTRConfig(TIMx, &bdtr);
+
+    myTIM_SelectOutputTrigger(TIMx, TIM_TRGOSource_Update);
+    myTIM_Cmd(TIMx, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  打开主输出（MOE）。
+  * @param  Inv: 逆变器句柄。
+  * @retval None
+  */
+void myTIM_InverterEnable(TIM_InverterTypeDef* Inv)
+{
+    myTIM_CtrlPWMOutputs(Inv->TIMx, ENABLE);
+}
+
+/**
+  * @brief  关闭主输出，六个管子进入空闲电平。
+  * @param  Inv: 逆变器句柄。
+  * @retval None
+  */
+void myTIM_InverterDisable(TIM_InverterTypeDef* Inv)
+{
+    myTIM_CtrlPWMOutputs(Inv->TIMx, DISABLE);
+}
+
+/**
+  * @brief  空间矢量调制：由 (α, β) 电压矢量计算三相比较值。
+  * @param  Inv: 逆变器句柄。
+  * @param  Alpha: α 轴电压，Q15，单位 Vdc/√3。
+  * @param  Beta: β 轴电压，Q15，单位 Vdc/√3。
+  * @param  Ccr: 输出三相比较值，范围 0 ~ ARR。
+  * @retval None
+  *
+  * @note
+  *  - 矢量幅值 <= 1.0 时为线性区；超出时比较值被限幅到 0 / ARR（六边形过调制）。
+  *  - 不访问外设，可在任意上下文调用，也可用于离线验证。
+  */
+void myTIM_InverterSVPWM(const TIM_InverterTypeDef* Inv, int16_t Alpha, int16_t Beta, uint32_t Ccr[3])
+{
+    int32_t halfA = -((int32_t)Alpha >> 1);
+    int32_t b = ((int32_t)Beta * INV_SQRT3_2_Q15) >> 15;
+    int32_t v[3];
+    int32_t vmax = 0;
+    int32_t vmin = 0;
+    int32_t off = 0;
+    int32_t ccr = 0;
+    uint8_t i = 0;
+
+    v[0] = Alpha;
+    v[1] = halfA + b;
+    v[2] = halfA - b;
+
+    /* 零序注入：三相整体平移，使最大、最小相关于中点对称 */
+    vmax = (v[0] > v[1]) ? v[0] : v[1];
+    vmax = (v[2] > vmax) ? v[2] : vmax;
+    vmin = (v[0] < v[1]) ? v[0] : v[1];
+    vmin = (v[2] < vmin) ? v[2] : vmin;
+    off = (vmax + vmin) >> 1;
+
+    for (i = 0; i < 3; i++)
+    {
+        ccr = (int32_t)((Inv->Center + (int64_t)(v[i] - off) * Inv->Gain) >> 31);
+        Ccr[i] = (ccr < 0) ? 0 : ((uint32_t)ccr > Inv->Period) ? Inv->Period : (uint32_t)ccr;
+    }
+}
+
+/**
+  * @brief  原子更新三相比较值。
+  * @param  Inv: 逆变器句柄。
+  * @param  Ccr1: U 相比较值。
+  * @param  Ccr2: V 相比较值。
+  * @param  Ccr3: W 相比较值。
+  * @retval None
+  * @note   写入期间置 UDIS 屏蔽更新事件，三个预装载值在同一个更新事件生效。
+  *         若写入恰好跨过更新时刻，本周期保持旧值，新值在下一个周期生效。
+  */
+void myTIM_InverterSetCompare(TIM_InverterTypeDef* Inv, uint32_t Ccr1, uint32_t Ccr2, uint32_t Ccr3)
+{
+    TIM_TypeDef* TIMx = Inv->TIMx;
+
+    TIMx->CR1 |= TIM_CR1_UDIS;
+    TIMx->CCR1 = Ccr1;
+    TIMx->CCR2 = Ccr2;
+    TIMx->CCR3 = Ccr3;
+    TIMx->CR1 &= (uint16_t)~TIM_CR1_UDIS;
+}
+
+/**
+  * @brief  由 (α, β) 电压矢量计算并原子更新三相比较值。
+  * @param  Inv: 逆变器句柄。
+  * @param  Alpha: α 轴电压，Q15，单位 Vdc/√3。
+  * @param  Beta: β 轴电压，Q15，单位 Vdc/√3。
+  * @retval None
+  */
+void myTIM_InverterSetVoltage(TIM_InverterTypeDef* Inv, int16_t Alpha, int16_t Beta)
+{
+    uint32_t ccr[3];
+
+    myTIM_InverterSVPWM(Inv, Alpha, Beta, ccr);
+    myTIM_InverterSetCompare(Inv, ccr[0], ccr[1], ccr[2]);
+}
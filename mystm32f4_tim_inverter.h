@@ -0,0 +1,35 @@
+﻿#ifndef mystm32f4_tim_inverter_h
+#define mystm32f4_tim_inverter_h
+
+#include "mystm32f4_tim.h"
+
+/* 三相逆变器初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;           /* 高级定时器 TIM1 或 TIM8，CH1~CH3/CH1N~CH3N 接 U/V/W 三相半桥 */
+    uint32_t PwmFreq;            /* PWM 频率（Hz），中心对齐：ARR = TIMxCLK / (2 * PwmFreq) */
+    uint32_t DeadTimeNs;         /* 死区时间（ns） */
+    uint16_t OCPolarity;         /* 上管极性 TIM_OCPolarity_High / Low */
+    uint16_t OCNPolarity;        /* 下管极性 TIM_OCNPolarity_High / Low */
+    uint16_t Break;              /* TIM_Break_Enable / TIM_Break_Disable */
+    uint16_t BreakPolarity;      /* TIM_BreakPolarity_Low / High */
+} TIM_InverterInitTypeDef;
+
+/* 三相逆变器句柄，由调用者分配 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;
+    uint32_t Period;             /* ARR，占空比 100% 对应的比较值 */
+    uint32_t Gain;               /* ARR / sqrt(3)，Q16 */
+    int64_t  Center;             /* ARR / 2，Q31，含舍入 */
+} TIM_InverterTypeDef;
+
+void myTIM_InverterStructInit(TIM_InverterInitTypeDef* Init);         // 初始化参数结构体默认值
+ErrorStatus myTIM_InverterInit(TIM_InverterTypeDef* Inv, TIM_InverterInitTypeDef* Init); // 初始化中心对齐互补三相 PWM
+void myTIM_InverterEnable(TIM_InverterTypeDef* Inv);                  // 打开主输出（MOE）
+void myTIM_InverterDisable(TIM_InverterTypeDef* Inv);                 // 关闭主输出
+void myTIM_InverterSVPWM(const TIM_InverterTypeDef* Inv, int16_t Alpha, int16_t Beta, uint32_t Ccr[3]); // 空间矢量调制计算三相比较值
+void myTIM_InverterSetCompare(TIM_InverterTypeDef* Inv, uint32_t Ccr1, uint32_t Ccr2, uint32_t Ccr3); // 原子更新三相比较值
+void myTIM_InverterSetVoltage(TIM_InverterTypeDef* Inv, int16_t Alpha, int16_t Beta); // 计算并原子更新
+
+#endif
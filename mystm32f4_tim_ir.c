@@ -0,0 +1,641 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_ir.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    基于输入捕获的红外遥控解码（NEC / Sony SIRC / RC5 / RC6）
+  *
+  * @attention
+  *
+  * 本文件用定时器双边沿输入捕获 + DMA 环形缓冲接收红外一体化接收头的输出，
+  * 在主循环中用查表驱动的脉宽状态机解码，不使用外部中断和忙等延时：
+  *
+  * - 定时器 1MHz 计数，通道配置为双边沿捕获并带数字滤波（TIM_ICFilter），
+  *   每个边沿的 CCR 由 DMA 循环写入环形缓冲区，CPU 不进中断。
+  * - myTIM_IRPoll() 把相邻时间戳相减得到 mark（有载波，接收头输出低）/ space 宽度，
+  *   送入所有使能协议的状态机；任一协议收完一帧即返回，其余协议状态清零。
+  * - 协议时序放在描述表中，两种解码引擎：
+  *     脉冲编码：NEC（位信息在 space 宽度）、SIRC（位信息在 mark 宽度）；
+  *     曼彻斯特：RC5（先 space 后 mark 为 1）、RC6 模式 0（先 mark 后 space 为 1，第 4 位双倍宽度）。
+  * - 空闲超过 TIM_IR_IDLE_US 视为帧结束：SIRC 的位数（12/15/20）和曼彻斯特码
+  *   落在空闲里的最后半位都在这里确定。
+  *
+  * 限制：
+  * - myTIM_IRPoll() 的调用间隔必须小于环形缓冲区写满的时间（128 个边沿约 100ms）；
+  *   16 位定时器还要求小于 65ms - TIM_IR_IDLE_US，否则空闲时间会回绕，建议 20ms 以内。
+  * - 只支持 RC6 模式 0（21 位），不支持 RC6-6A 等扩展模式。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 TIM5、DMA1 时钟，把接收头输出引脚（PA0）复用到 TIM5_CH1。
+
+(#) 初始化：
+    TIM_IRInitTypeDef init;
+    myTIM_IRStructInit(&init);
+    init.TIMx = TIM5;
+    init.Channel = 1;
+    myTIM_IRInit(&ir, &init);
+
+(#) 主循环中（间隔不超过 20ms）：
+    TIM_IRFrameTypeDef frame;
+    if (myTIM_IRPoll(&ir, &frame))
+    {
+        Key_Handle(frame.Protocol, frame.Address, frame.Command, frame.Repeat);
+    }
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_ir.h"
+
+/* Private define ------------------------------------------------------------*/
+#define IR_SPACE              0
+#define IR_MARK               1
+#define IR_FOREVER            0xFFFFFFFF   /* 空闲超时：无限长的 space */
+
+#define IR_ENGINE_PULSE       0
+#define IR_ENGINE_MANCHESTER  1
+
+/* 解码状态 */
+#define IR_S_IDLE             0
+#define IR_S_LEAD_SPACE       1
+#define IR_S_BIT_MARK         2
+#define IR_S_BIT_SPACE        3
+#define IR_S_REPEAT_MARK      4
+#define IR_S_DATA             5
+
+/* 引擎返回值 */
+#define IR_NONE               0
+#define IR_FRAME              1
+#define IR_REPEAT             2
+
+/* Private typedef -----------------------------------------------------------*/
+/* 协议时序描述（单位 us） */
+typedef struct
+{
+    uint8_t  Engine;             /* IR_ENGINE_x */
+    uint16_t LeadMark;           /* 引导 mark，0 表示没有引导码 */
+    uint16_t LeadSpace;          /* 引导 space */
+    uint16_t RepeatSpace;        /* 重复码的引导 space，0 表示没有重复码 */
+    uint16_t Unit;               /* 脉冲编码：短单元；曼彻斯特：半位宽度 T */
+    uint16_t Long;               /* 脉冲编码：表示 1 的长单元 */
+    uint8_t  BitInMark;          /* 脉冲编码：1 = 位在 mark 宽度，0 = 位在 space 宽度（带结束 mark） */
+    uint8_t  MinBits;
+    uint8_t  MaxBits;
+    uint8_t  Trailer;            /* 曼彻斯特：双倍宽度位的序号，0xFF 表示没有 */
+    uint8_t  MarkFirst;          /* 曼彻斯特：1 = 先 mark 后 space 表示 1 */
+} IR_ProtocolTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+/* 按 TIM_IR_x 顺序排列 */
+static const IR_ProtocolTypeDef s_protocols[TIM_IR_PROTOCOLS] = {
+    /* Engine                LeadM  LeadS  RepS  Unit  Long  InMark Min Max Trailer MarkFirst */
+    { IR_ENGINE_PULSE,       9000,  4500,  2250, 560,  1690, 0,     32, 32, 0xFF,   0 },   // NEC
+    { IR_ENGINE_PULSE,       2400,  600,   0,    600,  1200, 1,     12, 20, 0xFF,   0 },   // SIRC
+    { IR_ENGINE_MANCHESTER,  0,     0,     0,    889,  0,    0,     14, 14, 0xFF,   0 },   // RC5
+    { IR_ENGINE_MANCHESTER,  2666,  889,   0,    444,  0,    0,     21, 21, 4,      1 },   // RC6 模式 0
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t IR_Match(uint32_t Dur, uint32_t Ref);
+static uint8_t IR_PulseFeed(TIM_IRDecoderTypeDef* Dec, const IR_ProtocolTypeDef* P, uint8_t Mark, uint32_t Dur);
+static uint8_t IR_ManchesterHalf(TIM_IRDecoderTypeDef* Dec, const IR_ProtocolTypeDef* P, uint8_t Level);
+static uint8_t IR_ManchesterFeed(TIM_IRDecoderTypeDef* Dec, const IR_ProtocolTypeDef* P, uint8_t Mark, uint32_t Dur);
+static ErrorStatus IR_Build(TIM_IRTypeDef* Ir, uint8_t Protocol, uint8_t Result, TIM_IRFrameTypeDef* Frame);
+static uint8_t IR_Feed(TIM_IRTypeDef* Ir, uint8_t Mark, uint32_t Dur, TIM_IRFrameTypeDef* Frame);
+static void IR_ResetDecoders(TIM_IRTypeDef* Ir);
+
+
+/**
+  * @brief  初始化红外接收参数结构体为默认值。
+  * @param  Init: 参数结构体。
+  * @retval None
+  * @note   默认：TIM5 CH1、滤波 0x6（fDTS/4 连续 6 次）、全部协议、第一个 DMA 数据流。
+  */
+void myTIM_IRStructInit(TIM_IRInitTypeDef* Init)
+{
+    Init->TIMx = TIM5;
+    Init->Channel = 1;
+    Init->ICFilter = 0x6;
+    Init->Protocols = TIM_IR_MASK_ALL;
+    Init->DMAAlt = 0;
+}
+
+/**
+  * @brief  初始化红外接收。
+  * @param  Ir: 红外接收句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成，DMA 已开始记录边沿；
+  *         ERROR: 定时器时钟无法分频到 1MHz，或该通道没有 DMA 请求映射。
+  *
+  * @note
+  *  - 定时器配置为满量程向上计数，通道双边沿直接输入捕获，CCxDE 触发 DMA。
+  *  - DMA 循环模式，外设和存储器均为字宽度，16 位定时器的 CCR 高位读为 0。
+  *  - 定时器被本模块独占（其他通道仍可做不影响计数的用途）。
+  *  - 小白理解：定时器把每个电平跳变的时刻自动记进数组，解码时只看相邻跳变的间隔。
+  */
+ErrorStatus myTIM_IRInit(TIM_IRTypeDef* Ir, TIM_IRInitTypeDef* Init)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_ICInitTypeDef ic;
+    TIM_TypeDef* TIMx = Init->TIMx;
+    uint16_t source = (uint16_t)(TIM_DMA_CC1 << (Init->Channel - 1));
+    uint32_t channel = 0;
+    uint32_t psc = 0;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST1_PERIPH(TIMx));
+    assert_param(Init->Channel >= 1 && Init->Channel <= 4);
+    assert_param(IS_TIM_IC_FILTER(Init->ICFilter));
+
+    psc = (myTIM_GetClockFreq(TIMx) + 500000) / 1000000;
+    if (Init->Channel < 1 || Init->Channel > 4 || psc == 0 || psc > 0x10000 ||
+        myTIM_GetDMARequest(TIMx, source, Init->DMAAlt, &Ir->Stream, &channel) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    Ir->TIMx = TIMx;
+    Ir->Mask = (TIMx == TIM2 || TIMx == TIM5) ? 0xFFFFFFFF : 0xFFFF;
+    Ir->Protocols = Init->Protocols;
+    Ir->Prev.Protocol = 0xFF;
+
+    myTIM_Cmd(TIMx, DISABLE);
+    myTIM_DMACmd(TIMx, source, DISABLE);
+
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Prescaler = (uint16_t)(psc - 1);
+    timeBase.TIM_Period = Ir->Mask;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+
+    myTIM_ICStructInit(&ic);
+    ic.TIM_Channel = (uint16_t)((Init->Channel - 1) << 2);
+    ic.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+    ic.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    ic.TIM_ICFilter = Init->ICFilter;
+    myTIM_ICInit(TIMx, &ic);
+
+    /* CCRx -> Ring，循环模式，字宽度 */
+    Ir->Stream->CR &= ~DMA_SxCR_EN;
+    while (Ir->Stream->CR & DMA_SxCR_EN)
+    {
+    }
+    myTIM_DMAClearFlags(Ir->Stream);
+    Ir->Stream->PAR = (uint32_t)(&TIMx->CCR1 + (Init->Channel - 1));
+    Ir->Stream->M0AR = (uint32_t)Ir->Ring;
+    Ir->Stream->NDTR = TIM_IR_RING;
+    Ir->Stream->FCR = 0;
+    Ir->Stream->CR = channel | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 |
+        DMA_SxCR_MINC | DMA_SxCR_CIRC;
+    Ir->Stream->CR |= DMA_SxCR_EN;
+
+    myTIM_IRReset(Ir);
+    myTIM_DMACmd(TIMx, source, ENABLE);
+    myTIM_Cmd(TIMx, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  解码已捕获的边沿。
+  * @param  Ir: 红外接收句柄。
+  * @param  Frame: 输出解码结果。
+  * @retval 1: 解码出一帧（或 NEC 重复码），结果在 Frame；0: 没有新的完整帧
+  *
+  * @note
+  *  - 每次最多返回一帧，剩余边沿留到下一次调用，不会丢失。
+  *  - 先读 DMA 写位置再读 CNT：本次处理的边沿都早于判断空闲用的“当前时刻”，
+  *    now - Last 不会回绕成接近满量程而被误判为空闲；两次读取之间到达的边沿留到下一次。
+  *  - 只在主循环调用，不可重入，执行时间与新边沿数成正比，一帧约几十微秒。
+  */
+uint8_t myTIM_IRPoll(TIM_IRTypeDef* Ir, TIM_IRFrameTypeDef* Frame)
+{
+    uint16_t head = (uint16_t)((TIM_IR_RING - Ir->Stream->NDTR) % TIM_IR_RING);
+    uint32_t now = Ir->TIMx->CNT;
+    uint32_t t = 0;
+    uint32_t dur = 0;
+    uint8_t level = 0;
+
+    while (Ir->Tail != head)
+    {
+        t = Ir->Ring[Ir->Tail];
+        Ir->Tail = (uint16_t)((Ir->Tail + 1) % TIM_IR_RING);
+
+        if (Ir->Idle)
+        {
+            /* 空闲后的第一个边沿：mark 开始 */
+            Ir->Idle = 0;
+            Ir->Level = IR_MARK;
+            Ir->Last = t;
+            continue;
+        }
+
+        dur = (t - Ir->Last) & Ir->Mask;
+        level = Ir->Level;
+        Ir->Last = t;
+
+        if (dur > TIM_IR_IDLE_US)
+        {
+            /* 两次调用之间错过了空闲：先结束上一帧，本边沿作为新帧的开始 */
+            Ir->Level = IR_MARK;
+            if (level == IR_SPACE ? IR_Feed(Ir, IR_SPACE, IR_FOREVER, Frame) : (IR_ResetDecoders(Ir), 0))
+            {
+                return 1;
+            }
+            continue;
+        }
+
+        Ir->Level ^= 1;
+        if (IR_Feed(Ir, level, dur, Frame))
+        {
+            return 1;
+        }
+    }
+
+    if (!Ir->Idle && ((now - Ir->Last) & Ir->Mask) > TIM_IR_IDLE_US)
+    {
+        Ir->Idle = 1;
+        if (Ir->Level == IR_SPACE)
+        {
+            return IR_Feed(Ir, IR_SPACE, IR_FOREVER, Frame);
+        }
+        IR_ResetDecoders(Ir);
+    }
+
+    return 0;
+}
+
+/**
+  * @brief  丢弃未处理的边沿和全部解码状态。
+  * @param  Ir: 红外接收句柄。
+  * @retval None
+  */
+void myTIM_IRReset(TIM_IRTypeDef* Ir)
+{
+    Ir->Tail = (uint16_t)((TIM_IR_RING - Ir->Stream->NDTR) % TIM_IR_RING);
+    Ir->Idle = 1;
+    Ir->Level = IR_SPACE;
+    Ir->Last = 0;
+    IR_ResetDecoders(Ir);
+}
+
+
+/**
+  * @brief  判断脉宽是否在参考值的容差范围内。
+  */
+static uint8_t IR_Match(uint32_t Dur, uint32_t Ref)
+{
+    uint32_t tol = Ref * TIM_IR_TOLERANCE / 100;
+
+    return (Dur + tol >= Ref && Dur <= Ref + tol) ? 1 : 0;
+}
+
+/**
+  * @brief  脉冲编码引擎（NEC / SIRC）。
+  * @retval IR_NONE / IR_FRAME / IR_REPEAT；出错时回到空闲并检查本区间是否为新的引导码。
+  */
+static uint8_t IR_PulseFeed(TIM_IRDecoderTypeDef* Dec, const IR_ProtocolTypeDef* P, uint8_t Mark, uint32_t Dur)
+{
+    uint8_t bit = 0;
+
+    switch (Dec->State)
+    {
+    case IR_S_LEAD_SPACE:
+        if (!Mark && IR_Match(Dur, P->LeadSpace))
+        {
+            Dec->State = IR_S_BIT_MARK;
+            Dec->Bits = 0;
+            Dec->Data = 0;
+            return IR_NONE;
+        }
+        if (!Mark && P->RepeatSpace != 0 && IR_Match(Dur, P->RepeatSpace))
+        {
+            Dec->State = IR_S_REPEAT_MARK;
+            return IR_NONE;
+        }
+        break;
+
+    case IR_S_REPEAT_MARK:
+        if (Mark && IR_Match(Dur, P->Unit))
+        {
+            Dec->State = IR_S_IDLE;
+            return IR_REPEAT;
+        }
+        break;
+
+    case IR_S_BIT_MARK:
+        if (!Mark)
+        {
+            break;
+        }
+        if (!P->BitInMark)
+        {
+            /* 位在 space 中：mark 固定为短单元，收满后的 mark 是结束位 */
+            if (IR_Match(Dur, P->Unit))
+            {
+                Dec->State = (Dec->Bits == P->MaxBits) ? IR_S_IDLE : IR_S_BIT_SPACE;
+                return (Dec->Bits == P->MaxBits) ? IR_FRAME : IR_NONE;
+            }
+            break;
+        }
+        if (IR_Match(Dur, P->Long) || IR_Match(Dur, P->Unit))
+        {
+            bit = IR_Match(Dur, P->Long);
+            Dec->Data |= (uint32_t)bit << Dec->Bits;
+            Dec->Bits++;
+            Dec->State = IR_S_BIT_SPACE;
+            return IR_NONE;
+        }
+        break;
+
+    case IR_S_BIT_SPACE:
+        if (Mark)
+        {
+            break;
+        }
+        if (!P->BitInMark)
+        {
+            if (IR_Match(Dur, P->Long) || IR_Match(Dur, P->Unit))
+            {
+                bit = IR_Match(Dur, P->Long);
+                Dec->Data |= (uint32_t)bit << Dec->Bits;
+                Dec->Bits++;
+                Dec->State = IR_S_BIT_MARK;
+                return IR_NONE;
+            }
+            break;
+        }
+        /* 位在 mark 中：短 space 后继续，长 space（或空闲）结束一帧 */
+        if (Dec->Bits < P->MaxBits && IR_Match(Dur, P->Unit))
+        {
+            Dec->State = IR_S_BIT_MARK;
+            return IR_NONE;
+        }
+        if (Dur > 2 * P->Long && Dec->Bits >= P->MinBits)
+        {
+            Dec->State = IR_S_IDLE;
+            return IR_FRAME;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    /* 空闲或出错：本区间可能是新的引导码 */
+    Dec->State = (Mark && IR_Match(Dur, P->LeadMark)) ? IR_S_LEAD_SPACE : IR_S_IDLE;
+    return IR_NONE;
+}
+
+/**
+  * @brief  曼彻斯特引擎收到一个半位。
+  * @retval IR_NONE / IR_FRAME；两个半位电平相同时回到空闲。
+  */
+static uint8_t IR_ManchesterHalf(TIM_IRDecoderTypeDef* Dec, const IR_ProtocolTypeDef* P, uint8_t Level)
+{
+    if (Dec->Half == 0)
+    {
+        Dec->First = Level;
+        Dec->Half = 1;
+        return IR_NONE;
+    }
+    if (Dec->First == Level)
+    {
+        Dec->State = IR_S_IDLE;
+        return IR_NONE;
+    }
+
+    /* 高位在前 */
+    Dec->Data = (Dec->Data << 1) | ((Dec->First == IR_MARK) == (P->MarkFirst != 0) ? 1 : 0);
+    Dec->Bits++;
+    Dec->Half = 0;
+    if (Dec->Bits == P->MaxBits)
+    {
+        Dec->State = IR_S_IDLE;
+        return IR_FRAME;
+    }
+    return IR_NONE;
+}
+
+/**
+  * @brief  曼彻斯特引擎（RC5 / RC6）：把区间拆成 1~2 个半位，双倍宽度位的半位为 2T。
+  * @retval IR_NONE / IR_FRAME
+  */
+static uint8_t IR_ManchesterFeed(TIM_IRDecoderTypeDef* Dec, const IR_ProtocolTypeDef* P, uint8_t Mark, uint32_t Dur)
+{
+    int32_t rem = 0;
+    int32_t half = 0;
+    uint8_t n = 0;
+    uint8_t r = IR_NONE;
+
+    if (Dec->State == IR_S_IDLE)
+    {
+        if (P->LeadMark != 0)
+        {
+            Dec->State = (Mark && IR_Match(Dur, P->LeadMark)) ? IR_S_LEAD_SPACE : IR_S_IDLE;
+            return IR_NONE;
+        }
+        if (!Mark)
+        {
+            return IR_NONE;
+        }
+        /* 没有引导码（RC5）：起始位 1 的前半位 space 与空闲重合，补上 */
+        Dec->State = IR_S_DATA;
+        Dec->Bits = 0;
+        Dec->Half = 0;
+        Dec->Data = 0;
+        IR_ManchesterHalf(Dec, P, IR_SPACE);
+    }
+    else if (Dec->State == IR_S_LEAD_SPACE)
+    {
+        Dec->State = (!Mark && IR_Match(Dur, P->LeadSpace)) ? IR_S_DATA : IR_S_IDLE;
+        Dec->Bits = 0;
+        Dec->Half = 0;
+        Dec->Data = 0;
+        return IR_NONE;
+    }
+
+    /* 长 space：只有最后一位的后半位 space 可以落在空闲里 */
+    if (!Mark && Dur > 6U * P->Unit)
+    {
+        if (Dec->Bits + 1 == P->MaxBits && Dec->Half == 1 && Dec->First == IR_MARK)
+        {
+            return IR_ManchesterHalf(Dec, P, IR_SPACE);
+        }
+        Dec->State = IR_S_IDLE;
+        return IR_NONE;
+    }
+
+    rem = (int32_t)Dur;
+    for (;;)
+    {
+        half = (Dec->Bits == P->Trailer) ? 2 * P->Unit : P->Unit;
+        if (rem < half - half * TIM_IR_TOLERANCE / 100 || n == 2)
+        {
+            break;
+        }
+        r = IR_ManchesterHalf(Dec, P, Mark);
+        if (r != IR_NONE || Dec->State == IR_S_IDLE)
+        {
+            return r;
+        }
+        rem -= half;
+        n++;
+    }
+
+    /* 区间必须正好是 1 或 2 个半位 */
+    if (n == 0 || rem > half * TIM_IR_TOLERANCE / 100)
+    {
+        Dec->State = IR_S_IDLE;
+        if (P->LeadMark != 0 && Mark && IR_Match(Dur, P->LeadMark))
+        {
+            Dec->State = IR_S_LEAD_SPACE;
+        }
+    }
+    return IR_NONE;
+}
+
+/**
+  * @brief  把引擎输出的原始位转换为地址/命令并校验。
+  * @retval SUCCESS: 有效帧；ERROR: 校验失败
+  */
+static ErrorStatus IR_Build(TIM_IRTypeDef* Ir, uint8_t Protocol, uint8_t Result, TIM_IRFrameTypeDef* Frame)
+{
+    TIM_IRDecoderTypeDef* dec = &Ir->Dec[Protocol];
+    uint32_t d = dec->Data;
+
+    Frame->Protocol = Protocol;
+    Frame->Repeat = 0;
+    Frame->Toggle = 0;
+    Frame->Bits = dec->Bits;
+    Frame->Raw = d;
+
+    switch (Protocol)
+    {
+    case TIM_IR_NEC:
+        if (Result == IR_REPEAT)
+        {
+            /* 重复码不带数据，沿用上一帧 */
+            if (Ir->Prev.Protocol != TIM_IR_NEC)
+            {
+                return ERROR;
+            }
+            *Frame = Ir->Prev;
+            Frame->Repeat = 1;
+            return SUCCESS;
+        }
+        /* 地址、~地址、命令、~命令，低位在前；地址反码不成立时为 16 位扩展地址 */
+        if ((((d >> 16) ^ (d >> 24)) & 0xFF) != 0xFF)
+        {
+            return ERROR;
+        }
+        Frame->Address = (uint16_t)((((d ^ (d >> 8)) & 0xFF) == 0xFF) ? (d & 0xFF) : (d & 0xFFFF));
+        Frame->Command = (uint16_t)((d >> 16) & 0xFF);
+        break;
+
+    case TIM_IR_SIRC:
+        /* 7 位命令 + 5/8/13 位地址，低位在前 */
+        if (dec->Bits != 12 && dec->Bits != 15 && dec->Bits != 20)
+        {
+            return ERROR;
+        }
+        Frame->Command = (uint16_t)(d & 0x7F);
+        Frame->Address = (uint16_t)(d >> 7);
+        Frame->Repeat = (Ir->Prev.Protocol == TIM_IR_SIRC && Ir->Prev.Raw == d && Ir->Prev.Bits == dec->Bits) ? 1 : 0;
+        break;
+
+    case TIM_IR_RC5:
+        /* S1 S2 T A4..A0 C5..C0；S2 取反为 RC5X 命令第 6 位 */
+        if (!(d & 0x2000))
+        {
+            return ERROR;
+        }
+        Frame->Toggle = (uint8_t)((d >> 11) & 1);
+        Frame->Address = (uint16_t)((d >> 6) & 0x1F);
+        Frame->Command = (uint16_t)((d & 0x3F) | ((~d >> 6) & 0x40));
+        break;
+
+    default:
+        /* RC6 模式 0：起始位 1、模式 000、翻转位、8 位地址、8 位命令 */
+        if ((d >> 17) != 0x8)
+        {
+            return ERROR;
+        }
+        Frame->Toggle = (uint8_t)((d >> 16) & 1);
+        Frame->Address = (uint16_t)((d >> 8) & 0xFF);
+        Frame->Command = (uint16_t)(d & 0xFF);
+        break;
+    }
+
+    if (Protocol == TIM_IR_RC5 || Protocol == TIM_IR_RC6)
+    {
+        Frame->Repeat = (Ir->Prev.Protocol == Protocol && Ir->Prev.Toggle == Frame->Toggle &&
+            Ir->Prev.Address == Frame->Address && Ir->Prev.Command == Frame->Command) ? 1 : 0;
+    }
+    Ir->Prev = *Frame;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  把一个 mark/space 区间送入所有使能的协议。
+  * @retval 1: 某协议完成一帧，结果在 Frame，全部协议状态清零；0: 没有
+  */
+static uint8_t IR_Feed(TIM_IRTypeDef* Ir, uint8_t Mark, uint32_t Dur, TIM_IRFrameTypeDef* Frame)
+{
+    const IR_ProtocolTypeDef* p = 0;
+    uint8_t i = 0;
+    uint8_t r = IR_NONE;
+
+    for (i = 0; i < TIM_IR_PROTOCOLS; i++)
+    {
+        if (!(Ir->Protocols & (1U << i)))
+        {
+            continue;
+        }
+        p = &s_protocols[i];
+        r = (p->Engine == IR_ENGINE_PULSE) ? IR_PulseFeed(&Ir->Dec[i], p, Mark, Dur)
+            : IR_ManchesterFeed(&Ir->Dec[i], p, Mark, Dur);
+        if (r != IR_NONE && IR_Build(Ir, i, r, Frame) == SUCCESS)
+        {
+            IR_ResetDecoders(Ir);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+  * @brief  全部协议状态回到空闲。
+  */
+static void IR_ResetDecoders(TIM_IRTypeDef* Ir)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < TIM_IR_PROTOCOLS; i++)
+    {
+        Ir->Dec[i].State = IR_S_IDLE;
+        Ir->Dec[i].Bits = 0;
+        Ir->Dec[i].Half = 0;
+        Ir->Dec[i].Data = 0;
+    }
+}
@@ -0,0 +1,88 @@
+﻿#ifndef mystm32f4_tim_ir_h
+#define mystm32f4_tim_ir_h
+
+#include "mystm32f4_tim.h"
+
+/* DMA 捕获环形缓冲区长度（边沿个数），一帧 NEC 为 68 个边沿 */
+#ifndef TIM_IR_RING
+#define TIM_IR_RING                 128
+#endif
+
+/* 脉宽容差（百分比） */
+#ifndef TIM_IR_TOLERANCE
+#define TIM_IR_TOLERANCE            30
+#endif
+
+/* 无边沿超过该时间（us）视为帧结束/空闲，须大于帧内最长脉宽（NEC 引导码 9ms） */
+#ifndef TIM_IR_IDLE_US
+#define TIM_IR_IDLE_US              12000
+#endif
+
+/* 协议编号 */
+#define TIM_IR_NEC                  0
+#define TIM_IR_SIRC                 1
+#define TIM_IR_RC5                  2
+#define TIM_IR_RC6                  3
+#define TIM_IR_PROTOCOLS            4
+
+/* 协议使能掩码 */
+#define TIM_IR_MASK_NEC             (1U << TIM_IR_NEC)
+#define TIM_IR_MASK_SIRC            (1U << TIM_IR_SIRC)
+#define TIM_IR_MASK_RC5             (1U << TIM_IR_RC5)
+#define TIM_IR_MASK_RC6             (1U << TIM_IR_RC6)
+#define TIM_IR_MASK_ALL             ((1U << TIM_IR_PROTOCOLS) - 1)
+
+/* 红外接收初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;           /* 捕获定时器，计数频率固定为 1MHz */
+    uint8_t  Channel;            /* 接收头输出所接的通道 1~4 */
+    uint16_t ICFilter;           /* 输入滤波 0x0~0xF，见 TIM_ICFilter */
+    uint8_t  Protocols;          /* 使能的协议 TIM_IR_MASK_x 组合 */
+    uint8_t  DMAAlt;             /* CCx DMA 请求的备选数据流序号，见 myTIM_GetDMARequest() */
+} TIM_IRInitTypeDef;
+
+/* 解码结果 */
+typedef struct
+{
+    uint8_t  Protocol;           /* TIM_IR_x */
+    uint8_t  Repeat;             /* 1：按键保持（NEC 重复码 / RC5、RC6 翻转位未变 / SIRC 与上一帧相同） */
+    uint8_t  Toggle;             /* RC5/RC6 翻转位 */
+    uint8_t  Bits;               /* 数据位数 */
+    uint16_t Address;            /* 地址（NEC 扩展地址为 16 位） */
+    uint16_t Command;            /* 命令（RC5X 为 7 位） */
+    uint32_t Raw;                /* 原始数据位 */
+} TIM_IRFrameTypeDef;
+
+/* 单个协议的解码状态 */
+typedef struct
+{
+    uint8_t  State;
+    uint8_t  Bits;
+    uint8_t  Half;               /* 曼彻斯特：当前位已收到的半位数 */
+    uint8_t  First;              /* 曼彻斯特：当前位前半位电平 */
+    uint32_t Data;
+} TIM_IRDecoderTypeDef;
+
+/* 红外接收句柄，由调用者分配 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;
+    DMA_Stream_TypeDef* Stream;
+    uint32_t Mask;               /* 计数器量程掩码：0xFFFF 或 0xFFFFFFFF */
+    uint8_t  Protocols;
+    uint8_t  Idle;               /* 1：线路空闲，下一个边沿是帧的第一个下降沿 */
+    uint8_t  Level;              /* 正在测量的区间：1 = 载波（mark），0 = 无载波（space） */
+    uint16_t Tail;               /* 环形缓冲区读位置 */
+    uint32_t Last;               /* 上一个边沿时间戳 */
+    TIM_IRDecoderTypeDef Dec[TIM_IR_PROTOCOLS];
+    TIM_IRFrameTypeDef Prev;     /* 上一帧，用于判断重复 */
+    uint32_t Ring[TIM_IR_RING];  /* DMA 写入的捕获时间戳 */
+} TIM_IRTypeDef;
+
+void myTIM_IRStructInit(TIM_IRInitTypeDef* Init);                         // 初始化参数结构体默认值
+ErrorStatus myTIM_IRInit(TIM_IRTypeDef* Ir, TIM_IRInitTypeDef* Init);      // 初始化红外接收：双边沿捕获 + DMA 环形缓冲
+uint8_t myTIM_IRPoll(TIM_IRTypeDef* Ir, TIM_IRFrameTypeDef* Frame);        // 解码已捕获的边沿，得到一帧时返回 1
+void myTIM_IRReset(TIM_IRTypeDef* Ir);                                    // 丢弃未处理的边沿和解码状态
+
+#endif
@@ -0,0 +1,330 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_pace.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    定时器 DMA 请求分发：按固定节拍把存储器数据写入外设寄存器
+  *
+  * @attention
+  *
+  * 在中断里按节拍写 GPIO 或 USART，时序抖动等于中断延迟的变化量（几百 ns 到几 us）。
+  * 本文件让定时器的 DMA 请求直接驱动“存储器 -> 外设”传输，CPU 完全不参与：
+  *
+  * - 一个定时器最多 5 路请求：更新事件（UDE）+ CC1~CC4（CCxDE）。
+  *   myTIM_SelectCCDMA(DISABLE) 使 CCx 请求在比较匹配时产生，
+  *   CCR = Offset 决定该通路在周期内的相位，多路可以错开或对齐。
+  * - 每路占用一个 DMA 数据流，按 myTIM_GetDMARequest() 的映射自动挑选：
+  *   跳过本句柄已占用的数据流，也跳过访问不到目标地址的数据流。
+  *   DMA1 的外设端口只连 APB1；GPIO 在 AHB1，只有 DMA2（TIM1/TIM8）能写 GPIO BSRR。
+  * - 数据流优先级设为“非常高”，直接模式（无 FIFO），每个请求立即搬运一个数据。
+  *   剩下的抖动只有总线仲裁的几个时钟周期。
+  *
+  * 典型用法：
+  * - 并行总线/多路波形：TIM1 更新 -> GPIOx->BSRR，BSRR 图样同时置位和复位任意引脚。
+  * - 定速串口输出：TIMx 更新 -> USARTx->DR，节拍周期须大于一个字节的发送时间。
+  *
+  * 限制：
+  * - 同一定时器的某些请求共用一个数据流（如 TIM1 CC4/TRIG/COM），不能同时使用。
+  * - 定时器和所选数据流被本模块独占。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 TIM1、DMA2 和 GPIOD 时钟，PD0~PD7 配置为推挽输出。
+
+(#) 准备 BSRR 图样，每个节拍一个字：
+    static const uint32_t wave[4] = {
+        TIM_PACE_BSRR(0x01, 0xFE), TIM_PACE_BSRR(0x02, 0xFD),
+        TIM_PACE_BSRR(0x04, 0xFB), TIM_PACE_BSRR(0x08, 0xF7) };
+
+(#) 初始化并添加通路：
+    TIM_PaceLaneInitTypeDef lane;
+    myTIM_PaceInit(&pace, TIM1, 1000000);                  // 1MHz 节拍
+    lane.Source = TIM_DMA_Update;
+    lane.Offset = 0;
+    lane.Dest = &GPIOD->BSRR;
+    lane.Buffer = wave;
+    lane.Count = 4;
+    lane.Width = TIM_PACE_WIDTH_WORD;
+    lane.Circular = 1;
+    myTIM_PaceAddLane(&pace, &lane);
+
+(#) myTIM_PaceStart(&pace); ... myTIM_PaceStop(&pace);
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_pace.h"
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Pace_CanReach(DMA_Stream_TypeDef* Stream, uint32_t Addr);
+static uint8_t Pace_StreamUsed(const TIM_PaceTypeDef* Pace, DMA_Stream_TypeDef* Stream);
+
+
+/**
+  * @brief  数据流能否访问目标地址。
+  * @param  Stream: DMA 数据流。
+  * @param  Addr: 目标外设地址。
+  * @retval 1: 可以；0: DMA1 访问 APB1 以外的地址。
+  */
+static uint8_t Pace_CanReach(DMA_Stream_TypeDef* Stream, uint32_t Addr)
+{
+    uint8_t isDMA1 = ((uint32_t)Stream < (uint32_t)DMA2_Stream0);
+
+    return (!isDMA1 || (Addr >= APB1PERIPH_BASE && Addr < APB2PERIPH_BASE)) ? 1 : 0;
+}
+
+/**
+  * @brief  数据流是否已被本句柄的其他通路占用。
+  */
+static uint8_t Pace_StreamUsed(const TIM_PaceTypeDef* Pace, DMA_Stream_TypeDef* Stream)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < Pace->LaneCount; i++)
+    {
+        if (Pace->Lane[i].Stream == Stream)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+  * @brief  初始化节拍定时器。
+  * @param  Pace: 分发句柄。
+  * @param  TIMx: 有 DMA 请求的定时器（TIM1~TIM8）。
+  * @param  Freq: 更新请求频率（Hz）。
+  * @retval SUCCESS: 完成，定时器未启动；ERROR: 频率无法实现。
+  *
+  * @note
+  *  - 自动选择 PSC 使 ARR 尽量大，CCx 通路的相位分辨率最高；实际频率见 Pace->Freq。
+  *  - 小白理解：定时器只负责“敲节拍”，每敲一下 DMA 就搬一个数据到外设。
+  */
+ErrorStatus myTIM_PaceInit(TIM_PaceTypeDef* Pace, TIM_TypeDef* TIMx, uint32_t Freq)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    uint32_t clk = 0;
+    uint32_t total = 0;
+    uint32_t psc = 0;
+    uint64_t range = 0;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_LIST5_PERIPH(TIMx));
+    assert_param(Freq != 0);
+
+    clk = myTIM_GetClockFreq(TIMx);
+    total = (Freq != 0) ? clk / Freq : 0;
+    range = (TIMx == TIM2 || TIMx == TIM5) ? 0x100000000ULL : 0x10000;
+    psc = (uint32_t)((total + range - 1) / range);
+    if (total < 2 || psc == 0 || psc > 0x10000 || total / psc < 2)
+    {
+        return ERROR;
+    }
+
+    Pace->TIMx = TIMx;
+    Pace->Period = total / psc - 1;
+    Pace->Freq = clk / (psc * (Pace->Period + 1));
+    Pace->LaneCount = 0;
+
+    myTIM_Cmd(TIMx, DISABLE);
+    myTIM_DMACmd(TIMx, TIM_DMA_Update | TIM_DMA_CC1 | TIM_DMA_CC2 | TIM_DMA_CC3 | TIM_DMA_CC4, DISABLE);
+
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Prescaler = (uint16_t)(psc - 1);
+    timeBase.TIM_Period = Pace->Period;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+
+    /* CCx 请求在比较匹配时产生，而不是在更新事件时 */
+    myTIM_SelectCCDMA(TIMx, DISABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  添加一路 DMA 通路。
+  * @param  Pace: 分发句柄。
+  * @param  Lane: 通路参数。
+  * @retval SUCCESS: 已添加，通路序号为添加顺序（从 0 开始）；
+  *         ERROR: 请求源非法或已使用、Offset 超出周期，或没有可用且能访问目标的数据流。
+  *
+  * @note
+  *  - CCx 通路的通道被配置为冻结比较模式，引脚不受影响。
+  *  - 通路在 myTIM_PaceStart() 时才真正启动。
+  */
+ErrorStatus myTIM_PaceAddLane(TIM_PaceTypeDef* Pace, TIM_PaceLaneInitTypeDef* Lane)
+{
+    TIM_TypeDef* TIMx = Pace->TIMx;
+    TIM_PaceLaneTypeDef* lane = &Pace->Lane[Pace->LaneCount];
+    DMA_Stream_TypeDef* stream = NULL;
+    uint32_t channel = 0;
+    uint8_t ch = 0;
+    uint8_t alt = 0;
+    uint8_t i = 0;
+
+    /* 参数检查 */
+    assert_param(Lane->Width <= TIM_PACE_WIDTH_WORD);
+    assert_param(Lane->Count != 0);
+
+    /* 请求源必须是单个：更新或 CC1~CC4 */
+    ch = (Lane->Source == TIM_DMA_CC1) ? 1 : (Lane->Source == TIM_DMA_CC2) ? 2 :
+         (Lane->Source == TIM_DMA_CC3) ? 3 : (Lane->Source == TIM_DMA_CC4) ? 4 : 0;
+
+    if (Pace->LaneCount >= TIM_PACE_LANES || Lane->Count == 0 || Lane->Width > TIM_PACE_WIDTH_WORD
+        || (ch == 0 && Lane->Source != TIM_DMA_Update) || (ch != 0 && Lane->Offset > Pace->Period))
+    {
+        return ERROR;
+    }
+    for (i = 0; i < Pace->LaneCount; i++)
+    {
+        if (Pace->Lane[i].Source == Lane->Source)
+        {
+            return ERROR;
+        }
+    }
+
+    /* 按映射表顺序找第一个空闲、能访问目标的数据流 */
+    while (myTIM_GetDMARequest(TIMx, Lane->Source, alt++, &stream, &channel) == SUCCESS)
+    {
+        if (!Pace_StreamUsed(Pace, stream) && Pace_CanReach(stream, (uint32_t)Lane->Dest))
+        {
+            break;
+        }
+        stream = NULL;
+    }
+    if (stream == NULL)
+    {
+        return ERROR;
+    }
+
+    if (ch != 0)
+    {
+        myTIM_SelectOCxM(TIMx, (uint16_t)((ch - 1) << 2), TIM_OCMode_Timing);
+        myTIM_SetCompare(TIMx, ch, Lane->Offset);
+    }
+
+    lane->Stream = stream;
+    lane->Source = Lane->Source;
+    lane->Dest = (uint32_t)Lane->Dest;
+    lane->Buffer = (uint32_t)Lane->Buffer;
+    lane->Count = Lane->Count;
+    /* 存储器 -> 外设，存储器递增，源与目标同宽，最高优先级 */
+    lane->CR = channel | DMA_SxCR_PL_1 | DMA_SxCR_PL_0 | DMA_SxCR_DIR_0 | DMA_SxCR_MINC |
+        ((uint32_t)Lane->Width * DMA_SxCR_PSIZE_0) | ((uint32_t)Lane->Width * DMA_SxCR_MSIZE_0) |
+        (Lane->Circular ? DMA_SxCR_CIRC : 0);
+
+    Pace->LaneCount++;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  所有通路从第一个数据开始，并启动定时器。
+  * @param  Pace: 分发句柄。
+  * @retval None
+  *
+  * @note
+  *  - 先 UG 清零计数器（此时 DMA 请求未使能，UG 不会多搬一个数据），
+  *    再打开数据流和 DMA 请求，最后 CEN：第一个周期内 CCx 通路在 Offset 处搬运，
+  *    更新通路在第一个周期结束时搬运。
+  *  - 可重复调用以重新发送单次通路。
+  */
+void myTIM_PaceStart(TIM_PaceTypeDef* Pace)
+{
+    TIM_TypeDef* TIMx = Pace->TIMx;
+    TIM_PaceLaneTypeDef* lane = NULL;
+    uint16_t sources = 0;
+    uint8_t i = 0;
+
+    myTIM_PaceStop(Pace);
+    myTIM_GenerateEvent(TIMx, TIM_EventSource_Update);
+
+    for (i = 0; i < Pace->LaneCount; i++)
+    {
+        lane = &Pace->Lane[i];
+        myTIM_DMAClearFlags(lane->Stream);
+        lane->Stream->PAR = lane->Dest;
+        lane->Stream->M0AR = lane->Buffer;
+        lane->Stream->NDTR = lane->Count;
+        lane->Stream->FCR = 0;
+        lane->Stream->CR = lane->CR;
+        lane->Stream->CR |= DMA_SxCR_EN;
+        sources |= lane->Source;
+    }
+
+    myTIM_DMACmd(TIMx, sources, ENABLE);
+    myTIM_Cmd(TIMx, ENABLE);
+}
+
+/**
+  * @brief  停止定时器和全部通路。
+  * @param  Pace: 分发句柄。
+  * @retval None
+  * @note   等待数据流真正关闭后返回，之后可以安全修改源数据。
+  */
+void myTIM_PaceStop(TIM_PaceTypeDef* Pace)
+{
+    TIM_TypeDef* TIMx = Pace->TIMx;
+    uint8_t i = 0;
+
+    myTIM_Cmd(TIMx, DISABLE);
+    myTIM_DMACmd(TIMx, TIM_DMA_Update | TIM_DMA_CC1 | TIM_DMA_CC2 | TIM_DMA_CC3 | TIM_DMA_CC4, DISABLE);
+
+    for (i = 0; i < Pace->LaneCount; i++)
+    {
+        Pace->Lane[i].Stream->CR &= ~DMA_SxCR_EN;
+        while (Pace->Lane[i].Stream->CR & DMA_SxCR_EN)
+        {
+        }
+    }
+}
+
+/**
+  * @brief  读取通路剩余数据个数。
+  * @param  Pace: 分发句柄。
+  * @param  Lane: 通路序号（添加顺序）。
+  * @retval 剩余个数；循环通路为本圈剩余个数
+  */
+uint16_t myTIM_PaceGetRemaining(TIM_PaceTypeDef* Pace, uint8_t Lane)
+{
+    assert_param(Lane < Pace->LaneCount);
+
+    return (Lane < Pace->LaneCount) ? (uint16_t)Pace->Lane[Lane].Stream->NDTR : 0;
+}
+
+/**
+  * @brief  是否还有单次通路没发完。
+  * @param  Pace: 分发句柄。
+  * @retval 1: 有；0: 单次通路全部发完（循环通路不计）。
+  */
+uint8_t myTIM_PaceIsBusy(TIM_PaceTypeDef* Pace)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < Pace->LaneCount; i++)
+    {
+        if (!(Pace->Lane[i].CR & DMA_SxCR_CIRC) && Pace->Lane[i].Stream->NDTR != 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
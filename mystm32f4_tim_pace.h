@@ -0,0 +1,57 @@
+﻿#ifndef mystm32f4_tim_pace_h
+#define mystm32f4_tim_pace_h
+
+#include "mystm32f4_tim.h"
+
+/* 一个定时器最多的 DMA 通路：更新 + CC1~CC4 */
+#define TIM_PACE_LANES              5
+
+/* 数据宽度 */
+#define TIM_PACE_WIDTH_BYTE         0
+#define TIM_PACE_WIDTH_HALFWORD     1
+#define TIM_PACE_WIDTH_WORD         2
+
+/* GPIO BSRR 图样：低 16 位置位，高 16 位复位 */
+#define TIM_PACE_BSRR(SetPins, ResetPins)   ((uint32_t)(uint16_t)(SetPins) | ((uint32_t)(uint16_t)(ResetPins) << 16))
+
+/* 一路 DMA 通路的参数 */
+typedef struct
+{
+    uint16_t Source;             /* 请求源 TIM_DMA_Update / TIM_DMA_CC1 ~ TIM_DMA_CC4 */
+    uint32_t Offset;             /* CCx 通路：周期内的相位（计数节拍，< ARR），更新通路忽略 */
+    volatile void* Dest;         /* 目标外设寄存器，例如 &GPIOD->BSRR、&USART2->DR */
+    const void* Buffer;          /* 源数据 */
+    uint16_t Count;              /* 数据个数，每个请求搬运一个 */
+    uint8_t  Width;              /* TIM_PACE_WIDTH_x，源与目标相同 */
+    uint8_t  Circular;           /* 1：循环发送；0：发送一遍后停止（定时器继续运行） */
+} TIM_PaceLaneInitTypeDef;
+
+/* 通路运行信息 */
+typedef struct
+{
+    DMA_Stream_TypeDef* Stream;
+    uint32_t CR;                 /* 启动时写入的 DMA_SxCR（不含 EN） */
+    uint32_t Dest;
+    uint32_t Buffer;
+    uint16_t Count;
+    uint16_t Source;
+} TIM_PaceLaneTypeDef;
+
+/* 定时节拍 DMA 分发句柄，由调用者分配 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;
+    uint32_t Period;             /* ARR */
+    uint32_t Freq;               /* 实际请求频率（Hz） */
+    uint8_t  LaneCount;
+    TIM_PaceLaneTypeDef Lane[TIM_PACE_LANES];
+} TIM_PaceTypeDef;
+
+ErrorStatus myTIM_PaceInit(TIM_PaceTypeDef* Pace, TIM_TypeDef* TIMx, uint32_t Freq); // 初始化节拍定时器
+ErrorStatus myTIM_PaceAddLane(TIM_PaceTypeDef* Pace, TIM_PaceLaneInitTypeDef* Lane); // 添加一路 DMA 通路
+void myTIM_PaceStart(TIM_PaceTypeDef* Pace);                          // 所有通路从头开始并启动定时器
+void myTIM_PaceStop(TIM_PaceTypeDef* Pace);                           // 停止定时器和全部通路
+uint16_t myTIM_PaceGetRemaining(TIM_PaceTypeDef* Pace, uint8_t Lane);  // 读取通路剩余数据个数
+uint8_t myTIM_PaceIsBusy(TIM_PaceTypeDef* Pace);                      // 是否还有单次通路没发完
+
+#endif
@@ -0,0 +1,357 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_stage.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    定时器多寄存器配置暂存与更新事件原子生效
+  *
+  * @attention
+  *
+  * 分开调用 myTIM_SetAutoreload() 和 myTIM_SetCompare() 改频率和占空比时，
+  * 两次写入之间如果恰好发生更新事件，就会出现一个“新 ARR + 旧 CCR”的周期：
+  * 表现为一个过短（runt）或过长的脉冲。本模块把 PSC、ARR、CCR1~4、RCR、
+  * 输出模式打包成一组，保证它们在同一个更新事件一起生效：
+  *
+  * - 强制打开 ARPE 和各输出通道的 OCxPE，PSC/ARR/CCR/RCR 写入的都是预装载寄存器，
+  *   只有更新事件才会把它们搬到影子寄存器。
+  * - 写入前用 myTIM_UpdateDisableConfig() 置 UDIS，写完再清除。UDIS 期间计数器照常
+  *   按旧影子值溢出，但不产生更新事件，影子寄存器保持旧的一组值：
+  *   即使调用者被高优先级中断打断、写入跨过了周期边界，也只是旧配置多走一个周期，
+  *   不会出现新旧混合的周期。
+  * - OCxM 位没有硬件预装载：提交时锁存到句柄，打开更新中断，在更新中断里写入 CCMR。
+  *   模式切换因此比 PSC/ARR/CCR 晚一个中断响应时间（通常 < 1us）。
+  * - Immediate 模式：全部写入后置 URS 并发 UG，立即装载并重新开始一个周期，不触发更新中断。
+  *
+  * 限制：
+  * - 调用者优先级应低于（或等于）定时器更新中断；反过来时模式切换会推迟到调用者返回后。
+  * - 定时器未运行（CEN = 0）时不会有更新事件，自动按 Immediate 模式处理。
+  * - 通道被配置为输入捕获时不能暂存该通道的比较值或模式。
+  * - 应用自己打开了更新中断时，UIF 由应用的中断及时清除，本模块不去动它；
+  *   若应用的更新中断长期被屏蔽，残留的 UIF 会让模式提前在旧周期内生效。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 按常规方式初始化定时器和 PWM 通道并启动计数器。
+
+(#) 准备一组新配置并提交：
+    TIM_StageTypeDef stage;
+    myTIM_StageStructInit(&stage);
+    stage.Fields = TIM_Stage_Period;
+    stage.Period = 839;                              // 100kHz
+    myTIM_StageSetPulse(&stage, 1, 420);             // 50%
+    myTIM_StageSetPulse(&stage, 2, 210);             // 25%
+    myTIM_StageCommit(TIM3, &stage, TIM_StageMode_Update);
+
+(#) 暂存了输出模式时，在更新中断中调用：
+    void TIM3_IRQHandler(void) { myTIM_StageIRQHandler(TIM3, &stage); }
+    （TIM1/TIM8 的更新中断为 TIM1_UP_TIM10_IRQn / TIM8_UP_TIM13_IRQn）
+
+(#) myTIM_StageIsPending() 返回 0 后句柄可再次使用；只改 PSC/ARR/CCR 时
+    不需要中断，可以连续提交，最后一次提交的配置在下一个更新事件生效。
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_stage.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STAGE_PULSE_SHIFT     2        /* TIM_Stage_Pulse1 的位号 */
+#define STAGE_MODE_SHIFT      6        /* TIM_Stage_OCMode1 的位号 */
+#define STAGE_MODE_MASK       ((uint16_t)(TIM_Stage_OCMode1 | TIM_Stage_OCMode2 | TIM_Stage_OCMode3 | TIM_Stage_OCMode4))
+
+/* Private function prototypes -----------------------------------------------*/
+static volatile uint16_t* Stage_CCMR(TIM_TypeDef* TIMx, uint8_t Channel);
+static void Stage_WriteOCMode(TIM_TypeDef* TIMx, uint8_t Channel, uint16_t TIM_OCMode);
+static void Stage_ApplyModes(TIM_TypeDef* TIMx, TIM_StageTypeDef* Stage, uint16_t Modes);
+
+
+/**
+  * @brief  取通道对应的 CCMR 寄存器地址。
+  * @param  TIMx: 定时器。
+  * @param  Channel: 通道 1~4。
+  * @retval CCMR1（CH1/CH2）或 CCMR2（CH3/CH4）的地址
+  */
+static volatile uint16_t* Stage_CCMR(TIM_TypeDef* TIMx, uint8_t Channel)
+{
+    return (Channel <= 2) ? &TIMx->CCMR1 : &TIMx->CCMR2;
+}
+
+/**
+  * @brief  只改写通道的 OCxM 位。
+  * @param  TIMx: 定时器。
+  * @param  Channel: 通道 1~4。
+  * @param  TIM_OCMode: TIM_OCMode_x。
+  * @retval None
+  * @note   不经过 myTIM_SelectOCxM()：它会先关闭 CCxE，输出会闪断一下。
+  */
+static void Stage_WriteOCMode(TIM_TypeDef* TIMx, uint8_t Channel, uint16_t TIM_OCMode)
+{
+    volatile uint16_t* ccmr = Stage_CCMR(TIMx, Channel);
+    uint8_t shift = (Channel & 1) ? 0 : 8;
+
+    *ccmr = (uint16_t)((*ccmr & ~(TIM_CCMR1_OC1M << shift)) | (TIM_OCMode << shift));
+}
+
+/**
+  * @brief  把锁存的模式写入 CCMR。
+  * @param  TIMx: 定时器。
+  * @param  Stage: 暂存句柄。
+  * @param  Modes: 要写入的模式位 TIM_Stage_OCModex 组合。
+  * @retval None
+  */
+static void Stage_ApplyModes(TIM_TypeDef* TIMx, TIM_StageTypeDef* Stage, uint16_t Modes)
+{
+    uint8_t ch = 0;
+
+    for (ch = 1; ch <= 4; ch++)
+    {
+        if (Modes & (TIM_Stage_OCMode1 << (ch - 1)))
+        {
+            Stage_WriteOCMode(TIMx, ch, Stage->PendMode[ch - 1]);
+        }
+    }
+}
+
+/**
+  * @brief  初始化暂存结构体：不选中任何字段，没有待生效的模式。
+  * @param  Stage: 暂存句柄。
+  * @retval None
+  */
+void myTIM_StageStructInit(TIM_StageTypeDef* Stage)
+{
+    uint8_t i = 0;
+
+    Stage->Fields = 0;
+    Stage->Prescaler = 0;
+    Stage->Period = 0xFFFF;
+    for (i = 0; i < 4; i++)
+    {
+        Stage->Pulse[i] = 0;
+        Stage->OCMode[i] = TIM_OCMode_PWM1;
+        Stage->PendMode[i] = TIM_OCMode_PWM1;
+    }
+    Stage->RepetitionCounter = 0;
+    Stage->OwnUIE = 0;
+    Stage->Pending = 0;
+}
+
+/**
+  * @brief  暂存一个通道的比较值。
+  * @param  Stage: 暂存句柄。
+  * @param  Channel: 通道 1~4。
+  * @param  Pulse: 比较值 CCRx。
+  * @retval None
+  */
+void myTIM_StageSetPulse(TIM_StageTypeDef* Stage, uint8_t Channel, uint32_t Pulse)
+{
+    assert_param(Channel >= 1 && Channel <= 4);
+
+    Stage->Pulse[Channel - 1] = Pulse;
+    Stage->Fields |= (uint16_t)(1U << (STAGE_PULSE_SHIFT + Channel - 1));
+}
+
+/**
+  * @brief  暂存一个通道的输出比较模式。
+  * @param  Stage: 暂存句柄。
+  * @param  Channel: 通道 1~4。
+  * @param  TIM_OCMode: TIM_OCMode_Timing / Active / Inactive / Toggle / PWM1 / PWM2，
+  *         或强制电平 TIM_ForcedAction_Active / InActive。
+  * @retval None
+  */
+void myTIM_StageSetOCMode(TIM_StageTypeDef* Stage, uint8_t Channel, uint16_t TIM_OCMode)
+{
+    assert_param(Channel >= 1 && Channel <= 4);
+
+    Stage->OCMode[Channel - 1] = TIM_OCMode;
+    Stage->Fields |= (uint16_t)(1U << (STAGE_MODE_SHIFT + Channel - 1));
+}
+
+/**
+  * @brief  提交一组配置，所有选中的字段在同一个更新事件生效。
+  * @param  TIMx: 定时器，TIM1~TIM14。
+  * @param  Stage: 暂存句柄，Fields 选中要修改的字段。
+  * @param  Mode: TIM_StageMode_Update（下一个更新事件）或 TIM_StageMode_Immediate（立即 UG）。
+  * @retval SUCCESS: 已提交；
+  *         ERROR: 非 TIM1/TIM8 却选了 RCR，或选中的通道不存在/处于输入捕获模式。
+  *
+  * @note
+  *  - 会强制打开 ARPE 和选中通道的 OCxPE，之后单独调用 myTIM_SetCompare() 等也是下一周期生效。
+  *  - 可在任意优先级低于定时器更新中断的上下文中调用，包括被打断、跨越周期边界的情况。
+  *  - 暂存了输出模式且用 Update 模式时，要在更新中断中调用 myTIM_StageIRQHandler()。
+  *  - 小白理解：先把“新菜单”整张写在后台，写的时候把“换菜单的铃”关掉，
+  *    写完再打开铃，下次铃响时整张菜单一起换上。
+  *
+  * @example
+  *  stage.Fields = TIM_Stage_Prescaler | TIM_Stage_Period | TIM_Stage_Pulse1;
+  *  stage.Prescaler = 0; stage.Period = 1679; stage.Pulse[0] = 840;
+  *  myTIM_StageCommit(TIM1, &stage, TIM_StageMode_Update);
+  */
+ErrorStatus myTIM_StageCommit(TIM_TypeDef* TIMx, TIM_StageTypeDef* Stage, uint8_t Mode)
+{
+    uint16_t fields = Stage->Fields;
+    uint16_t modes = fields & STAGE_MODE_MASK;
+    uint16_t used = 0;
+    uint16_t urs = 0;
+    uint8_t chCount = 0;
+    uint8_t ch = 0;
+
+    /* 参数检查 */
+    assert_param(IS_TIM_ALL_PERIPH(TIMx));
+    assert_param(Mode == TIM_StageMode_Update || Mode == TIM_StageMode_Immediate);
+
+    /* 各定时器的比较通道数：TIM6/7 没有，TIM10/11/13/14 一个，TIM9/12 两个 */
+    chCount = (TIMx == TIM6 || TIMx == TIM7) ? 0
+        : (TIMx == TIM10 || TIMx == TIM11 || TIMx == TIM13 || TIMx == TIM14) ? 1
+        : (TIMx == TIM9 || TIMx == TIM12) ? 2 : 4;
+
+    if ((fields & TIM_Stage_Repetition) && TIMx != TIM1 && TIMx != TIM8)
+    {
+        return ERROR;
+    }
+
+    for (ch = 1; ch <= 4; ch++)
+    {
+        used = (uint16_t)((fields >> (STAGE_PULSE_SHIFT + ch - 1)) | (fields >> (STAGE_MODE_SHIFT + ch - 1))) & 1;
+        if (!used)
+        {
+            continue;
+        }
+        /* CCxS != 0 表示通道是输入，CCR 只读 */
+        if (ch > chCount || (*Stage_CCMR(TIMx, ch) & (TIM_CCMR1_CC1S << ((ch & 1) ? 0 : 8))))
+        {
+            return ERROR;
+        }
+        /* 打开 OCxPE：CCR 写入预装载寄存器 */
+        *Stage_CCMR(TIMx, ch) |= (uint16_t)(TIM_CCMR1_OC1PE << ((ch & 1) ? 0 : 8));
+    }
+
+    /* 计数器没在跑就不会有更新事件，只能立即生效 */
+    Mode = (TIMx->CR1 & TIM_CR1_CEN) ? Mode : TIM_StageMode_Immediate;
+
+    TIMx->CR1 |= TIM_CR1_ARPE;
+
+    /* 1. 屏蔽更新事件：此后影子寄存器保持旧的一组值 */
+    myTIM_UpdateDisableConfig(TIMx, ENABLE);
+
+    /* 2. 写预装载寄存器 */
+    if (fields & TIM_Stage_Prescaler)
+    {
+        TIMx->PSC = Stage->Prescaler;
+    }
+    if (fields & TIM_Stage_Period)
+    {
+        TIMx->ARR = Stage->Period;
+    }
+    for (ch = 1; ch <= 4; ch++)
+    {
+        if (fields & (TIM_Stage_Pulse1 << (ch - 1)))
+        {
+            myTIM_SetCompare(TIMx, ch, Stage->Pulse[ch - 1]);
+        }
+        if (modes & (TIM_Stage_OCMode1 << (ch - 1)))
+        {
+            Stage->PendMode[ch - 1] = Stage->OCMode[ch - 1];
+        }
+    }
+    if (fields & TIM_Stage_Repetition)
+    {
+        TIMx->RCR = Stage->RepetitionCounter;
+    }
+
+    if (Mode == TIM_StageMode_Immediate)
+    {
+        /* 模式直接写入；前一次提交还没生效的模式一并作废 */
+        Stage_ApplyModes(TIMx, Stage, modes);
+        Stage->Pending &= (uint16_t)~modes;
+
+        /* URS = 1 时 UG 只装载影子寄存器，不置 UIF、不触发中断/DMA */
+        urs = TIMx->CR1 & TIM_CR1_URS;
+        TIMx->CR1 |= TIM_CR1_URS;
+        myTIM_UpdateDisableConfig(TIMx, DISABLE);
+        TIMx->EGR = TIM_EventSource_Update;
+        urs ? (TIMx->CR1 |= TIM_CR1_URS) : (TIMx->CR1 &= (uint16_t)~TIM_CR1_URS);
+        return SUCCESS;
+    }
+
+    /* 3. 模式没有预装载：登记给更新中断（UDIS 期间没有更新事件，中断不会半途插进来）。
+     *    UIE 关闭时每次溢出照样置 UIF，打开前先清掉旧标志，
+     *    只让第 4 步放开后的那个更新事件触发写入，否则会在旧周期中途改模式 */
+    if (modes)
+    {
+        Stage->Pending |= modes;
+        if (!(TIMx->DIER & TIM_IT_Update))
+        {
+            Stage->OwnUIE = 1;
+        }
+        if (Stage->OwnUIE)
+        {
+            TIMx->SR = (uint16_t)~TIM_SR_UIF;
+            TIMx->DIER |= TIM_IT_Update;
+        }
+    }
+
+    /* 4. 放开更新事件：下一次溢出把整组值一起装入影子寄存器 */
+    myTIM_UpdateDisableConfig(TIMx, DISABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  查询是否还有输出模式等待更新事件生效。
+  * @param  Stage: 暂存句柄。
+  * @retval 1: 有；0: 没有，上一次提交已全部生效（PSC/ARR/CCR 只需再等一个更新事件）。
+  */
+uint8_t myTIM_StageIsPending(const TIM_StageTypeDef* Stage)
+{
+    return Stage->Pending ? 1 : 0;
+}
+
+/**
+  * @brief  更新中断处理：把锁存的输出模式写入 CCMR。
+  * @param  TIMx: 定时器。
+  * @param  Stage: 暂存句柄。
+  * @retval None
+  * @note   在 TIMx 更新中断中调用。更新中断由本模块打开时，这里清除 UIF 并关闭中断；
+  *         应用自己也用更新中断时，UIF 由应用自己清除。
+  */
+void myTIM_StageIRQHandler(TIM_TypeDef* TIMx, TIM_StageTypeDef* Stage)
+{
+    uint16_t modes = 0;
+
+    if (!(TIMx->SR & TIM_FLAG_Update))
+    {
+        return;
+    }
+
+    modes = Stage->Pending;
+    if (modes)
+    {
+        Stage_ApplyModes(TIMx, Stage, modes);
+        Stage->Pending = 0;
+    }
+
+    if (Stage->OwnUIE)
+    {
+        Stage->OwnUIE = 0;
+        TIMx->DIER &= (uint16_t)~TIM_IT_Update;
+        TIMx->SR = (uint16_t)~TIM_FLAG_Update;
+    }
+}
@@ -0,0 +1,45 @@
+﻿#ifndef mystm32f4_tim_stage_h
+#define mystm32f4_tim_stage_h
+
+#include "mystm32f4_tim.h"
+
+/* 暂存字段选择位（TIM_StageTypeDef.Fields），未选中的字段保持硬件原值 */
+#define TIM_Stage_Prescaler         ((uint16_t)0x0001)
+#define TIM_Stage_Period            ((uint16_t)0x0002)
+#define TIM_Stage_Pulse1            ((uint16_t)0x0004)
+#define TIM_Stage_Pulse2            ((uint16_t)0x0008)
+#define TIM_Stage_Pulse3            ((uint16_t)0x0010)
+#define TIM_Stage_Pulse4            ((uint16_t)0x0020)
+#define TIM_Stage_OCMode1           ((uint16_t)0x0040)
+#define TIM_Stage_OCMode2           ((uint16_t)0x0080)
+#define TIM_Stage_OCMode3           ((uint16_t)0x0100)
+#define TIM_Stage_OCMode4           ((uint16_t)0x0200)
+#define TIM_Stage_Repetition        ((uint16_t)0x0400)   /* 仅 TIM1/TIM8 */
+#define TIM_Stage_All               ((uint16_t)0x07FF)
+
+/* 生效时机 */
+#define TIM_StageMode_Update        0   /* 下一个更新事件一起生效，当前周期走完 */
+#define TIM_StageMode_Immediate     1   /* 立即生效：UG 重新开始一个周期 */
+
+/* 一组待生效的定时器配置，由调用者分配 */
+typedef struct
+{
+    uint16_t Fields;             /* 要修改的字段，TIM_Stage_x 的组合 */
+    uint16_t Prescaler;          /* PSC */
+    uint32_t Period;             /* ARR */
+    uint32_t Pulse[4];           /* CCR1~CCR4 */
+    uint16_t OCMode[4];          /* CH1~CH4 输出比较模式 TIM_OCMode_x */
+    uint8_t  RepetitionCounter;  /* RCR */
+    uint8_t  OwnUIE;             /* 更新中断由本模块打开，模式生效后关闭 */
+    uint16_t PendMode[4];        /* 提交时锁存的模式，更新中断里写入 CCMR */
+    volatile uint16_t Pending;   /* 已写入预装载、等待更新中断生效的模式位 TIM_Stage_OCModex */
+} TIM_StageTypeDef;
+
+void myTIM_StageStructInit(TIM_StageTypeDef* Stage);                   // 初始化暂存结构体（不修改任何字段）
+void myTIM_StageSetPulse(TIM_StageTypeDef* Stage, uint8_t Channel, uint32_t Pulse); // 暂存通道比较值
+void myTIM_StageSetOCMode(TIM_StageTypeDef* Stage, uint8_t Channel, uint16_t TIM_OCMode); // 暂存通道输出模式
+ErrorStatus myTIM_StageCommit(TIM_TypeDef* TIMx, TIM_StageTypeDef* Stage, uint8_t Mode); // 提交配置，所有字段同一拍生效
+uint8_t myTIM_StageIsPending(const TIM_StageTypeDef* Stage);           // 是否还有模式等待更新事件生效
+void myTIM_StageIRQHandler(TIM_TypeDef* TIMx, TIM_StageTypeDef* Stage); // 更新中断处理，在 TIMx_IRQHandler 中调用
+
+#endif
@@ -0,0 +1,656 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_stepper.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    DMA 驱动的步进电机脉冲串与加减速曲线
+  *
+  * @attention
+  *
+  * 本文件用一个定时器通道 + 一个 DMA 数据流产生步进电机 STEP 脉冲串：
+  *
+  * 脉冲：
+  * - 向下计数 PWM1，CCR = 脉宽（固定）：每个周期末尾的 PulseTicks 个节拍输出脉冲，
+  *   计数器停止时 CNT = ARR，输出保持无效电平。
+  * - 每个周期就是一步，周期长度 = ARR + 1 个节拍，ARR 开预装载。
+  *
+  * 加减速：
+  * - 加减速表为预先算好的 ARR 序列，梯形（恒加速度）或 S 形（smoothstep 速度曲线）。
+  * - 更新事件触发 DMA，把下一步的周期写入 ARR 预装载寄存器：运动过程中每步
+  *   没有任何中断，CPU 只在每个 DMA 块结束时介入一次（加速段、匀速段、减速段）。
+  *   匀速段的 DMA 源地址不递增，重复写入同一个值，不需要占用表空间。
+  *
+  * 精确步数：
+  * - 前两步的周期由 CPU 写入（UG 装入影子寄存器 + 预装载），其余 N-2 步由 DMA 写入。
+  * - 最后一个 DMA 块完成后关闭 DMA 请求、打开更新中断；下一个更新事件时置 OPM，
+  *   计数器在最后一步结束的更新事件自动停止，不会多出或少掉脉冲。
+  * - TIM1/TIM8 另提供 RCR + OPM 的纯硬件脉冲串（最多 256 步），整个运动只有结束时一次中断。
+  *
+  * 限制：
+  * - 只支持 16 位定时器 TIM1/TIM3/TIM4/TIM8。DMA 以半字写 ARR，
+  *   对 32 位的 TIM2/TIM5 会把同一半字复制到高 16 位，得到错误的周期。
+  * - DMA 块结束中断和定时器中断的响应时间必须小于一步的周期（200kHz 时为 5us），
+  *   这两个中断应设为较高优先级。
+  * - 每个轴占用一个定时器和一个 DMA 数据流，4 个轴可用 TIM1/TIM3/TIM4/TIM8。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能定时器、DMA 和 DIR 引脚所在 GPIO 的时钟，把 STEP 引脚复用到定时器通道。
+
+(#) 生成加减速表（可在启动时做一次，多个轴共用）：
+    static uint16_t rampBuf[2 * 1024];
+    TIM_StepperRampTypeDef ramp;
+    myTIM_StepperRampBuild(&ramp, rampBuf, 1024, 2000000,  // 2MHz 计数
+        500, 20000, 400000, TIM_STEPPER_RAMP_SCURVE);     // 500 -> 20000 步/秒，400000 步/秒²
+
+(#) 初始化轴：
+    TIM_StepperInitTypeDef init;
+    myTIM_StepperStructInit(&init);
+    init.TIMx = TIM4;
+    init.Channel = 1;
+    init.TickFreq = 2000000;
+    init.DirPort = GPIOD;
+    init.DirPin = GPIO_Pin_10;
+    myTIM_StepperInit(&axis, &init);
+
+(#) 使能 NVIC 中断：
+    DMA1_Stream6_IRQHandler 中调用 myTIM_StepperDMAIRQHandler(&axis)
+    TIM4_IRQHandler 中调用 myTIM_StepperIRQHandler(&axis)
+    （TIM1/TIM8 的更新中断为 TIM1_UP_TIM10_IRQn / TIM8_UP_TIM13_IRQn）
+    数据流可用 myTIM_GetDMARequest(TIM4, TIM_DMA_Update, 0, ...) 查询。
+
+(#) 运动：
+    myTIM_StepperMove(&axis, -12800, &ramp);
+    while (myTIM_StepperIsBusy(&axis)) { }
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_stepper.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STEPPER_DMA_TCIF      0x20     /* myTIM_DMAGetFlags() 中的 TCIF */
+#define STEPPER_DMA_TEIF      0x08     /* myTIM_DMAGetFlags() 中的 TEIF */
+
+/* Private function prototypes -----------------------------------------------*/
+static void Stepper_SetOCMode(TIM_StepperTypeDef* Stp, uint16_t TIM_OCMode);
+static void Stepper_AddSeg(TIM_StepperTypeDef* Stp, const uint16_t* Addr, uint32_t Count, uint8_t Inc);
+static uint16_t Stepper_Pop(TIM_StepperTypeDef* Stp);
+static void Stepper_Arm(TIM_StepperTypeDef* Stp);
+static void Stepper_Prepare(TIM_StepperTypeDef* Stp, int32_t Steps);
+static void Stepper_Finish(TIM_StepperTypeDef* Stp);
+static uint32_t Stepper_Steps(const TIM_StepperTypeDef* Stp);
+
+
+/**
+  * @brief  生成加减速表。
+  * @param  Ramp: 输出加减速表。
+  * @param  Buffer: 表存储区，长度至少 2 * MaxLen 个元素，前半为加速段，后半为减速段。
+  * @param  MaxLen: 加速段最大长度（步）。
+  * @param  TickFreq: 定时器计数频率（Hz），须与轴的 TickFreq 一致。
+  * @param  StartRate: 起跳速度（步/秒），不能为 0。
+  * @param  MaxRate: 最高速度（步/秒），不小于 StartRate。
+  * @param  Accel: 加速度（步/秒²）；S 形曲线为平均加速度。
+  * @param  Shape: TIM_STEPPER_RAMP_LINEAR / TIM_STEPPER_RAMP_SCURVE。
+  * @retval SUCCESS: 生成完成；ERROR: 参数非法或起跳速度的周期超出 16 位。
+  *
+  * @note
+  *  - 按时间积分生成：第 k 步的速度取该步起始时刻 t 的 v(t)，周期 = TickFreq / v，
+  *    t 再加上这一步的周期。这样加速度对应的是真实时间而不是步数。
+  *  - 加速时间 Ta = (MaxRate - StartRate) / Accel；
+  *    梯形 v = Vs + dV * t/Ta，S 形 v = Vs + dV * (3x² - 2x³)，x = t/Ta。
+  *  - MaxLen 不够时加速段在 MaxLen 处截断，匀速段速度取截断处的速度。
+  *  - 只在初始化时调用，有 64 位除法，不要放在中断里。
+  */
+ErrorStatus myTIM_StepperRampBuild(TIM_StepperRampTypeDef* Ramp, uint16_t* Buffer, uint16_t MaxLen,
+    uint32_t TickFreq, uint32_t StartRate, uint32_t MaxRate, uint32_t Accel, uint8_t Shape)
+{
+    uint32_t dv = MaxRate - StartRate;
+    uint64_t ta = 0;
+    uint64_t t = 0;
+    uint64_t x = 0;
+    uint64_t s = 0;
+    uint32_t v = 0;
+    uint32_t period = 0;
+    uint16_t len = 0;
+    uint16_t i = 0;
+
+    /* 参数检查 */
+    assert_param(StartRate != 0 && MaxRate >= StartRate && Accel != 0);
+    assert_param(Shape == TIM_STEPPER_RAMP_LINEAR || Shape == TIM_STEPPER_RAMP_SCURVE);
+
+    if (StartRate == 0 || MaxRate < StartRate || Accel == 0 || TickFreq == 0 ||
+        (TickFreq + StartRate / 2) / StartRate > 0x10000)
+    {
+        return ERROR;
+    }
+
+    ta = (uint64_t)dv * TickFreq / Accel;
+
+    while (t < ta && len < MaxLen)
+    {
+        x = (t << 16) / ta;                                    // Q16，0 ~ 1
+        s = (Shape == TIM_STEPPER_RAMP_SCURVE) ?
+            (((x * x) >> 16) * (3 * 65536 - 2 * x)) >> 16 : x;  // smoothstep 或线性
+        v = StartRate + (uint32_t)(((uint64_t)dv * s) >> 16);
+        period = (TickFreq + v / 2) / v;
+        period = (period < 2) ? 2 : period;
+        Buffer[len++] = (uint16_t)(period - 1);
+        t += period;
+    }
+
+    /* 匀速段周期；加速段被截断时取截断处的速度 */
+    period = (TickFreq + MaxRate / 2) / MaxRate;
+    period = (period < 2) ? 2 : period;
+    Ramp->Cruise = (t < ta && len != 0) ? Buffer[len - 1] : (uint16_t)(period - 1);
+
+    /* 减速段为加速段的逆序 */
+    for (i = 0; i < len; i++)
+    {
+        Buffer[MaxLen + i] = Buffer[len - 1 - i];
+    }
+
+    Ramp->Accel = Buffer;
+    Ramp->Decel = Buffer + MaxLen;
+    Ramp->Length = len;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  初始化步进轴参数结构体为默认值。
+  * @param  Init: 参数结构体。
+  * @retval None
+  * @note   默认：TIM4 CH1、2MHz 计数、2us 脉宽、高电平脉冲、第一个 DMA 数据流、不控制 DIR。
+  */
+void myTIM_StepperStructInit(TIM_StepperInitTypeDef* Init)
+{
+    Init->TIMx = TIM4;
+    Init->Channel = 1;
+    Init->TickFreq = 2000000;
+    Init->PulseTicks = 4;
+    Init->OCPolarity = TIM_OCPolarity_High;
+    Init->DMAAlt = 0;
+    Init->DirPort = NULL;
+    Init->DirPin = 0;
+    Init->DirInvert = 0;
+}
+
+/**
+  * @brief  初始化步进轴。
+  * @param  Stp: 步进轴句柄。
+  * @param  Init: 初始化参数。
+  * @retval SUCCESS: 初始化完成，输出保持无效电平；
+  *         ERROR: 定时器不支持、计数频率无法实现或没有对应的更新 DMA 数据流。
+  *
+  * @note
+  *  - 定时器配置为向下计数、ARR 预装载、URS = 1（UG 不触发 DMA 也不置 UIF）。
+  *  - 空闲时通道为强制无效电平，运动开始时切换为 PWM1。
+  *  - DMA 数据流的时钟需提前使能，数据流被本轴独占。
+  */
+ErrorStatus myTIM_StepperInit(TIM_StepperTypeDef* Stp, TIM_StepperInitTypeDef* Init)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_OCInitTypeDef oc;
+    TIM_TypeDef* TIMx = Init->TIMx;
+    uint32_t psc = 0;
+
+    /* 参数检查 */
+    assert_param(TIMx == TIM1 || TIMx == TIM3 || TIMx == TIM4 || TIMx == TIM8);
+    assert_param(Init->Channel >= 1 && Init->Channel <= 4);
+    assert_param(Init->TickFreq != 0 && Init->PulseTicks != 0);
+
+    if ((TIMx != TIM1 && TIMx != TIM3 && TIMx != TIM4 && TIMx != TIM8) ||
+        Init->Channel < 1 || Init->Channel > 4 || Init->TickFreq == 0 || Init->PulseTicks == 0)
+    {
+        return ERROR;
+    }
+
+    psc = (myTIM_GetClockFreq(TIMx) + Init->TickFreq / 2) / Init->TickFreq;
+    if (psc == 0 || psc > 0x10000 ||
+        myTIM_GetDMARequest(TIMx, TIM_DMA_Update, Init->DMAAlt, &Stp->Stream, &Stp->DMAChannel) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    Stp->TIMx = TIMx;
+    Stp->Channel = Init->Channel;
+    Stp->PulseTicks = Init->PulseTicks;
+    Stp->DirPort = Init->DirPort;
+    Stp->DirPin = Init->DirPin;
+    Stp->DirInvert = Init->DirInvert;
+    Stp->State = TIM_STEPPER_IDLE;
+    Stp->Dir = 1;
+    Stp->SegHead = 0;
+    Stp->SegCount = 0;
+    Stp->Total = 0;
+    Stp->Done = 0;
+    Stp->Chunk = 0;
+    Stp->Position = 0;
+
+    myTIM_Cmd(TIMx, DISABLE);
+    TIMx->DIER &= (uint16_t)~(TIM_DIER_UIE | TIM_DIER_UDE);
+    Stp->Stream->CR &= ~DMA_SxCR_EN;
+
+    /* 向下计数，周期由运动时写入 */
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Prescaler = (uint16_t)(psc - 1);
+    timeBase.TIM_CounterMode = TIM_CounterMode_Down;
+    timeBase.TIM_Period = 0xFFFF;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+    myTIM_ARRPreloadConfig(TIMx, ENABLE);
+    myTIM_UpdateRequestConfig(TIMx, TIM_UpdateSource_Regular);
+
+    /* PWM1，CCR = 脉宽：CNT < CCR 时输出脉冲，即每个周期的末尾 */
+    myTIM_OCStructInit(&oc);
+    oc.TIM_OCMode = TIM_OCMode_PWM1;
+    oc.TIM_OutputState = TIM_OutputState_Enable;
+    oc.TIM_Pulse = Init->PulseTicks;
+    oc.TIM_OCPolarity = Init->OCPolarity;
+    (Init->Channel == 1) ? myTIM_OCxInit(TIMx, 1, &oc) :
+        (Init->Channel == 2) ? myTIM_OC2Init(TIMx, &oc) :
+        (Init->Channel == 3) ? myTIM_OC3Init(TIMx, &oc) : myTIM_OC4Init(TIMx, &oc);
+    Stepper_SetOCMode(Stp, TIM_ForcedAction_InActive);
+
+    if (TIMx == TIM1 || TIMx == TIM8)
+    {
+        myTIM_CtrlPWMOutputs(TIMx, ENABLE);
+    }
+
+    TIMx->SR = 0;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  按加减速表走精确步数。
+  * @param  Stp: 步进轴句柄。
+  * @param  Steps: 步数，符号为方向，0 时直接返回。
+  * @param  Ramp: 加减速表，运动期间必须保持有效（DMA 直接读取）。
+  * @retval SUCCESS: 运动已启动；ERROR: 轴正忙或匀速段周期不大于脉宽。
+  *
+  * @note
+  *  - 步数不足以加速到匀速段时，加速一半、减速一半（三角形速度曲线）。
+  *  - DIR 引脚在启动前设置，第一个脉冲在第一个周期末尾，DIR 建立时间至少一个周期。
+  *  - 小白理解：把每一步要等多久提前排好队，DMA 在每一步结束时自动把下一步的等待时间递给定时器。
+  */
+ErrorStatus myTIM_StepperMove(TIM_StepperTypeDef* Stp, int32_t Steps, const TIM_StepperRampTypeDef* Ramp)
+{
+    TIM_TypeDef* TIMx = Stp->TIMx;
+    uint32_t n = (Steps < 0) ? (uint32_t)0 - (uint32_t)Steps : (uint32_t)Steps;
+    uint32_t na = 0;
+    uint32_t nd = 0;
+
+    if (Stp->State != TIM_STEPPER_IDLE || Ramp->Cruise < Stp->PulseTicks)
+    {
+        return ERROR;
+    }
+    if (n == 0)
+    {
+        return SUCCESS;
+    }
+
+    /* 加速段、匀速段、减速段；奇数步时多出的一步给加速段 */
+    na = (Ramp->Length < (n + 1) / 2) ? Ramp->Length : (n + 1) / 2;
+    nd = (Ramp->Length < n / 2) ? Ramp->Length : n / 2;
+    Stp->SegHead = 0;
+    Stp->SegCount = 0;
+    Stepper_AddSeg(Stp, Ramp->Accel, na, 1);
+    Stepper_AddSeg(Stp, &Ramp->Cruise, n - na - nd, 0);
+    Stepper_AddSeg(Stp, Ramp->Decel + (Ramp->Length - nd), nd, 1);
+
+    Stepper_Prepare(Stp, Steps);
+
+    /* 第 0 步：UG 装入影子寄存器；第 1 步：写入预装载 */
+    TIMx->ARR = Stepper_Pop(Stp);
+    TIMx->EGR = TIM_EGR_UG;
+    if (n >= 2)
+    {
+        TIMx->ARR = Stepper_Pop(Stp);
+    }
+    TIMx->SR = (uint16_t)~TIM_SR_UIF;
+
+    if (n >= 3)
+    {
+        Stp->State = TIM_STEPPER_RUN;
+        Stepper_Arm(Stp);
+        TIMx->DIER |= TIM_DIER_UDE;
+    }
+    else
+    {
+        n == 1 ? (TIMx->CR1 |= TIM_CR1_OPM) : 0;
+        Stp->State = (n == 1) ? TIM_STEPPER_LAST : TIM_STEPPER_TAIL;
+        TIMx->DIER |= TIM_DIER_UIE;
+    }
+
+    TIMx->CR1 |= TIM_CR1_CEN;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  RCR 硬件脉冲串：以固定周期输出 1~256 步。
+  * @param  Stp: 步进轴句柄，定时器必须是 TIM1 或 TIM8。
+  * @param  Steps: 步数，符号为方向，绝对值 1 ~ TIM_STEPPER_BURST_MAX。
+  * @param  Period: 周期（ARR 值），必须大于等于脉宽。
+  * @retval SUCCESS: 已启动；ERROR: 定时器不支持、参数非法或轴正忙。
+  *
+  * @note
+  *  - RCR = 步数 - 1，OPM = 1：重复计数器减到 0 时才产生更新事件，计数器随之停止。
+  *    过程中没有 DMA 也没有中断，只在结束时进一次更新中断。
+  *  - 适合点动、回零后的微调等短距离匀速运动。
+  *  - 过程中 myTIM_StepperGetSteps() 返回 0，结束后为 Steps。
+  */
+ErrorStatus myTIM_StepperMoveBurst(TIM_StepperTypeDef* Stp, int32_t Steps, uint16_t Period)
+{
+    TIM_TypeDef* TIMx = Stp->TIMx;
+    uint32_t n = (Steps < 0) ? (uint32_t)0 - (uint32_t)Steps : (uint32_t)Steps;
+
+    if ((TIMx != TIM1 && TIMx != TIM8) || n == 0 || n > TIM_STEPPER_BURST_MAX ||
+        Period < Stp->PulseTicks || Stp->State != TIM_STEPPER_IDLE)
+    {
+        return ERROR;
+    }
+
+    Stp->SegHead = 0;
+    Stp->SegCount = 0;
+    Stepper_Prepare(Stp, Steps);
+
+    TIMx->ARR = Period;
+    TIMx->RCR = (uint16_t)(n - 1);
+    TIMx->EGR = TIM_EGR_UG;
+    TIMx->SR = (uint16_t)~TIM_SR_UIF;
+    TIMx->CR1 |= TIM_CR1_OPM;
+    Stp->State = TIM_STEPPER_LAST;
+    TIMx->DIER |= TIM_DIER_UIE;
+    TIMx->CR1 |= TIM_CR1_CEN;
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  立即停止当前运动。
+  * @param  Stp: 步进轴句柄。
+  * @retval None
+  * @note   已完成的步数计入位置；停止时若正处在脉冲中，该脉冲被截断且不计入。
+  *         没有减速过程，高速时可能失步，正常停止应让运动自然结束。
+  */
+void myTIM_StepperStop(TIM_StepperTypeDef* Stp)
+{
+    TIM_TypeDef* TIMx = Stp->TIMx;
+    uint32_t done = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    TIMx->CR1 &= (uint16_t)~TIM_CR1_CEN;
+    TIMx->DIER &= (uint16_t)~(TIM_DIER_UIE | TIM_DIER_UDE);
+    Stp->Stream->CR &= ~DMA_SxCR_EN;
+    Stepper_SetOCMode(Stp, TIM_ForcedAction_InActive);
+
+    if (Stp->State != TIM_STEPPER_IDLE)
+    {
+        done = Stepper_Steps(Stp);
+        Stp->Position += Stp->Dir * (int64_t)done;
+        Stp->Done = done;
+        Stp->Chunk = 0;
+        Stp->State = TIM_STEPPER_IDLE;
+    }
+
+    TIMx->SR = (uint16_t)~TIM_SR_UIF;
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  查询轴是否正在运动。
+  * @param  Stp: 步进轴句柄。
+  * @retval 1: 运动中；0: 空闲
+  */
+uint8_t myTIM_StepperIsBusy(const TIM_StepperTypeDef* Stp)
+{
+    return (Stp->State != TIM_STEPPER_IDLE) ? 1 : 0;
+}
+
+/**
+  * @brief  读取本次运动已完成的步数。
+  * @param  Stp: 步进轴句柄。
+  * @retval 步数（不带符号）
+  * @note   DMA 阶段由 NDTR 推算，精确到已结束的周期。
+  */
+uint32_t myTIM_StepperGetSteps(const TIM_StepperTypeDef* Stp)
+{
+    uint32_t steps = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    steps = Stepper_Steps(Stp);
+    __set_PRIMASK(primask);
+
+    return steps;
+}
+
+/**
+  * @brief  读取当前位置。
+  * @param  Stp: 步进轴句柄。
+  * @retval 位置（步），运动中包含本次已完成的步数
+  */
+int64_t myTIM_StepperGetPosition(const TIM_StepperTypeDef* Stp)
+{
+    int64_t pos = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    pos = Stp->Position;
+    pos += (Stp->State != TIM_STEPPER_IDLE) ? Stp->Dir * (int64_t)Stepper_Steps(Stp) : 0;
+    __set_PRIMASK(primask);
+
+    return pos;
+}
+
+/**
+  * @brief  DMA 数据流中断处理：一个块传输完成后装入下一块，全部完成后转入收尾。
+  * @param  Stp: 步进轴句柄。
+  * @retval None
+  * @note   传输错误时立即停止运动。
+  */
+void myTIM_StepperDMAIRQHandler(TIM_StepperTypeDef* Stp)
+{
+    TIM_TypeDef* TIMx = Stp->TIMx;
+    uint8_t flags = myTIM_DMAGetFlags(Stp->Stream);
+
+    myTIM_DMAClearFlags(Stp->Stream);
+
+    if (flags & STEPPER_DMA_TEIF)
+    {
+        myTIM_StepperStop(Stp);
+        return;
+    }
+    if (!(flags & STEPPER_DMA_TCIF) || Stp->State != TIM_STEPPER_RUN)
+    {
+        return;
+    }
+
+    Stp->Done += Stp->Chunk;
+    Stp->Chunk = 0;
+
+    if (Stp->SegHead < Stp->SegCount)
+    {
+        Stepper_Arm(Stp);
+        return;
+    }
+
+    /* 最后一个周期值已写入预装载：改用更新中断数出剩下的两步 */
+    TIMx->DIER &= (uint16_t)~TIM_DIER_UDE;
+    TIMx->SR = (uint16_t)~TIM_SR_UIF;
+    Stp->State = TIM_STEPPER_TAIL;
+    TIMx->DIER |= TIM_DIER_UIE;
+}
+
+/**
+  * @brief  定时器更新中断处理：收尾阶段置 OPM，计数器停止后结束运动。
+  * @param  Stp: 步进轴句柄。
+  * @retval None
+  */
+void myTIM_StepperIRQHandler(TIM_StepperTypeDef* Stp)
+{
+    TIM_TypeDef* TIMx = Stp->TIMx;
+
+    if (!(TIMx->SR & TIM_SR_UIF))
+    {
+        return;
+    }
+    TIMx->SR = (uint16_t)~TIM_SR_UIF;
+
+    if (Stp->State == TIM_STEPPER_TAIL)
+    {
+        /* 倒数第二步结束，最后一步已开始：其结束的更新事件停止计数器 */
+        Stp->Done++;
+        TIMx->CR1 |= TIM_CR1_OPM;
+        Stp->State = TIM_STEPPER_LAST;
+    }
+    else if (Stp->State == TIM_STEPPER_LAST)
+    {
+        Stepper_Finish(Stp);
+    }
+}
+
+
+/**
+  * @brief  修改 STEP 通道的 OCxM，不影响 CCxE。
+  * @param  Stp: 步进轴句柄。
+  * @param  TIM_OCMode: 输出比较模式或强制电平。
+  * @retval None
+  */
+static void Stepper_SetOCMode(TIM_StepperTypeDef* Stp, uint16_t TIM_OCMode)
+{
+    __IO uint16_t* ccmr = (Stp->Channel <= 2) ? &Stp->TIMx->CCMR1 : &Stp->TIMx->CCMR2;
+    uint8_t shift = (Stp->Channel & 1) ? 0 : 8;
+
+    *ccmr = (uint16_t)((*ccmr & ~(TIM_CCMR1_OC1M << shift)) | (TIM_OCMode << shift));
+}
+
+/**
+  * @brief  追加一个 DMA 传输段，长度为 0 时忽略。
+  */
+static void Stepper_AddSeg(TIM_StepperTypeDef* Stp, const uint16_t* Addr, uint32_t Count, uint8_t Inc)
+{
+    if (Count != 0)
+    {
+        Stp->Seg[Stp->SegCount].Addr = Addr;
+        Stp->Seg[Stp->SegCount].Count = Count;
+        Stp->Seg[Stp->SegCount].Inc = Inc;
+        Stp->SegCount++;
+    }
+}
+
+/**
+  * @brief  由 CPU 取出队首一步的周期值。
+  */
+static uint16_t Stepper_Pop(TIM_StepperTypeDef* Stp)
+{
+    TIM_StepperSegTypeDef* seg = &Stp->Seg[Stp->SegHead];
+    uint16_t value = *seg->Addr;
+
+    seg->Addr += seg->Inc;
+    if (--seg->Count == 0)
+    {
+        Stp->SegHead++;
+    }
+
+    return value;
+}
+
+/**
+  * @brief  用队首段配置并启动一次 DMA 块传输（存储器 -> ARR，半字）。
+  * @note   数据流在块完成后自动关闭，这里在下一个更新事件前重新启动。
+  */
+static void Stepper_Arm(TIM_StepperTypeDef* Stp)
+{
+    TIM_StepperSegTypeDef* seg = &Stp->Seg[Stp->SegHead];
+    DMA_Stream_TypeDef* stream = Stp->Stream;
+    uint32_t chunk = (seg->Count > TIM_STEPPER_DMA_MAX) ? TIM_STEPPER_DMA_MAX : seg->Count;
+
+    stream->CR &= ~DMA_SxCR_EN;
+    while (stream->CR & DMA_SxCR_EN)
+    {
+    }
+    myTIM_DMAClearFlags(stream);
+
+    stream->PAR = (uint32_t)&Stp->TIMx->ARR;
+    stream->M0AR = (uint32_t)seg->Addr;
+    stream->NDTR = chunk;
+    stream->FCR = 0;    // 直接模式
+    stream->CR = Stp->DMAChannel | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 |
+        (seg->Inc ? DMA_SxCR_MINC : 0) | DMA_SxCR_DIR_0 | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+    seg->Addr += seg->Inc ? chunk : 0;
+    seg->Count -= chunk;
+    if (seg->Count == 0)
+    {
+        Stp->SegHead++;
+    }
+
+    Stp->Chunk = chunk;
+    stream->CR |= DMA_SxCR_EN;
+}
+
+/**
+  * @brief  运动开始前的公共准备：停止计数器、设置方向、清计数、切换为 PWM1。
+  */
+static void Stepper_Prepare(TIM_StepperTypeDef* Stp, int32_t Steps)
+{
+    TIM_TypeDef* TIMx = Stp->TIMx;
+    uint8_t forward = (Steps > 0) ? 1 : 0;
+
+    TIMx->CR1 &= (uint16_t)~(TIM_CR1_CEN | TIM_CR1_OPM);
+    TIMx->DIER &= (uint16_t)~(TIM_DIER_UIE | TIM_DIER_UDE);
+    (TIMx == TIM1 || TIMx == TIM8) ? (TIMx->RCR = 0) : 0;
+
+    if (Stp->DirPort != NULL)
+    {
+        (forward ^ Stp->DirInvert) ? myGPIO_SetBits(Stp->DirPort, Stp->DirPin)
+            : myGPIO_ResetBits(Stp->DirPort, Stp->DirPin);
+    }
+
+    Stp->Dir = forward ? 1 : -1;
+    Stp->Total = (Steps < 0) ? (uint32_t)0 - (uint32_t)Steps : (uint32_t)Steps;
+    Stp->Done = 0;
+    Stp->Chunk = 0;
+    Stepper_SetOCMode(Stp, TIM_OCMode_PWM1);
+}
+
+/**
+  * @brief  运动正常结束：计入位置并回到空闲。
+  */
+static void Stepper_Finish(TIM_StepperTypeDef* Stp)
+{
+    Stp->TIMx->DIER &= (uint16_t)~TIM_DIER_UIE;
+    Stp->Done = Stp->Total;
+    Stp->Position += Stp->Dir * (int64_t)Stp->Total;
+    Stp->State = TIM_STEPPER_IDLE;
+}
+
+/**
+  * @brief  已完成步数，调用者负责关中断。
+  */
+static uint32_t Stepper_Steps(const TIM_StepperTypeDef* Stp)
+{
+    return Stp->Done + ((Stp->State == TIM_STEPPER_RUN) ? Stp->Chunk - Stp->Stream->NDTR : 0);
+}
@@ -0,0 +1,89 @@
+﻿#ifndef mystm32f4_tim_stepper_h
+#define mystm32f4_tim_stepper_h
+
+#include "mystm32f4_tim.h"
+#include "mystm32f4_gpio.h"
+
+/* 加减速曲线形状 */
+#define TIM_STEPPER_RAMP_LINEAR     0   /* 梯形：恒加速度 */
+#define TIM_STEPPER_RAMP_SCURVE     1   /* S 形：速度按 smoothstep 变化，加速度连续 */
+
+/* 单次 DMA 传输的最大长度（NDTR 为 16 位） */
+#define TIM_STEPPER_DMA_MAX         0xFFFF
+
+/* RCR 硬件脉冲串最多步数（TIM1/TIM8 的 RCR 为 8 位） */
+#define TIM_STEPPER_BURST_MAX       256
+
+/* 轴运行状态 */
+#define TIM_STEPPER_IDLE            0   /* 空闲 */
+#define TIM_STEPPER_RUN             1   /* DMA 正在流式写入 ARR */
+#define TIM_STEPPER_TAIL            2   /* DMA 已写完，下一个更新事件置 OPM */
+#define TIM_STEPPER_LAST            3   /* OPM 已置位，下一个更新事件计数器停止 */
+
+/* 加减速表：表项为 ARR 值（周期节拍数 - 1），由 myTIM_StepperRampBuild() 生成 */
+typedef struct
+{
+    const uint16_t* Accel;       /* 加速段，周期递减 */
+    const uint16_t* Decel;       /* 减速段，周期递增（加速段的逆序） */
+    uint16_t Length;             /* 加速段/减速段长度（步） */
+    uint16_t Cruise;             /* 匀速段 ARR 值 */
+} TIM_StepperRampTypeDef;
+
+/* 步进轴初始化参数 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;           /* 脉冲定时器：TIM1 / TIM3 / TIM4 / TIM8 */
+    uint8_t  Channel;            /* STEP 输出通道 1~4 */
+    uint32_t TickFreq;           /* 计数频率（Hz），决定周期分辨率 */
+    uint16_t PulseTicks;         /* STEP 脉冲宽度（节拍） */
+    uint16_t OCPolarity;         /* TIM_OCPolarity_High / Low */
+    uint8_t  DMAAlt;             /* 更新 DMA 请求的备选数据流序号，见 myTIM_GetDMARequest() */
+    GPIO_TypeDef* DirPort;       /* DIR 引脚端口，NULL 表示不控制方向引脚 */
+    uint16_t DirPin;             /* DIR 引脚 GPIO_Pin_x */
+    uint8_t  DirInvert;          /* 1：正方向时 DIR 输出低电平 */
+} TIM_StepperInitTypeDef;
+
+/* DMA 传输段 */
+typedef struct
+{
+    const uint16_t* Addr;        /* 源地址 */
+    uint32_t Count;              /* 剩余表项数 */
+    uint8_t  Inc;                /* 1：源地址递增；0：重复同一个值 */
+} TIM_StepperSegTypeDef;
+
+/* 步进轴句柄，由调用者分配，每个轴一个 */
+typedef struct
+{
+    TIM_TypeDef* TIMx;
+    DMA_Stream_TypeDef* Stream;
+    uint32_t DMAChannel;         /* DMA_SxCR.CHSEL 位 */
+    uint8_t  Channel;
+    uint16_t PulseTicks;
+    GPIO_TypeDef* DirPort;
+    uint16_t DirPin;
+    uint8_t  DirInvert;
+    volatile uint8_t State;      /* TIM_STEPPER_x */
+    int8_t   Dir;                /* 本次运动方向 +1 / -1 */
+    uint8_t  SegHead;            /* 下一个待传输段 */
+    uint8_t  SegCount;
+    TIM_StepperSegTypeDef Seg[3];
+    uint32_t Total;              /* 本次运动总步数 */
+    volatile uint32_t Done;      /* 已完成步数（不含当前 DMA 块） */
+    volatile uint32_t Chunk;     /* 当前 DMA 块长度 */
+    volatile int64_t Position;   /* 已完成运动的累计位置（步） */
+} TIM_StepperTypeDef;
+
+ErrorStatus myTIM_StepperRampBuild(TIM_StepperRampTypeDef* Ramp, uint16_t* Buffer, uint16_t MaxLen, // 生成加减速表，Buffer 长度 2*MaxLen
+    uint32_t TickFreq, uint32_t StartRate, uint32_t MaxRate, uint32_t Accel, uint8_t Shape);
+void myTIM_StepperStructInit(TIM_StepperInitTypeDef* Init);            // 初始化参数结构体默认值
+ErrorStatus myTIM_StepperInit(TIM_StepperTypeDef* Stp, TIM_StepperInitTypeDef* Init); // 初始化步进轴
+ErrorStatus myTIM_StepperMove(TIM_StepperTypeDef* Stp, int32_t Steps, const TIM_StepperRampTypeDef* Ramp); // 按加减速表走精确步数
+ErrorStatus myTIM_StepperMoveBurst(TIM_StepperTypeDef* Stp, int32_t Steps, uint16_t Period); // RCR 硬件脉冲串（TIM1/TIM8，最多 256 步）
+void myTIM_StepperStop(TIM_StepperTypeDef* Stp);                       // 立即停止当前运动
+uint8_t myTIM_StepperIsBusy(const TIM_StepperTypeDef* Stp);            // 是否正在运动
+uint32_t myTIM_StepperGetSteps(const TIM_StepperTypeDef* Stp);         // 本次运动已完成步数
+int64_t myTIM_StepperGetPosition(const TIM_StepperTypeDef* Stp);       // 读取当前位置（步）
+void myTIM_StepperDMAIRQHandler(TIM_StepperTypeDef* Stp);              // DMA 数据流中断处理，在 DMAx_Streamy_IRQHandler 中调用
+void myTIM_StepperIRQHandler(TIM_StepperTypeDef* Stp);                 // 定时器更新中断处理，在 TIMx_IRQHandler 中调用
+
+#endif
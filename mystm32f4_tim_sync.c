@@ -0,0 +1,375 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_sync.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    声明式定时器同步关系图与多定时器同时启动
+  *
+  * @attention
+  *
+  * myTIM_SelectMasterSlaveMode / SelectOutputTrigger / SelectInputTrigger /
+  * SelectSlaveMode / ITRxExternalClockConfig 都只是单个寄存器操作。本文件用一张
+  * “连接表”描述主从关系，统一校验后一次性配置：
+  *
+  * - 每条连接：从定时器、主定时器、关系（触发 / 门控 / 级联时钟 / 复位锁相）、
+  *   可选的主定时器 TRGO 源和从定时器初始相位。
+  * - 校验：内部触发连接存在（myTIM_GetInternalTrigger() 查表），每个从定时器只有
+  *   一个主，同一主定时器的多个从定时器对 TRGO 源的要求一致，没有环，整张图只有一个根。
+  *
+  * 同时启动：
+  * - 指定 Starter（一个不参与计数的空闲定时器）时，Starter 的 TRGO = 复位（UG），
+  *   所有直接挂在 Starter 下的定时器工作在触发模式。myTIM_SyncStart() 写一次 UG，
+  *   这些定时器在同一个硬件触发沿上启动，彼此之间零偏差，与 CPU 指令时序无关。
+  * - 所有参与的定时器都置 MSM，使其自身的触发延迟与送给下级的 TRGO 对齐。
+  * - 不指定 Starter 时由根定时器的 CEN 启动，从定时器相对根有固定的几个时钟的
+  *   同步延迟，可用 Phase 补偿。
+  *
+  * 级联：TIM_SYNC_CLOCK 让从定时器以主定时器的更新事件为时钟，
+  * 例如 TIM2（低 32 位）-> TIM5（高 32 位）组成 64 位计数器，
+  * 用 myTIM_SyncCascadeRead() 读取一致的值。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 先用 myTIM_TimeBaseInit() / myTIM_OCxInit() 等配置好各定时器的时基和输出。
+
+(#) 描述关系并配置（例：用空闲的 TIM4 作 Starter，
+    TIM1、TIM8、TIM3 三路 PWM 同时启动，TIM8 相位滞后 100 个节拍）：
+    static const TIM_SyncLinkTypeDef links[] = {
+        { TIM1, TIM4, TIM_SYNC_TRIGGER, TIM_SYNC_TRGO_DEFAULT, 0   },
+        { TIM8, TIM4, TIM_SYNC_TRIGGER, TIM_SYNC_TRGO_DEFAULT, 100 },
+        { TIM3, TIM4, TIM_SYNC_TRIGGER, TIM_SYNC_TRGO_DEFAULT, 0   },
+    };
+    static const TIM_SyncGraphTypeDef graph = { links, 3, TIM4 };
+    myTIM_SyncConfig(&graph);
+    myTIM_SyncStart(&graph);
+
+(#) 64 位级联计数器：
+    static const TIM_SyncLinkTypeDef cascade[] = {
+        { TIM5, TIM2, TIM_SYNC_CLOCK, TIM_SYNC_TRGO_DEFAULT, 0 },
+    };
+    static const TIM_SyncGraphTypeDef graph64 = { cascade, 1, NULL };
+    myTIM_SyncConfig(&graph64);
+    myTIM_SyncStart(&graph64);
+    uint64_t t = myTIM_SyncCascadeRead(TIM2, TIM5);
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_sync.h"
+
+/* Private function prototypes -----------------------------------------------*/
+static int16_t Sync_FindSlave(const TIM_SyncGraphTypeDef* Graph, TIM_TypeDef* TIMx);
+static uint16_t Sync_MasterTRGO(const TIM_SyncGraphTypeDef* Graph, const TIM_SyncLinkTypeDef* Link);
+static TIM_TypeDef* Sync_Root(const TIM_SyncGraphTypeDef* Graph);
+
+
+/**
+  * @brief  校验同步关系图。
+  * @param  Graph: 同步关系图。
+  * @retval SUCCESS: 可以配置；ERROR: 见下方规则
+  *
+  * @note  以下任一情况返回 ERROR：
+  *  - 连接为空、从/主为 NULL 或相同、关系非法；
+  *  - 两个定时器之间没有内部触发连接；
+  *  - 同一个从定时器出现在多条连接中；
+  *  - 同一个主定时器的多条连接要求不同的 TRGO 源；
+  *  - 存在环，或图中有多个根；
+  *  - 指定了 Starter 但它不是根、是某条连接的从，或它的连接不是触发关系。
+  */
+ErrorStatus myTIM_SyncValidate(const TIM_SyncGraphTypeDef* Graph)
+{
+    const TIM_SyncLinkTypeDef* link = NULL;
+    TIM_TypeDef* root = NULL;
+    TIM_TypeDef* top = NULL;
+    int16_t up = 0;
+    uint8_t steps = 0;
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    if (Graph == NULL || Graph->Links == NULL || Graph->Count == 0)
+    {
+        return ERROR;
+    }
+
+    for (i = 0; i < Graph->Count; i++)
+    {
+        link = &Graph->Links[i];
+
+        if (link->Slave == NULL || link->Master == NULL || link->Slave == link->Master ||
+            link->Mode > TIM_SYNC_RESET || link->Slave == Graph->Starter)
+        {
+            return ERROR;
+        }
+
+        /* ITRx 布线 */
+        if (myTIM_GetInternalTrigger(link->Slave, link->Master) == 0xFFFF)
+        {
+            return ERROR;
+        }
+
+        /* Starter 只能触发启动 */
+        if (link->Master == Graph->Starter && link->Mode != TIM_SYNC_TRIGGER)
+        {
+            return ERROR;
+        }
+
+        /* 每个从定时器只有一个触发输入 */
+        if (Sync_FindSlave(Graph, link->Slave) != i)
+        {
+            return ERROR;
+        }
+
+        /* 同一个主定时器只有一个 TRGO */
+        for (j = 0; j < i; j++)
+        {
+            if (Graph->Links[j].Master == link->Master &&
+                Sync_MasterTRGO(Graph, &Graph->Links[j]) != Sync_MasterTRGO(Graph, link))
+            {
+                return ERROR;
+            }
+        }
+
+        /* 沿主定时器向上找根，步数超过连接数说明有环 */
+        top = link->Master;
+        steps = 0;
+        while ((up = Sync_FindSlave(Graph, top)) >= 0)
+        {
+            top = Graph->Links[up].Master;
+            if (++steps > Graph->Count)
+            {
+                return ERROR;
+            }
+        }
+
+        /* 整张图只有一个根 */
+        if (root == NULL)
+        {
+            root = top;
+        }
+        else if (top != root)
+        {
+            return ERROR;
+        }
+    }
+
+    if (Graph->Starter != NULL && root != Graph->Starter)
+    {
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  校验并配置同步关系图中的所有定时器，配置完成后全部处于停止状态。
+  * @param  Graph: 同步关系图。
+  * @retval SUCCESS: 配置完成；ERROR: 校验失败，未改动任何寄存器。
+  *
+  * @note
+  *  - 只配置主从相关的位（CR2.MMS、SMCR.TS/SMS/MSM）和计数初值，时基、输出由调用者先配置好。
+  *  - 先清 SMS 再改 TS，避免切换触发源时误触发。
+  *  - 级联时钟关系通过 myTIM_ITRxExternalClockConfig() 配置为外部时钟模式 1。
+  */
+ErrorStatus myTIM_SyncConfig(const TIM_SyncGraphTypeDef* Graph)
+{
+    const TIM_SyncLinkTypeDef* link = NULL;
+    uint16_t itr = 0;
+    uint8_t i = 0;
+
+    /* 从模式映射表：TRIGGER / GATED / CLOCK / RESET */
+    const uint16_t slaveMode[] = {
+        TIM_SlaveMode_Trigger,
+        TIM_SlaveMode_Gated,
+        TIM_SlaveMode_External1,
+        TIM_SlaveMode_Reset
+    };
+
+    if (myTIM_SyncValidate(Graph) != SUCCESS)
+    {
+        return ERROR;
+    }
+
+    myTIM_SyncStop(Graph);
+
+    for (i = 0; i < Graph->Count; i++)
+    {
+        link = &Graph->Links[i];
+        itr = myTIM_GetInternalTrigger(link->Slave, link->Master);
+
+        /* 主定时器：TRGO 源；参与计数的主定时器置 MSM */
+        myTIM_SelectOutputTrigger(link->Master, Sync_MasterTRGO(Graph, link));
+        if (link->Master != Graph->Starter)
+        {
+            myTIM_SelectMasterSlaveMode(link->Master, TIM_MasterSlaveMode_Enable);
+        }
+
+        /* 从定时器：先关从模式，再选触发源，最后设从模式 */
+        link->Slave->SMCR &= (uint16_t)~TIM_SMCR_SMS;
+        if (link->Mode == TIM_SYNC_CLOCK)
+        {
+            myTIM_ITRxExternalClockConfig(link->Slave, itr);
+        }
+        else
+        {
+            myTIM_SelectInputTrigger(link->Slave, itr);
+            myTIM_SelectSlaveMode(link->Slave, slaveMode[link->Mode]);
+        }
+        myTIM_SelectMasterSlaveMode(link->Slave, TIM_MasterSlaveMode_Enable);
+
+        myTIM_SetCounter(link->Slave, link->Phase);
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  以一次硬件触发同时启动图中的所有定时器。
+  * @param  Graph: 已配置的同步关系图。
+  * @retval None
+  *
+  * @note
+  *  - 门控、级联时钟、复位锁相关系的从定时器需要 CEN = 1 才会响应，先逐个使能；
+  *    门控、级联时钟在主定时器运行前不会计数；复位锁相先自由计数，在主定时器第一次更新时对齐。
+  *  - 触发关系的从定时器由硬件置 CEN，软件不写。
+  *  - 有 Starter 时写一次 Starter 的 UG；否则使能根定时器。
+  */
+void myTIM_SyncStart(const TIM_SyncGraphTypeDef* Graph)
+{
+    uint8_t i = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    for (i = 0; i < Graph->Count; i++)
+    {
+        if (Graph->Links[i].Mode != TIM_SYNC_TRIGGER)
+        {
+            myTIM_Cmd(Graph->Links[i].Slave, ENABLE);
+        }
+    }
+
+    Graph->Starter != NULL ? myTIM_GenerateEvent(Graph->Starter, TIM_EventSource_Update)
+        : myTIM_Cmd(Sync_Root(Graph), ENABLE);
+
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  停止图中所有定时器。
+  * @param  Graph: 同步关系图。
+  * @retval None
+  * @note   逐个清 CEN，停止时刻有几个指令周期的先后；再次启动前可重新设置相位。
+  */
+void myTIM_SyncStop(const TIM_SyncGraphTypeDef* Graph)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < Graph->Count; i++)
+    {
+        myTIM_Cmd(Graph->Links[i].Master, DISABLE);
+        myTIM_Cmd(Graph->Links[i].Slave, DISABLE);
+    }
+}
+
+/**
+  * @brief  读取级联计数器的一致值。
+  * @param  Low: 低位定时器（级联关系中的主定时器），ARR 须为满量程。
+  * @param  High: 高位定时器（以 Low 的更新事件为时钟）。
+  * @retval (High << Low 位宽) | Low；TIM2+TIM5 为 64 位，32 位 + 16 位为 48 位
+  *
+  * @note
+  *  - 高-低-高读取，两次高位不同则重读。
+  *  - 进位经 TRGO -> ITR 同步到高位需要几个定时器时钟：低位刚回 0 时高位可能尚未加 1。
+  *    低位小于保护值时等它越过保护值再读，保护值按预分频折算为约 4 个定时器时钟，
+  *    最多等待 max(4, PSC + 1) 个定时器时钟。
+  */
+uint64_t myTIM_SyncCascadeRead(TIM_TypeDef* Low, TIM_TypeDef* High)
+{
+    uint8_t width = (Low == TIM2 || Low == TIM5) ? 32 : 16;
+    uint32_t psc = Low->PSC;
+    uint32_t guard = (4 + psc) / (psc + 1);
+    uint8_t running = (Low->CR1 & TIM_CR1_CEN) ? 1 : 0;
+    uint32_t hi1 = 0;
+    uint32_t hi2 = 0;
+    uint32_t lo = 0;
+
+    do
+    {
+        hi1 = High->CNT;
+        lo = Low->CNT;
+        hi2 = High->CNT;
+    } while (hi1 != hi2 || (running && lo < guard));
+
+    return ((uint64_t)hi2 << width) | lo;
+}
+
+/**
+  * @brief  查找以 TIMx 为从定时器的连接。
+  * @retval 连接下标；没有返回 -1
+  */
+static int16_t Sync_FindSlave(const TIM_SyncGraphTypeDef* Graph, TIM_TypeDef* TIMx)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < Graph->Count; i++)
+    {
+        if (Graph->Links[i].Slave == TIMx)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+  * @brief  连接对主定时器 TRGO 源的要求。
+  * @note   Starter 固定为复位（UG）；否则优先用连接中指定的值，
+  *         默认：触发 -> 使能，门控 -> OC1REF，级联时钟/复位锁相 -> 更新。
+  */
+static uint16_t Sync_MasterTRGO(const TIM_SyncGraphTypeDef* Graph, const TIM_SyncLinkTypeDef* Link)
+{
+    const uint16_t defaultTRGO[] = {
+        TIM_TRGOSource_Enable,
+        TIM_TRGOSource_OC1Ref,
+        TIM_TRGOSource_Update,
+        TIM_TRGOSource_Update
+    };
+
+    return (Link->Master == Graph->Starter) ? TIM_TRGOSource_Reset :
+           (Link->MasterTRGO != TIM_SYNC_TRGO_DEFAULT) ? Link->MasterTRGO : defaultTRGO[Link->Mode];
+}
+
+/**
+  * @brief  获取图的根定时器（已通过校验的图只有一个根）。
+  */
+static TIM_TypeDef* Sync_Root(const TIM_SyncGraphTypeDef* Graph)
+{
+    TIM_TypeDef* top = Graph->Links[0].Master;
+    int16_t up = 0;
+
+    while ((up = Sync_FindSlave(Graph, top)) >= 0)
+    {
+        top = Graph->Links[up].Master;
+    }
+
+    return top;
+}
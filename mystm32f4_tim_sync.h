@@ -0,0 +1,39 @@
+﻿#ifndef mystm32f4_tim_sync_h
+#define mystm32f4_tim_sync_h
+
+#include "mystm32f4_tim.h"
+
+/* 从定时器与主定时器的关系 */
+#define TIM_SYNC_TRIGGER            0   /* 触发启动：主定时器启动时从定时器同时启动 */
+#define TIM_SYNC_GATED              1   /* 门控：主定时器 TRGO 为高时从定时器计数 */
+#define TIM_SYNC_CLOCK              2   /* 级联时钟：主定时器每次更新从定时器计数一次 */
+#define TIM_SYNC_RESET              3   /* 复位锁相：主定时器每次更新从定时器清零 */
+
+#define TIM_SYNC_TRGO_DEFAULT       0xFFFF  /* 主定时器 TRGO 按关系自动选择 */
+
+/* 一条主从连接 */
+typedef struct
+{
+    TIM_TypeDef* Slave;          /* 从定时器 */
+    TIM_TypeDef* Master;         /* 主定时器，须有到 Slave 的内部触发连接 */
+    uint8_t  Mode;               /* TIM_SYNC_x */
+    uint16_t MasterTRGO;         /* 主定时器 TRGO 源 TIM_TRGOSource_x，或 TIM_SYNC_TRGO_DEFAULT */
+    uint32_t Phase;              /* 从定时器启动前的计数初值，用于设定相位差 */
+} TIM_SyncLinkTypeDef;
+
+/* 同步关系图 */
+typedef struct
+{
+    const TIM_SyncLinkTypeDef* Links;   /* 连接表 */
+    uint8_t Count;                      /* 连接数 */
+    TIM_TypeDef* Starter;               /* 启动定时器：TRGO = UG，myTIM_SyncStart() 时产生一次 UG；
+                                           NULL 表示以唯一的根定时器 CEN 启动 */
+} TIM_SyncGraphTypeDef;
+
+ErrorStatus myTIM_SyncValidate(const TIM_SyncGraphTypeDef* Graph);    // 校验同步关系图
+ErrorStatus myTIM_SyncConfig(const TIM_SyncGraphTypeDef* Graph);      // 校验并配置所有定时器（不启动）
+void myTIM_SyncStart(const TIM_SyncGraphTypeDef* Graph);              // 以一次硬件触发同时启动
+void myTIM_SyncStop(const TIM_SyncGraphTypeDef* Graph);               // 停止图中所有定时器
+uint64_t myTIM_SyncCascadeRead(TIM_TypeDef* Low, TIM_TypeDef* High);  // 读取级联计数器（48/64 位）
+
+#endif
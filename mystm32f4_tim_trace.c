@@ -0,0 +1,309 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_trace.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    基于 32 位定时器的热点路径性能探针
+  *
+  * @attention
+  *
+  * 本文件提供常驻生产版本的区域进出探针：
+  *
+  * - TIM_TRACE_ENTER(id) / TIM_TRACE_EXIT(id) 把 32 位定时器的 CNT（即 myTIM_GetCounter()
+  *   读取的寄存器）和区域 ID 写入当前上下文的环形缓冲区，不关中断、不调用函数。
+  * - 上下文按抢占优先级划分：线程模式一个缓冲区，用到的每个抢占优先级各一个。
+  *   同一抢占优先级的中断不会互相抢占，所以每个缓冲区任一时刻只有一个写者，
+  *   不需要锁也不需要 LDREX/STREX。异常号 -> 缓冲区的映射表在初始化时由 NVIC 优先级生成。
+  * - 记录里带有异常号，主机端解码器据此把中断嵌套链拼成完整调用栈。
+  * - 缓冲区写满后覆盖最旧的记录，始终保留最近的 TIM_TRACE_DEPTH 条。
+  *
+  * 转储格式（小端）：
+  *   文件头 5 字：TIM_TRACE_MAGIC、时间戳频率、转储时的 CNT、上下文个数、缓冲区深度
+  *   每个上下文：2 字 Level、记录条数，随后按时间先后排列的记录（Time、Tag）
+  * 主机端 tools/tim_trace_decode.c 把转储还原为火焰图折叠栈和各区域延迟直方图。
+  *
+  * 限制：
+  * - 线程模式只有一个缓冲区。用 RTOS 时不同任务可能在探针中途切换，
+  *   应只在中断和单一任务中使用探针，或为各任务关闭探针。
+  * - NMI 和 HardFault 中的探针被丢弃。
+  * - 只为已使能的中断分配缓冲区（外设中断看 NVIC->ISER，MemManage/BusFault/UsageFault
+  *   看 SHCSR，SysTick 看 TICKINT，DebugMon 看 MON_EN）。未配置的中断默认优先级为 0，
+  *   若也参与映射会白白占掉一个缓冲区。映射之后才使能的中断，其探针被丢弃，
+  *   使能之后要再调用一次 myTIM_TraceRefresh()。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 使能 TIM5 时钟，配置好所有中断优先级并使能中断后初始化：
+    myTIM_TraceInit(0);                 // 0 = 定时器时钟全速（84MHz 时 11.9ns 分辨率）
+
+(#) 在需要测量的区域前后放置探针，ID 为 16 位整数：
+    #define TR_ADC_ISR   1
+    #define TR_FOC       2
+    void ADC_IRQHandler(void)
+    {
+        TIM_TRACE_ENTER(TR_ADC_ISR);
+        ...
+        TIM_TRACE_ENTER(TR_FOC);
+        Foc_Step();
+        TIM_TRACE_EXIT(TR_FOC);
+        TIM_TRACE_EXIT(TR_ADC_ISR);
+    }
+
+(#) 需要分析时把缓冲区转储到串口或文件：
+    myTIM_TraceDump(Uart_Write);
+
+(#) 主机端：
+    gcc -O2 -o tim_trace_decode tools/tim_trace_decode.c
+    ./tim_trace_decode dump.bin -n names.txt -f out.folded
+    flamegraph.pl out.folded > out.svg
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_trace.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TRACE_DISCARD         0
+#define TRACE_THREAD          1
+
+#if (TIM_TRACE_DEPTH & (TIM_TRACE_DEPTH - 1)) != 0
+#error "TIM_TRACE_DEPTH must be a power of 2"
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+TIM_TraceBufferTypeDef myTIM_TraceBuf[TIM_TRACE_CONTEXTS + 1];
+uint8_t myTIM_TraceMap[TIM_TRACE_EXC_MAX];
+
+static TIM_TraceRecordTypeDef s_rec[TIM_TRACE_CONTEXTS][TIM_TRACE_DEPTH];
+static TIM_TraceRecordTypeDef s_discard;
+static uint32_t s_freq = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static void Trace_Write(void (*Write)(const void* Data, uint32_t Len), uint32_t Head, uint32_t Count,
+    const TIM_TraceRecordTypeDef* Rec);
+static uint8_t Trace_ExcEnabled(uint32_t Exc);
+
+
+/**
+  * @brief  启动时间戳定时器并按 NVIC 优先级分配上下文缓冲区。
+  * @param  Freq: 时间戳频率（Hz），0 表示使用定时器时钟（不分频）。
+  * @retval SUCCESS: 初始化完成；
+  *         ERROR: TIM_TRACE_TIM 不是 32 位定时器、频率无法实现，
+  *         或用到的抢占优先级多于 TIM_TRACE_CONTEXTS - 1（多出的优先级的探针被丢弃）。
+  *
+  * @note
+  *  - 必须在所有中断优先级配置完成、中断使能之后调用，之后修改优先级或使能新的中断
+  *    要调用 myTIM_TraceRefresh()。
+  *  - 初始化之前探针可以安全执行，记录被丢弃。
+  *  - 定时器时钟需提前使能；定时器被本模块独占，只读 CNT，不产生中断。
+  *  - 小白理解：给每一段代码进出各打一个时间戳，事后在电脑上算出每段花了多久。
+  */
+ErrorStatus myTIM_TraceInit(uint32_t Freq)
+{
+    TIM_TimeBaseInitTypeDef timeBase;
+    TIM_TypeDef* TIMx = TIM_TRACE_TIM;
+    uint32_t clk = myTIM_GetClockFreq(TIMx);
+    uint32_t psc = (Freq == 0) ? 1 : (clk + Freq / 2) / Freq;
+
+    /* 参数检查 */
+    assert_param(TIMx == TIM2 || TIMx == TIM5);
+
+    if ((TIMx != TIM2 && TIMx != TIM5) || psc == 0 || psc > 0x10000)
+    {
+        return ERROR;
+    }
+
+    myTIM_Cmd(TIMx, DISABLE);
+    myTIM_TimeBaseStructInit(&timeBase);
+    timeBase.TIM_Prescaler = (uint16_t)(psc - 1);
+    timeBase.TIM_Period = 0xFFFFFFFF;
+    myTIM_TimeBaseInit(TIMx, &timeBase);
+    myTIM_Cmd(TIMx, ENABLE);
+    s_freq = clk / psc;
+
+    return myTIM_TraceRefresh();
+}
+
+/**
+  * @brief  按当前 NVIC 优先级重新生成异常号 -> 缓冲区映射，并清空全部缓冲区。
+  * @param  None
+  * @retval SUCCESS: 完成；ERROR: 抢占优先级个数超过可用缓冲区。
+  * @note   只有抢占优先级决定能否互相打断，子优先级不同的中断共用一个缓冲区。
+  *         只映射当前已使能的异常，未使能的映射到丢弃缓冲区，不占用抢占优先级。
+  *         内部关中断遍历全部异常号，约几微秒。
+  */
+ErrorStatus myTIM_TraceRefresh(void)
+{
+    uint8_t slotOfLevel[1 << __NVIC_PRIO_BITS];
+    uint32_t group = NVIC_GetPriorityGrouping();
+    uint32_t pre = 0;
+    uint32_t sub = 0;
+    uint32_t exc = 0;
+    uint8_t next = TRACE_THREAD + 1;
+    ErrorStatus status = SUCCESS;
+    uint32_t primask = __get_PRIMASK();
+
+    for (exc = 0; exc < sizeof(slotOfLevel); exc++)
+    {
+        slotOfLevel[exc] = TRACE_DISCARD;
+    }
+
+    __disable_irq();
+
+    myTIM_TraceBuf[TRACE_DISCARD].Head = 0;
+    myTIM_TraceBuf[TRACE_DISCARD].Mask = 0;
+    myTIM_TraceBuf[TRACE_DISCARD].Rec = &s_discard;
+    myTIM_TraceBuf[TRACE_DISCARD].Level = 0xFFFFFFFF;
+    for (exc = TRACE_THREAD; exc <= TIM_TRACE_CONTEXTS; exc++)
+    {
+        myTIM_TraceBuf[exc].Head = 0;
+        myTIM_TraceBuf[exc].Mask = TIM_TRACE_DEPTH - 1;
+        myTIM_TraceBuf[exc].Rec = s_rec[exc - TRACE_THREAD];
+        myTIM_TraceBuf[exc].Level = 0;
+    }
+
+    /* 0：线程模式；1~3：复位、NMI、HardFault；7~10、13：保留 */
+    myTIM_TraceMap[0] = TRACE_THREAD;
+    for (exc = 1; exc < TIM_TRACE_EXC_MAX; exc++)
+    {
+        myTIM_TraceMap[exc] = TRACE_DISCARD;
+        if (exc < 4 || (exc >= 7 && exc <= 10) || exc == 13 || !Trace_ExcEnabled(exc))
+        {
+            continue;
+        }
+
+        NVIC_DecodePriority(NVIC_GetPriority((IRQn_Type)((int32_t)exc - 16)), group, &pre, &sub);
+        if (slotOfLevel[pre] == TRACE_DISCARD && next <= TIM_TRACE_CONTEXTS)
+        {
+            myTIM_TraceBuf[next].Level = pre + 1;
+            slotOfLevel[pre] = next++;
+        }
+
+        myTIM_TraceMap[exc] = slotOfLevel[pre];
+        status = (slotOfLevel[pre] == TRACE_DISCARD) ? ERROR : status;
+    }
+
+    __set_PRIMASK(primask);
+
+    return status;
+}
+
+/**
+  * @brief  异常当前是否可能执行（已使能）。
+  * @param  Exc: 异常号 4~6、11、12、14、15 或外设中断（>= 16）。
+  * @retval 1: 已使能；0: 未使能
+  * @note   SVCall、PendSV 由软件触发，没有使能位，总是返回 1。
+  */
+static uint8_t Trace_ExcEnabled(uint32_t Exc)
+{
+    uint32_t irq = Exc - 16;
+
+    switch (Exc)
+    {
+    case 4:  return (SCB->SHCSR & SCB_SHCSR_MEMFAULTENA_Msk) ? 1 : 0;
+    case 5:  return (SCB->SHCSR & SCB_SHCSR_BUSFAULTENA_Msk) ? 1 : 0;
+    case 6:  return (SCB->SHCSR & SCB_SHCSR_USGFAULTENA_Msk) ? 1 : 0;
+    case 12: return (CoreDebug->DEMCR & CoreDebug_DEMCR_MON_EN_Msk) ? 1 : 0;
+    case 15: return (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) ? 1 : 0;
+    default: break;
+    }
+
+    return (Exc < 16 || (NVIC->ISER[irq >> 5] & (1UL << (irq & 0x1F)))) ? 1 : 0;
+}
+
+/**
+  * @brief  清空全部缓冲区。
+  * @param  None
+  * @retval None
+  * @note   用于只观察某一段时间（例如一次按键触发之后）。
+  */
+void myTIM_TraceReset(void)
+{
+    uint8_t i = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    for (i = 0; i <= TIM_TRACE_CONTEXTS; i++)
+    {
+        myTIM_TraceBuf[i].Head = 0;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  按转储格式输出全部上下文缓冲区。
+  * @param  Write: 输出函数，例如串口阻塞发送或写文件。
+  * @retval None
+  *
+  * @note
+  *  - 先记下各缓冲区的 Head，再读 CNT 作为转储时刻，保证转储的记录都早于该时刻。
+  *  - 转储期间探针继续写入，输出较慢时最旧的几条记录可能已被覆盖，
+  *    解码器会丢弃开头时间不单调的记录。需要完整快照时先关闭产生探针的中断。
+  */
+void myTIM_TraceDump(void (*Write)(const void* Data, uint32_t Len))
+{
+    uint32_t head[TIM_TRACE_CONTEXTS];
+    uint32_t word[5];
+    uint32_t count = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < TIM_TRACE_CONTEXTS; i++)
+    {
+        head[i] = myTIM_TraceBuf[TRACE_THREAD + i].Head;
+    }
+
+    word[0] = TIM_TRACE_MAGIC;
+    word[1] = s_freq;
+    word[2] = TIM_TRACE_TIM->CNT;
+    word[3] = TIM_TRACE_CONTEXTS;
+    word[4] = TIM_TRACE_DEPTH;
+    Write(word, sizeof(word));
+
+    for (i = 0; i < TIM_TRACE_CONTEXTS; i++)
+    {
+        count = (head[i] < TIM_TRACE_DEPTH) ? head[i] : TIM_TRACE_DEPTH;
+        word[0] = myTIM_TraceBuf[TRACE_THREAD + i].Level;
+        word[1] = count;
+        Write(word, 2 * sizeof(uint32_t));
+        Trace_Write(Write, head[i], count, myTIM_TraceBuf[TRACE_THREAD + i].Rec);
+    }
+}
+
+
+/**
+  * @brief  按时间先后输出环形缓冲区中最近 Count 条记录（最多分两段）。
+  */
+static void Trace_Write(void (*Write)(const void* Data, uint32_t Len), uint32_t Head, uint32_t Count,
+    const TIM_TraceRecordTypeDef* Rec)
+{
+    uint32_t start = (Head - Count) & (TIM_TRACE_DEPTH - 1);
+    uint32_t first = TIM_TRACE_DEPTH - start;
+
+    first = (first < Count) ? first : Count;
+    if (first != 0)
+    {
+        Write(&Rec[start], first * sizeof(TIM_TraceRecordTypeDef));
+    }
+    if (Count > first)
+    {
+        Write(&Rec[0], (Count - first) * sizeof(TIM_TraceRecordTypeDef));
+    }
+}
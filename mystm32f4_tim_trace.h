@@ -0,0 +1,87 @@
+﻿#ifndef mystm32f4_tim_trace_h
+#define mystm32f4_tim_trace_h
+
+#include "mystm32f4_tim.h"
+
+/* 1：编译探针；0：TIM_TRACE_ENTER/EXIT 展开为空 */
+#ifndef TIM_TRACE_ENABLE
+#define TIM_TRACE_ENABLE            1
+#endif
+
+/* 时间戳定时器，必须是 32 位定时器（TIM2 / TIM5） */
+#ifndef TIM_TRACE_TIM
+#define TIM_TRACE_TIM               TIM5
+#endif
+
+/* 上下文缓冲区个数：线程模式 1 个 + 用到的每个抢占优先级 1 个 */
+#ifndef TIM_TRACE_CONTEXTS
+#define TIM_TRACE_CONTEXTS          5
+#endif
+
+/* 每个缓冲区的记录条数，必须是 2 的幂 */
+#ifndef TIM_TRACE_DEPTH
+#define TIM_TRACE_DEPTH             256
+#endif
+
+/* 异常号上限（16 个系统异常 + 外设中断个数） */
+#ifndef TIM_TRACE_EXC_MAX
+#define TIM_TRACE_EXC_MAX           (16 + 91)
+#endif
+
+#define TIM_TRACE_MAGIC             0x31435254U   /* "TRC1"，转储文件头 */
+#define TIM_TRACE_EXIT_FLAG         0x80000000U   /* Tag bit31：离开区域 */
+
+/* 一条记录：Tag = EXIT 标志 | 异常号 << 16 | 区域 ID */
+typedef struct
+{
+    uint32_t Time;               /* 时间戳定时器 CNT */
+    uint32_t Tag;
+} TIM_TraceRecordTypeDef;
+
+/* 上下文缓冲区：只被同一抢占优先级的代码写入，无需加锁 */
+typedef struct
+{
+    volatile uint32_t Head;      /* 已写入记录总数，写位置 = Head & Mask */
+    uint32_t Mask;               /* 深度 - 1；丢弃缓冲区为 0 */
+    TIM_TraceRecordTypeDef* Rec;
+    uint32_t Level;              /* 0 = 线程模式，n = 抢占优先级 n - 1 */
+} TIM_TraceBufferTypeDef;
+
+/* 缓冲区 0 为丢弃缓冲区（深度 1），1 ~ TIM_TRACE_CONTEXTS 为各上下文缓冲区 */
+extern TIM_TraceBufferTypeDef myTIM_TraceBuf[TIM_TRACE_CONTEXTS + 1];
+/* 异常号 -> 缓冲区序号，由 myTIM_TraceInit() 按 NVIC 优先级生成；未初始化时全部为 0（丢弃） */
+extern uint8_t myTIM_TraceMap[TIM_TRACE_EXC_MAX];
+
+/**
+  * @brief  写入一条探针记录（由 TIM_TRACE_ENTER/EXIT 调用）。
+  * @param  Tag: EXIT 标志 | 区域 ID。
+  * @note   读 IPSR、查表、读 CNT、写两个字、更新 Head，约 10 个周期，不关中断。
+  *         同一缓冲区只会被同一抢占优先级写入，而同级中断不会互相抢占，
+  *         所以读-改-写 Head 不会被同一缓冲区的另一个写者打断。
+  */
+static __INLINE void myTIM_TraceRecord(uint32_t Tag)
+{
+    uint32_t ipsr = __get_IPSR();
+    TIM_TraceBufferTypeDef* buf = &myTIM_TraceBuf[(ipsr < TIM_TRACE_EXC_MAX) ? myTIM_TraceMap[ipsr] : 0];
+    uint32_t head = buf->Head;
+    TIM_TraceRecordTypeDef* rec = &buf->Rec[head & buf->Mask];
+
+    rec->Time = TIM_TRACE_TIM->CNT;
+    rec->Tag = Tag | (ipsr << 16);
+    buf->Head = head + 1;
+}
+
+#if TIM_TRACE_ENABLE
+#define TIM_TRACE_ENTER(id)         myTIM_TraceRecord((uint16_t)(id))
+#define TIM_TRACE_EXIT(id)          myTIM_TraceRecord(TIM_TRACE_EXIT_FLAG | (uint16_t)(id))
+#else
+#define TIM_TRACE_ENTER(id)         ((void)0)
+#define TIM_TRACE_EXIT(id)          ((void)0)
+#endif
+
+ErrorStatus myTIM_TraceInit(uint32_t Freq);                             // 启动时间戳定时器并按 NVIC 优先级分配缓冲区
+ErrorStatus myTIM_TraceRefresh(void);                                   // 修改中断优先级或使能新中断后重新分配缓冲区
+void myTIM_TraceReset(void);                                            // 清空全部缓冲区
+void myTIM_TraceDump(void (*Write)(const void* Data, uint32_t Len));    // 按转储格式输出全部缓冲区
+
+#endif
@@ -0,0 +1,582 @@
+﻿/**
+  ******************************************************************************
+  * @file     mystm32f4_tim_wheel.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    单比较通道上的无节拍（tickless）分层定时轮
+  *
+  * @attention
+  *
+  * 本文件把任意数量的单次/周期软件定时器复用到 64 位时间戳定时器
+  * （mystm32f4_tim_clock）的一个空闲比较通道上。没有固定频率的节拍中断，
+  * CCRx 只被编程到“下一个需要处理的时刻”。
+  *
+  * 数据结构：
+  * - 时间以“粒度”为单位：粒度 = 时间戳节拍 >> GranuleShift。
+  * - 共 TIM_WHEEL_LEVELS 层，每层 64 个槽，每个槽是一个侵入式链表，
+  *   每层再配一个 64 位占用位图。
+  * - 定时器所在层由 (Expires XOR clk) 的最高位决定：
+  *     层 k 中的定时器与 clk 在第 k 层以上的各位完全相同，第 k 层的 6 位不同。
+  *   因此第 0 层的全部到期时间 < 第 1 层 < 第 2 层 ……，各层之间天然有序。
+  * - 插入：一次异或 + 一次 CLZ 求层号，链表头插，置位图，O(1)。
+  * - 取消：通过 PPrev 指针直接摘链，必要时清位图，O(1)。
+  * - 下一个事件：找到最低的非空层，用 RBIT + CLZ 取位图最低位，O(层数)。
+  *     第 0 层得到的是精确到期时间；更高层得到的是该槽的起始时间，
+  *     到点后把整槽重新插入（级联）到更低的层。
+  *
+  * 中断中处理到当前时间后，只在目标时刻变化时才重新写 CCRx。
+  * CCR 为 32 位，超过 2^31 节拍的目标先编程一个中途唤醒点。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 先初始化时间戳：myTIM_ClockInit(TIM5, 1000000, 4)
+
+(#) 在同一定时器的另一个通道上初始化定时轮：
+    myTIM_WheelInit(1, 0);            // 通道 1，粒度 = 1 个节拍（1us）
+
+(#) 中断服务函数中依次调用：
+    void TIM5_IRQHandler(void)
+    {
+        myTIM_ClockIRQHandler();
+        myTIM_WheelIRQHandler();
+    }
+
+(#) 定义并启动定时器：
+    static TIM_WheelTimerTypeDef led;
+    myTIM_WheelTimerInit(&led, LedToggle, NULL);
+    myTIM_WheelStart(&led, 500000, 500000);    // 500ms 后首次到期，之后每 500ms 一次
+
+(#) 取消：myTIM_WheelStop(&led)
+@endverbatim
+*/
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mystm32f4_tim_wheel.h"
+
+/* Private define ------------------------------------------------------------*/
+#define WHEEL_SLOT_MASK       ((uint64_t)(TIM_WHEEL_SLOTS - 1))
+#define WHEEL_NONE            ((uint64_t)0xFFFFFFFFFFFFFFFF)   /* 没有待处理事件 */
+#define WHEEL_MAX_AHEAD       ((uint64_t)0x7FFFFFFF)           /* CCR 单次可表达的最远距离（节拍） */
+
+/* Private variables ---------------------------------------------------------*/
+static TIM_WheelTimerTypeDef* s_slots[TIM_WHEEL_LEVELS][TIM_WHEEL_SLOTS];
+static uint64_t s_bitmap[TIM_WHEEL_LEVELS];   /* 每层的槽占用位图 */
+static TIM_WheelTimerTypeDef* s_far = NULL;   /* 超出最高层范围的定时器 */
+static uint64_t s_clk = 0;                    /* 已处理到的时间（粒度） */
+
+static TIM_TypeDef* s_tim = NULL;             /* 时间戳定时器 */
+static uint8_t s_channel = 0;                 /* 定时轮使用的比较通道 1~4 */
+static uint8_t s_shift = 0;                   /* 粒度移位 */
+static uint8_t s_inHandler = 0;               /* 中断处理中，推迟重新编程 */
+static uint8_t s_armed = 0;                   /* CCR 已编程且有效 */
+static uint32_t s_compare = 0;                /* 当前写入 CCR 的值 */
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t Wheel_Msb64(uint64_t Value);
+static uint8_t Wheel_Ctz64(uint64_t Value);
+static void Wheel_Link(TIM_WheelTimerTypeDef* Timer);
+static void Wheel_Unlink(TIM_WheelTimerTypeDef* Timer);
+static uint64_t Wheel_NextEvent(uint8_t* Level, uint8_t* Slot);
+static void Wheel_Advance(uint64_t Now);
+static void Wheel_Program(void);
+
+
+/**
+  * @brief  初始化定时轮。
+  * @param  Channel: 时间戳定时器上空闲的比较通道，取值 1~4，
+  *         不能与 myTIM_ClockInit() 使用的半周期通道相同。
+  * @param  GranuleShift: 粒度移位，粒度 = 2^GranuleShift 个时间戳节拍，取值 0~16。
+  *         粒度越大，同样层数覆盖的时间越长，但到期时间向上取整到粒度。
+  * @retval SUCCESS: 初始化完成；ERROR: 时间戳未初始化或参数非法。
+  *
+  * @note
+  *  - 必须先调用 myTIM_ClockInit()。
+  *  - 小白理解：时间戳负责“现在几点”，定时轮负责“下一次什么时候叫醒我”，
+  *    两者共用一个 32 位定时器，只是多占一个比较通道。
+  */
+ErrorStatus myTIM_WheelInit(uint8_t Channel, uint8_t GranuleShift)
+{
+    TIM_TypeDef* tim = myTIM_ClockGetTIM();
+    uint16_t ccie = 0;
+    uint8_t level = 0;
+    uint8_t slot = 0;
+
+    /* 参数检查 */
+    assert_param(Channel >= 1 && Channel <= 4);
+    assert_param(GranuleShift <= 16);
+    assert_param(TIM_WHEEL_LEVELS * TIM_WHEEL_SLOT_BITS < 64);
+
+    if (tim == NULL || Channel < 1 || Channel > 4 || GranuleShift > 16)
+    {
+        return ERROR;
+    }
+
+    ccie = (uint16_t)(TIM_DIER_CC1IE << (Channel - 1));
+    tim->DIER &= (uint16_t)~ccie;
+
+    for (level = 0; level < TIM_WHEEL_LEVELS; level++)
+    {
+        s_bitmap[level] = 0;
+        for (slot = 0; slot < TIM_WHEEL_SLOTS; slot++)
+        {
+            s_slots[level][slot] = NULL;
+        }
+    }
+    s_far = NULL;
+
+    s_tim = tim;
+    s_channel = Channel;
+    s_shift = GranuleShift;
+    s_armed = 0;
+    s_inHandler = 0;
+    s_clk = myTIM_ClockGetTicks() >> GranuleShift;
+
+    /* 冻结比较模式：只产生 CCxIF，不影响引脚 */
+    myTIM_SelectOCxM(tim, (uint16_t)((Channel - 1) << 2), TIM_OCMode_Timing);
+    tim->SR = (uint16_t)~ccie;   /* CCxIF 与 CCxIE 位置相同 */
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  初始化定时器节点。
+  * @param  Timer: 定时器节点。
+  * @param  Callback: 到期回调，在 TIMx 中断上下文执行，应尽量短。
+  * @param  Arg: 回调参数。
+  * @retval None
+  */
+void myTIM_WheelTimerInit(TIM_WheelTimerTypeDef* Timer, TIM_WheelCallback Callback, void* Arg)
+{
+    Timer->Next = NULL;
+    Timer->PPrev = NULL;
+    Timer->Expires = 0;
+    Timer->Period = 0;
+    Timer->Callback = Callback;
+    Timer->Arg = Arg;
+    Timer->Level = 0;
+    Timer->Slot = 0;
+}
+
+/**
+  * @brief  以相对时间启动（或重启）定时器。
+  * @param  Timer: 已初始化的定时器节点，若已在轮中则先取消再重新插入。
+  * @param  Timeout: 距离现在的超时时间，单位：时间戳节拍。
+  * @param  Period: 周期，单位：时间戳节拍；0 表示单次。
+  * @retval None
+  * @note   到期时间向上取整到粒度，保证不会提前到期。
+  */
+void myTIM_WheelStart(TIM_WheelTimerTypeDef* Timer, uint64_t Timeout, uint64_t Period)
+{
+    myTIM_WheelStartAt(Timer, myTIM_ClockGetTicks() + Timeout, Period);
+}
+
+/**
+  * @brief  以绝对时间启动（或重启）定时器。
+  * @param  Timer: 已初始化的定时器节点。
+  * @param  Deadline: 到期时刻，单位：时间戳节拍（与 myTIM_ClockGetTicks() 同一时基）。
+  *         已经过去的时刻会在下一次中断中立即到期。
+  * @param  Period: 周期，单位：时间戳节拍；0 表示单次。
+  * @retval None
+  *
+  * @note
+  *  - 可在线程、中断及定时器回调中调用，内部用极短的关中断区保护链表。
+  *  - 只有最近到期时刻发生变化时才会改写 CCRx。
+  *  - Period 换算成粒度后超过 0xFFFFFFFF 时按 0xFFFFFFFF 个粒度处理，不会截断成一个很短的周期。
+  */
+void myTIM_WheelStartAt(TIM_WheelTimerTypeDef* Timer, uint64_t Deadline, uint64_t Period)
+{
+    uint64_t round = ((uint64_t)1 << s_shift) - 1;
+    uint64_t period = (Period + round) >> s_shift;
+    uint64_t now = 0;
+    uint8_t level = 0;
+    uint8_t slot = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    /* 参数检查 */
+    assert_param(Timer->Callback != NULL);
+    assert_param(period <= 0xFFFFFFFF);
+
+    /* 关闭断言时仍要防止截断：超长周期限制到节点能表示的最大值 */
+    period = (period > 0xFFFFFFFF) ? 0xFFFFFFFF : period;
+
+    __disable_irq();
+
+    if (Timer->PPrev != NULL)
+    {
+        Wheel_Unlink(Timer);
+    }
+
+    /* s_clk 只在中断里前进，轮空闲很久后会严重落后：插入空轮前先同步到当前时间 */
+    if (!s_inHandler && Wheel_NextEvent(&level, &slot) == WHEEL_NONE)
+    {
+        now = myTIM_ClockGetTicks() >> s_shift;
+        s_clk = (now > s_clk) ? now : s_clk;
+    }
+
+    Timer->Expires = (Deadline + round) >> s_shift;
+    Timer->Period = (uint32_t)period;
+    Wheel_Link(Timer);
+
+    /* 中断处理中由处理函数统一重新编程 */
+    if (!s_inHandler)
+    {
+        Wheel_Program();
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  取消定时器。
+  * @param  Timer: 定时器节点，未挂入时调用无副作用。
+  * @retval None
+  * @note   O(1)；取消最近到期的定时器后 CCRx 会顺延到新的最近时刻。
+  */
+void myTIM_WheelStop(TIM_WheelTimerTypeDef* Timer)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    if (Timer->PPrev != NULL)
+    {
+        Wheel_Unlink(Timer);
+        if (!s_inHandler)
+        {
+            Wheel_Program();
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  查询定时器是否在定时轮中（等待到期）。
+  * @param  Timer: 定时器节点。
+  * @retval 1: 在轮中；0: 未启动或已到期（单次）
+  */
+uint8_t myTIM_WheelIsActive(const TIM_WheelTimerTypeDef* Timer)
+{
+    return (Timer->PPrev != NULL) ? 1 : 0;
+}
+
+/**
+  * @brief  获取定时轮下一次需要处理的时刻。
+  * @retval 时间戳节拍；没有任何定时器时返回 0xFFFFFFFFFFFFFFFF
+  * @note   返回值可能是级联时刻而非某个定时器的到期时刻，可用于低功耗模块估算可睡眠时间。
+  */
+uint64_t myTIM_WheelNextDeadline(void)
+{
+    uint8_t level = 0;
+    uint8_t slot = 0;
+    uint64_t next = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    next = Wheel_NextEvent(&level, &slot);
+    __set_PRIMASK(primask);
+
+    return (next == WHEEL_NONE) ? WHEEL_NONE : (next << s_shift);
+}
+
+/**
+  * @brief  定时轮中断处理函数。
+  * @retval None
+  *
+  * @note
+  *  - 在时间戳定时器的 TIMx_IRQHandler 中调用，只处理自己通道的比较标志。
+  *  - 处理到当前时间的全部到期定时器和级联，回调执行期间开中断。
+  */
+void myTIM_WheelIRQHandler(void)
+{
+    uint16_t flag = 0;
+    uint32_t primask = 0;
+
+    if (s_tim == NULL)
+    {
+        return;
+    }
+
+    flag = (uint16_t)(TIM_SR_CC1IF << (s_channel - 1));
+    if ((s_tim->SR & flag) == 0 || (s_tim->DIER & flag) == 0)
+    {
+        return;
+    }
+    s_tim->SR = (uint16_t)~flag;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    s_inHandler = 1;
+    Wheel_Advance(myTIM_ClockGetTicks() >> s_shift);
+    s_inHandler = 0;
+
+    /* CCR 已经匹配过，强制按新的最近时刻重新编程 */
+    s_armed = 0;
+    Wheel_Program();
+
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  64 位最高置位位序号（Value 不为 0）。
+  */
+static uint8_t Wheel_Msb64(uint64_t Value)
+{
+    uint32_t hi = (uint32_t)(Value >> 32);
+
+    return hi ? (uint8_t)(63 - __CLZ(hi)) : (uint8_t)(31 - __CLZ((uint32_t)Value));
+}
+
+/**
+  * @brief  64 位最低置位位序号（Value 不为 0），RBIT + CLZ 两条指令。
+  */
+static uint8_t Wheel_Ctz64(uint64_t Value)
+{
+    uint32_t lo = (uint32_t)Value;
+
+    return lo ? (uint8_t)__CLZ(__RBIT(lo)) : (uint8_t)(32 + __CLZ(__RBIT((uint32_t)(Value >> 32))));
+}
+
+/**
+  * @brief  把定时器插入对应层的槽（调用者已关中断）。
+  * @note   已经过期的时间按 s_clk 处理，落在第 0 层当前槽，下一次处理时立即到期。
+  */
+static void Wheel_Link(TIM_WheelTimerTypeDef* Timer)
+{
+    uint64_t expires = (Timer->Expires < s_clk) ? s_clk : Timer->Expires;
+    uint64_t diff = expires ^ s_clk;
+    uint8_t level = diff ? (uint8_t)(Wheel_Msb64(diff) / TIM_WHEEL_SLOT_BITS) : 0;
+    TIM_WheelTimerTypeDef** head = NULL;
+
+    if (level < TIM_WHEEL_LEVELS)
+    {
+        Timer->Slot = (uint8_t)((expires >> (level * TIM_WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK);
+        head = &s_slots[level][Timer->Slot];
+        s_bitmap[level] |= (uint64_t)1 << Timer->Slot;
+    }
+    else
+    {
+        level = TIM_WHEEL_LEVELS;
+        Timer->Slot = 0;
+        head = &s_far;
+    }
+    Timer->Level = level;
+
+    /* 头插 */
+    Timer->Next = *head;
+    if (*head != NULL)
+    {
+        (*head)->PPrev = &Timer->Next;
+    }
+    *head = Timer;
+    Timer->PPrev = head;
+}
+
+/**
+  * @brief  把定时器从所在槽摘下（调用者已关中断），槽空时清位图。
+  */
+static void Wheel_Unlink(TIM_WheelTimerTypeDef* Timer)
+{
+    *Timer->PPrev = Timer->Next;
+    if (Timer->Next != NULL)
+    {
+        Timer->Next->PPrev = Timer->PPrev;
+    }
+
+    if (Timer->Level < TIM_WHEEL_LEVELS && s_slots[Timer->Level][Timer->Slot] == NULL)
+    {
+        s_bitmap[Timer->Level] &= ~((uint64_t)1 << Timer->Slot);
+    }
+
+    Timer->Next = NULL;
+    Timer->PPrev = NULL;
+}
+
+/**
+  * @brief  计算下一个需要处理的时刻（粒度）。
+  * @param  Level: 输出所在层，等于 TIM_WHEEL_LEVELS 表示远期链表。
+  * @param  Slot: 输出所在槽。
+  * @retval 时刻（粒度），没有事件返回 WHEEL_NONE
+  *
+  * @note
+  *  - 层间天然有序，最低的非空层即是最近事件所在层。
+  *  - 第 0 层返回精确到期时刻；更高层返回槽起始时刻（级联点）：
+  *    取 s_clk 在本层以上的高位，本层 6 位替换为槽号，低位清零。
+  */
+static uint64_t Wheel_NextEvent(uint8_t* Level, uint8_t* Slot)
+{
+    uint8_t level = 0;
+    uint8_t shift = 0;
+
+    for (level = 0; level < TIM_WHEEL_LEVELS; level++)
+    {
+        if (s_bitmap[level] != 0)
+        {
+            shift = (uint8_t)(level * TIM_WHEEL_SLOT_BITS);
+            *Level = level;
+            *Slot = Wheel_Ctz64(s_bitmap[level]);
+            return ((s_clk >> (shift + TIM_WHEEL_SLOT_BITS)) << (shift + TIM_WHEEL_SLOT_BITS)) |
+                ((uint64_t)*Slot << shift);
+        }
+    }
+
+    if (s_far != NULL)
+    {
+        shift = TIM_WHEEL_LEVELS * TIM_WHEEL_SLOT_BITS;
+        *Level = TIM_WHEEL_LEVELS;
+        *Slot = 0;
+        return ((s_clk >> shift) + 1) << shift;
+    }
+
+    return WHEEL_NONE;
+}
+
+/**
+  * @brief  把定时轮推进到 Now（调用者已关中断）。
+  * @param  Now: 当前时间（粒度）。
+  *
+  * @note
+  *  - 每次只跳到最近的一个事件点：第 0 层执行到期回调，更高层和远期链表做级联。
+  *  - 级联的定时器一次性摘下整槽再逐个重新插入，不会插回原槽。
+  *  - 周期定时器若因中断被长时间屏蔽错过多个周期，直接跳到 Now 之后的下一个周期，
+  *    不补发，避免回调风暴。
+  */
+static void Wheel_Advance(uint64_t Now)
+{
+    TIM_WheelTimerTypeDef* timer = NULL;
+    TIM_WheelTimerTypeDef* list = NULL;
+    TIM_WheelTimerTypeDef** head = NULL;
+    uint64_t next = 0;
+    uint8_t level = 0;
+    uint8_t slot = 0;
+
+    for (;;)
+    {
+        next = Wheel_NextEvent(&level, &slot);
+        if (next > Now)
+        {
+            break;
+        }
+        s_clk = next;
+
+        if (level == 0)
+        {
+            /* 到期：整槽移到本地链表后逐个弹出，回调中可以自由启动/取消任何定时器。
+               s_clk 先越过本槽，回调里重新启动的已过期定时器落到下一个粒度，不会死循环 */
+            list = s_slots[0][slot];
+            s_slots[0][slot] = NULL;
+            s_bitmap[0] &= ~((uint64_t)1 << slot);
+            list->PPrev = &list;
+            s_clk = next + 1;
+
+            while ((timer = list) != NULL)
+            {
+                Wheel_Unlink(timer);
+                if (timer->Period != 0)
+                {
+                    timer->Expires += timer->Period;
+                    if (timer->Expires <= Now)
+                    {
+                        timer->Expires += ((Now - timer->Expires) / timer->Period + 1) * timer->Period;
+                    }
+                    Wheel_Link(timer);
+                }
+
+                __enable_irq();
+                timer->Callback(timer->Arg);
+                __disable_irq();
+            }
+            continue;
+        }
+
+        /* 级联：整槽摘下后重新插入，此时 s_clk 已到槽起点，定时器会落到更低的层 */
+        head = (level < TIM_WHEEL_LEVELS) ? &s_slots[level][slot] : &s_far;
+        list = *head;
+        *head = NULL;
+        if (level < TIM_WHEEL_LEVELS)
+        {
+            s_bitmap[level] &= ~((uint64_t)1 << slot);
+        }
+
+        while (list != NULL)
+        {
+            timer = list;
+            list = list->Next;
+            Wheel_Link(timer);
+        }
+    }
+
+    if (Now > s_clk)
+    {
+        s_clk = Now;
+    }
+}
+
+/**
+  * @brief  把 CCRx 编程到最近的事件时刻（调用者已关中断）。
+  *
+  * @note
+  *  - 目标与当前 CCR 相同则不写寄存器。
+  *  - 目标超过 2^31 节拍时先编程中途唤醒点，中断里再继续。
+  *  - 目标已经过去（64 位比较，与过去多久无关）时直接用 CCxG 软件产生比较事件。
+  *  - 写完 CCR 后复查一次：若目标在写入前后已经过去，比较匹配不会再发生，
+  *    此时同样用 CCxG 立即进入中断处理。目标此时距 now 不超过 2^31 节拍，32 位差值不会回绕。
+  */
+static void Wheel_Program(void)
+{
+    uint8_t level = 0;
+    uint8_t slot = 0;
+    uint64_t next = Wheel_NextEvent(&level, &slot);
+    uint64_t now = 0;
+    uint64_t target = 0;
+    uint16_t ccie = (uint16_t)(TIM_DIER_CC1IE << (s_channel - 1));
+
+    if (next == WHEEL_NONE)
+    {
+        s_tim->DIER &= (uint16_t)~ccie;
+        s_armed = 0;
+        return;
+    }
+
+    now = myTIM_ClockGetTicks();
+    target = next << s_shift;
+    if (target > now + WHEEL_MAX_AHEAD)
+    {
+        target = now + WHEEL_MAX_AHEAD;
+    }
+
+    if (s_armed && (uint32_t)target == s_compare)
+    {
+        return;
+    }
+
+    s_compare = (uint32_t)target;
+    s_armed = 1;
+    myTIM_SetCompare(s_tim, s_channel, s_compare);
+    s_tim->SR = (uint16_t)~ccie;
+    s_tim->DIER |= ccie;
+
+    if (target <= now || (int32_t)(s_compare - s_tim->CNT) <= 0)
+    {
+        myTIM_GenerateEvent(s_tim, (uint16_t)(TIM_EventSource_CC1 << (s_channel - 1)));
+    }
+}
@@ -0,0 +1,39 @@
+﻿#ifndef mystm32f4_tim_wheel_h
+#define mystm32f4_tim_wheel_h
+
+#include "mystm32f4_tim_clock.h"
+
+/* 定时轮层数，每层 64 个槽；6 层覆盖 2^36 个粒度，超出部分挂在远期链表 */
+#ifndef TIM_WHEEL_LEVELS
+#define TIM_WHEEL_LEVELS        6
+#endif
+
+#define TIM_WHEEL_SLOT_BITS     6
+#define TIM_WHEEL_SLOTS         (1U << TIM_WHEEL_SLOT_BITS)
+
+typedef void (*TIM_WheelCallback)(void* Arg);
+
+/* 软件定时器节点，由调用者分配，挂入定时轮期间不得释放 */
+typedef struct TIM_WheelTimer
+{
+    struct TIM_WheelTimer* Next;     /* 槽内单向链表后继 */
+    struct TIM_WheelTimer** PPrev;   /* 指向前驱的 Next 指针，NULL 表示未挂入 */
+    uint64_t Expires;                /* 到期时间，单位：粒度 */
+    uint32_t Period;                 /* 周期，单位：粒度；0 表示单次 */
+    TIM_WheelCallback Callback;      /* 到期回调，在 TIMx 中断上下文执行 */
+    void* Arg;                       /* 回调参数 */
+    uint8_t Level;                   /* 所在层，等于 TIM_WHEEL_LEVELS 表示远期链表 */
+    uint8_t Slot;                    /* 所在槽 */
+} TIM_WheelTimerTypeDef;
+
+ErrorStatus myTIM_WheelInit(uint8_t Channel, uint8_t GranuleShift);  // 在时间戳定时器的空闲通道上初始化定时轮
+void myTIM_WheelTimerInit(TIM_WheelTimerTypeDef* Timer,              // 初始化定时器节点
+    TIM_WheelCallback Callback, void* Arg);
+void myTIM_WheelStart(TIM_WheelTimerTypeDef* Timer, uint64_t Timeout, uint64_t Period); // 相对时间启动（节拍）
+void myTIM_WheelStartAt(TIM_WheelTimerTypeDef* Timer, uint64_t Deadline, uint64_t Period); // 绝对时间启动（节拍）
+void myTIM_WheelStop(TIM_WheelTimerTypeDef* Timer);                  // 取消定时器，O(1)
+uint8_t myTIM_WheelIsActive(const TIM_WheelTimerTypeDef* Timer);     // 定时器是否在轮中
+uint64_t myTIM_WheelNextDeadline(void);                              // 最近一次需要唤醒的时间（节拍）
+void myTIM_WheelIRQHandler(void);                                    // 定时轮中断处理，在 TIMx_IRQHandler 中调用
+
+#endif
@@ -0,0 +1,216 @@
+/**
+  ******************************************************************************
+  * @file     stm32f4xx.h
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    主机测试用的设备头文件替身
+  *
+  * @attention
+  *
+  * 只提供 mystm32f4_tim.c 用到的类型、外设指针和寄存器位，位定义取自官方 CMSIS 头文件。
+  * TIM1~TIM14 指向 TimShim_Tim[] 中各个模型的寄存器组，驱动按地址识别定时器的
+  * 查表（myTIM_DeInit、myTIM_TimeBaseInit、myTIM_GetClockFreq 等）因此照常工作。
+  * 编译时用 -I tools/shim 让它排在真实头文件之前，不要加入固件工程。
+  *
+  ******************************************************************************
+  */
+
+#ifndef stm32f4xx_h
+#define stm32f4xx_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../tim_model.h"
+
+#define __IO volatile
+#define __I  volatile const
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+typedef enum { ERROR = 0, SUCCESS = !ERROR } ErrorStatus;
+
+#define IS_FUNCTIONAL_STATE(STATE) (((STATE) == DISABLE) || ((STATE) == ENABLE))
+
+/* 主机测试不检查参数，与 USE_FULL_ASSERT 未定义时一致 */
+#define assert_param(expr) ((void)0)
+
+/* 寄存器组与模型共用一个布局 */
+typedef TimModelRegs TIM_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR;
+    __IO uint32_t NDTR;
+    __IO uint32_t PAR;
+    __IO uint32_t M0AR;
+    __IO uint32_t M1AR;
+    __IO uint32_t FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t LISR;
+    __IO uint32_t HISR;
+    __IO uint32_t LIFCR;
+    __IO uint32_t HIFCR;
+} DMA_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR;
+    __IO uint32_t PLLCFGR;
+    __IO uint32_t CFGR;
+    __IO uint32_t CIR;
+    __IO uint32_t AHB1RSTR;
+    __IO uint32_t AHB2RSTR;
+    __IO uint32_t AHB3RSTR;
+    uint32_t      RESERVED0;
+    __IO uint32_t APB1RSTR;
+    __IO uint32_t APB2RSTR;
+    uint32_t      RESERVED1[2];
+    __IO uint32_t AHB1ENR;
+    __IO uint32_t AHB2ENR;
+    __IO uint32_t AHB3ENR;
+    uint32_t      RESERVED2;
+    __IO uint32_t APB1ENR;
+    __IO uint32_t APB2ENR;
+    uint32_t      RESERVED3[2];
+    __IO uint32_t AHB1LPENR;
+    __IO uint32_t AHB2LPENR;
+    __IO uint32_t AHB3LPENR;
+    uint32_t      RESERVED4;
+    __IO uint32_t APB1LPENR;
+    __IO uint32_t APB2LPENR;
+    uint32_t      RESERVED5[2];
+    __IO uint32_t BDCR;
+    __IO uint32_t CSR;
+    uint32_t      RESERVED6[2];
+    __IO uint32_t SSCGR;
+    __IO uint32_t PLLI2SCFGR;
+} RCC_TypeDef;
+
+/* 外设实例，定义在 tim_shim.c */
+extern TimModel TimShim_Tim[14];
+extern DMA_Stream_TypeDef TimShim_DmaStream[16];
+extern DMA_TypeDef TimShim_Dma[2];
+extern RCC_TypeDef TimShim_Rcc;
+
+#define TIM1   ((TIM_TypeDef*)&TimShim_Tim[0].Regs)
+#define TIM2   ((TIM_TypeDef*)&TimShim_Tim[1].Regs)
+#define TIM3   ((TIM_TypeDef*)&TimShim_Tim[2].Regs)
+#define TIM4   ((TIM_TypeDef*)&TimShim_Tim[3].Regs)
+#define TIM5   ((TIM_TypeDef*)&TimShim_Tim[4].Regs)
+#define TIM6   ((TIM_TypeDef*)&TimShim_Tim[5].Regs)
+#define TIM7   ((TIM_TypeDef*)&TimShim_Tim[6].Regs)
+#define TIM8   ((TIM_TypeDef*)&TimShim_Tim[7].Regs)
+#define TIM9   ((TIM_TypeDef*)&TimShim_Tim[8].Regs)
+#define TIM10  ((TIM_TypeDef*)&TimShim_Tim[9].Regs)
+#define TIM11  ((TIM_TypeDef*)&TimShim_Tim[10].Regs)
+#define TIM12  ((TIM_TypeDef*)&TimShim_Tim[11].Regs)
+#define TIM13  ((TIM_TypeDef*)&TimShim_Tim[12].Regs)
+#define TIM14  ((TIM_TypeDef*)&TimShim_Tim[13].Regs)
+
+#define DMA1          (&TimShim_Dma[0])
+#define DMA2          (&TimShim_Dma[1])
+#define DMA1_Stream0  (&TimShim_DmaStream[0])
+#define DMA1_Stream1  (&TimShim_DmaStream[1])
+#define DMA1_Stream2  (&TimShim_DmaStream[2])
+#define DMA1_Stream3  (&TimShim_DmaStream[3])
+#define DMA1_Stream4  (&TimShim_DmaStream[4])
+#define DMA1_Stream5  (&TimShim_DmaStream[5])
+#define DMA1_Stream6  (&TimShim_DmaStream[6])
+#define DMA1_Stream7  (&TimShim_DmaStream[7])
+#define DMA2_Stream0  (&TimShim_DmaStream[8])
+#define DMA2_Stream1  (&TimShim_DmaStream[9])
+#define DMA2_Stream2  (&TimShim_DmaStream[10])
+#define DMA2_Stream3  (&TimShim_DmaStream[11])
+#define DMA2_Stream4  (&TimShim_DmaStream[12])
+#define DMA2_Stream5  (&TimShim_DmaStream[13])
+#define DMA2_Stream6  (&TimShim_DmaStream[14])
+#define DMA2_Stream7  (&TimShim_DmaStream[15])
+
+#define RCC           (&TimShim_Rcc)
+
+/******************************  TIM 寄存器位  *******************************/
+#define TIM_CR1_CEN       ((uint16_t)0x0001)
+#define TIM_CR1_UDIS      ((uint16_t)0x0002)
+#define TIM_CR1_URS       ((uint16_t)0x0004)
+#define TIM_CR1_OPM       ((uint16_t)0x0008)
+#define TIM_CR1_DIR       ((uint16_t)0x0010)
+#define TIM_CR1_CMS       ((uint16_t)0x0060)
+#define TIM_CR1_ARPE      ((uint16_t)0x0080)
+#define TIM_CR1_CKD       ((uint16_t)0x0300)
+
+#define TIM_CR2_CCPC      ((uint16_t)0x0001)
+#define TIM_CR2_CCUS      ((uint16_t)0x0004)
+#define TIM_CR2_CCDS      ((uint16_t)0x0008)
+#define TIM_CR2_MMS       ((uint16_t)0x0070)
+#define TIM_CR2_TI1S      ((uint16_t)0x0080)
+#define TIM_CR2_OIS1      ((uint16_t)0x0100)
+#define TIM_CR2_OIS1N     ((uint16_t)0x0200)
+#define TIM_CR2_OIS2      ((uint16_t)0x0400)
+#define TIM_CR2_OIS2N     ((uint16_t)0x0800)
+#define TIM_CR2_OIS3      ((uint16_t)0x1000)
+#define TIM_CR2_OIS3N     ((uint16_t)0x2000)
+#define TIM_CR2_OIS4      ((uint16_t)0x4000)
+
+#define TIM_SMCR_SMS      ((uint16_t)0x0007)
+#define TIM_SMCR_TS       ((uint16_t)0x0070)
+#define TIM_SMCR_MSM      ((uint16_t)0x0080)
+#define TIM_SMCR_ETF      ((uint16_t)0x0F00)
+#define TIM_SMCR_ETPS     ((uint16_t)0x3000)
+#define TIM_SMCR_ECE      ((uint16_t)0x4000)
+#define TIM_SMCR_ETP      ((uint16_t)0x8000)
+
+#define TIM_SR_UIF        ((uint16_t)0x0001)
+#define TIM_SR_CC1IF      ((uint16_t)0x0002)
+
+#define TIM_CCMR1_CC1S    ((uint16_t)0x0003)
+#define TIM_CCMR1_CC1S_0  ((uint16_t)0x0001)
+#define TIM_CCMR1_IC1PSC  ((uint16_t)0x000C)
+#define TIM_CCMR1_IC1F    ((uint16_t)0x00F0)
+#define TIM_CCMR1_OC1M    ((uint16_t)0x0070)
+#define TIM_CCMR1_OC1CE   ((uint16_t)0x0080)
+#define TIM_CCMR1_CC2S    ((uint16_t)0x0300)
+#define TIM_CCMR1_CC2S_0  ((uint16_t)0x0100)
+#define TIM_CCMR1_IC2PSC  ((uint16_t)0x0C00)
+#define TIM_CCMR1_IC2F    ((uint16_t)0xF000)
+#define TIM_CCMR1_OC2M    ((uint16_t)0x7000)
+
+#define TIM_CCMR2_CC3S    ((uint16_t)0x0003)
+#define TIM_CCMR2_IC3PSC  ((uint16_t)0x000C)
+#define TIM_CCMR2_IC3F    ((uint16_t)0x00F0)
+#define TIM_CCMR2_OC3M    ((uint16_t)0x0070)
+#define TIM_CCMR2_CC4S    ((uint16_t)0x0300)
+#define TIM_CCMR2_IC4PSC  ((uint16_t)0x0C00)
+#define TIM_CCMR2_IC4F    ((uint16_t)0xF000)
+#define TIM_CCMR2_OC4M    ((uint16_t)0x7000)
+
+#define TIM_CCER_CC1E     ((uint16_t)0x0001)
+#define TIM_CCER_CC1P     ((uint16_t)0x0002)
+#define TIM_CCER_CC1NE    ((uint16_t)0x0004)
+#define TIM_CCER_CC1NP    ((uint16_t)0x0008)
+#define TIM_CCER_CC2E     ((uint16_t)0x0010)
+#define TIM_CCER_CC2P     ((uint16_t)0x0020)
+#define TIM_CCER_CC2NE    ((uint16_t)0x0040)
+#define TIM_CCER_CC2NP    ((uint16_t)0x0080)
+#define TIM_CCER_CC3E     ((uint16_t)0x0100)
+#define TIM_CCER_CC3P     ((uint16_t)0x0200)
+#define TIM_CCER_CC3NE    ((uint16_t)0x0400)
+#define TIM_CCER_CC3NP    ((uint16_t)0x0800)
+#define TIM_CCER_CC4E     ((uint16_t)0x1000)
+#define TIM_CCER_CC4P     ((uint16_t)0x2000)
+#define TIM_CCER_CC4NP    ((uint16_t)0x8000)
+
+/* F4 的通道 4 没有互补输出，官方头文件不定义下面两个位；驱动的通道表引用了它们，按 0 处理 */
+#define TIM_CCER_CC4NE    ((uint16_t)0x0000)
+#define TIM_CR2_OIS4N     ((uint16_t)0x0000)
+
+#define TIM_BDTR_MOE      ((uint16_t)0x8000)
+
+/******************************  RCC 寄存器位  *******************************/
+#define RCC_CFGR_PPRE1_2  ((uint32_t)0x00001000)
+#define RCC_CFGR_PPRE2_2  ((uint32_t)0x00008000)
+
+#endif
@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+  * @file     stm32f4xx_rcc.h
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    主机测试用的 StdPeriph RCC 头文件替身
+  *
+  * @attention
+  *
+  * 时钟固定为 168MHz 主频、APB1 四分频、APB2 二分频（TIMxCLK 分别为 84MHz / 168MHz）。
+  * 定时器复位（RCC_APBxPeriphResetCmd 的 ENABLE）把对应模型恢复为上电状态。
+  *
+  ******************************************************************************
+  */
+
+#ifndef stm32f4xx_rcc_h
+#define stm32f4xx_rcc_h
+
+#include "stm32f4xx.h"
+
+typedef struct
+{
+    uint32_t SYSCLK_Frequency;
+    uint32_t HCLK_Frequency;
+    uint32_t PCLK1_Frequency;
+    uint32_t PCLK2_Frequency;
+} RCC_ClocksTypeDef;
+
+#define RCC_APB1Periph_TIM2    ((uint32_t)0x00000001)
+#define RCC_APB1Periph_TIM3    ((uint32_t)0x00000002)
+#define RCC_APB1Periph_TIM4    ((uint32_t)0x00000004)
+#define RCC_APB1Periph_TIM5    ((uint32_t)0x00000008)
+#define RCC_APB1Periph_TIM6    ((uint32_t)0x00000010)
+#define RCC_APB1Periph_TIM7    ((uint32_t)0x00000020)
+#define RCC_APB1Periph_TIM12   ((uint32_t)0x00000040)
+#define RCC_APB1Periph_TIM13   ((uint32_t)0x00000080)
+#define RCC_APB1Periph_TIM14   ((uint32_t)0x00000100)
+
+#define RCC_APB2Periph_TIM1    ((uint32_t)0x00000001)
+#define RCC_APB2Periph_TIM8    ((uint32_t)0x00000002)
+#define RCC_APB2Periph_TIM9    ((uint32_t)0x00010000)
+#define RCC_APB2Periph_TIM10   ((uint32_t)0x00020000)
+#define RCC_APB2Periph_TIM11   ((uint32_t)0x00040000)
+
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks);                         // 读取各总线时钟
+void RCC_APB1PeriphResetCmd(uint32_t RCC_APB1Periph, FunctionalState NewState); // APB1 外设复位
+void RCC_APB2PeriphResetCmd(uint32_t RCC_APB2Periph, FunctionalState NewState); // APB2 外设复位
+
+#endif
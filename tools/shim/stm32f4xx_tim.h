@@ -0,0 +1,272 @@
+/**
+  ******************************************************************************
+  * @file     stm32f4xx_tim.h
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    主机测试用的 StdPeriph TIM 头文件替身
+  *
+  * @attention
+  *
+  * 初始化结构体与常量取值和官方 stm32f4xx_tim.h 一致；驱动直接调用的几个库函数
+  * （TIM_SetICxPrescaler、TIM_SelectInputTrigger、TIM_ETRConfig）在 tim_shim.c 中按官方实现给出。
+  *
+  ******************************************************************************
+  */
+
+#ifndef stm32f4xx_tim_h
+#define stm32f4xx_tim_h
+
+#include "stm32f4xx.h"
+
+typedef struct
+{
+    uint16_t TIM_Prescaler;
+    uint16_t TIM_CounterMode;
+    uint32_t TIM_Period;
+    uint16_t TIM_ClockDivision;
+    uint8_t  TIM_RepetitionCounter;
+} TIM_TimeBaseInitTypeDef;
+
+typedef struct
+{
+    uint16_t TIM_OCMode;
+    uint16_t TIM_OutputState;
+    uint16_t TIM_OutputNState;
+    uint32_t TIM_Pulse;
+    uint16_t TIM_OCPolarity;
+    uint16_t TIM_OCNPolarity;
+    uint16_t TIM_OCIdleState;
+    uint16_t TIM_OCNIdleState;
+} TIM_OCInitTypeDef;
+
+typedef struct
+{
+    uint16_t TIM_Channel;
+    uint16_t TIM_ICPolarity;
+    uint16_t TIM_ICSelection;
+    uint16_t TIM_ICPrescaler;
+    uint16_t TIM_ICFilter;
+} TIM_ICInitTypeDef;
+
+typedef struct
+{
+    uint16_t TIM_OSSRState;
+    uint16_t TIM_OSSIState;
+    uint16_t TIM_LOCKLevel;
+    uint16_t TIM_DeadTime;
+    uint16_t TIM_Break;
+    uint16_t TIM_BreakPolarity;
+    uint16_t TIM_AutomaticOutput;
+} TIM_BDTRInitTypeDef;
+
+#define TIM_OCMode_Timing                ((uint16_t)0x0000)
+#define TIM_OCMode_Active                ((uint16_t)0x0010)
+#define TIM_OCMode_Inactive              ((uint16_t)0x0020)
+#define TIM_OCMode_Toggle                ((uint16_t)0x0030)
+#define TIM_OCMode_PWM1                  ((uint16_t)0x0060)
+#define TIM_OCMode_PWM2                  ((uint16_t)0x0070)
+
+#define TIM_OPMode_Single                ((uint16_t)0x0008)
+#define TIM_OPMode_Repetitive            ((uint16_t)0x0000)
+
+#define TIM_Channel_1                    ((uint16_t)0x0000)
+#define TIM_Channel_2                    ((uint16_t)0x0004)
+#define TIM_Channel_3                    ((uint16_t)0x0008)
+#define TIM_Channel_4                    ((uint16_t)0x000C)
+
+#define TIM_CKD_DIV1                     ((uint16_t)0x0000)
+#define TIM_CKD_DIV2                     ((uint16_t)0x0100)
+#define TIM_CKD_DIV4                     ((uint16_t)0x0200)
+
+#define TIM_CounterMode_Up               ((uint16_t)0x0000)
+#define TIM_CounterMode_Down             ((uint16_t)0x0010)
+#define TIM_CounterMode_CenterAligned1   ((uint16_t)0x0020)
+#define TIM_CounterMode_CenterAligned2   ((uint16_t)0x0040)
+#define TIM_CounterMode_CenterAligned3   ((uint16_t)0x0060)
+
+#define TIM_OCPolarity_High              ((uint16_t)0x0000)
+#define TIM_OCPolarity_Low               ((uint16_t)0x0002)
+
+#define TIM_OCNPolarity_High             ((uint16_t)0x0000)
+#define TIM_OCNPolarity_Low              ((uint16_t)0x0008)
+
+#define TIM_OutputState_Disable          ((uint16_t)0x0000)
+#define TIM_OutputState_Enable           ((uint16_t)0x0001)
+
+#define TIM_OutputNState_Disable         ((uint16_t)0x0000)
+#define TIM_OutputNState_Enable          ((uint16_t)0x0004)
+
+#define TIM_CCx_Enable                   ((uint16_t)0x0001)
+#define TIM_CCx_Disable                  ((uint16_t)0x0000)
+
+#define TIM_CCxN_Enable                  ((uint16_t)0x0004)
+#define TIM_CCxN_Disable                 ((uint16_t)0x0000)
+
+#define TIM_Break_Enable                 ((uint16_t)0x1000)
+#define TIM_Break_Disable                ((uint16_t)0x0000)
+
+#define TIM_BreakPolarity_Low            ((uint16_t)0x0000)
+#define TIM_BreakPolarity_High           ((uint16_t)0x2000)
+
+#define TIM_AutomaticOutput_Enable       ((uint16_t)0x4000)
+#define TIM_AutomaticOutput_Disable      ((uint16_t)0x0000)
+
+#define TIM_LOCKLevel_OFF                ((uint16_t)0x0000)
+#define TIM_LOCKLevel_1                  ((uint16_t)0x0100)
+
+#define TIM_OSSRState_Enable             ((uint16_t)0x0800)
+#define TIM_OSSRState_Disable            ((uint16_t)0x0000)
+
+#define TIM_OSSIState_Enable             ((uint16_t)0x0400)
+#define TIM_OSSIState_Disable            ((uint16_t)0x0000)
+
+#define TIM_OCIdleState_Set              ((uint16_t)0x0100)
+#define TIM_OCIdleState_Reset            ((uint16_t)0x0000)
+
+#define TIM_OCNIdleState_Set             ((uint16_t)0x0200)
+#define TIM_OCNIdleState_Reset           ((uint16_t)0x0000)
+
+#define TIM_ICPolarity_Rising            ((uint16_t)0x0000)
+#define TIM_ICPolarity_Falling           ((uint16_t)0x0002)
+#define TIM_ICPolarity_BothEdge          ((uint16_t)0x000A)
+
+#define TIM_ICSelection_DirectTI         ((uint16_t)0x0001)
+#define TIM_ICSelection_IndirectTI       ((uint16_t)0x0002)
+#define TIM_ICSelection_TRC              ((uint16_t)0x0003)
+
+#define TIM_ICPSC_DIV1                   ((uint16_t)0x0000)
+#define TIM_ICPSC_DIV2                   ((uint16_t)0x0004)
+#define TIM_ICPSC_DIV4                   ((uint16_t)0x0008)
+#define TIM_ICPSC_DIV8                   ((uint16_t)0x000C)
+
+#define TIM_IT_Update                    ((uint16_t)0x0001)
+#define TIM_IT_CC1                       ((uint16_t)0x0002)
+#define TIM_IT_CC2                       ((uint16_t)0x0004)
+#define TIM_IT_CC3                       ((uint16_t)0x0008)
+#define TIM_IT_CC4                       ((uint16_t)0x0010)
+#define TIM_IT_COM                       ((uint16_t)0x0020)
+#define TIM_IT_Trigger                   ((uint16_t)0x0040)
+#define TIM_IT_Break                     ((uint16_t)0x0080)
+
+#define TIM_FLAG_Update                  ((uint16_t)0x0001)
+#define TIM_FLAG_CC1                     ((uint16_t)0x0002)
+#define TIM_FLAG_CC2                     ((uint16_t)0x0004)
+#define TIM_FLAG_CC3                     ((uint16_t)0x0008)
+#define TIM_FLAG_CC4                     ((uint16_t)0x0010)
+#define TIM_FLAG_COM                     ((uint16_t)0x0020)
+#define TIM_FLAG_Trigger                 ((uint16_t)0x0040)
+#define TIM_FLAG_Break                   ((uint16_t)0x0080)
+#define TIM_FLAG_CC1OF                   ((uint16_t)0x0200)
+#define TIM_FLAG_CC2OF                   ((uint16_t)0x0400)
+#define TIM_FLAG_CC3OF                   ((uint16_t)0x0800)
+#define TIM_FLAG_CC4OF                   ((uint16_t)0x1000)
+
+#define TIM_DMA_Update                   ((uint16_t)0x0100)
+#define TIM_DMA_CC1                      ((uint16_t)0x0200)
+#define TIM_DMA_CC2                      ((uint16_t)0x0400)
+#define TIM_DMA_CC3                      ((uint16_t)0x0800)
+#define TIM_DMA_CC4                      ((uint16_t)0x1000)
+#define TIM_DMA_COM                      ((uint16_t)0x2000)
+#define TIM_DMA_Trigger                  ((uint16_t)0x4000)
+
+#define TIM_DMABase_CR1                  ((uint16_t)0x0000)
+#define TIM_DMABase_CR2                  ((uint16_t)0x0001)
+#define TIM_DMABase_SMCR                 ((uint16_t)0x0002)
+#define TIM_DMABase_DIER                 ((uint16_t)0x0003)
+#define TIM_DMABase_SR                   ((uint16_t)0x0004)
+#define TIM_DMABase_EGR                  ((uint16_t)0x0005)
+#define TIM_DMABase_CCMR1                ((uint16_t)0x0006)
+#define TIM_DMABase_CCMR2                ((uint16_t)0x0007)
+#define TIM_DMABase_CCER                 ((uint16_t)0x0008)
+#define TIM_DMABase_CNT                  ((uint16_t)0x0009)
+#define TIM_DMABase_PSC                  ((uint16_t)0x000A)
+#define TIM_DMABase_ARR                  ((uint16_t)0x000B)
+#define TIM_DMABase_RCR                  ((uint16_t)0x000C)
+#define TIM_DMABase_CCR1                 ((uint16_t)0x000D)
+#define TIM_DMABase_CCR2                 ((uint16_t)0x000E)
+#define TIM_DMABase_CCR3                 ((uint16_t)0x000F)
+#define TIM_DMABase_CCR4                 ((uint16_t)0x0010)
+#define TIM_DMABase_BDTR                 ((uint16_t)0x0011)
+#define TIM_DMABase_DCR                  ((uint16_t)0x0012)
+#define TIM_DMABase_OR                   ((uint16_t)0x0013)
+
+#define TIM_DMABurstLength_1Transfer     ((uint16_t)0x0000)
+#define TIM_DMABurstLength_3Transfers    ((uint16_t)0x0200)
+#define TIM_DMABurstLength_18Transfers   ((uint16_t)0x1100)
+
+#define TIM_EventSource_Update           ((uint16_t)0x0001)
+#define TIM_EventSource_CC1              ((uint16_t)0x0002)
+#define TIM_EventSource_CC2              ((uint16_t)0x0004)
+#define TIM_EventSource_CC3              ((uint16_t)0x0008)
+#define TIM_EventSource_CC4              ((uint16_t)0x0010)
+#define TIM_EventSource_COM              ((uint16_t)0x0020)
+#define TIM_EventSource_Trigger          ((uint16_t)0x0040)
+#define TIM_EventSource_Break            ((uint16_t)0x0080)
+
+#define TIM_UpdateSource_Global          ((uint16_t)0x0000)
+#define TIM_UpdateSource_Regular         ((uint16_t)0x0001)
+
+#define TIM_OCPreload_Enable             ((uint16_t)0x0008)
+#define TIM_OCPreload_Disable            ((uint16_t)0x0000)
+
+#define TIM_OCClear_Enable               ((uint16_t)0x0080)
+#define TIM_OCClear_Disable              ((uint16_t)0x0000)
+
+#define TIM_ForcedAction_Active          ((uint16_t)0x0050)
+#define TIM_ForcedAction_InActive        ((uint16_t)0x0040)
+
+#define TIM_TS_ITR0                      ((uint16_t)0x0000)
+#define TIM_TS_ITR1                      ((uint16_t)0x0010)
+#define TIM_TS_ITR2                      ((uint16_t)0x0020)
+#define TIM_TS_ITR3                      ((uint16_t)0x0030)
+#define TIM_TS_TI1F_ED                   ((uint16_t)0x0040)
+#define TIM_TS_TI1FP1                    ((uint16_t)0x0050)
+#define TIM_TS_TI2FP2                    ((uint16_t)0x0060)
+#define TIM_TS_ETRF                      ((uint16_t)0x0070)
+
+#define TIM_TIxExternalCLK1Source_TI1    ((uint16_t)0x0050)
+#define TIM_TIxExternalCLK1Source_TI2    ((uint16_t)0x0060)
+#define TIM_TIxExternalCLK1Source_TI1ED  ((uint16_t)0x0040)
+
+#define TIM_SlaveMode_Reset              ((uint16_t)0x0004)
+#define TIM_SlaveMode_Gated              ((uint16_t)0x0005)
+#define TIM_SlaveMode_Trigger            ((uint16_t)0x0006)
+#define TIM_SlaveMode_External1          ((uint16_t)0x0007)
+
+#define TIM_TRGOSource_Reset             ((uint16_t)0x0000)
+#define TIM_TRGOSource_Enable            ((uint16_t)0x0010)
+#define TIM_TRGOSource_Update            ((uint16_t)0x0020)
+#define TIM_TRGOSource_OC1               ((uint16_t)0x0030)
+#define TIM_TRGOSource_OC1Ref            ((uint16_t)0x0040)
+#define TIM_TRGOSource_OC2Ref            ((uint16_t)0x0050)
+#define TIM_TRGOSource_OC3Ref            ((uint16_t)0x0060)
+#define TIM_TRGOSource_OC4Ref            ((uint16_t)0x0070)
+
+#define TIM_MasterSlaveMode_Enable       ((uint16_t)0x0080)
+#define TIM_MasterSlaveMode_Disable      ((uint16_t)0x0000)
+
+#define TIM_ExtTRGPSC_OFF                ((uint16_t)0x0000)
+#define TIM_ExtTRGPSC_DIV2               ((uint16_t)0x1000)
+#define TIM_ExtTRGPSC_DIV4               ((uint16_t)0x2000)
+#define TIM_ExtTRGPSC_DIV8               ((uint16_t)0x3000)
+
+#define TIM_ExtTRGPolarity_Inverted      ((uint16_t)0x8000)
+#define TIM_ExtTRGPolarity_NonInverted   ((uint16_t)0x0000)
+
+#define TIM_EncoderMode_TI1              ((uint16_t)0x0001)
+#define TIM_EncoderMode_TI2              ((uint16_t)0x0002)
+#define TIM_EncoderMode_TI12             ((uint16_t)0x0003)
+
+#define TIM_PSCReloadMode_Update         ((uint16_t)0x0000)
+#define TIM_PSCReloadMode_Immediate      ((uint16_t)0x0001)
+
+void TIM_SetIC1Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC);       // 设置通道 1 输入捕获预分频
+void TIM_SetIC2Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC);       // 设置通道 2 输入捕获预分频
+void TIM_SetIC3Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC);       // 设置通道 3 输入捕获预分频
+void TIM_SetIC4Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC);       // 设置通道 4 输入捕获预分频
+void TIM_SelectInputTrigger(TIM_TypeDef* TIMx, uint16_t TIM_InputTriggerSource); // 选择输入触发源
+void TIM_ETRConfig(TIM_TypeDef* TIMx, uint16_t TIM_ExtTRGPrescaler,    // 配置外部触发 ETR
+    uint16_t TIM_ExtTRGPolarity, uint16_t ExtTRGFilter);
+
+#endif
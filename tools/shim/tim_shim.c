@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file     tim_shim.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    主机测试用的外设实例与库函数替身
+  *
+  * @attention
+  *
+  * - TimShim_Tim[0~13] 依次对应 TIM1~TIM14，TIM2/TIM5 为 32 位计数器。
+  *   使用前调用 TimShim_Init() 把全部模型复位为上电状态。
+  * - RCC_APBxPeriphResetCmd(..., ENABLE) 复位对应模型，中断和输出回调随之清除。
+  * - TIM_SetICxPrescaler、TIM_SelectInputTrigger、TIM_ETRConfig 与官方库的实现一致。
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "stm32f4xx_tim.h"
+#include "stm32f4xx_rcc.h"
+#include "tim_shim.h"
+
+TimModel TimShim_Tim[14];
+DMA_Stream_TypeDef TimShim_DmaStream[16];
+DMA_TypeDef TimShim_Dma[2];
+RCC_TypeDef TimShim_Rcc;
+
+/* 复位位与模型下标的对应关系 */
+typedef struct
+{
+    uint32_t Periph;     /* RCC_APBxPeriph_TIMx */
+    uint8_t  Index;      /* TimShim_Tim 下标 */
+} TimShim_ResetMap;
+
+static const TimShim_ResetMap s_apb1[] = {
+    { RCC_APB1Periph_TIM2, 1 },  { RCC_APB1Periph_TIM3, 2 },   { RCC_APB1Periph_TIM4, 3 },
+    { RCC_APB1Periph_TIM5, 4 },  { RCC_APB1Periph_TIM6, 5 },   { RCC_APB1Periph_TIM7, 6 },
+    { RCC_APB1Periph_TIM12, 11 }, { RCC_APB1Periph_TIM13, 12 }, { RCC_APB1Periph_TIM14, 13 }
+};
+
+static const TimShim_ResetMap s_apb2[] = {
+    { RCC_APB2Periph_TIM1, 0 },  { RCC_APB2Periph_TIM8, 7 },   { RCC_APB2Periph_TIM9, 8 },
+    { RCC_APB2Periph_TIM10, 9 }, { RCC_APB2Periph_TIM11, 10 }
+};
+
+/**
+  * @brief  复位表中被选中的模型。
+  */
+static void TimShim_Reset(const TimShim_ResetMap* Map, size_t Count, uint32_t Periph)
+{
+    size_t i = 0;
+
+    for (i = 0; i < Count; i++)
+    {
+        if (Periph & Map[i].Periph)
+        {
+            TimModel_Init(&TimShim_Tim[Map[i].Index], Map[i].Index == 1 || Map[i].Index == 4);
+        }
+    }
+}
+
+/**
+  * @brief  复位全部模型和 RCC，设置固定的 APB 预分频。
+  * @retval None
+  */
+void TimShim_Init(void)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < 14; i++)
+    {
+        TimModel_Init(&TimShim_Tim[i], i == 1 || i == 4);
+    }
+    memset(&TimShim_Rcc, 0, sizeof(TimShim_Rcc));
+    memset(TimShim_DmaStream, 0, sizeof(TimShim_DmaStream));
+    memset(TimShim_Dma, 0, sizeof(TimShim_Dma));
+
+    /* PPRE1 = 101（四分频），PPRE2 = 100（二分频） */
+    TimShim_Rcc.CFGR = (0x5U << 10) | (0x4U << 13);
+}
+
+/**
+  * @brief  TIMx 对应的模型，不是 TIM1~TIM14 时返回 NULL。
+  * @param  TIMx: TIM1~TIM14。
+  * @retval 模型指针
+  */
+TimModel* TimShim_Model(TIM_TypeDef* TIMx)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < 14; i++)
+    {
+        if ((TIM_TypeDef*)&TimShim_Tim[i].Regs == TIMx)
+        {
+            return &TimShim_Tim[i];
+        }
+    }
+    return NULL;
+}
+
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks)
+{
+    RCC_Clocks->SYSCLK_Frequency = TIM_SHIM_HCLK;
+    RCC_Clocks->HCLK_Frequency = TIM_SHIM_HCLK;
+    RCC_Clocks->PCLK1_Frequency = TIM_SHIM_HCLK / 4;
+    RCC_Clocks->PCLK2_Frequency = TIM_SHIM_HCLK / 2;
+}
+
+void RCC_APB1PeriphResetCmd(uint32_t RCC_APB1Periph, FunctionalState NewState)
+{
+    NewState != DISABLE ? TimShim_Reset(s_apb1, sizeof(s_apb1) / sizeof(s_apb1[0]), RCC_APB1Periph) : (void)0;
+}
+
+void RCC_APB2PeriphResetCmd(uint32_t RCC_APB2Periph, FunctionalState NewState)
+{
+    NewState != DISABLE ? TimShim_Reset(s_apb2, sizeof(s_apb2) / sizeof(s_apb2[0]), RCC_APB2Periph) : (void)0;
+}
+
+void TIM_SetIC1Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC)
+{
+    TIMx->CCMR1 = (uint16_t)((TIMx->CCMR1 & ~TIM_CCMR1_IC1PSC) | TIM_ICPSC);
+}
+
+void TIM_SetIC2Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC)
+{
+    TIMx->CCMR1 = (uint16_t)((TIMx->CCMR1 & ~TIM_CCMR1_IC2PSC) | (uint16_t)(TIM_ICPSC << 8));
+}
+
+void TIM_SetIC3Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC)
+{
+    TIMx->CCMR2 = (uint16_t)((TIMx->CCMR2 & ~TIM_CCMR2_IC3PSC) | TIM_ICPSC);
+}
+
+void TIM_SetIC4Prescaler(TIM_TypeDef* TIMx, uint16_t TIM_ICPSC)
+{
+    TIMx->CCMR2 = (uint16_t)((TIMx->CCMR2 & ~TIM_CCMR2_IC4PSC) | (uint16_t)(TIM_ICPSC << 8));
+}
+
+void TIM_SelectInputTrigger(TIM_TypeDef* TIMx, uint16_t TIM_InputTriggerSource)
+{
+    TIMx->SMCR = (uint16_t)((TIMx->SMCR & ~TIM_SMCR_TS) | TIM_InputTriggerSource);
+}
+
+void TIM_ETRConfig(TIM_TypeDef* TIMx, uint16_t TIM_ExtTRGPrescaler,
+    uint16_t TIM_ExtTRGPolarity, uint16_t ExtTRGFilter)
+{
+    TIMx->SMCR = (uint16_t)((TIMx->SMCR & 0x00FF) | TIM_ExtTRGPrescaler | TIM_ExtTRGPolarity
+        | (uint16_t)(ExtTRGFilter << 8));
+}
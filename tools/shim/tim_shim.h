@@ -0,0 +1,22 @@
+/**
+  ******************************************************************************
+  * @file     tim_shim.h
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    主机测试用的外设替身接口
+  ******************************************************************************
+  */
+
+#ifndef tim_shim_h
+#define tim_shim_h
+
+#include "stm32f4xx.h"
+
+/* 替身的 HCLK，APB1 = HCLK / 4，APB2 = HCLK / 2 */
+#define TIM_SHIM_HCLK  168000000U
+
+void TimShim_Init(void);                         // 复位全部模型和 RCC
+TimModel* TimShim_Model(TIM_TypeDef* TIMx);      // TIMx 对应的模型
+
+#endif
@@ -0,0 +1,589 @@
+/**
+  ******************************************************************************
+  * @file     tim_model.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    主机端 TIM 计数器周期级模型
+  *
+  * @attention
+  *
+  * 让 myTIM_* 驱动和上层模块在 Linux 上以模拟时间运行，用于单元测试和性能对比。
+  * 时间单位为定时器内核时钟 CK_INT 的节拍；模型按“下一个计数时钟 / 下一个输入边沿 /
+  * 运行终点”三者中最近的一个跳跃推进，开销与计数次数成正比，与 PSC 无关。
+  *
+  * 已建模：
+  * - PSC、ARR、CCRx 的预装载与影子寄存器（PSC 总是预装载，ARR 看 ARPE，CCRx 看 OCxPE），
+  *   更新事件时装载；UDIS 屏蔽更新事件，URS 使 UG 不置 UIF。
+  * - 向上、向下、中心对齐 1/2/3 计数；中心对齐时上溢和下溢都算一次更新机会，
+  *   比较标志按 CMS 只在向下/向上/双向计数时置位。
+  * - 重复计数器 RCR、单脉冲模式 OPM（更新事件时清 CEN）。
+  * - 输出比较：冻结、匹配置有效/无效、翻转、强制有效/无效、PWM1/PWM2，
+  *   输出电平 = OCxREF 异或 CCxP，CCxE = 0 时为 0。
+  * - 输入捕获：CCxS = 01/10 的直接/交叉输入，上升/下降/双边沿，IC 预分频，
+  *   CCxIF 已置位时再捕获置 CCxOF。
+  * - EGR：UG、CC1G~CC4G。
+  *
+  * 未建模：从模式、ETR、编码器、DMA、BDTR/互补输出、输入滤波和同步延迟。
+  *
+  * 编译：与测试程序一起编译，完整示例见 tools/tim_model_test.c 文件头
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+/*
+@verbatim
+================================================================================
+##### 使用本模块的方法 #####
+================================================================================
+[..]
+(#) 用 -I tools/shim 编译驱动和测试程序，TIM1~TIM14 即为 TimShim_Tim[] 中的模型：
+    TimShim_Init();
+    TimModel* m = TimShim_Model(TIM3);
+    不要自己建模型再把 &m.Regs 强转交给驱动，按地址识别定时器的函数会走错分支。
+
+(#) 调用 myTIM_TimeBaseInit(TIM3, ...)、myTIM_OCxInit(TIM3, 1, ...)、myTIM_Cmd(TIM3, ENABLE) 等。
+
+(#) 可选：m->Irq = MyIrq; 在回调里调用被测模块的 IRQHandler；
+    m->Output = MyScope; 记录每个通道的电平变化时刻。
+
+(#) TimModel_Run(m, 84000000);       // 推进 1 秒（84MHz 内核时钟）
+@endverbatim
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "tim_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TM_CR1_CEN            0x0001
+#define TM_CR1_UDIS           0x0002
+#define TM_CR1_URS            0x0004
+#define TM_CR1_OPM            0x0008
+#define TM_CR1_DIR            0x0010
+#define TM_CR1_CMS            0x0060
+#define TM_CR1_ARPE           0x0080
+
+#define TM_SR_UIF             0x0001
+#define TM_SR_CC1IF           0x0002
+#define TM_SR_CC1OF           0x0200
+
+#define TM_EGR_UG             0x0001
+#define TM_EGR_CC1G           0x0002
+
+#define TM_CCMR_CCS           0x03
+#define TM_CCMR_ICPSC         0x0C
+#define TM_CCMR_OCPE          0x08
+#define TM_CCMR_OCM           0x70
+
+#define TM_CCER_CCE           0x1
+#define TM_CCER_CCP           0x2
+#define TM_CCER_CCNP          0x8
+
+#define TM_OCM_FROZEN         0
+#define TM_OCM_ACTIVE         1
+#define TM_OCM_INACTIVE       2
+#define TM_OCM_TOGGLE         3
+#define TM_OCM_FORCE_LOW      4
+#define TM_OCM_FORCE_HIGH     5
+#define TM_OCM_PWM1           6
+#define TM_OCM_PWM2           7
+
+#define TM_NEVER              UINT64_MAX
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t TM_Ccmr(const TimModel* M, uint8_t Ch);
+static uint8_t TM_Ccer(const TimModel* M, uint8_t Ch);
+static volatile uint32_t* TM_Ccr(TimModel* M, uint8_t Ch);
+static uint32_t TM_Compare(TimModel* M, uint8_t Ch);
+static void TM_UpdateEvent(TimModel* M, int FromUG);
+static void TM_Sync(TimModel* M);
+static void TM_Publish(TimModel* M);
+static void TM_Outputs(TimModel* M);
+static void TM_Match(TimModel* M, uint32_t Cnt, int DirUp);
+static void TM_CounterTick(TimModel* M);
+static void TM_Edge(TimModel* M, uint8_t Input, uint8_t Level);
+static uint64_t TM_NextEdge(const TimModel* M);
+
+
+/**
+  * @brief  取通道在 CCMRx 中的 8 位字段。
+  */
+static uint8_t TM_Ccmr(const TimModel* M, uint8_t Ch)
+{
+    uint16_t ccmr = (Ch <= 2) ? M->Regs.CCMR1 : M->Regs.CCMR2;
+
+    return (uint8_t)(ccmr >> (((Ch - 1) & 1) * 8));
+}
+
+/**
+  * @brief  取通道在 CCER 中的 4 位字段。
+  */
+static uint8_t TM_Ccer(const TimModel* M, uint8_t Ch)
+{
+    return (uint8_t)((M->Regs.CCER >> ((Ch - 1) * 4)) & 0xF);
+}
+
+/**
+  * @brief  取通道的 CCRx 寄存器地址（CCR1~CCR4 连续排列）。
+  */
+static volatile uint32_t* TM_Ccr(TimModel* M, uint8_t Ch)
+{
+    return &M->Regs.CCR1 + (Ch - 1);
+}
+
+/**
+  * @brief  输出比较实际使用的比较值：OCxPE = 1 用影子寄存器，否则直接用 CCRx。
+  */
+static uint32_t TM_Compare(TimModel* M, uint8_t Ch)
+{
+    return (TM_Ccmr(M, Ch) & TM_CCMR_OCPE) ? M->CcrShadow[Ch - 1] : *TM_Ccr(M, Ch);
+}
+
+/**
+  * @brief  更新事件：装载影子寄存器、重装重复计数器、置 UIF、单脉冲停止。
+  * @param  FromUG: 1 表示由 UG 产生（URS = 1 时不置 UIF，不触发单脉冲停止）。
+  */
+static void TM_UpdateEvent(TimModel* M, int FromUG)
+{
+    uint8_t ch = 0;
+
+    M->PscShadow = M->Regs.PSC;
+    M->ArrShadow = M->Regs.ARR & M->Mask;
+    for (ch = 1; ch <= 4; ch++)
+    {
+        if ((TM_Ccmr(M, ch) & TM_CCMR_CCS) == 0)
+        {
+            M->CcrShadow[ch - 1] = *TM_Ccr(M, ch) & M->Mask;
+        }
+    }
+    M->RepCnt = M->Regs.RCR;
+
+    if (!FromUG || !(M->Regs.CR1 & TM_CR1_URS))
+    {
+        M->SrShadow |= TM_SR_UIF;
+    }
+    if (!FromUG && (M->Regs.CR1 & TM_CR1_OPM))
+    {
+        M->Regs.CR1 &= (uint16_t)~TM_CR1_CEN;
+    }
+}
+
+/**
+  * @brief  吸收驱动的写入：SR 写 0 清除，执行并清零 EGR。
+  */
+static void TM_Sync(TimModel* M)
+{
+    uint16_t egr = M->Regs.EGR;
+    uint8_t ch = 0;
+
+    M->SrShadow &= M->Regs.SR;
+
+    if (egr & TM_EGR_UG)
+    {
+        /* UG 总是重新初始化计数器和预分频器；UDIS = 1 时不产生更新事件 */
+        if (!(M->Regs.CR1 & TM_CR1_UDIS))
+        {
+            TM_UpdateEvent(M, 1);
+        }
+        M->PscCnt = 0;
+        M->Up = 1;
+        M->Regs.CNT = ((M->Regs.CR1 & TM_CR1_CMS) == 0 && (M->Regs.CR1 & TM_CR1_DIR)) ? M->ArrShadow : 0;
+    }
+    for (ch = 1; ch <= 4; ch++)
+    {
+        if (egr & (TM_EGR_CC1G << (ch - 1)))
+        {
+            if (M->SrShadow & (TM_SR_CC1IF << (ch - 1)) && (TM_Ccmr(M, ch) & TM_CCMR_CCS))
+            {
+                M->SrShadow |= (uint16_t)(TM_SR_CC1OF << (ch - 1));
+            }
+            if (TM_Ccmr(M, ch) & TM_CCMR_CCS)
+            {
+                *TM_Ccr(M, ch) = M->Regs.CNT;
+            }
+            M->SrShadow |= (uint16_t)(TM_SR_CC1IF << (ch - 1));
+        }
+    }
+    M->Regs.EGR = 0;
+
+    TM_Outputs(M);
+    TM_Publish(M);
+}
+
+/**
+  * @brief  把硬件状态写回驱动可见的寄存器。
+  */
+static void TM_Publish(TimModel* M)
+{
+    M->Regs.SR = M->SrShadow;
+
+    /* 中心对齐模式下 DIR 只读，反映当前方向 */
+    if (M->Regs.CR1 & TM_CR1_CMS)
+    {
+        M->Regs.CR1 = M->Up ? (uint16_t)(M->Regs.CR1 & ~TM_CR1_DIR) : (uint16_t)(M->Regs.CR1 | TM_CR1_DIR);
+    }
+}
+
+/**
+  * @brief  按当前计数值和模式刷新 OCxREF 与输出电平，电平变化时调用输出回调。
+  * @note   匹配置有效/无效和翻转在 TM_Match() 中处理，这里只处理电平型模式。
+  */
+static void TM_Outputs(TimModel* M)
+{
+    uint32_t cnt = M->Regs.CNT;
+    int dirUp = (M->Regs.CR1 & TM_CR1_CMS) ? M->Up : !(M->Regs.CR1 & TM_CR1_DIR);
+    uint8_t ch = 0;
+    uint8_t field = 0;
+    uint8_t ccer = 0;
+    uint8_t level = 0;
+    uint32_t ccr = 0;
+
+    for (ch = 1; ch <= 4; ch++)
+    {
+        field = TM_Ccmr(M, ch);
+        if (field & TM_CCMR_CCS)
+        {
+            continue;
+        }
+
+        ccr = TM_Compare(M, ch);
+        switch ((field & TM_CCMR_OCM) >> 4)
+        {
+        case TM_OCM_FORCE_LOW:  M->OcRef[ch - 1] = 0; break;
+        case TM_OCM_FORCE_HIGH: M->OcRef[ch - 1] = 1; break;
+        case TM_OCM_PWM1:       M->OcRef[ch - 1] = dirUp ? (cnt < ccr) : (cnt <= ccr); break;
+        case TM_OCM_PWM2:       M->OcRef[ch - 1] = dirUp ? (cnt >= ccr) : (cnt > ccr); break;
+        default: break;
+        }
+
+        ccer = TM_Ccer(M, ch);
+        level = (ccer & TM_CCER_CCE) ? (uint8_t)(M->OcRef[ch - 1] ^ ((ccer & TM_CCER_CCP) ? 1 : 0)) : 0;
+        if (level != M->OutLevel[ch - 1])
+        {
+            M->OutLevel[ch - 1] = level;
+            if (M->Output != NULL)
+            {
+                M->Output(M, ch, level, M->OutputCtx);
+            }
+        }
+    }
+}
+
+/**
+  * @brief  比较匹配：置 CCxIF，处理匹配型输出模式。
+  * @param  Cnt: 计数器新值。
+  * @param  DirUp: 本次计数方向。
+  */
+static void TM_Match(TimModel* M, uint32_t Cnt, int DirUp)
+{
+    uint8_t cms = (uint8_t)((M->Regs.CR1 & TM_CR1_CMS) >> 5);
+    uint8_t ch = 0;
+    uint8_t field = 0;
+
+    for (ch = 1; ch <= 4; ch++)
+    {
+        field = TM_Ccmr(M, ch);
+        if ((field & TM_CCMR_CCS) || Cnt != TM_Compare(M, ch))
+        {
+            continue;
+        }
+
+        /* CMS = 1 只在向下计数时置标志，2 只在向上，3 双向 */
+        if (cms == 0 || cms == 3 || (cms == 1 && !DirUp) || (cms == 2 && DirUp))
+        {
+            M->SrShadow |= (uint16_t)(TM_SR_CC1IF << (ch - 1));
+        }
+
+        switch ((field & TM_CCMR_OCM) >> 4)
+        {
+        case TM_OCM_ACTIVE:   M->OcRef[ch - 1] = 1; break;
+        case TM_OCM_INACTIVE: M->OcRef[ch - 1] = 0; break;
+        case TM_OCM_TOGGLE:   M->OcRef[ch - 1] ^= 1; break;
+        default: break;
+        }
+    }
+}
+
+/**
+  * @brief  一个计数时钟 CK_CNT：计数、比较、上溢/下溢与重复计数。
+  */
+static void TM_CounterTick(TimModel* M)
+{
+    uint16_t cr1 = M->Regs.CR1;
+    uint32_t arr = (cr1 & TM_CR1_ARPE) ? M->ArrShadow : (M->Regs.ARR & M->Mask);
+    uint32_t cnt = M->Regs.CNT & M->Mask;
+    int dirUp = 1;
+    int event = 0;
+
+    /* ARR = 0 时计数器被阻塞 */
+    if (arr == 0)
+    {
+        return;
+    }
+
+    if ((cr1 & TM_CR1_CMS) == 0)
+    {
+        dirUp = !(cr1 & TM_CR1_DIR);
+        if (dirUp)
+        {
+            event = (cnt >= arr);
+            cnt = event ? 0 : cnt + 1;
+        }
+        else
+        {
+            event = (cnt == 0);
+            cnt = event ? arr : cnt - 1;
+        }
+    }
+    else
+    {
+        /* 中心对齐：0 -> ARR 上溢，ARR -> 0 下溢 */
+        dirUp = M->Up;
+        cnt = dirUp ? cnt + 1 : cnt - 1;
+        if (dirUp && cnt >= arr)
+        {
+            cnt = arr;
+            M->Up = 0;
+            event = 1;
+        }
+        else if (!dirUp && cnt == 0)
+        {
+            M->Up = 1;
+            event = 1;
+        }
+    }
+
+    M->Regs.CNT = cnt;
+    TM_Match(M, cnt, dirUp);
+
+    if (event && !(cr1 & TM_CR1_UDIS))
+    {
+        if (M->RepCnt == 0)
+        {
+            TM_UpdateEvent(M, 0);
+        }
+        else
+        {
+            M->RepCnt--;
+        }
+    }
+
+    TM_Outputs(M);
+}
+
+/**
+  * @brief  输入 TIx 电平变化：按各通道的输入选择、极性和预分频捕获。
+  */
+static void TM_Edge(TimModel* M, uint8_t Input, uint8_t Level)
+{
+    uint8_t ch = 0;
+    uint8_t field = 0;
+    uint8_t ccer = 0;
+    uint8_t src = 0;
+    uint8_t match = 0;
+    uint8_t div = 0;
+    uint16_t flag = 0;
+
+    if (Input < 1 || Input > 4 || M->Input[Input - 1] == (Level ? 1 : 0))
+    {
+        return;
+    }
+    M->Input[Input - 1] = Level ? 1 : 0;
+
+    for (ch = 1; ch <= 4; ch++)
+    {
+        field = TM_Ccmr(M, ch);
+        ccer = TM_Ccer(M, ch);
+
+        /* CCxS = 01 直接输入，10 交叉输入（1<->2，3<->4），11 为 TRC（未建模） */
+        src = ((field & TM_CCMR_CCS) == 1) ? ch : ((field & TM_CCMR_CCS) == 2) ? (uint8_t)(((ch - 1) ^ 1) + 1) : 0;
+        if (src != Input || !(ccer & TM_CCER_CCE))
+        {
+            continue;
+        }
+
+        /* CCxNP:CCxP = 00 上升沿，01 下降沿，11 双边沿 */
+        match = ((ccer & TM_CCER_CCP) && (ccer & TM_CCER_CCNP)) ? 1 : (ccer & TM_CCER_CCP) ? !Level : (Level != 0);
+        if (!match)
+        {
+            continue;
+        }
+
+        div = (uint8_t)(1U << ((field & TM_CCMR_ICPSC) >> 2));
+        if (++M->IcDiv[ch - 1] < div)
+        {
+            continue;
+        }
+        M->IcDiv[ch - 1] = 0;
+
+        flag = (uint16_t)(TM_SR_CC1IF << (ch - 1));
+        if (M->SrShadow & flag)
+        {
+            M->SrShadow |= (uint16_t)(TM_SR_CC1OF << (ch - 1));
+        }
+        *TM_Ccr(M, ch) = M->Regs.CNT;
+        M->SrShadow |= flag;
+    }
+}
+
+/**
+  * @brief  下一个脚本边沿的时刻，没有则返回 TM_NEVER。
+  */
+static uint64_t TM_NextEdge(const TimModel* M)
+{
+    return (M->EdgeNext < M->EdgeCount) ? M->Edges[M->EdgeNext].Time : TM_NEVER;
+}
+
+/**
+  * @brief  复位为上电状态。
+  * @param  Model: 模型。
+  * @param  Is32: 非 0 为 32 位计数器（TIM2/TIM5），否则为 16 位。
+  * @retval None
+  * @note   回调指针一并清零，需要时在本函数之后设置。
+  */
+void TimModel_Init(TimModel* Model, int Is32)
+{
+    memset(Model, 0, sizeof(*Model));
+    Model->Mask = Is32 ? 0xFFFFFFFF : 0xFFFF;
+    Model->Regs.ARR = Model->Mask;
+    Model->ArrShadow = Model->Mask;
+    Model->Up = 1;
+}
+
+/**
+  * @brief  设置脚本化输入边沿。
+  * @param  Model: 模型。
+  * @param  Edges: 边沿数组，按 Time 升序排列，运行期间须保持有效。
+  * @param  Count: 边沿个数。
+  * @retval None
+  * @note   早于当前时刻的边沿在下一次 TimModel_Run() 开始时立即生效。
+  */
+void TimModel_SetEdges(TimModel* Model, const TimModelEdge* Edges, size_t Count)
+{
+    Model->Edges = Edges;
+    Model->EdgeCount = Count;
+    Model->EdgeNext = 0;
+}
+
+/**
+  * @brief  在当前时刻改变输入电平。
+  * @param  Model: 模型。
+  * @param  Input: TI1~TI4，取 1~4。
+  * @param  Level: 新电平。
+  * @retval None
+  */
+void TimModel_SetInput(TimModel* Model, uint8_t Input, uint8_t Level)
+{
+    TM_Sync(Model);
+    TM_Edge(Model, Input, Level);
+    TM_Publish(Model);
+}
+
+/**
+  * @brief  推进模拟时间。
+  * @param  Model: 模型。
+  * @param  Ticks: 推进的 CK_INT 节拍数。
+  * @retval 推进后的当前时刻
+  *
+  * @note
+  *  - 每一步先同步驱动的写入，再跳到“下一个计数时钟 / 下一个边沿 / 终点”中最近的一个。
+  *  - 同一时刻先处理输入边沿（捕获到的是计数前的 CNT），再处理计数时钟。
+  *  - 每一步之后若 SR & DIER 非零且设置了中断回调则调用回调；
+  *    回调不清标志时会在每个计数时钟重复进入，与真实硬件一致。
+  */
+uint64_t TimModel_Run(TimModel* Model, uint64_t Ticks)
+{
+    uint64_t end = Model->Now + Ticks;
+    uint64_t next = 0;
+    uint64_t edge = 0;
+
+    while (Model->Now < end)
+    {
+        TM_Sync(Model);
+
+        edge = TM_NextEdge(Model);
+        next = end;
+        if (Model->Regs.CR1 & TM_CR1_CEN)
+        {
+            next = Model->Now + (Model->PscShadow + 1 - Model->PscCnt);
+            next = (next < end) ? next : end;
+        }
+        next = (edge > Model->Now && edge < next) ? edge : next;
+
+        if (Model->Regs.CR1 & TM_CR1_CEN)
+        {
+            Model->PscCnt += (uint32_t)(next - Model->Now);
+        }
+        Model->Now = next;
+
+        while (Model->EdgeNext < Model->EdgeCount && Model->Edges[Model->EdgeNext].Time <= Model->Now)
+        {
+            TM_Edge(Model, Model->Edges[Model->EdgeNext].Input, Model->Edges[Model->EdgeNext].Level);
+            Model->EdgeNext++;
+        }
+
+        if ((Model->Regs.CR1 & TM_CR1_CEN) && Model->PscCnt > Model->PscShadow)
+        {
+            Model->PscCnt = 0;
+            TM_CounterTick(Model);
+        }
+
+        TM_Publish(Model);
+        if (Model->Irq != NULL && TimModel_IrqPending(Model))
+        {
+            Model->Irq(Model, Model->IrqCtx);
+        }
+    }
+
+    TM_Sync(Model);
+    return Model->Now;
+}
+
+/**
+  * @brief  读 CCRx，输入捕获模式下同时清除 CCxIF（与硬件读操作的副作用一致）。
+  * @param  Model: 模型。
+  * @param  Channel: 通道 1~4。
+  * @retval CCRx 的值
+  */
+uint32_t TimModel_ReadCCR(TimModel* Model, uint8_t Channel)
+{
+    uint32_t value = *TM_Ccr(Model, Channel);
+
+    if (TM_Ccmr(Model, Channel) & TM_CCMR_CCS)
+    {
+        Model->SrShadow &= Model->Regs.SR;
+        Model->SrShadow &= (uint16_t)~(TM_SR_CC1IF << (Channel - 1));
+        Model->Regs.SR = Model->SrShadow;
+    }
+    return value;
+}
+
+/**
+  * @brief  读通道输出电平。
+  * @param  Model: 模型。
+  * @param  Channel: 通道 1~4。
+  * @retval 输出电平 0/1（含 CCxP 极性；CCxE = 0 时为 0）
+  */
+uint8_t TimModel_GetOutput(const TimModel* Model, uint8_t Channel)
+{
+    return Model->OutLevel[Channel - 1];
+}
+
+/**
+  * @brief  是否有使能的中断挂起。
+  * @param  Model: 模型。
+  * @retval 非 0：SR & DIER 的中断位非零
+  */
+int TimModel_IrqPending(const TimModel* Model)
+{
+    return (Model->Regs.SR & Model->Regs.DIER & 0xFF) != 0;
+}
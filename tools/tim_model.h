@@ -0,0 +1,105 @@
+/**
+  ******************************************************************************
+  * @file     tim_model.h
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    主机端 TIM 寄存器模型接口
+  *
+  * @attention
+  *
+  * TimModelRegs 与 StdPeriph 的 TIM_TypeDef 布局完全一致（16 位寄存器后跟 16 位保留）。
+  * 但 myTIM_DeInit、myTIM_TimeBaseInit、myTIM_GetClockFreq、myTIM_OCxInit 等函数按地址
+  * 与 TIM1~TIM14 比较来识别定时器，把任意 TimModel 的 &Regs 强转后传入时，高级定时器和
+  * 计数模式分支（CMS/DIR/CKD/RCR）会被跳过，时钟查询也得不到正确结果。
+  * 驱动测试应通过 tools/shim 编译：替身头文件把 TIM1~TIM14 定义为 TimShim_Tim[] 中各模型的
+  * 寄存器组，驱动源码无需修改，见 tools/tim_model_test.c。
+  *
+  * 驱动对寄存器的写入就是普通内存写，模型在每次推进时间前同步：
+  * - SR 按“写 0 清除、写 1 无效”合并；EGR 的 UG/CCxG 在同步时执行并自动清零。
+  * - 输入捕获模式下读 CCRx 会清除 CCxIF，普通内存读无法感知，需要该语义时用 TimModel_ReadCCR()。
+  *
+  ******************************************************************************
+  */
+
+#ifndef tim_model_h
+#define tim_model_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* 与 TIM_TypeDef 相同布局的寄存器组 */
+typedef struct
+{
+    volatile uint16_t CR1;   uint16_t RESERVED0;
+    volatile uint16_t CR2;   uint16_t RESERVED1;
+    volatile uint16_t SMCR;  uint16_t RESERVED2;
+    volatile uint16_t DIER;  uint16_t RESERVED3;
+    volatile uint16_t SR;    uint16_t RESERVED4;
+    volatile uint16_t EGR;   uint16_t RESERVED5;
+    volatile uint16_t CCMR1; uint16_t RESERVED6;
+    volatile uint16_t CCMR2; uint16_t RESERVED7;
+    volatile uint16_t CCER;  uint16_t RESERVED8;
+    volatile uint32_t CNT;
+    volatile uint16_t PSC;   uint16_t RESERVED9;
+    volatile uint32_t ARR;
+    volatile uint16_t RCR;   uint16_t RESERVED10;
+    volatile uint32_t CCR1;
+    volatile uint32_t CCR2;
+    volatile uint32_t CCR3;
+    volatile uint32_t CCR4;
+    volatile uint16_t BDTR;  uint16_t RESERVED11;
+    volatile uint16_t DCR;   uint16_t RESERVED12;
+    volatile uint16_t DMAR;  uint16_t RESERVED13;
+    volatile uint16_t OR;    uint16_t RESERVED14;
+} TimModelRegs;
+
+/* 脚本化输入边沿，按 Time 升序排列 */
+typedef struct
+{
+    uint64_t Time;               /* 发生时刻（CK_INT 节拍，从 TimModel_Init 起算） */
+    uint8_t  Input;              /* 输入 TI1~TI4，取 1~4 */
+    uint8_t  Level;              /* 边沿之后的电平 0/1 */
+} TimModelEdge;
+
+typedef struct TimModel TimModel;
+
+/* 中断回调：SR & DIER 非零时调用，回调里可以像真实中断一样读写 Regs */
+typedef void (*TimModelIrq)(TimModel* Model, void* Ctx);
+/* 输出回调：通道输出电平变化时调用，可用来记录 PWM 波形 */
+typedef void (*TimModelOutput)(TimModel* Model, uint8_t Channel, uint8_t Level, void* Ctx);
+
+struct TimModel
+{
+    TimModelRegs Regs;           /* 驱动看到的寄存器 */
+    uint64_t Now;                /* 当前时刻（CK_INT 节拍） */
+    uint32_t Mask;               /* 计数器量程：0xFFFF 或 0xFFFFFFFF */
+    uint32_t PscCnt;             /* 预分频计数器 */
+    uint32_t PscShadow;          /* PSC 影子寄存器 */
+    uint32_t ArrShadow;          /* ARR 影子寄存器 */
+    uint32_t CcrShadow[4];       /* CCRx 影子寄存器（OCxPE = 1 时使用） */
+    uint16_t RepCnt;             /* 重复计数器 */
+    uint16_t SrShadow;           /* 硬件维护的 SR */
+    uint8_t  Up;                 /* 中心对齐模式的当前方向 */
+    uint8_t  Input[4];           /* TI1~TI4 当前电平 */
+    uint8_t  IcDiv[4];           /* 输入捕获预分频计数 */
+    uint8_t  OcRef[4];           /* OCxREF */
+    uint8_t  OutLevel[4];        /* 通道输出电平（含极性和 CCxE） */
+    const TimModelEdge* Edges;
+    size_t   EdgeCount;
+    size_t   EdgeNext;
+    TimModelIrq Irq;
+    void*    IrqCtx;
+    TimModelOutput Output;
+    void*    OutputCtx;
+};
+
+void TimModel_Init(TimModel* Model, int Is32);                        // 复位为上电状态
+void TimModel_SetEdges(TimModel* Model, const TimModelEdge* Edges, size_t Count); // 设置脚本化输入边沿
+void TimModel_SetInput(TimModel* Model, uint8_t Input, uint8_t Level); // 在当前时刻改变输入电平
+uint64_t TimModel_Run(TimModel* Model, uint64_t Ticks);               // 推进 Ticks 个 CK_INT 节拍，返回当前时刻
+uint32_t TimModel_ReadCCR(TimModel* Model, uint8_t Channel);          // 读 CCRx（输入捕获时清 CCxIF）
+uint8_t TimModel_GetOutput(const TimModel* Model, uint8_t Channel);   // 读通道输出电平
+int TimModel_IrqPending(const TimModel* Model);                       // SR & DIER 是否有中断挂起
+
+#endif
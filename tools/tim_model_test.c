@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file     tim_model_test.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    在 TIM 寄存器模型上运行 myTIM_* 驱动的主机测试
+  *
+  * @attention
+  *
+  * 驱动源码原样编译，设备头文件换成 tools/shim 下的替身：TIM1~TIM14 指向
+  * TimShim_Tim[] 中的模型，RCC 时钟固定为 168MHz / APB1 42MHz / APB2 84MHz。
+  *
+  * 覆盖：
+  * - myTIM_GetClockFreq：APB1 与 APB2 定时器的 TIMxCLK。
+  * - myTIM_DeInit / myTIM_TimeBaseInit / myTIM_OCxInit / myTIM_Cmd：TIM3 通道 1 输出
+  *   1kHz、25% 占空比的 PWM，按输出回调记录的边沿时刻检查周期和高电平宽度。
+  * - myTIM_TimeBaseInit 的高级定时器分支：TIM1 中心对齐 + RCR，检查更新中断间隔。
+  *   这两项依赖驱动按地址识别 TIM1/TIM3，直接把 &model.Regs 强转交给驱动时不会生效。
+  *
+  * 编译：gcc -O2 -std=c99 -I tools/shim -I . -o tim_model_test tools/tim_model_test.c
+  *       tools/tim_model.c tools/shim/tim_shim.c mystm32f4_tim.c
+  * 用法：在仓库根目录执行 ./tim_model_test，全部通过返回 0。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "mystm32f4_tim.h"
+#include "tim_shim.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TEST_MAX_EDGES  16
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint64_t Rise[TEST_MAX_EDGES];   /* 上升沿时刻 */
+    uint64_t Fall[TEST_MAX_EDGES];   /* 下降沿时刻 */
+    uint8_t  Rises;
+    uint8_t  Falls;
+} Scope;
+
+/* Private variables ---------------------------------------------------------*/
+static int s_failed = 0;
+
+/* Private functions ---------------------------------------------------------*/
+static void Check(int Ok, const char* What, uint64_t Got, uint64_t Want)
+{
+    printf("%s %-40s got %llu, want %llu\n", Ok ? "PASS" : "FAIL", What,
+        (unsigned long long)Got, (unsigned long long)Want);
+    s_failed += Ok ? 0 : 1;
+}
+
+static void ScopeOutput(TimModel* Model, uint8_t Channel, uint8_t Level, void* Ctx)
+{
+    Scope* scope = (Scope*)Ctx;
+
+    if (Channel != 1)
+    {
+        return;
+    }
+    if (Level && scope->Rises < TEST_MAX_EDGES)
+    {
+        scope->Rise[scope->Rises++] = Model->Now;
+    }
+    else if (!Level && scope->Falls < TEST_MAX_EDGES)
+    {
+        scope->Fall[scope->Falls++] = Model->Now;
+    }
+}
+
+static void CountUpdate(TimModel* Model, void* Ctx)
+{
+    uint64_t* last = (uint64_t*)Ctx;
+
+    /* 像中断服务函数一样通过驱动清标志；记录最近两次更新的间隔 */
+    myTIM_ClearITPendingBit(TIM1, TIM_IT_Update);
+    last[1] = Model->Now - last[0];
+    last[0] = Model->Now;
+    last[2]++;
+}
+
+/**
+  * @brief  TIM3 通道 1 输出 1kHz、25% 占空比的 PWM。
+  */
+static void TestPwm(void)
+{
+    TIM_TimeBaseInitTypeDef base;
+    TIM_OCInitTypeDef oc;
+    TimModel* model = TimShim_Model(TIM3);
+    Scope scope;
+    uint32_t clk = myTIM_GetClockFreq(TIM3);
+
+    myTIM_DeInit(TIM3);
+    memset(&scope, 0, sizeof(scope));
+    model->Output = ScopeOutput;
+    model->OutputCtx = &scope;
+
+    myTIM_TimeBaseStructInit(&base);
+    base.TIM_Prescaler = (uint16_t)(clk / 1000000 - 1);
+    base.TIM_Period = 999;
+    myTIM_TimeBaseInit(TIM3, &base);
+
+    myTIM_OCStructInit(&oc);
+    oc.TIM_OCMode = TIM_OCMode_PWM1;
+    oc.TIM_OutputState = TIM_OutputState_Enable;
+    oc.TIM_Pulse = 250;
+    oc.TIM_OCPolarity = TIM_OCPolarity_High;
+    myTIM_OCxInit(TIM3, 1, &oc);
+    myTIM_Cmd(TIM3, ENABLE);
+
+    TimModel_Run(model, (uint64_t)clk / 1000 * 5);
+
+    Check(scope.Rises >= 3 && scope.Falls >= 3, "TIM3 PWM edges", scope.Rises, 3);
+    if (scope.Rises >= 3 && scope.Falls >= 3)
+    {
+        Check(scope.Rise[2] - scope.Rise[1] == clk / 1000, "TIM3 PWM period (ticks)",
+            scope.Rise[2] - scope.Rise[1], clk / 1000);
+        Check(scope.Fall[1] - scope.Rise[1] == clk / 4000, "TIM3 PWM high time (ticks)",
+            scope.Fall[1] - scope.Rise[1], clk / 4000);
+    }
+}
+
+/**
+  * @brief  TIM1 中心对齐 1 模式、ARR = 100、RCR = 1。
+  * @note   中心对齐时上溢和下溢各消耗一次重复计数，每 (RCR + 1) × ARR = 200 个计数更新一次。
+  */
+static void TestCenterAligned(void)
+{
+    TIM_TimeBaseInitTypeDef base;
+    TimModel* model = TimShim_Model(TIM1);
+    uint64_t last[3] = { 0, 0, 0 };
+
+    myTIM_DeInit(TIM1);
+    model->Irq = CountUpdate;
+    model->IrqCtx = last;
+
+    myTIM_TimeBaseStructInit(&base);
+    base.TIM_CounterMode = TIM_CounterMode_CenterAligned1;
+    base.TIM_Period = 100;
+    base.TIM_RepetitionCounter = 1;
+    myTIM_TimeBaseInit(TIM1, &base);
+
+    Check((TIM1->CR1 & TIM_CR1_CMS) == TIM_CounterMode_CenterAligned1, "TIM1 CR1.CMS",
+        TIM1->CR1 & TIM_CR1_CMS, TIM_CounterMode_CenterAligned1);
+    Check(TIM1->RCR == 1, "TIM1 RCR", TIM1->RCR, 1);
+
+    /* 模型在推进时间时才执行 EGR.UG，先让初始化产生的 UIF 落地再清除 */
+    TimModel_Run(model, 0);
+    myTIM_ClearFlag(TIM1, TIM_FLAG_Update);
+    myTIM_ITConfig(TIM1, TIM_IT_Update, ENABLE);
+    myTIM_Cmd(TIM1, ENABLE);
+    TimModel_Run(model, 2000);
+
+    Check(last[2] == 10, "TIM1 updates in 2000 ticks", last[2], 10);
+    Check(last[1] == 200, "TIM1 update interval (ticks)", last[1], 200);
+}
+
+int main(void)
+{
+    TimShim_Init();
+
+    Check(myTIM_GetClockFreq(TIM3) == TIM_SHIM_HCLK / 2, "TIM3 clock (APB1 x2)",
+        myTIM_GetClockFreq(TIM3), TIM_SHIM_HCLK / 2);
+    Check(myTIM_GetClockFreq(TIM1) == TIM_SHIM_HCLK, "TIM1 clock (APB2 x2)",
+        myTIM_GetClockFreq(TIM1), TIM_SHIM_HCLK);
+
+    TestPwm();
+    TestCenterAligned();
+
+    printf("%s\n", s_failed ? "FAILED" : "OK");
+    return s_failed ? 1 : 0;
+}
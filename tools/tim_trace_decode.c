@@ -0,0 +1,564 @@
+/**
+  ******************************************************************************
+  * @file     tim_trace_decode.c
+  * @author   QiangGu
+  * @version  V1.0.0
+  * @date     2026-10-18
+  * @brief    mystm32f4_tim_trace 转储文件的主机端解码器
+  *
+  * @attention
+  *
+  * 在 Linux（或任何有 C99 编译器的主机）上运行，输入 myTIM_TraceDump() 的输出：
+  *
+  * - 各区域延迟统计：次数、最小/平均/中位数/P99/最大值，以及按 2 的幂分桶的直方图。
+  *   延迟为 ENTER 到 EXIT 的墙钟时间，包含被更高优先级中断抢占的时间。
+  * - 火焰图折叠栈（-f）：每行“上下文;区域;子区域 节拍数”，可直接交给 flamegraph.pl。
+  *   中断抢占时，被抢占上下文的栈作为前缀，能看到中断嵌套链中时间花在哪里。
+  *   计数为排除子区域和抢占后的独占时间，单位为时间戳节拍。
+  *
+  * 时间戳还原：
+  * - 以转储时刻的 CNT 为基准向前还原 64 位时间，要求整个记录窗口短于计数器
+  *   半个回绕周期（84MHz 时约 25 秒）；看起来晚于转储时刻的记录视为转储期间被覆盖，丢弃。
+  * - 各上下文缓冲区写满的时刻不同，只分析所有写满的缓冲区都有记录的时间段，
+  *   避免低频上下文的旧记录缺少与高频上下文的交错关系。
+  *
+  * 编译：gcc -O2 -std=c99 -o tim_trace_decode tim_trace_decode.c
+  * 用法：tim_trace_decode dump.bin [-n names.txt] [-f out.folded]
+  *       names.txt 每行“ID 名称”，未命名的区域显示为 region<ID>。
+  *
+  * 版本历史：
+  * V1.0.0 初始版本
+  *
+  * 免责声明：
+  * 本软件按“原样”提供，不提供任何明示或暗示的担保，包括但不限于对适销性或特定用途适用性的保证。
+  * 作者不对因使用本软件而产生的任何直接、间接、偶然、特殊、示例性或后果性损失承担责任。
+  * 本软件仅供学习和研究使用，无偿共享，禁止用于商业用途。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define TRACE_MAGIC           0x31435254U
+#define TRACE_EXIT_FLAG       0x80000000U
+#define TRACE_MAX_CONTEXTS    64
+#define TRACE_MAX_NEST        64
+#define TRACE_IDS             65536
+#define TRACE_BUCKETS         40
+#define TRACE_BASE            ((uint64_t)1 << 40)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+    uint64_t Time;               /* 还原后的 64 位时间 */
+    uint32_t Tag;
+    uint32_t Ctx;
+    uint32_t Seq;                /* 上下文内序号，时间相同时保持原顺序 */
+} Event;
+
+typedef struct
+{
+    uint16_t Id;
+    uint64_t Enter;
+} Frame;
+
+typedef struct
+{
+    uint32_t Level;
+    uint32_t Ipsr;               /* 栈底区域所在异常号，用作上下文标签 */
+    uint32_t Depth;
+    Frame Stack[TRACE_MAX_NEST];
+} Context;
+
+typedef struct
+{
+    uint32_t Count;
+    uint32_t Cap;
+    uint64_t* Samples;
+    uint64_t Bucket[TRACE_BUCKETS];
+} Region;
+
+typedef struct
+{
+    char* Key;
+    uint64_t Ticks;
+} FoldEntry;
+
+/* Private variables ---------------------------------------------------------*/
+static char* s_names[TRACE_IDS];
+static Region s_region[TRACE_IDS];
+static Context s_ctx[TRACE_MAX_CONTEXTS];
+static uint32_t s_active[TRACE_MAX_CONTEXTS];
+static uint32_t s_activeCount = 0;
+static FoldEntry* s_fold = NULL;
+static uint32_t s_foldCap = 0;
+static uint32_t s_foldCount = 0;
+static double s_freq = 1.0;
+
+
+/**
+  * @brief  读取一个小端 32 位字。
+  */
+static int ReadWord(FILE* f, uint32_t* Word)
+{
+    uint8_t b[4];
+
+    if (fread(b, 1, 4, f) != 4)
+    {
+        return 0;
+    }
+    *Word = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    return 1;
+}
+
+/**
+  * @brief  复制字符串（C99 没有 strdup）。
+  */
+static char* Dup(const char* S)
+{
+    size_t len = strlen(S) + 1;
+    char* p = (char*)malloc(len);
+
+    if (p == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    return (char*)memcpy(p, S, len);
+}
+
+/**
+  * @brief  读取区域名称文件，每行“ID 名称”。
+  */
+static void LoadNames(const char* Path)
+{
+    FILE* f = fopen(Path, "r");
+    char line[256];
+    char name[200];
+    unsigned id = 0;
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", Path);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (sscanf(line, "%u %199s", &id, name) == 2 && id < TRACE_IDS)
+        {
+            free(s_names[id]);
+            s_names[id] = Dup(name);
+        }
+    }
+    fclose(f);
+}
+
+/**
+  * @brief  区域名称；未命名时返回 region<ID>。
+  */
+static const char* RegionName(uint16_t Id, char* Buf, size_t Len)
+{
+    if (s_names[Id] != NULL)
+    {
+        return s_names[Id];
+    }
+    snprintf(Buf, Len, "region%u", (unsigned)Id);
+    return Buf;
+}
+
+/**
+  * @brief  上下文标签：线程模式、系统异常名称或外设中断号。
+  */
+static const char* ContextName(uint32_t Ipsr, char* Buf, size_t Len)
+{
+    switch (Ipsr)
+    {
+    case 0:  return "thread";
+    case 11: return "SVCall";
+    case 14: return "PendSV";
+    case 15: return "SysTick";
+    default: break;
+    }
+    (Ipsr < 16) ? snprintf(Buf, Len, "exc%u", (unsigned)Ipsr) : snprintf(Buf, Len, "irq%u", (unsigned)(Ipsr - 16));
+    return Buf;
+}
+
+/**
+  * @brief  事件排序：时间、上下文、上下文内序号。
+  */
+static int CompareEvent(const void* A, const void* B)
+{
+    const Event* a = (const Event*)A;
+    const Event* b = (const Event*)B;
+
+    if (a->Time != b->Time)
+    {
+        return (a->Time < b->Time) ? -1 : 1;
+    }
+    if (a->Ctx != b->Ctx)
+    {
+        return (a->Ctx < b->Ctx) ? -1 : 1;
+    }
+    return (a->Seq < b->Seq) ? -1 : (a->Seq > b->Seq);
+}
+
+static int CompareU64(const void* A, const void* B)
+{
+    uint64_t a = *(const uint64_t*)A;
+    uint64_t b = *(const uint64_t*)B;
+
+    return (a < b) ? -1 : (a > b);
+}
+
+/**
+  * @brief  FNV-1a 字符串散列。
+  */
+static uint32_t Hash(const char* S)
+{
+    uint32_t h = 2166136261U;
+
+    while (*S)
+    {
+        h = (h ^ (uint8_t)*S++) * 16777619U;
+    }
+    return h;
+}
+
+/**
+  * @brief  把节拍数累加到折叠栈 Key（开放寻址散列表，装载率超过一半时扩容）。
+  */
+static void FoldAdd(const char* Key, uint64_t Ticks)
+{
+    FoldEntry* old = s_fold;
+    uint32_t oldCap = s_foldCap;
+    uint32_t i = 0;
+
+    if (2 * (s_foldCount + 1) > s_foldCap)
+    {
+        s_foldCap = (s_foldCap == 0) ? 1024 : 2 * s_foldCap;
+        s_fold = (FoldEntry*)calloc(s_foldCap, sizeof(FoldEntry));
+        for (i = 0; i < oldCap; i++)
+        {
+            if (old[i].Key != NULL)
+            {
+                uint32_t j = Hash(old[i].Key) & (s_foldCap - 1);
+                while (s_fold[j].Key != NULL)
+                {
+                    j = (j + 1) & (s_foldCap - 1);
+                }
+                s_fold[j] = old[i];
+            }
+        }
+        free(old);
+    }
+
+    i = Hash(Key) & (s_foldCap - 1);
+    while (s_fold[i].Key != NULL && strcmp(s_fold[i].Key, Key) != 0)
+    {
+        i = (i + 1) & (s_foldCap - 1);
+    }
+    if (s_fold[i].Key == NULL)
+    {
+        s_fold[i].Key = Dup(Key);
+        s_foldCount++;
+    }
+    s_fold[i].Ticks += Ticks;
+}
+
+/**
+  * @brief  把 Ticks 计入当前正在执行的栈：所有活动上下文按被抢占的先后拼接。
+  */
+static void FoldCurrent(uint64_t Ticks)
+{
+    char key[4096];
+    char buf[32];
+    size_t len = 0;
+    uint32_t i = 0;
+    uint32_t k = 0;
+
+    if (s_activeCount == 0 || Ticks == 0)
+    {
+        return;
+    }
+
+    key[0] = '\0';
+    for (i = 0; i < s_activeCount; i++)
+    {
+        Context* c = &s_ctx[s_active[i]];
+
+        len += (size_t)snprintf(key + len, sizeof(key) - len, "%s%s", (i == 0) ? "" : ";",
+            ContextName(c->Ipsr, buf, sizeof(buf)));
+        for (k = 0; k < c->Depth && len < sizeof(key); k++)
+        {
+            len += (size_t)snprintf(key + len, sizeof(key) - len, ";%s", RegionName(c->Stack[k].Id, buf, sizeof(buf)));
+        }
+        if (len >= sizeof(key))
+        {
+            break;
+        }
+    }
+    FoldAdd(key, Ticks);
+}
+
+/**
+  * @brief  记录一次区域延迟。
+  */
+static void RegionAdd(uint16_t Id, uint64_t Ticks)
+{
+    Region* r = &s_region[Id];
+    uint32_t b = 0;
+
+    if (r->Count == r->Cap)
+    {
+        r->Cap = (r->Cap == 0) ? 64 : 2 * r->Cap;
+        r->Samples = (uint64_t*)realloc(r->Samples, r->Cap * sizeof(uint64_t));
+    }
+    r->Samples[r->Count++] = Ticks;
+
+    /* 按纳秒的 2 的幂分桶：桶 b 为 [2^b, 2^(b+1)) ns */
+    for (b = 0; b + 1 < TRACE_BUCKETS && ((uint64_t)1 << (b + 1)) <= (uint64_t)(Ticks * 1e9 / s_freq); b++)
+    {
+    }
+    r->Bucket[b]++;
+}
+
+/**
+  * @brief  上下文从活动列表中移除（栈清空）。
+  */
+static void Deactivate(uint32_t Ctx)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < s_activeCount; i++)
+    {
+        if (s_active[i] == Ctx)
+        {
+            memmove(&s_active[i], &s_active[i + 1], (s_activeCount - i - 1) * sizeof(uint32_t));
+            s_activeCount--;
+            return;
+        }
+    }
+}
+
+/**
+  * @brief  输出各区域延迟统计和直方图。
+  */
+static void PrintRegions(void)
+{
+    char buf[32];
+    uint32_t id = 0;
+    uint32_t b = 0;
+    uint32_t i = 0;
+
+    for (id = 0; id < TRACE_IDS; id++)
+    {
+        Region* r = &s_region[id];
+        uint64_t sum = 0;
+        uint64_t peak = 0;
+
+        if (r->Count == 0)
+        {
+            continue;
+        }
+        qsort(r->Samples, r->Count, sizeof(uint64_t), CompareU64);
+        for (i = 0; i < r->Count; i++)
+        {
+            sum += r->Samples[i];
+        }
+
+        printf("%s: n=%u min=%.3fus mean=%.3fus p50=%.3fus p99=%.3fus max=%.3fus\n",
+            RegionName((uint16_t)id, buf, sizeof(buf)), r->Count,
+            r->Samples[0] * 1e6 / s_freq, (double)sum / r->Count * 1e6 / s_freq,
+            r->Samples[r->Count / 2] * 1e6 / s_freq, r->Samples[(uint64_t)r->Count * 99 / 100] * 1e6 / s_freq,
+            r->Samples[r->Count - 1] * 1e6 / s_freq);
+
+        for (b = 0; b < TRACE_BUCKETS; b++)
+        {
+            peak = (r->Bucket[b] > peak) ? r->Bucket[b] : peak;
+        }
+        for (b = 0; b < TRACE_BUCKETS; b++)
+        {
+            if (r->Bucket[b] != 0)
+            {
+                printf("  [%12llu ns, %12llu ns) %8llu %.*s\n", (unsigned long long)(b ? (uint64_t)1 << b : 0),
+                    (unsigned long long)((uint64_t)1 << (b + 1)), (unsigned long long)r->Bucket[b],
+                    (int)(r->Bucket[b] * 50 / peak), "##################################################");
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* dumpPath = NULL;
+    const char* foldPath = NULL;
+    FILE* f = NULL;
+    Event* ev = NULL;
+    uint32_t magic = 0, freq = 0, now = 0, contexts = 0, depth = 0;
+    uint32_t level = 0, count = 0, time = 0, tag = 0;
+    uint32_t total = 0, n = 0, c = 0, i = 0;
+    uint32_t orphan = 0, mismatch = 0, dropped = 0;
+    uint64_t start = 0, prev = 0;
+    int a = 0;
+
+    for (a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-n") == 0 && a + 1 < argc)
+        {
+            LoadNames(argv[++a]);
+        }
+        else if (strcmp(argv[a], "-f") == 0 && a + 1 < argc)
+        {
+            foldPath = argv[++a];
+        }
+        else
+        {
+            dumpPath = argv[a];
+        }
+    }
+    if (dumpPath == NULL)
+    {
+        fprintf(stderr, "usage: %s dump.bin [-n names.txt] [-f out.folded]\n", argv[0]);
+        return 1;
+    }
+
+    f = fopen(dumpPath, "rb");
+    if (f == NULL || !ReadWord(f, &magic) || magic != TRACE_MAGIC || !ReadWord(f, &freq) ||
+        !ReadWord(f, &now) || !ReadWord(f, &contexts) || !ReadWord(f, &depth) ||
+        freq == 0 || contexts > TRACE_MAX_CONTEXTS)
+    {
+        fprintf(stderr, "%s: not a trace dump\n", dumpPath);
+        return 1;
+    }
+    s_freq = freq;
+
+    /* 读入全部记录，以转储时刻为基准还原 64 位时间 */
+    for (c = 0; c < contexts; c++)
+    {
+        uint64_t first = 0;
+        uint32_t kept = 0;
+
+        if (!ReadWord(f, &level) || !ReadWord(f, &count))
+        {
+            fprintf(stderr, "%s: truncated\n", dumpPath);
+            return 1;
+        }
+        s_ctx[c].Level = level;
+        ev = (Event*)realloc(ev, (total + count) * sizeof(Event));
+
+        for (i = 0; i < count; i++)
+        {
+            if (!ReadWord(f, &time) || !ReadWord(f, &tag))
+            {
+                fprintf(stderr, "%s: truncated\n", dumpPath);
+                return 1;
+            }
+            if ((uint32_t)(now - time) >= 0x80000000U ||
+                (kept != 0 && TRACE_BASE - (uint32_t)(now - time) < ev[total + kept - 1].Time))
+            {
+                dropped++;      // 转储期间被覆盖，或时间不单调
+                continue;
+            }
+            ev[total + kept].Time = TRACE_BASE - (uint32_t)(now - time);
+            ev[total + kept].Tag = tag;
+            ev[total + kept].Ctx = c;
+            ev[total + kept].Seq = i;
+            first = (kept == 0) ? ev[total + kept].Time : first;
+            kept++;
+        }
+
+        /* 写满的缓冲区：更早的记录已被覆盖，分析从它最早的记录开始 */
+        if (count == depth && kept != 0 && first > start)
+        {
+            start = first;
+        }
+        total += kept;
+    }
+    fclose(f);
+
+    qsort(ev, total, sizeof(Event), CompareEvent);
+
+    /* 按时间回放：相邻事件之间的时间计入当前栈，EXIT 时记录区域延迟 */
+    for (n = 0; n < total; n++)
+    {
+        Context* ctx = &s_ctx[ev[n].Ctx];
+        uint16_t id = (uint16_t)ev[n].Tag;
+
+        if (ev[n].Time < start)
+        {
+            continue;
+        }
+        if (prev != 0)
+        {
+            FoldCurrent(ev[n].Time - prev);
+        }
+        prev = ev[n].Time;
+
+        if (!(ev[n].Tag & TRACE_EXIT_FLAG))
+        {
+            if (ctx->Depth == 0)
+            {
+                ctx->Ipsr = (ev[n].Tag >> 16) & 0x1FF;
+                s_active[s_activeCount++] = ev[n].Ctx;
+            }
+            if (ctx->Depth < TRACE_MAX_NEST)
+            {
+                ctx->Stack[ctx->Depth].Id = id;
+                ctx->Stack[ctx->Depth].Enter = ev[n].Time;
+                ctx->Depth++;
+            }
+            continue;
+        }
+
+        /* EXIT：找到匹配的 ENTER；中间没有 EXIT 的区域视为不配对，一并弹出 */
+        for (i = ctx->Depth; i > 0 && ctx->Stack[i - 1].Id != id; i--)
+        {
+        }
+        if (i == 0)
+        {
+            orphan++;
+            continue;
+        }
+        mismatch += ctx->Depth - i;
+        ctx->Depth = i - 1;
+        RegionAdd(id, ev[n].Time - ctx->Stack[i - 1].Enter);
+        if (ctx->Depth == 0)
+        {
+            Deactivate(ev[n].Ctx);
+        }
+    }
+
+    printf("timestamp %u Hz, %u contexts, %u events, window %.3f ms\n", freq, contexts, total,
+        (total && prev > start) ? (prev - (start ? start : ev[0].Time)) * 1e3 / s_freq : 0.0);
+    if (dropped || orphan || mismatch)
+    {
+        printf("dropped %u overwritten, %u unmatched EXIT, %u unmatched ENTER\n", dropped, orphan, mismatch);
+    }
+    PrintRegions();
+
+    if (foldPath != NULL)
+    {
+        f = fopen(foldPath, "w");
+        if (f == NULL)
+        {
+            fprintf(stderr, "cannot open %s\n", foldPath);
+            return 1;
+        }
+        for (i = 0; i < s_foldCap; i++)
+        {
+            if (s_fold[i].Key != NULL)
+            {
+                fprintf(f, "%s %llu\n", s_fold[i].Key, (unsigned long long)s_fold[i].Ticks);
+            }
+        }
+        fclose(f);
+    }
+
+    free(ev);
+    return 0;
+}